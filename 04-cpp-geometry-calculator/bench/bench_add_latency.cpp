@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+
+using namespace geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Time every append and print latency percentiles
+ */
+template <typename Append>
+void measure(const char* name, size_t count, Append append) {
+    std::vector<double> latencies(count);
+    auto total_start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        auto start = Clock::now();
+        append(i);
+        latencies[i] = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+    double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - total_start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[std::min(count - 1, static_cast<size_t>(p * static_cast<double>(count)))];
+    };
+    std::printf("%-24s %10.0f %10.0f %10.0f %12.0f %10.1f\n", name, percentile(0.5), percentile(0.99),
+                percentile(0.999), latencies.back(), total_ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    if (count == 0) {
+        std::fprintf(stderr, "usage: %s [shapes]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%zu appends\n\n", count);
+    std::printf("%-24s %10s %10s %10s %12s %10s\n", "storage", "p50 ns", "p99 ns", "p99.9 ns", "max ns",
+                "total ms");
+
+    {
+        // Baseline: contiguous vectors that reallocate as they grow
+        std::vector<std::unique_ptr<Shape>> shapes;
+        std::vector<Point> positions;
+        std::vector<double> areas;
+        measure("contiguous vectors", count, [&](size_t i) {
+            auto shape = std::make_unique<Circle>(1.0 + static_cast<double>(i % 7));
+            areas.push_back(shape->area());
+            positions.push_back(Point{static_cast<double>(i), 0.0});
+            shapes.push_back(std::move(shape));
+        });
+    }
+    {
+        GeometryCalculator calculator;
+        measure("GeometryCalculator", count, [&](size_t i) {
+            calculator.addShape(std::make_unique<Circle>(1.0 + static_cast<double>(i % 7)),
+                                Point{static_cast<double>(i), 0.0});
+        });
+    }
+    return 0;
+}
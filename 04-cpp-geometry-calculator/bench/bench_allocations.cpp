@@ -0,0 +1,161 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include "alloc_counter.h"
+#include "geometry_calculator.h"
+#include "small_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+
+using namespace geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile double g_sink = 0.0;
+
+/**
+ * @brief Run op(i) for i in [0, iterations) and report allocations, bytes
+ *        and time per operation (one operation = items_per_call items)
+ */
+template <typename Op>
+void measure(const char* name, size_t iterations, Op op, size_t items_per_call = 1) {
+    AllocationScope scope;
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        op(i);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    AllocationStats stats = scope.stats();
+
+    double operations = static_cast<double>(iterations) * static_cast<double>(items_per_call);
+    std::printf("%-46s %10.2f %12.1f %12.1f\n", name,
+                static_cast<double>(stats.allocations) / operations,
+                static_cast<double>(stats.bytes) / operations,
+                static_cast<double>(elapsed.count()) / operations);
+}
+
+void fill(GeometryCalculator& calculator, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        double size = 1.0 + static_cast<double>(i % 10);
+        Point position{static_cast<double>(i % 100) * 3.0, static_cast<double>(i / 100) * 3.0};
+        switch (i % 3) {
+            case 0: calculator.addShape(std::make_unique<Circle>(size), position); break;
+            case 1: calculator.addShape(std::make_unique<Rectangle>(size, 2.0), position); break;
+            default: calculator.addShape(std::make_unique<Triangle>(size, size, size), position); break;
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    if (n == 0) {
+        std::fprintf(stderr, "usage: %s [shapes]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%zu shapes\n\n", n);
+    std::printf("%-46s %10s %12s %12s\n", "operation", "allocs/op", "bytes/op", "ns/op");
+
+    // Shapes
+    Circle circle(2.0);
+    Triangle triangle(3.0, 3.0, 3.0);
+    measure("Circle construct (make_unique)", n, [](size_t i) {
+        auto shape = std::make_unique<Circle>(1.0 + static_cast<double>(i % 7));
+        g_sink = g_sink + shape->radius();
+    });
+    measure("Circle::area", n, [&](size_t) { g_sink = g_sink + circle.area(); });
+    measure("Circle::perimeter", n, [&](size_t) { g_sink = g_sink + circle.perimeter(); });
+    measure("Circle::name", n, [&](size_t) { g_sink = g_sink + circle.name().size(); });
+    measure("Triangle::name (equilateral)", n, [&](size_t) {
+        g_sink = g_sink + triangle.name().size();
+    });
+    measure("Triangle::isValid", n, [&](size_t) { g_sink = g_sink + triangle.isValid(); });
+
+    // Calculator mutations
+    {
+        GeometryCalculator calculator;
+        measure("GeometryCalculator::addShape", n, [&](size_t i) {
+            calculator.addShape(std::make_unique<Circle>(1.0 + static_cast<double>(i % 7)));
+        });
+    }
+    {
+        GeometryCalculator calculator;
+        calculator.createView("circles", ViewDefinition{});
+        measure("GeometryCalculator::addShape (1 view)", n, [&](size_t i) {
+            calculator.addShape(std::make_unique<Circle>(1.0 + static_cast<double>(i % 7)));
+        });
+    }
+
+    GeometryCalculator calculator;
+    fill(calculator, n);
+    measure("GeometryCalculator::replaceShape", n, [&](size_t i) {
+        calculator.replaceShape(i, std::make_unique<Rectangle>(2.0, 1.0 + static_cast<double>(i % 5)));
+    });
+    measure("GeometryCalculator::setPosition", n, [&](size_t i) {
+        calculator.setPosition(i, Point{1.0, static_cast<double>(i)});
+    });
+
+    // Calculator queries
+    measure("GeometryCalculator::shapeCount", n, [&](size_t) {
+        g_sink = g_sink + calculator.shapeCount();
+    });
+    measure("GeometryCalculator::getShape", n, [&](size_t i) {
+        g_sink = g_sink + calculator.getShape(i)->area();
+    });
+    measure("GeometryCalculator::getPlacedShape", n, [&](size_t i) {
+        g_sink = g_sink + calculator.getPlacedShape(i).position.x;
+    });
+    calculator.totalArea();
+    measure("GeometryCalculator::totalArea (cached)", n, [&](size_t) {
+        g_sink = g_sink + calculator.totalArea();
+    });
+    measure("setPosition + totalArea (uncached)", 20, [&](size_t i) {
+        calculator.setPosition(0, Point{static_cast<double>(i), 0.0});
+        g_sink = g_sink + calculator.totalArea();
+    });
+    ShapeQuery circles{QueryAggregate::TotalArea, kindMask(ShapeKind::Circle)};
+    calculator.query(circles);
+    measure("GeometryCalculator::query (filtered, cached)", n, [&](size_t) {
+        g_sink = g_sink + calculator.query(circles);
+    });
+    measure("GeometryCalculator::getShapesInfo (per shape)", 3, [&](size_t) {
+        g_sink = g_sink + calculator.getShapesInfo().size();
+    }, n);
+    measure("GeometryCalculator::reportPage (50, per shape)", 200, [&](size_t i) {
+        g_sink = g_sink + calculator.reportPage((i * 50) % n, 50).count;
+    }, 50);
+    measure("GeometryCalculator::reportFooter", n, [&](size_t) {
+        g_sink = g_sink + calculator.reportFooter().size();
+    });
+    {
+        GeometryCalculator placed;
+        fill(placed, 30);
+        measure("unionPerimeter (30 shapes, tol 1e-3, uncached)", 3, [&](size_t) {
+            placed.queryCache().clear();
+            g_sink = g_sink + placed.unionPerimeter(1e-3);
+        });
+    }
+    measure("merge + partition (per shape)", 5, [&](size_t) {
+        auto parts = calculator.partition(2, [](const Shape& shape) {
+            return static_cast<size_t>(shape.kind() == ShapeKind::Circle);
+        });
+        calculator.merge(parts[0]);
+        calculator.merge(parts[1]);
+    }, n);
+
+    // Small calculator
+    measure("SmallGeometryCalculator<8>::addShape x8", n, [](size_t i) {
+        SmallGeometryCalculator<8> small;
+        for (int s = 0; s < 8; ++s) {
+            small.addShape(ShapeValue::circle(1.0 + static_cast<double>((i + s) % 7)));
+        }
+        g_sink = g_sink + small.totalArea();
+    }, 8);
+    return 0;
+}
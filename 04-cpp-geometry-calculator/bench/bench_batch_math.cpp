@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "batch_math.h"
+
+using namespace geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr MathAccuracy kTiers[] = {MathAccuracy::Reference, MathAccuracy::Faithful, MathAccuracy::Fast};
+constexpr const char* kTierNames[] = {"reference", "faithful", "fast"};
+constexpr int kRepeats = 5;
+
+struct Error {
+    double ulps = 0.0;
+    double relative = 0.0;
+
+    void add(long double exact, double value) {
+        double rounded = static_cast<double>(exact);
+        double ulp = std::nextafter(std::abs(rounded), INFINITY) - std::abs(rounded);
+        double diff = static_cast<double>(std::abs(static_cast<long double>(value) - exact));
+        ulps = std::max(ulps, diff / ulp);
+        relative = std::max(relative, exact != 0 ? diff / static_cast<double>(std::abs(exact)) : diff);
+    }
+};
+
+/**
+ * @brief Best time per element over a few runs
+ */
+template <typename Run>
+double nanosecondsPer(size_t count, Run run) {
+    double best = INFINITY;
+    for (int r = 0; r < kRepeats; ++r) {
+        auto start = Clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return best / static_cast<double>(count);
+}
+
+void report(const char* function, size_t tier, double ns, const Error& error) {
+    std::printf("%-18s %-10s %10.2f %12.3f %12.2e\n", function, kTierNames[tier], ns, error.ulps, error.relative);
+}
+
+/**
+ * @brief AGM ellipse perimeter in extended precision, iterated to convergence
+ */
+long double exactPerimeter(long double a, long double b) {
+    long double hi = std::max(a, b);
+    long double an = 1.0L;
+    long double bn = std::min(a, b) / hi;
+    long double sum = 0.5L * (1.0L - bn) * (1.0L + bn);
+    long double weight = 0.5L;
+    for (int step = 0; step < 40; ++step) {
+        long double c = 0.5L * (an - bn);
+        long double next = 0.5L * (an + bn);
+        bn = std::sqrt(an * bn);
+        an = next;
+        weight *= 2.0L;
+        sum += weight * c * c;
+    }
+    return 2.0L * 3.14159265358979323846264338327950288L * hi * (1.0L - sum) / an;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    if (count == 0) {
+        std::fprintf(stderr, "usage: %s [elements]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> angle_dist(-100.0, 100.0);
+    std::uniform_real_distribution<double> coord_dist(-10.0, 10.0);
+    std::uniform_real_distribution<double> axis_dist(1e-3, 1.0);
+    std::vector<double> angle(count), x(count), y(count), a(count), b(count);
+    for (size_t i = 0; i < count; ++i) {
+        angle[i] = angle_dist(rng);
+        x[i] = coord_dist(rng);
+        y[i] = coord_dist(rng);
+        a[i] = axis_dist(rng);
+        b[i] = axis_dist(rng);
+    }
+    std::vector<double> out(count), out2(count);
+
+    std::printf("%zu elements, errors against long double\n\n", count);
+    std::printf("%-18s %-10s %10s %12s %12s\n", "function", "tier", "ns/elem", "max ulp", "max rel");
+
+    for (size_t t = 0; t < 3; ++t) {
+        double ns = nanosecondsPer(count, [&] { batchSqrt(a.data(), out.data(), count, kTiers[t]); });
+        Error error;
+        for (size_t i = 0; i < count; ++i) {
+            error.add(std::sqrt(static_cast<long double>(a[i])), out[i]);
+        }
+        report("sqrt", t, ns, error);
+    }
+    for (size_t t = 0; t < 3; ++t) {
+        double ns = nanosecondsPer(count, [&] { batchHypot(x.data(), y.data(), out.data(), count, kTiers[t]); });
+        Error error;
+        for (size_t i = 0; i < count; ++i) {
+            error.add(std::hypot(static_cast<long double>(x[i]), static_cast<long double>(y[i])), out[i]);
+        }
+        report("hypot", t, ns, error);
+    }
+    for (size_t t = 0; t < 3; ++t) {
+        double ns = nanosecondsPer(count, [&] {
+            batchSinCos(angle.data(), out.data(), out2.data(), count, kTiers[t]);
+        });
+        Error sin_error;
+        Error cos_error;
+        for (size_t i = 0; i < count; ++i) {
+            sin_error.add(std::sin(static_cast<long double>(angle[i])), out[i]);
+            cos_error.add(std::cos(static_cast<long double>(angle[i])), out2[i]);
+        }
+        report("sincos (sin)", t, ns, sin_error);
+        report("sincos (cos)", t, ns, cos_error);
+    }
+    for (size_t t = 0; t < 3; ++t) {
+        double ns = nanosecondsPer(count, [&] { batchAtan2(y.data(), x.data(), out.data(), count, kTiers[t]); });
+        Error error;
+        for (size_t i = 0; i < count; ++i) {
+            error.add(std::atan2(static_cast<long double>(y[i]), static_cast<long double>(x[i])), out[i]);
+        }
+        report("atan2", t, ns, error);
+    }
+    for (size_t t = 0; t < 3; ++t) {
+        double ns = nanosecondsPer(count, [&] {
+            batchEllipsePerimeter(a.data(), b.data(), out.data(), count, kTiers[t]);
+        });
+        Error error;
+        for (size_t i = 0; i < count; ++i) {
+            error.add(exactPerimeter(a[i], b[i]), out[i]);
+        }
+        report("ellipse perimeter", t, ns, error);
+    }
+    return 0;
+}
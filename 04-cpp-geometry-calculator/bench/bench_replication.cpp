@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "geometry_calculator.h"
+#include "replication.h"
+#include "shapes/circle.h"
+
+using namespace geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::unique_ptr<Shape> makeShape(size_t i) {
+    return std::make_unique<Circle>(1.0 + static_cast<double>(i % 7));
+}
+
+/**
+ * @brief Ingest shapes on a replicated calculator and report how long each took to reach the follower
+ * @param flush_every Adds between explicit flushes (frames also go out when full)
+ */
+void measure(size_t count, size_t flush_every, double baseline_ms) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        std::perror("socketpair");
+        std::exit(1);
+    }
+
+    // The follower records when each shape count became visible
+    std::vector<std::pair<size_t, Clock::time_point>> visible;
+    bool matches = false;
+    std::thread follower_thread([&] {
+        ReplicationFollower follower(fds[1]);
+        while (!follower.closed()) {
+            if (follower.poll(std::chrono::milliseconds(100)) > 0) {
+                visible.emplace_back(follower.calculator().shapeCount(), Clock::now());
+            }
+        }
+        matches = follower.calculator().shapeCount() == count;
+    });
+
+    std::vector<Clock::time_point> added(count);
+    GeometryCalculator calculator;
+    auto start = Clock::now();
+    {
+        ReplicationLeader leader(calculator, fds[0]);
+        for (size_t i = 0; i < count; ++i) {
+            calculator.addShape(makeShape(i), Point{static_cast<double>(i), 0.0});
+            added[i] = Clock::now();
+            if ((i + 1) % flush_every == 0) {
+                leader.flush();
+            }
+        }
+    }
+    double ingest_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    shutdown(fds[0], SHUT_WR);
+    follower_thread.join();
+    close(fds[0]);
+    close(fds[1]);
+
+    std::vector<double> lag(count);
+    size_t next = 0;
+    for (size_t i = 0; i < count; ++i) {
+        while (next + 1 < visible.size() && visible[next].first <= i) {
+            ++next;
+        }
+        lag[i] = std::chrono::duration<double, std::micro>(visible[next].second - added[i]).count();
+    }
+    std::sort(lag.begin(), lag.end());
+    auto percentile = [&](double p) {
+        return lag[std::min(count - 1, static_cast<size_t>(p * static_cast<double>(count)))];
+    };
+    std::printf("%-12zu %12.1f %10.2f %10.0f %10.0f %10.0f %8s\n", flush_every, ingest_ms, ingest_ms / baseline_ms,
+                percentile(0.5), percentile(0.99), lag.back(), matches ? "yes" : "NO");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    if (count == 0) {
+        std::fprintf(stderr, "usage: %s [shapes]\n", argv[0]);
+        return 1;
+    }
+
+    auto start = Clock::now();
+    {
+        GeometryCalculator calculator;
+        for (size_t i = 0; i < count; ++i) {
+            calculator.addShape(makeShape(i), Point{static_cast<double>(i), 0.0});
+        }
+    }
+    double baseline_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::printf("%zu adds, %.1f ms without replication\n\n", count, baseline_ms);
+    std::printf("%-12s %12s %10s %10s %10s %10s %8s\n", "flush every", "ingest ms", "slowdown", "p50 us",
+                "p99 us", "max us", "in sync");
+    for (size_t flush_every : {size_t{1}, size_t{64}, size_t{1024}, count}) {
+        measure(count, flush_every, baseline_ms);
+    }
+    return 0;
+}
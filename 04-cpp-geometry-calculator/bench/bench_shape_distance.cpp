@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "shape_distance.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+
+using namespace geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nanosecondsPer(Clock::time_point start, size_t count) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    return static_cast<double>(elapsed.count()) / static_cast<double>(count);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    size_t pair_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200000;
+    double threshold = argc > 3 ? std::atof(argv[3]) : 1.0;
+    if (count < 2 || pair_count == 0) {
+        std::fprintf(stderr, "usage: %s [shapes] [pairs] [threshold]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::uniform_real_distribution<double> size(0.5, 3.0);
+    std::vector<std::unique_ptr<Shape>> owned;
+    std::vector<PlacedShape> placed;
+    for (size_t i = 0; i < count; ++i) {
+        switch (i % 3) {
+            case 0: owned.push_back(std::make_unique<Circle>(size(rng))); break;
+            case 1: owned.push_back(std::make_unique<Rectangle>(size(rng), size(rng))); break;
+            default: owned.push_back(std::make_unique<Triangle>(3.0, 4.0, 5.0)); break;
+        }
+        placed.push_back({owned.back().get(), {coord(rng), coord(rng)}});
+    }
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    std::vector<ShapePair> pairs(pair_count);
+    for (ShapePair& pair : pairs) {
+        pair = {pick(rng), pick(rng)};
+    }
+
+    std::printf("%zu shapes, %zu pairs, threshold %g\n\n", count, pair_count, threshold);
+    std::printf("%-22s %12s\n", "kernel", "ns/pair");
+
+    size_t scalar_pairs = std::min<size_t>(pair_count, 20000);
+    auto start = Clock::now();
+    double checksum = 0.0;
+    for (size_t p = 0; p < scalar_pairs; ++p) {
+        checksum += minimumDistance(placed[pairs[p].first], placed[pairs[p].second]);
+    }
+    std::printf("%-22s %12.1f   (checksum %.6g)\n", "per pair", nanosecondsPer(start, scalar_pairs),
+                checksum);
+
+    DistanceShapes shapes(placed);
+    start = Clock::now();
+    std::vector<double> distances = shapes.distances(pairs);
+    double batch_ns = nanosecondsPer(start, pair_count);
+    checksum = 0.0;
+    for (double d : distances) {
+        checksum += d;
+    }
+    std::printf("%-22s %12.1f   (checksum %.6g)\n", "batch distances", batch_ns, checksum);
+
+    start = Clock::now();
+    std::vector<uint8_t> close = shapes.within(pairs, threshold);
+    double within_ns = nanosecondsPer(start, pair_count);
+    size_t hits = 0;
+    for (uint8_t flag : close) {
+        hits += flag;
+    }
+    std::printf("%-22s %12.1f   (%zu closer)\n", "batch within", within_ns, hits);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "alloc_counter.h"
+#include "geometry_calculator.h"
+#include "small_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+
+using namespace geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nanosecondsPer(Clock::time_point start, size_t count) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    return static_cast<double>(elapsed.count()) / static_cast<double>(count);
+}
+
+struct Result {
+    double bytes_per_instance;
+    double build_ns;
+    double aggregate_ns;
+    double checksum;
+};
+
+/**
+ * @brief Build many calculators with a few shapes each, then sum their totals
+ */
+template <typename Calculator, typename AddShapes>
+Result run(size_t instances, AddShapes add_shapes) {
+    AllocationScope heap;
+    auto start = Clock::now();
+    std::vector<Calculator> calculators(instances);
+    for (size_t i = 0; i < instances; ++i) {
+        add_shapes(calculators[i], i);
+    }
+    Result result{};
+    result.build_ns = nanosecondsPer(start, instances);
+    result.bytes_per_instance =
+        sizeof(Calculator) + static_cast<double>(heap.bytes()) / static_cast<double>(instances);
+
+    start = Clock::now();
+    for (const auto& calculator : calculators) {
+        result.checksum += calculator.totalArea() + calculator.totalPerimeter();
+    }
+    result.aggregate_ns = nanosecondsPer(start, instances);
+    return result;
+}
+
+void print(const char* name, const Result& result) {
+    std::printf("%-26s %12.0f %12.1f %14.1f   (checksum %.6g)\n", name, result.bytes_per_instance,
+                result.build_ns, result.aggregate_ns, result.checksum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t instances = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    size_t shapes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+    if (instances == 0) {
+        std::fprintf(stderr, "usage: %s [instances] [shapes per instance]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%zu instances, %zu shapes each\n\n", instances, shapes);
+    std::printf("%-26s %12s %12s %14s\n", "calculator", "bytes/inst", "build ns", "aggregate ns");
+
+    print("GeometryCalculator", run<GeometryCalculator>(instances, [&](auto& calc, size_t i) {
+        for (size_t s = 0; s < shapes; ++s) {
+            double size = 1.0 + static_cast<double>((i + s) % 7);
+            switch (s % 3) {
+                case 0: calc.addShape(std::make_unique<Circle>(size)); break;
+                case 1: calc.addShape(std::make_unique<Rectangle>(size, 2.0)); break;
+                default: calc.addShape(std::make_unique<Triangle>(size, size, size)); break;
+            }
+        }
+    }));
+
+    print("SmallGeometryCalculator<8>", run<SmallGeometryCalculator<8>>(instances, [&](auto& calc, size_t i) {
+        for (size_t s = 0; s < shapes; ++s) {
+            double size = 1.0 + static_cast<double>((i + s) % 7);
+            switch (s % 3) {
+                case 0: calc.addShape(ShapeValue::circle(size)); break;
+                case 1: calc.addShape(ShapeValue::rectangle(size, 2.0)); break;
+                default: calc.addShape(ShapeValue::triangle(size, size, size)); break;
+            }
+        }
+    }));
+    return 0;
+}
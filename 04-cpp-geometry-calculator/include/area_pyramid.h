@@ -0,0 +1,138 @@
+#pragma once
+
+#include "materialized_views.h"
+#include "placement.h"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Shape totals over a set of tiles
+ */
+struct RegionTotals {
+    double count = 0.0;
+    double area = 0.0;
+    std::array<double, kShapeKindCount> kind_count{};  ///< Indexed by ShapeKind
+    std::array<double, kShapeKindCount> kind_area{};   ///< Indexed by ShapeKind
+};
+
+/**
+ * @brief Bounds on the totals of a region
+ *
+ * Shapes are attributed to the tile holding their bounding box center.
+ * The totals of the shapes whose centers lie in the region are between
+ * inner and outer; the gap is the content of the tiles the region edge
+ * cuts through, so it shrinks with finer levels.
+ */
+struct RegionAggregate {
+    RegionTotals inner;  ///< Tiles entirely inside the region
+    RegionTotals outer;  ///< Tiles touching the region
+};
+
+/**
+ * @brief Multi-resolution summed-area tables over placed shapes
+ *
+ * Level l divides the bounds into 2^l x 2^l tiles and keeps a summed-area
+ * table of count, area and per-kind totals, so a region query reads four
+ * table cells per bound whatever the region size. Shapes outside the
+ * bounds are counted in the nearest edge tile, whose extent is treated as
+ * unbounded.
+ *
+ * Inserts update the per-tile totals of every level at once and are kept
+ * in a pending list that queries scan; the tables are rebuilt when the
+ * list reaches its limit or on flush().
+ */
+class AreaPyramid {
+private:
+    static constexpr size_t kChannels = 2 + 2 * kShapeKindCount;
+
+    struct Level {
+        size_t size = 0;             // Tiles per side
+        std::vector<double> tiles;   // size * size cells of kChannels totals
+        std::vector<double> table;   // (size + 1)^2 cells of kChannels prefix sums
+    };
+
+    struct Entry {
+        size_t tile_x = 0;  // Tile at the finest level
+        size_t tile_y = 0;
+        std::array<double, kChannels> values{};
+    };
+
+    BoundingBox bounds_;
+    std::vector<Level> levels_;
+    std::vector<Entry> pending_;
+    size_t max_pending_;
+
+    Entry entryFor(const PlacedShape& placed) const;
+    void add(const Entry& entry);
+    void rebuildTables();
+    void accumulate(const Level& level, size_t x0, size_t y0, size_t x1, size_t y1,
+                    RegionTotals& totals) const;
+
+public:
+    /**
+     * @brief Create an empty pyramid
+     * @param bounds Area covered by the tiles
+     * @param levels Number of levels (the finest has 2^(levels-1) tiles per side)
+     * @param max_pending Inserts kept out of the tables before they are rebuilt
+     * @throws std::invalid_argument If bounds are empty or not finite, or levels is 0 or above 16
+     */
+    explicit AreaPyramid(const BoundingBox& bounds, size_t levels = 8, size_t max_pending = 256);
+
+    /**
+     * @brief Replace the contents with a set of shapes, in parallel
+     * @param shapes Placed shapes
+     */
+    void build(const std::vector<PlacedShape>& shapes);
+
+    /**
+     * @brief Add a shape
+     * @param placed Placed shape
+     */
+    void insert(const PlacedShape& placed);
+
+    /**
+     * @brief Rebuild the tables so no inserts are pending
+     */
+    void flush();
+
+    /**
+     * @brief Get the number of levels
+     * @return Level count
+     */
+    size_t levelCount() const { return levels_.size(); }
+
+    /**
+     * @brief Get the number of tiles per side of a level
+     * @param level Level index
+     * @return 2^level
+     * @throws std::out_of_range If level is invalid
+     */
+    size_t tilesPerSide(size_t level) const { return levels_.at(level).size; }
+
+    /**
+     * @brief Get the number of inserts not yet in the tables
+     * @return Pending inserts
+     */
+    size_t pendingCount() const { return pending_.size(); }
+
+    /**
+     * @brief Aggregate a region at a level
+     * @param region Query region
+     * @param level Level index (finer levels give tighter bounds)
+     * @return Inner and outer totals
+     * @throws std::out_of_range If level is invalid
+     */
+    RegionAggregate query(const BoundingBox& region, size_t level) const;
+
+    /**
+     * @brief Aggregate a region at the finest level
+     * @param region Query region
+     * @return Inner and outer totals
+     */
+    RegionAggregate query(const BoundingBox& region) const { return query(region, levels_.size() - 1); }
+};
+
+} // namespace geometry
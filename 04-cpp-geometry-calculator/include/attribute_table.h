@@ -0,0 +1,247 @@
+#pragma once
+
+#include "segmented_vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Weight applied to one term of a weighted aggregate
+ *
+ * The weight of a shape is factor times its value in the numeric column,
+ * or factor alone when no column is named.
+ */
+struct AttributeWeight {
+    std::string column;   ///< Numeric column, or empty for a constant weight
+    double factor = 0.0;  ///< Scale of the column value, or the constant weight
+
+    static AttributeWeight constant(double value) { return {std::string(), value}; }
+    static AttributeWeight of(const std::string& column, double factor = 1.0) { return {column, factor}; }
+};
+
+/**
+ * @brief Weighted sum over shapes: area * area_weight + perimeter * perimeter_weight + offset
+ */
+struct WeightedAggregate {
+    AttributeWeight area;       ///< Weight of each shape's area
+    AttributeWeight perimeter;  ///< Weight of each shape's perimeter
+    AttributeWeight offset;     ///< Added once per shape
+    std::string group_by;       ///< Categorical column, or empty for one group
+};
+
+/**
+ * @brief Result of a weighted aggregate, one entry per category
+ */
+struct GroupedTotals {
+    std::vector<std::string> groups;  ///< Categories in dictionary order ("" when ungrouped)
+    std::vector<double> totals;       ///< Weighted sum of each group
+    std::vector<size_t> counts;       ///< Number of shapes in each group
+};
+
+/**
+ * @brief User-defined attribute columns aligned with a calculator's shapes
+ *
+ * Numeric columns hold doubles; categorical columns hold 16-bit codes into
+ * a per-column dictionary of up to 65536 categories. The table also keeps
+ * every shape's area and perimeter, so weighted aggregates are one fused
+ * pass over contiguous columns with no virtual calls. Columns are
+ * segmented, so appending a row never relocates existing values.
+ */
+class AttributeTable {
+private:
+    struct Column {
+        bool categorical = false;
+        SegmentedVector<double> numbers;
+        SegmentedVector<uint16_t> codes;
+        std::vector<std::string> dictionary;
+        std::unordered_map<std::string, uint16_t> lookup;
+        double default_number = 0.0;
+        uint16_t default_code = 0;
+
+        uint16_t intern(const std::string& category);
+    };
+
+    SegmentedVector<double> area_;
+    SegmentedVector<double> perimeter_;
+    std::unordered_map<std::string, Column> columns_;
+
+    Column& column(const std::string& name, bool categorical);
+    const Column& column(const std::string& name, bool categorical) const;
+    void checkRow(size_t row) const;
+
+public:
+    /**
+     * @brief Get the number of rows
+     * @return Row count
+     */
+    size_t rowCount() const { return area_.size(); }
+
+    /**
+     * @brief Add a numeric column, filled with its default
+     * @param name Unique column name
+     * @param default_value Value of existing and future rows
+     * @throws std::invalid_argument If the name is empty or taken
+     */
+    void addNumeric(const std::string& name, double default_value = 0.0);
+
+    /**
+     * @brief Add a categorical column, filled with its default
+     * @param name Unique column name
+     * @param default_category Category of existing and future rows
+     * @throws std::invalid_argument If the name is empty or taken
+     */
+    void addCategorical(const std::string& name, const std::string& default_category = "");
+
+    /**
+     * @brief Remove a column
+     * @param name Column name
+     * @return True if the column existed
+     */
+    bool drop(const std::string& name);
+
+    /**
+     * @brief Check whether a column exists
+     * @param name Column name
+     * @return True if it exists
+     */
+    bool has(const std::string& name) const { return columns_.count(name) != 0; }
+
+    /**
+     * @brief Check that a column exists with a type
+     * @param name Column name
+     * @param categorical Expected type
+     * @throws std::invalid_argument If the column is missing or of the other type
+     */
+    void requireColumn(const std::string& name, bool categorical) const { column(name, categorical); }
+
+    /**
+     * @brief Check that a categorical column can take new values without its dictionary overflowing
+     * @param name Categorical column
+     * @param categories Distinct categories about to be set
+     * @throws std::invalid_argument If the column is missing or numeric
+     * @throws std::length_error If interning them would overflow the dictionary
+     */
+    void requireCategories(const std::string& name, const std::unordered_set<std::string>& categories) const;
+
+    /**
+     * @brief Set a numeric value
+     * @param row Row index
+     * @param name Numeric column
+     * @param value New value
+     * @throws std::out_of_range If row is invalid
+     * @throws std::invalid_argument If the column is missing or categorical
+     */
+    void set(size_t row, const std::string& name, double value);
+
+    /**
+     * @brief Set a category
+     * @param row Row index
+     * @param name Categorical column
+     * @param category New category (added to the dictionary if new)
+     * @throws std::out_of_range If row is invalid
+     * @throws std::invalid_argument If the column is missing or numeric
+     * @throws std::length_error If the dictionary is full
+     */
+    void set(size_t row, const std::string& name, const std::string& category);
+
+    /**
+     * @brief Get a numeric value
+     * @param row Row index
+     * @param name Numeric column
+     * @return Value
+     * @throws std::out_of_range If row is invalid
+     * @throws std::invalid_argument If the column is missing or categorical
+     */
+    double number(size_t row, const std::string& name) const;
+
+    /**
+     * @brief Get a category
+     * @param row Row index
+     * @param name Categorical column
+     * @return Category
+     * @throws std::out_of_range If row is invalid
+     * @throws std::invalid_argument If the column is missing or numeric
+     */
+    const std::string& category(size_t row, const std::string& name) const;
+
+    /**
+     * @brief Append a row with default attributes
+     * @param area Area of the new shape
+     * @param perimeter Perimeter of the new shape
+     */
+    void appendRow(double area, double perimeter);
+
+    /**
+     * @brief Update the metrics of a row after its shape was replaced
+     * @param row Row index
+     * @param area New area
+     * @param perimeter New perimeter
+     */
+    void setMetrics(size_t row, double area, double perimeter);
+
+    /**
+     * @brief Remove a row, shifting later rows down
+     * @param row Row index
+     */
+    void eraseRow(size_t row);
+
+    /**
+     * @brief Remove several rows in one pass
+     * @param rows Distinct valid row indices in ascending order
+     */
+    void eraseRows(const std::vector<size_t>& rows);
+
+    /**
+     * @brief Check that another table's columns can be appended
+     * @param other Table to append
+     * @throws std::invalid_argument If a column has a different type in each table
+     * @throws std::length_error If re-coding its categories would overflow a dictionary
+     */
+    void checkAppend(const AttributeTable& other) const;
+
+    /**
+     * @brief Append another table's rows
+     *
+     * Columns missing on either side are added with their default value;
+     * categories are re-coded into this table's dictionaries.
+     *
+     * @param other Table to append
+     * @throws std::invalid_argument If a column has a different type in each table
+     * @throws std::length_error If a dictionary would overflow; nothing is appended
+     */
+    void append(const AttributeTable& other);
+
+    /**
+     * @brief Copy a subset of rows, with every column
+     * @param rows Row indices in output order
+     * @return New table
+     */
+    AttributeTable select(const std::vector<size_t>& rows) const;
+
+    /**
+     * @brief Remove every row, keeping the columns
+     */
+    void clearRows();
+
+    /**
+     * @brief Reserve memory for rows
+     * @param count Expected row count
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Compute a weighted sum grouped by category, in parallel
+     * @param aggregate Weights and grouping column
+     * @return Totals per group
+     * @throws std::invalid_argument If a weight column is not numeric or the
+     *         grouping column is not categorical
+     */
+    GroupedTotals aggregate(const WeightedAggregate& aggregate) const;
+};
+
+} // namespace geometry
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "deadline.h"
+#include "materialized_views.h"
+#include "placement.h"
+#include "query_cache.h"
+#include "shape_store.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Indexes a calculator can build in the background
+ */
+enum class IndexKind {
+    Area,    ///< Shapes sorted by area per kind, answers filtered aggregates
+    Spatial  ///< Placed bounding boxes sorted by x, answers box intersection
+};
+
+constexpr size_t kIndexKindCount = 2;
+
+/**
+ * @brief Areas and perimeters sorted by area, one run per shape kind
+ *
+ * Count, TotalArea and TotalPerimeter queries with area bounds are answered
+ * with two binary searches and prefix sums per accepted kind.
+ */
+class AreaIndex {
+private:
+    struct Entry {
+        double area;
+        double perimeter;
+    };
+
+    std::array<std::vector<Entry>, kShapeKindCount> entries_;
+    std::array<std::vector<double>, kShapeKindCount> area_prefix_;
+    std::array<std::vector<double>, kShapeKindCount> perimeter_prefix_;
+
+public:
+    /**
+     * @brief Peak memory needed to build the index
+     * @param count Number of shapes
+     * @return Bytes
+     */
+    static size_t buildBytes(size_t count) { return count * (sizeof(Entry) + 2 * sizeof(double)); }
+
+    /**
+     * @brief Record a shape (before finish())
+     * @param shape Shape
+     */
+    void add(size_t, const Shape& shape, const Point&);
+
+    /**
+     * @brief Sort the recorded shapes and compute prefix sums
+     */
+    void finish();
+
+    /**
+     * @brief Evaluate a query
+     * @param query Normalized query
+     * @return Aggregate value, or nothing for union perimeter queries
+     */
+    std::optional<double> evaluate(const ShapeQuery& query) const;
+
+    /**
+     * @brief Get the memory held by the index
+     * @return Bytes
+     */
+    size_t bytes() const;
+};
+
+/**
+ * @brief Bounding boxes of placed shapes sorted by their left edge
+ *
+ * A box query binary-searches the left edges that can reach the box, using
+ * the widest indexed box, and checks only those.
+ */
+class SpatialIndex {
+private:
+    struct Entry {
+        BoundingBox box;
+        size_t index;
+    };
+
+    std::vector<Entry> entries_;
+    double max_width_ = 0.0;
+
+public:
+    /**
+     * @brief Peak memory needed to build the index
+     * @param count Number of shapes
+     * @return Bytes
+     */
+    static size_t buildBytes(size_t count) { return count * sizeof(Entry); }
+
+    /**
+     * @brief Record a placed shape (before finish())
+     * @param index Shape index
+     * @param shape Shape
+     * @param position Placement position
+     */
+    void add(size_t index, const Shape& shape, const Point& position);
+
+    /**
+     * @brief Sort the recorded boxes
+     */
+    void finish();
+
+    /**
+     * @brief Find the shapes whose bounding boxes intersect a box
+     * @param box Query box
+     * @return Shape indices in ascending order
+     */
+    std::vector<size_t> intersecting(const BoundingBox& box) const;
+
+    /**
+     * @brief Get the memory held by the index
+     * @return Bytes
+     */
+    size_t bytes() const { return entries_.capacity() * sizeof(Entry); }
+};
+
+/**
+ * @brief Memory budget shared by concurrent index builds
+ *
+ * A build waits until its estimated memory fits in the budget. A build
+ * larger than the whole budget runs only when no other build holds memory,
+ * so it is delayed but never starved.
+ */
+class IndexBuildBudget {
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    size_t limit_;
+    size_t in_use_ = 0;
+
+public:
+    /**
+     * @brief Create a budget
+     * @param bytes Memory that concurrent builds may hold together
+     */
+    explicit IndexBuildBudget(size_t bytes) : limit_(bytes) {}
+
+    /**
+     * @brief Get the process-wide default budget (256 MiB)
+     * @return Shared budget
+     */
+    static std::shared_ptr<IndexBuildBudget> shared();
+
+    /**
+     * @brief Wait until memory is available and take it
+     * @param bytes Memory needed
+     * @param token Token that abandons the wait
+     * @return True if acquired, false if cancelled
+     */
+    bool acquire(size_t bytes, const CancellationToken& token);
+
+    /**
+     * @brief Return memory taken by acquire()
+     * @param bytes Memory to return
+     */
+    void release(size_t bytes);
+
+    /**
+     * @brief Wake waiting builds so they notice cancellation
+     */
+    void wake();
+
+    /**
+     * @brief Get the budget
+     * @return Bytes
+     */
+    size_t limit() const { return limit_; }
+
+    /**
+     * @brief Get the memory currently held by builds
+     * @return Bytes
+     */
+    size_t inUse() const;
+};
+
+/**
+ * @brief Progress of an index
+ */
+struct IndexStatus {
+    bool requested = false;  ///< The index was requested and not dropped
+    bool building = false;   ///< A build is running or waiting for budget
+    bool ready = false;      ///< Queries use the index
+    double progress = 0.0;   ///< Fraction of shapes read by the build (1 when ready)
+    size_t bytes = 0;        ///< Memory held by the ready index
+};
+
+/**
+ * @brief Indexes over a ShapeStore built on background threads
+ *
+ * A build reads the store, then sorts its private copy. invalidate() must
+ * be called before every change to the store: it cancels running builds,
+ * waits until they no longer read the store (at most a few hundred shapes)
+ * and discards ready indexes. Requested indexes are rebuilt on demand the
+ * next time they are looked up, so bulk loads do not restart builds on
+ * every shape.
+ */
+class BackgroundIndexes {
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+
+    void ensureBuilding(IndexKind kind, const ShapeStore& store) const;
+
+public:
+    BackgroundIndexes();
+    ~BackgroundIndexes();
+
+    /**
+     * @brief Take over another set's requests and ready indexes
+     *
+     * Builds of other are cancelled; they restart on demand.
+     */
+    BackgroundIndexes(BackgroundIndexes&& other);
+    BackgroundIndexes& operator=(BackgroundIndexes&& other);
+
+    /**
+     * @brief Request an index and start building it
+     * @param kind Index kind
+     * @param store Store to index
+     */
+    void request(IndexKind kind, const ShapeStore& store);
+
+    /**
+     * @brief Cancel and discard an index
+     * @param kind Index kind
+     */
+    void drop(IndexKind kind);
+
+    /**
+     * @brief Cancel builds and discard ready indexes before the store changes
+     */
+    void invalidate();
+
+    /**
+     * @brief Get the area index if ready, restarting its build if needed
+     * @param store Indexed store
+     * @return Index, or nullptr to fall back to a scan
+     */
+    std::shared_ptr<const AreaIndex> area(const ShapeStore& store) const;
+
+    /**
+     * @brief Get the spatial index if ready, restarting its build if needed
+     * @param store Indexed store
+     * @return Index, or nullptr to fall back to a scan
+     */
+    std::shared_ptr<const SpatialIndex> spatial(const ShapeStore& store) const;
+
+    /**
+     * @brief Get the progress of an index
+     * @param kind Index kind
+     * @return Status
+     */
+    IndexStatus status(IndexKind kind) const;
+
+    /**
+     * @brief Wait until a requested index is ready
+     * @param kind Index kind
+     * @param store Indexed store
+     * @param timeout Longest wait
+     * @return True if the index is ready
+     */
+    bool wait(IndexKind kind, const ShapeStore& store, std::chrono::nanoseconds timeout) const;
+
+    /**
+     * @brief Use another memory budget for future builds
+     * @param budget Budget (shared with other calculators)
+     * @throws std::invalid_argument If budget is null
+     */
+    void setBudget(std::shared_ptr<IndexBuildBudget> budget);
+};
+
+} // namespace geometry
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+
+namespace geometry {
+
+/**
+ * @brief Accuracy tier of the batch math functions
+ *
+ * The polynomial tiers run branch-free loops over blocks of arguments so
+ * the compiler can vectorize them, and hand the few arguments a kernel
+ * cannot handle (huge, tiny or non-finite) to the C library. Error bounds
+ * are measured against an extended-precision reference; bench_batch_math
+ * reports the measured error and throughput of each tier.
+ */
+enum class MathAccuracy {
+    Reference,  ///< The C library (sqrt correctly rounded, the rest libm's best)
+    Faithful,   ///< Within 1 ulp (ellipse perimeters within 1e-14 relative)
+    Fast        ///< Within 1e-7 relative (absolute for sin and cos)
+};
+
+/// Tier used by the library's own batch kernels
+constexpr MathAccuracy kKernelAccuracy = MathAccuracy::Faithful;
+
+/**
+ * @brief Square roots of a batch
+ *
+ * Every tier uses the correctly rounded hardware square root: a single-
+ * precision root plus the range checks it needs measured slower.
+ *
+ * @param x Inputs
+ * @param out Outputs (may be x)
+ * @param count Number of elements
+ * @param accuracy Accuracy tier
+ */
+void batchSqrt(const double* x, double* out, size_t count, MathAccuracy accuracy = kKernelAccuracy);
+
+/**
+ * @brief sqrt(x * x + y * y) without spurious overflow for a batch
+ * @param x First legs
+ * @param y Second legs
+ * @param out Outputs (may be x or y)
+ * @param count Number of elements
+ * @param accuracy Accuracy tier
+ */
+void batchHypot(const double* x, const double* y, double* out, size_t count,
+                MathAccuracy accuracy = kKernelAccuracy);
+
+/**
+ * @brief Sine and cosine of a batch of angles
+ *
+ * Arguments are reduced by a multiple n of pi/2 carried in two parts,
+ * which is accurate to about n * 2^-86. Angles beyond about 1.6e6 radians,
+ * and those within n * 2^-31 of a multiple of pi/2 (a fraction of at
+ * most 2^-11 at the top of the range), fall back to the C library.
+ *
+ * @param angle Angles in radians
+ * @param sin_out Sines (may be angle)
+ * @param cos_out Cosines
+ * @param count Number of elements
+ * @param accuracy Accuracy tier
+ */
+void batchSinCos(const double* angle, double* sin_out, double* cos_out, size_t count,
+                 MathAccuracy accuracy = kKernelAccuracy);
+
+/**
+ * @brief atan2(y, x) for a batch
+ * @param y Ordinates
+ * @param x Abscissas
+ * @param out Angles in [-pi, pi] (may be y or x)
+ * @param count Number of elements
+ * @param accuracy Accuracy tier
+ */
+void batchAtan2(const double* y, const double* x, double* out, size_t count,
+                MathAccuracy accuracy = kKernelAccuracy);
+
+/**
+ * @brief Perimeters of ellipses, 4 a E(e) with E the complete elliptic integral of the second kind
+ *
+ * Evaluated with the arithmetic-geometric mean and its modified form,
+ * which converge quadratically. The reference tier iterates until both
+ * converge; the others run a fixed number of steps, and ellipses too flat
+ * to converge in that many fall back to the next tier up.
+ *
+ * @param a First semi-axes
+ * @param b Second semi-axes
+ * @param out Perimeters (may be a or b)
+ * @param count Number of elements
+ * @param accuracy Accuracy tier
+ * @throws std::invalid_argument If a semi-axis is not positive and finite
+ */
+void batchEllipsePerimeter(const double* a, const double* b, double* out, size_t count,
+                           MathAccuracy accuracy = kKernelAccuracy);
+
+} // namespace geometry
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "placement.h"
+#include "shapes/shape.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+class GeometryCalculator;
+
+/**
+ * @brief Edits buffered against a calculator and applied together
+ *
+ * Obtained from GeometryCalculator::beginBatch(). Indices refer to the
+ * calculator as it was when the batch began, extended by the shapes the
+ * batch adds: existing shapes keep their indices and the k-th added shape
+ * has index shapeCount() + k. Removals take effect last, so every other
+ * edit can still address a shape the batch removes.
+ *
+ * Arguments are validated when an edit is buffered, so commit() applies
+ * either every edit or, if the calculator changed since the batch began,
+ * none of them. The calculator is invalidated and versioned once per
+ * commit, removals are one compaction pass, and replacements are applied
+ * in index order.
+ */
+class CalculatorBatch {
+public:
+    /// Returned by addShape() for ignored shapes
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+    friend class GeometryCalculator;
+
+    struct NumericEdit {
+        size_t index;
+        std::string column;
+        double value;
+    };
+
+    struct CategoryEdit {
+        size_t index;
+        std::string column;
+        std::string category;
+    };
+
+    GeometryCalculator* calculator_;
+    uint64_t version_;
+    size_t base_count_;
+    std::vector<std::unique_ptr<Shape>> added_;
+    std::vector<Point> added_positions_;
+    std::vector<std::pair<size_t, std::unique_ptr<Shape>>> replaced_;
+    std::vector<std::pair<size_t, Point>> moved_;
+    std::vector<size_t> removed_;
+    std::vector<NumericEdit> numbers_;
+    std::vector<CategoryEdit> categories_;
+
+    explicit CalculatorBatch(GeometryCalculator& calculator);
+
+    void checkIndex(size_t index) const;
+
+public:
+    CalculatorBatch(CalculatorBatch&&) = default;
+    CalculatorBatch& operator=(CalculatorBatch&&) = default;
+
+    /**
+     * @brief Buffer a shape addition (ignored if null or invalid)
+     * @param shape Shape to add
+     * @param position Placement position
+     * @return Index of the shape within the batch, or npos if ignored
+     */
+    size_t addShape(std::unique_ptr<Shape> shape, const Point& position = Point{});
+
+    /**
+     * @brief Buffer a shape replacement
+     * @param index Shape index within the batch
+     * @param shape New shape
+     * @throws std::out_of_range If index is invalid
+     * @throws std::invalid_argument If shape is null or invalid
+     */
+    void replaceShape(size_t index, std::unique_ptr<Shape> shape);
+
+    /**
+     * @brief Buffer a position change
+     * @param index Shape index within the batch
+     * @param position New position
+     * @throws std::out_of_range If index is invalid
+     */
+    void setPosition(size_t index, const Point& position);
+
+    /**
+     * @brief Buffer a removal
+     * @param index Shape index within the batch (removing twice is allowed)
+     * @throws std::out_of_range If index is invalid
+     */
+    void removeShape(size_t index);
+
+    /**
+     * @brief Buffer a numeric attribute change
+     * @param index Shape index within the batch
+     * @param name Numeric column
+     * @param value New value
+     * @throws std::out_of_range If index is invalid
+     * @throws std::invalid_argument If the column is missing or categorical
+     */
+    void setAttribute(size_t index, const std::string& name, double value);
+
+    /**
+     * @brief Buffer a categorical attribute change
+     * @param index Shape index within the batch
+     * @param name Categorical column
+     * @param category New category
+     * @throws std::out_of_range If index is invalid
+     * @throws std::invalid_argument If the column is missing or numeric
+     */
+    void setAttribute(size_t index, const std::string& name, const std::string& category);
+
+    /**
+     * @brief Get the number of buffered edits
+     * @return Edit count
+     */
+    size_t editCount() const;
+
+    /**
+     * @brief Apply every buffered edit and empty the batch
+     *
+     * The batch can be reused afterwards against the updated calculator.
+     *
+     * @throws std::logic_error If the calculator changed since the batch
+     *         began (nothing is applied)
+     * @throws std::invalid_argument If an edited column was dropped since
+     *         the edit was buffered (nothing is applied)
+     * @throws std::length_error If the new categories would overflow a
+     *         column's dictionary (nothing is applied)
+     */
+    void commit();
+
+    /**
+     * @brief Drop every buffered edit
+     */
+    void discard();
+};
+
+} // namespace geometry
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "placement.h"
+#include "shapes/shape.h"
+#include <cstddef>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Receives every change to a calculator's shapes, in order
+ *
+ * Callbacks run synchronously inside the mutating call, once the change
+ * has been applied, so replaying them in order against a calculator that
+ * started with the same shapes reproduces this one. Attributes are not
+ * reported. A callback must not mutate the calculator it observes, and
+ * must not throw: the change it reports has already been made, and an
+ * exception would leave the rest of the mutation undone. It may detach
+ * itself with setObserver(nullptr).
+ */
+class CalculatorObserver {
+public:
+    virtual ~CalculatorObserver() = default;
+
+    /**
+     * @brief A shape was appended
+     * @param shape New shape (owned by the calculator)
+     * @param position Its position
+     */
+    virtual void shapeAdded(const Shape& shape, const Point& position) = 0;
+
+    /**
+     * @brief The shape at an index was replaced; its position is unchanged
+     * @param index Shape index
+     * @param shape New shape (owned by the calculator)
+     */
+    virtual void shapeReplaced(size_t index, const Shape& shape) = 0;
+
+    /**
+     * @brief The shape at an index was moved
+     * @param index Shape index
+     * @param position New position
+     */
+    virtual void shapeMoved(size_t index, const Point& position) = 0;
+
+    /**
+     * @brief Shapes were removed in one pass; later shapes moved down
+     * @param indices Distinct indices before the removal, in ascending order
+     */
+    virtual void shapesRemoved(const std::vector<size_t>& indices) = 0;
+
+    /**
+     * @brief Every shape was removed
+     */
+    virtual void cleared() = 0;
+};
+
+} // namespace geometry
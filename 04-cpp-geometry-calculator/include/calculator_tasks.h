@@ -0,0 +1,77 @@
+#pragma once
+
+#include "geometry_calculator.h"
+#include "task_graph.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Chunk of shapes produced by an ingest loader
+ */
+struct ShapeBatch {
+    std::vector<std::unique_ptr<Shape>> shapes;
+    std::vector<Point> positions;  ///< Empty, or one position per shape
+};
+
+/**
+ * @brief Nodes of the ingest stage added by addIngestNodes()
+ */
+struct IngestNodes {
+    TaskGraph::NodeId load;      ///< Chunked: runs the loader
+    TaskGraph::NodeId validate;  ///< Chunked: drops null and invalid shapes
+    TaskGraph::NodeId commit;    ///< Ordered chunks: adds shapes to the calculator
+};
+
+/**
+ * @brief Add a streaming ingest stage feeding a calculator
+ *
+ * Loading and validation of different chunks run in parallel, and each
+ * chunk is committed as soon as it is validated; commits are ordered, so
+ * shapes reach the calculator in chunk order exactly as with sequential
+ * addShape() calls. Nodes reading the calculator should follow commit
+ * through TaskGraph::precede().
+ *
+ * @param graph Graph to extend
+ * @param calculator Calculator receiving the shapes (must outlive the graph)
+ * @param chunks Number of chunks (must be positive)
+ * @param loader Callable invoked as loader(size_t chunk), possibly concurrently
+ * @return Ingest nodes
+ */
+IngestNodes addIngestNodes(TaskGraph& graph, GeometryCalculator& calculator, size_t chunks,
+                           std::function<ShapeBatch(size_t)> loader);
+
+/**
+ * @brief Add a node computing GeometryCalculator::totalArea()
+ * @param graph Graph to extend
+ * @param calculator Calculator to read (must outlive the graph)
+ * @param result Receives the total area when the node runs
+ * @return Node id
+ */
+TaskGraph::NodeId addTotalAreaNode(TaskGraph& graph, const GeometryCalculator& calculator,
+                                   double& result);
+
+/**
+ * @brief Add a node computing GeometryCalculator::totalPerimeter()
+ * @param graph Graph to extend
+ * @param calculator Calculator to read (must outlive the graph)
+ * @param result Receives the total perimeter when the node runs
+ * @return Node id
+ */
+TaskGraph::NodeId addTotalPerimeterNode(TaskGraph& graph, const GeometryCalculator& calculator,
+                                        double& result);
+
+/**
+ * @brief Add a node computing GeometryCalculator::unionPerimeter()
+ * @param graph Graph to extend
+ * @param calculator Calculator to read (must outlive the graph)
+ * @param result Receives the union perimeter when the node runs
+ * @param tolerance Maximum deviation allowed for curved boundaries
+ * @return Node id
+ */
+TaskGraph::NodeId addUnionPerimeterNode(TaskGraph& graph, const GeometryCalculator& calculator,
+                                        double& result, double tolerance = 1e-6);
+
+} // namespace geometry
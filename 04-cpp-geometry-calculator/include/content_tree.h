@@ -0,0 +1,195 @@
+#pragma once
+
+#include "placement.h"
+#include "segmented_vector.h"
+#include "shapes/shape.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief 64-bit hash of a shape's exact content and position
+ *
+ * Covers the kind, the bit patterns of the dimensions as stored (every
+ * segment for paths) and the position, so two entries hash equally only
+ * if they would print and compute identically.
+ *
+ * @param shape Shape
+ * @param position Placement position
+ * @return Well-mixed hash value
+ */
+uint64_t shapeContentHash(const Shape& shape, const Point& position);
+
+/**
+ * @brief Entries that differ between an older and a newer shape sequence
+ */
+struct ContentDiff {
+    std::vector<size_t> removed;                      ///< Older indices with no newer counterpart
+    std::vector<size_t> added;                        ///< Newer indices with no older counterpart
+    std::vector<std::pair<size_t, size_t>> modified;  ///< (older, newer) indices whose content changed
+
+    bool empty() const { return removed.empty() && added.empty() && modified.empty(); }
+};
+
+/**
+ * @brief Merkle hash tree over a sequence of shape content hashes
+ *
+ * Leaves are grouped into blocks of kLeavesPerBlock, and a binary tree
+ * over the blocks combines them up to a root: each level pairs up the
+ * nodes of the one below, the last node of a level being passed up alone
+ * when it has no sibling. Nodes hold a polynomial
+ * hash modulo 2^61 - 1, which is associative: the root depends only on
+ * the leaf sequence, so two trees are equal exactly when their roots are
+ * (up to a 2^-61-scale collision chance), and the hash of any index range
+ * is available in O(log n).
+ *
+ * Leaves and every level are stored in segmented vectors, and a level
+ * gains one node when the one below outgrows it, with a new root level on
+ * top when the old root gets a sibling. Appending and updating a leaf
+ * therefore cost O(log n) every time, never a copy or rehash of what is
+ * already stored. Erasing shifts the later leaves and rehashes their
+ * blocks, like the column erase it accompanies.
+ */
+class ContentTree {
+public:
+    static constexpr size_t kLeavesPerBlock = 32;
+
+    /// Leaf storage; blocks never straddle a segment
+    using Leaves = SegmentedVector<uint64_t, 1024>;
+    static_assert(Leaves::kSegmentSize % kLeavesPerBlock == 0, "Leaf segments must hold whole blocks");
+
+    /**
+     * @brief Polynomial hash of a leaf sequence and the matching power of the base
+     */
+    struct Node {
+        uint64_t hash = 0;
+        uint64_t power = 1;
+
+        bool operator==(const Node& other) const { return hash == other.hash && power == other.power; }
+        bool operator!=(const Node& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Append a leaf
+     * @param content Content hash of the new entry
+     */
+    void push(uint64_t content);
+
+    /**
+     * @brief Replace a leaf
+     * @param index Leaf index (must be valid)
+     * @param content New content hash
+     */
+    void set(size_t index, uint64_t content);
+
+    /**
+     * @brief Remove a leaf; later leaves move down by one
+     * @param index Leaf index (must be valid)
+     */
+    void erase(size_t index);
+
+    /**
+     * @brief Remove several leaves in one pass
+     * @param indices Distinct valid indices in ascending order
+     */
+    void eraseSorted(const std::vector<size_t>& indices);
+
+    /**
+     * @brief Append every leaf of another tree
+     * @param other Tree to copy the leaves from
+     */
+    void append(const ContentTree& other);
+
+    /**
+     * @brief Build a tree over a subset of the leaves
+     * @param rows Leaf indices in the order they should appear
+     * @return New tree
+     */
+    ContentTree select(const std::vector<size_t>& rows) const;
+
+    /**
+     * @brief Remove all leaves
+     */
+    void clear();
+
+    /**
+     * @brief Reserve leaf storage
+     * @param count Expected number of leaves
+     */
+    void reserve(size_t count) { leaves_.reserve(count); }
+
+    /**
+     * @brief Get the number of leaves
+     * @return Leaf count
+     */
+    size_t size() const { return leaves_.size(); }
+
+    /**
+     * @brief Get a leaf value
+     * @param index Leaf index (must be valid)
+     * @return Leaf hash (the content hash reduced modulo 2^61 - 1)
+     */
+    uint64_t leaf(size_t index) const { return leaves_[index]; }
+
+    /**
+     * @brief Get the root hash
+     * @return Hash of the whole sequence (0 when empty)
+     */
+    uint64_t rootHash() const { return root().hash; }
+
+    /**
+     * @brief Hash an index range
+     * @param begin First leaf index
+     * @param end One past the last leaf index (begin <= end <= size())
+     * @return Hash equal to the root hash of a tree holding just that range
+     */
+    uint64_t rangeHash(size_t begin, size_t end) const { return range(begin, end).hash; }
+
+    bool operator==(const ContentTree& other) const {
+        return size() == other.size() && root() == other.root();
+    }
+    bool operator!=(const ContentTree& other) const { return !(*this == other); }
+
+private:
+    using Level = SegmentedVector<Node, 256>;
+
+    Leaves leaves_;
+    std::vector<Level> levels_;  ///< levels_[0] has a node per block, nodes 2i and 2i + 1 of a level
+                                 ///< combine into node i of the next; the last level is the root
+
+    Node root() const { return levels_.empty() ? Node{} : levels_.back()[0]; }
+    Node range(size_t begin, size_t end) const;
+    Node blockNode(size_t block) const;
+    Node parentNode(size_t level, size_t index) const;
+    void updateBlock(size_t block, Node node);
+    void rebuild(size_t first_block = 0);
+
+    friend ContentDiff diffContent(const ContentTree& before, const ContentTree& after);
+};
+
+/**
+ * @brief Find the entries that changed from one sequence to another
+ *
+ * Equal trees are recognized from their roots in O(1). Otherwise the
+ * common prefix and suffix are found by binary search over range hashes
+ * and the span between is aligned with a shortest edit script, whose
+ * equal runs are skipped by comparing range hashes: D inserted or removed
+ * entries cost about O(D^2 log^2 n) however far apart they are, and an
+ * entry removed in one place and added in another is reported as just
+ * that. Removals and additions at the same spot are reported as
+ * modifications, so a replaced or moved shape counts as two edits.
+ *
+ * Past 512 edits the spans are compared by position instead. Trees of
+ * equal size then descend only into subtrees whose hashes differ, in
+ * O(k log n) for k differing positions.
+ *
+ * @param before Older sequence
+ * @param after Newer sequence
+ * @return Changes that turn before into after
+ */
+ContentDiff diffContent(const ContentTree& before, const ContentTree& after);
+
+} // namespace geometry
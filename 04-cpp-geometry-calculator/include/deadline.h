@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+
+namespace geometry {
+
+/**
+ * @brief Shared flag used to cancel running queries from another thread
+ *
+ * Copies share the same flag, so a token handed to a query can be
+ * cancelled through any copy kept by the caller.
+ */
+class CancellationToken {
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+
+public:
+    CancellationToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    /**
+     * @brief Request cancellation
+     */
+    void cancel() { flag_->store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether cancellation was requested
+     * @return True once cancel() has been called on any copy
+     */
+    bool cancelled() const { return flag_->load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Point in time after which a query should stop, plus a cancellation token
+ */
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::time_point at_;
+    CancellationToken token_;
+
+public:
+    /**
+     * @brief Deadline that never expires on its own
+     * @param token Token that can still cancel the query
+     */
+    explicit Deadline(CancellationToken token = {})
+        : at_(Clock::time_point::max()), token_(std::move(token)) {}
+
+    /**
+     * @brief Deadline at a fixed point in time
+     * @param at Expiry time
+     * @param token Token that can cancel the query earlier
+     */
+    Deadline(Clock::time_point at, CancellationToken token = {})
+        : at_(at), token_(std::move(token)) {}
+
+    /**
+     * @brief Deadline a given budget from now
+     * @param budget Time allowed
+     * @param token Token that can cancel the query earlier
+     * @return Deadline
+     */
+    static Deadline after(std::chrono::nanoseconds budget, CancellationToken token = {}) {
+        return Deadline(Clock::now() + budget, std::move(token));
+    }
+
+    /**
+     * @brief Check whether the query should stop
+     * @return True if the deadline passed or the token was cancelled
+     */
+    bool expired() const {
+        return token_.cancelled() || (at_ != Clock::time_point::max() && Clock::now() >= at_);
+    }
+};
+
+/**
+ * @brief Result of an aggregation that may have been cut short by a deadline
+ *
+ * Shapes are visited in a strided order that spreads over the whole
+ * collection, so the processed shapes form an evenly spread sample and
+ * the estimate extrapolates their sum to all shapes. Passing a partial
+ * result back to the same query resumes where it stopped.
+ */
+struct PartialResult {
+    double value = 0.0;     ///< Exact sum over the processed shapes
+    double estimate = 0.0;  ///< Extrapolated total (equal to value when exact)
+    size_t processed = 0;   ///< Shapes accounted for
+    size_t total = 0;       ///< Shapes in the collection
+    uint64_t version = 0;   ///< Version of the collection the sum was taken over
+    uint32_t aggregate = 0; ///< What was summed, as tagged by the producer
+
+    /**
+     * @brief Check whether every shape was processed
+     * @return True if value is the exact answer
+     */
+    bool exact() const { return processed == total; }
+
+    /**
+     * @brief Fraction of shapes processed
+     * @return Coverage between 0 and 1 (1 for an empty collection)
+     */
+    double coverage() const {
+        return total == 0 ? 1.0 : static_cast<double>(processed) / static_cast<double>(total);
+    }
+};
+
+/**
+ * @brief Stride for visiting [0, count) in a spread-out order
+ *
+ * The stride is coprime with count and close to count / phi, so the visit
+ * k -> (k * stride) mod count reaches every index exactly once and any
+ * prefix of the visits is spread evenly over the range.
+ *
+ * @param count Number of items
+ * @return Stride (1 when count < 3)
+ */
+inline size_t spreadStride(size_t count) {
+    if (count < 3) {
+        return 1;
+    }
+    size_t stride = std::max<size_t>(static_cast<size_t>(count * 0.6180339887498949), 1);
+    while (std::gcd(stride, count) != 1) {
+        ++stride;
+    }
+    return stride;
+}
+
+/**
+ * @brief Index of the k-th visit of a spread-out order
+ * @param k Visit number
+ * @param stride Stride returned by spreadStride(count)
+ * @param count Number of items (must be positive)
+ * @return (k * stride) mod count, computed without overflow
+ */
+inline size_t spreadIndex(size_t k, size_t stride, size_t count) {
+    auto add = [count](size_t a, size_t b) { return a >= count - b ? a - (count - b) : a + b; };
+    size_t result = 0;
+    k %= count;
+    for (; stride != 0; stride >>= 1) {
+        if (stride & 1) {
+            result = add(result, k);
+        }
+        k = add(k, k);
+    }
+    return result;
+}
+
+} // namespace geometry
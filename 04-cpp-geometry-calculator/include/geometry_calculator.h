@@ -1,26 +1,165 @@
 #pragma once
 
+#include "attribute_table.h"
+#include "background_index.h"
+#include "calculator_batch.h"
+#include "calculator_observer.h"
+#include "content_tree.h"
+#include "deadline.h"
+#include "materialized_views.h"
+#include "placement.h"
+#include "query_cache.h"
+#include "shape_sketches.h"
+#include "shape_store.h"
 #include "shapes/shape.h"
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <string>
 
 namespace geometry {
 
+/**
+ * @brief One page of formatted shape details
+ */
+struct ReportPage {
+    std::string text;       ///< Shape entries, formatted as in getShapesInfo()
+    size_t count = 0;       ///< Number of shapes on the page
+    size_t next = 0;        ///< Cursor to pass for the following page
+    bool has_more = false;  ///< True if shapes remain past the cursor
+};
+
 /**
  * @brief Calculator for geometric operations
+ *
+ * Aggregate queries are cached per normalized query. Every mutation bumps
+ * the calculator's version, which invalidates all cached results at once.
+ *
+ * Indexes requested with buildIndex() are built on background threads;
+ * queries scan until an index is ready and use it from then on. Every
+ * mutation discards the indexes, which are rebuilt on the next query.
  */
 class GeometryCalculator {
 private:
-    std::vector<std::unique_ptr<Shape>> shapes_;
+    ShapeStore shapes_;
+    ShapeStatistics statistics_;
+    uint64_t version_ = 0;
+    mutable QueryCache cache_;
+    ViewSet views_;
+    AttributeTable attributes_;
+    ContentTree content_;
+    CalculatorObserver* observer_ = nullptr;  ///< Stays with this object when moved into
+    BackgroundIndexes indexes_;  ///< Declared last: destroyed first, stopping builds that read shapes_
+
+    double evaluate(const ShapeQuery& query) const;
+    void applyBatch(CalculatorBatch& batch);
+
+    friend class CalculatorBatch;
 
 public:
+    GeometryCalculator() = default;
+    
+    /**
+     * @brief Move a calculator, cancelling index builds of both
+     *
+     * Requested and ready indexes move along; cancelled builds restart on
+     * demand.
+     */
+    GeometryCalculator(GeometryCalculator&& other);
+    GeometryCalculator& operator=(GeometryCalculator&& other);
+    
     /**
      * @brief Add a shape to the calculator
      * @param shape Unique pointer to shape (will be moved)
      */
     void addShape(std::unique_ptr<Shape> shape);
     
+    /**
+     * @brief Add a shape placed at a position in the plane
+     * @param shape Unique pointer to shape (will be moved)
+     * @param position Placement position (see PlacedShape conventions)
+     */
+    void addShape(std::unique_ptr<Shape> shape, const Point& position);
+    
+    /**
+     * @brief Replace the shape at an index, keeping its position
+     * @param index Shape index
+     * @param shape Valid replacement shape (will be moved)
+     * @throws std::out_of_range If index is invalid
+     * @throws std::invalid_argument If shape is null or invalid
+     */
+    void replaceShape(size_t index, std::unique_ptr<Shape> shape);
+    
+    /**
+     * @brief Remove the shape at an index; later shapes move down by one
+     * @param index Shape index
+     * @throws std::out_of_range If index is invalid
+     */
+    void removeShape(size_t index);
+    
+    /**
+     * @brief Move the shape at an index
+     * @param index Shape index
+     * @param position New placement position
+     * @throws std::out_of_range If index is invalid
+     */
+    void setPosition(size_t index, const Point& position);
+    
+    /**
+     * @brief Start buffering edits to apply together
+     *
+     * Thousands of edits committed as one batch invalidate indexes and the
+     * query cache once and remove shapes in a single pass, instead of once
+     * per edit. See CalculatorBatch for index and validation rules.
+     *
+     * @return Empty batch bound to this calculator (must not outlive it)
+     */
+    CalculatorBatch beginBatch() { return CalculatorBatch(*this); }
+    
+    /**
+     * @brief Move all shapes of another calculator to the end of this one
+     *
+     * Shape storage is spliced in O(chunks), statistics are merged, and each
+     * materialized view is merged in O(1) when other maintains a view with
+     * the same name and definition (otherwise it is updated from other's
+     * shapes). Cached query results of both calculators are invalidated.
+     *
+     * @param other Calculator to take the shapes from (left empty)
+     * @throws std::invalid_argument If an attribute column has a different
+     *         type in each calculator; neither calculator changes
+     * @throws std::length_error If merging categories would overflow a
+     *         dictionary; neither calculator changes
+     */
+    void merge(GeometryCalculator& other);
+    
+    /**
+     * @brief Move every shape into one of several new calculators
+     *
+     * The selector runs over the storage chunks in parallel, and shapes keep
+     * their positions and relative order. The outputs have statistics but no
+     * materialized views; this calculator is left empty.
+     *
+     * @param parts Number of output calculators
+     * @param selector Returns the output index of a shape; called
+     *        concurrently, so it must be thread-safe
+     * @return Output calculators
+     * @throws std::out_of_range If the selector returns an index >= parts
+     *         (this calculator is then left unchanged)
+     */
+    std::vector<GeometryCalculator> partition(size_t parts,
+                                              const std::function<size_t(const Shape&)>& selector);
+    
+    /**
+     * @brief Reserve storage for a number of shapes
+     *
+     * Discards background indexes like a mutation, since reserving may
+     * reallocate the storage their builds read.
+     *
+     * @param count Expected total number of shapes
+     */
+    void reserve(size_t count);
+    
     /**
      * @brief Get the number of shapes
      * @return Number of shapes
@@ -39,12 +178,316 @@ public:
      */
     double totalPerimeter() const;
     
+    /**
+     * @brief Calculate total area, stopping when the deadline expires
+     *
+     * Shapes are visited in a spread-out order and the deadline is checked
+     * every few hundred shapes, so a partial result is an evenly spread
+     * sample with an extrapolated estimate.
+     *
+     * @param deadline Deadline or cancellation token
+     * @param resume Partial result of an earlier call of the same method to
+     *        continue from (ignored if the calculator changed since)
+     * @return Exact total, or partial total with coverage and estimate
+     */
+    PartialResult totalArea(const Deadline& deadline, const PartialResult* resume = nullptr) const;
+    
+    /**
+     * @brief Calculate total perimeter, stopping when the deadline expires
+     * @param deadline Deadline or cancellation token
+     * @param resume Partial result of an earlier call of the same method to
+     *        continue from (ignored if the calculator changed since)
+     * @return Exact total, or partial total with coverage and estimate
+     */
+    PartialResult totalPerimeter(const Deadline& deadline,
+                                 const PartialResult* resume = nullptr) const;
+    
+    /**
+     * @brief Calculate the perimeter of the union of all placed shapes
+     *
+     * Unlike totalPerimeter(), boundary shared between overlapping or
+     * touching shapes and boundary hidden inside other shapes is not
+     * counted. Exact for rectangles; curved boundaries are approximated
+     * within tolerance.
+     *
+     * @param tolerance Maximum deviation allowed for curved boundaries
+     * @return Length of the union contour
+     */
+    double unionPerimeter(double tolerance = 1e-6) const;
+    
+    /**
+     * @brief Calculate the union perimeter, stopping when the deadline expires
+     * @param deadline Deadline or cancellation token
+     * @param tolerance Maximum deviation allowed for curved boundaries
+     * @return Exact perimeter, or partial perimeter with coverage and estimate
+     */
+    PartialResult unionPerimeter(const Deadline& deadline, double tolerance = 1e-6) const;
+    
+    /**
+     * @brief Evaluate an aggregate over the shapes matching a filter
+     *
+     * Results are cached by normalized query and calculator version, so a
+     * repeated query costs a hash lookup until the next mutation.
+     * totalArea(), totalPerimeter() and unionPerimeter() use the same cache.
+     *
+     * @param query Aggregate and filter
+     * @return Aggregate value (shape count for QueryAggregate::Count)
+     */
+    double query(const ShapeQuery& query) const;
+    
+    /**
+     * @brief Find the placed shapes whose bounding boxes intersect a box
+     *
+     * Uses the spatial index when it is ready, otherwise scans.
+     *
+     * @param box Query box
+     * @return Shape indices in ascending order
+     */
+    std::vector<size_t> shapesIntersecting(const BoundingBox& box) const;
+    
+    /**
+     * @brief Request an index and start building it in the background
+     *
+     * Returns immediately. Until the index is ready, queries it would
+     * answer fall back to a scan. The area index answers Count, TotalArea
+     * and TotalPerimeter queries with a kind or area filter; the spatial
+     * index answers shapesIntersecting().
+     *
+     * @param kind Index kind
+     */
+    void buildIndex(IndexKind kind);
+    
+    /**
+     * @brief Stop maintaining an index
+     * @param kind Index kind
+     */
+    void dropIndex(IndexKind kind);
+    
+    /**
+     * @brief Get the build progress of an index
+     * @param kind Index kind
+     * @return Status
+     */
+    IndexStatus indexStatus(IndexKind kind) const;
+    
+    /**
+     * @brief Wait until a requested index is ready
+     * @param kind Index kind
+     * @param timeout Longest wait
+     * @return True if the index is ready
+     */
+    bool waitForIndex(IndexKind kind, std::chrono::nanoseconds timeout) const;
+    
+    /**
+     * @brief Share a memory budget for index builds with other calculators
+     *
+     * Builds wait until their memory fits in the budget, which caps how
+     * many run at once. The default is IndexBuildBudget::shared().
+     *
+     * @param budget Budget used by future builds
+     * @throws std::invalid_argument If budget is null
+     */
+    void setIndexBuildBudget(std::shared_ptr<IndexBuildBudget> budget);
+    
+    /**
+     * @brief Register a materialized view over the shapes
+     *
+     * The view is populated from the current shapes, then maintained on
+     * every add, replace, remove and clear, so reading it is O(1).
+     *
+     * @param name Unique view name
+     * @param definition Aggregate and filter
+     * @return View id
+     */
+    size_t createView(const std::string& name, const ViewDefinition& definition);
+    
+    /**
+     * @brief Unregister a materialized view
+     * @param name View name
+     * @return True if the view existed
+     */
+    bool dropView(const std::string& name);
+    
+    /**
+     * @brief Get the materialized views
+     * @return View set (read values with ViewSet::value())
+     */
+    const ViewSet& views() const { return views_; }
+    
+    /**
+     * @brief Add a numeric attribute column
+     * @param name Unique column name
+     * @param default_value Value of existing and future shapes
+     * @throws std::invalid_argument If the name is empty or taken
+     */
+    void addNumericAttribute(const std::string& name, double default_value = 0.0);
+    
+    /**
+     * @brief Add a categorical attribute column
+     * @param name Unique column name
+     * @param default_category Category of existing and future shapes
+     * @throws std::invalid_argument If the name is empty or taken
+     */
+    void addCategoricalAttribute(const std::string& name, const std::string& default_category = "");
+    
+    /**
+     * @brief Remove an attribute column
+     * @param name Column name
+     * @return True if the column existed
+     */
+    bool dropAttribute(const std::string& name);
+    
+    /**
+     * @brief Set a shape's numeric attribute
+     * @param index Shape index
+     * @param name Numeric column
+     * @param value New value
+     * @throws std::out_of_range If index is invalid
+     * @throws std::invalid_argument If the column is missing or categorical
+     */
+    void setAttribute(size_t index, const std::string& name, double value);
+    
+    /**
+     * @brief Set a shape's categorical attribute
+     * @param index Shape index
+     * @param name Categorical column
+     * @param category New category
+     * @throws std::out_of_range If index is invalid
+     * @throws std::invalid_argument If the column is missing or numeric
+     */
+    void setAttribute(size_t index, const std::string& name, const std::string& category);
+    
+    /**
+     * @brief Get the attribute columns
+     *
+     * Rows follow shape indices through removal, merge and partition.
+     *
+     * @return Attribute table (read values with number() and category())
+     */
+    const AttributeTable& attributes() const { return attributes_; }
+    
+    /**
+     * @brief Get the hash tree over the shapes and their positions
+     *
+     * Maintained on every mutation; attributes are not part of it. Copy it
+     * to keep a snapshot, and pass the snapshot and a later tree to
+     * diffContent() to find what changed in between.
+     *
+     * @return Content tree with one leaf per shape
+     */
+    const ContentTree& content() const { return content_; }
+    
+    /**
+     * @brief Check whether another calculator holds the same shapes at the same positions, in order
+     *
+     * Compares the root hashes in O(1) rather than the shapes.
+     *
+     * @param other Calculator to compare with
+     * @return True if the contents match
+     */
+    bool sameContent(const GeometryCalculator& other) const { return content_ == other.content_; }
+    
+    /**
+     * @brief Find the shapes that differ in another calculator, e.g. a replica
+     * @param newer Calculator to compare with
+     * @return Changes that turn this calculator's shapes into newer's (see diffContent())
+     */
+    ContentDiff diff(const GeometryCalculator& newer) const { return diffContent(content_, newer.content_); }
+    
+    /**
+     * @brief Report every later change to the shapes to an observer
+     *
+     * Merges report other's shapes as additions, partitions report a clear,
+     * and moving a calculator into this one reports a clear followed by
+     * the incoming shapes.
+     *
+     * @param observer Observer, or nullptr to detach (must stay alive while attached)
+     */
+    void setObserver(CalculatorObserver* observer) { observer_ = observer; }
+    
+    /**
+     * @brief Compute a weighted sum of areas and perimeters grouped by category
+     *
+     * For example, cost per material is
+     * {AttributeWeight::of("price"), AttributeWeight::constant(rate), {}, "material"}.
+     *
+     * @param aggregate Weights and grouping column
+     * @return Totals per category
+     * @throws std::invalid_argument If a named column is missing or of the wrong type
+     */
+    GroupedTotals weightedAggregate(const WeightedAggregate& aggregate) const;
+    
+    /**
+     * @brief Get the mutation version
+     *
+     * Drawn from a process-wide counter on every change to the shapes or
+     * positions (including being moved into), so it only ever grows and
+     * no two calculators share a version once either has changed.
+     *
+     * @return Current version
+     */
+    uint64_t version() const { return version_; }
+    
+    /**
+     * @brief Get the query result cache
+     * @return Cache (capacity can be changed through setCapacity())
+     */
+    QueryCache& queryCache() const { return cache_; }
+    
+    /**
+     * @brief Get heavy-hitter and distinct-count statistics
+     *
+     * Maintained in fixed memory on every addShape(); merge the statistics
+     * of several calculators with ShapeStatistics::merge().
+     *
+     * @return Statistics over all shapes added since the last clear()
+     */
+    const ShapeStatistics& statistics() const { return statistics_; }
+    
     /**
      * @brief Get shape information as string
      * @return Formatted string with all shapes info
      */
     std::string getShapesInfo() const;
     
+    /**
+     * @brief Format a page of shape details
+     *
+     * Costs O(page_size) however many shapes the calculator holds. The
+     * cursor is a shape index, so it stays meaningful across appends but
+     * shifts when earlier shapes are removed.
+     *
+     * @param cursor Index of the first shape (0, or next of the previous page)
+     * @param page_size Maximum number of shapes on the page
+     * @return Page with its continuation cursor
+     */
+    ReportPage reportPage(size_t cursor, size_t page_size) const;
+    
+    /**
+     * @brief Format a page of the shapes matching a filter
+     *
+     * Shapes are scanned from the cursor until the page is full, so the
+     * cost depends on page size and filter selectivity, not on the total
+     * number of shapes. A page can be short or empty while has_more is
+     * still true.
+     *
+     * @param cursor Index of the first shape to scan
+     * @param page_size Maximum number of shapes on the page
+     * @param filter Kind and area filter (the aggregate is ignored)
+     * @return Page with its continuation cursor
+     */
+    ReportPage reportPage(size_t cursor, size_t page_size, const ShapeQuery& filter) const;
+    
+    /**
+     * @brief Format the totals footer of the report
+     *
+     * The totals come from the query cache, so repeated footers between
+     * mutations cost two cache lookups.
+     *
+     * @return Footer as in getShapesInfo()
+     */
+    std::string reportFooter() const;
+    
     /**
      * @brief Clear all shapes
      */
@@ -56,6 +499,13 @@ public:
      * @return Pointer to shape (nullptr if invalid index)
      */
     const Shape* getShape(size_t index) const;
+    
+    /**
+     * @brief Get shape by index together with its position
+     * @param index Shape index
+     * @return Placed shape (null shape if invalid index)
+     */
+    PlacedShape getPlacedShape(size_t index) const;
 };
 
 } // namespace geometry
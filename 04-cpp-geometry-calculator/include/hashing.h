@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace geometry {
+
+/**
+ * @brief Mix a 64-bit value into a well-distributed hash (splitmix64 finalizer)
+ * @param x Value to mix
+ * @return Mixed value
+ */
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Get the bit pattern of a double
+ * @param value Value to reinterpret
+ * @return IEEE 754 bits
+ */
+inline uint64_t doubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // namespace geometry
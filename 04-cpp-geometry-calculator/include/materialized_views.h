@@ -0,0 +1,187 @@
+#pragma once
+
+#include "query_cache.h"
+#include "shapes/shape.h"
+#include <array>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Per-shape quantity a view can filter on
+ *
+ * Dimensions are the circle radius, the rectangle sides, the shortest and
+ * longest triangle sides, and the bounding box sides of a path.
+ */
+enum class ShapeFeature {
+    Area,
+    Perimeter,
+    MinDimension,
+    MaxDimension
+};
+
+/// Number of ShapeFeature values
+constexpr size_t kShapeFeatureCount = 4;
+
+/// Number of ShapeKind values
+constexpr size_t kShapeKindCount = 4;
+
+/**
+ * @brief Kind and feature values of one shape, as seen by views
+ */
+struct ShapeFeatures {
+    ShapeKind kind = ShapeKind::Circle;
+    std::array<double, kShapeFeatureCount> values{};
+};
+
+/**
+ * @brief Compute the features of a shape
+ * @param shape Shape to describe
+ * @return Kind and feature values
+ */
+ShapeFeatures shapeFeatures(const Shape& shape);
+
+/**
+ * @brief Definition of a materialized view: an aggregate over a filter
+ *
+ * Feature ranges are inclusive; use std::nextafter for strict bounds.
+ */
+struct ViewDefinition {
+    QueryAggregate aggregate = QueryAggregate::Count;  ///< Count, TotalArea or TotalPerimeter
+    uint32_t kinds = kAllShapeKinds;                   ///< Accepted kinds (kindMask bits)
+    std::array<double, kShapeFeatureCount> min{
+        -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+    std::array<double, kShapeFeatureCount> max{
+        std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+
+    /**
+     * @brief Restrict a feature to a range
+     * @param feature Feature to restrict
+     * @param lo Smallest accepted value
+     * @param hi Largest accepted value
+     * @return This definition, for chaining
+     */
+    ViewDefinition& where(ShapeFeature feature, double lo, double hi) {
+        min[static_cast<size_t>(feature)] = lo;
+        max[static_cast<size_t>(feature)] = hi;
+        return *this;
+    }
+};
+
+/**
+ * @brief Set of incrementally maintained aggregate views
+ *
+ * View definitions are stored as structure-of-arrays columns, so applying
+ * one shape to every view is a single branch-free loop over the views that
+ * the compiler vectorizes: registering many views adds a few vector
+ * operations per mutation instead of one filter evaluation per view.
+ * Sums are Kahan-compensated so long insert/remove sequences do not drift.
+ */
+class ViewSet {
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, size_t> ids_;
+    std::array<std::vector<double>, kShapeKindCount> accepts_;  ///< 1.0 if the view accepts the kind
+    std::array<std::vector<double>, kShapeFeatureCount> min_;
+    std::array<std::vector<double>, kShapeFeatureCount> max_;
+    std::vector<double> count_weight_;
+    std::vector<double> area_weight_;
+    std::vector<double> perimeter_weight_;
+    std::vector<double> sums_;
+    std::vector<double> compensation_;
+    size_t active_ = 0;
+
+public:
+    /**
+     * @brief Register a view with a zero value
+     * @param name Unique view name
+     * @param definition Aggregate and filter
+     * @return View id, stable until the view set is destroyed
+     * @throws std::invalid_argument If the name is taken, a bound is NaN or
+     *         the aggregate is not Count, TotalArea or TotalPerimeter
+     */
+    size_t add(const std::string& name, const ViewDefinition& definition);
+
+    /**
+     * @brief Unregister a view; its id is not reused
+     * @param name View name
+     * @return True if the view existed
+     */
+    bool remove(const std::string& name);
+
+    /**
+     * @brief Add (sign = 1) or subtract (sign = -1) a shape in every view
+     * @param features Features of the shape
+     * @param sign Direction of the update
+     */
+    void apply(const ShapeFeatures& features, double sign);
+
+    /**
+     * @brief Add or subtract a shape in a single view
+     *
+     * Used to populate a view registered after shapes were added.
+     *
+     * @param id View id
+     * @param features Features of the shape
+     * @param sign Direction of the update
+     */
+    void applyTo(size_t id, const ShapeFeatures& features, double sign);
+
+    /**
+     * @brief Add the values of another view set's matching views
+     *
+     * A view is merged in O(1) when other has a view with the same name and
+     * definition; any other view must be updated shape by shape.
+     *
+     * @param other View set maintained over the shapes being merged in
+     * @return Ids of the views that could not be merged
+     */
+    std::vector<size_t> merge(const ViewSet& other);
+
+    /**
+     * @brief Get the id of a view
+     * @param name View name
+     * @return View id
+     * @throws std::invalid_argument If no view has this name
+     */
+    size_t id(const std::string& name) const;
+
+    /**
+     * @brief Get the current value of a view
+     * @param id View id
+     * @return Aggregate value
+     * @throws std::out_of_range If the id is invalid or the view was removed
+     */
+    double value(size_t id) const;
+
+    /**
+     * @brief Get the current value of a view
+     * @param name View name
+     * @return Aggregate value
+     */
+    double value(const std::string& name) const { return value(id(name)); }
+
+    /**
+     * @brief Get the number of registered views
+     * @return View count
+     */
+    size_t size() const { return active_; }
+
+    /**
+     * @brief Check whether any view is registered
+     * @return True if there are no views
+     */
+    bool empty() const { return active_ == 0; }
+
+    /**
+     * @brief Reset every view value to zero, keeping the definitions
+     */
+    void reset();
+};
+
+} // namespace geometry
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Indexed triangle mesh in 3D
+ *
+ * Vertex coordinates are stored as separate x/y/z arrays so the face kernels
+ * read contiguous memory.
+ */
+struct TriangleMesh {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<uint32_t> indices;          ///< Three vertex indices per face
+    std::vector<uint32_t> regions;          ///< Region id per face (empty: all region 0)
+    std::vector<std::string> region_names;  ///< Optional names, indexed by region id
+
+    /**
+     * @brief Append a vertex
+     * @return Index of the new vertex
+     */
+    uint32_t addVertex(double vx, double vy, double vz) {
+        x.push_back(vx);
+        y.push_back(vy);
+        z.push_back(vz);
+        return static_cast<uint32_t>(x.size() - 1);
+    }
+
+    /**
+     * @brief Append a face
+     * @param a First vertex index
+     * @param b Second vertex index
+     * @param c Third vertex index
+     */
+    void addFace(uint32_t a, uint32_t b, uint32_t c) {
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+    }
+
+    /**
+     * @brief Get the number of vertices
+     * @return Vertex count
+     */
+    size_t vertexCount() const { return x.size(); }
+
+    /**
+     * @brief Get the number of faces
+     * @return Face count
+     */
+    size_t faceCount() const { return indices.size() / 3; }
+};
+
+/**
+ * @brief Area and boundary length of a mesh, in total and per region
+ *
+ * The perimeter of a region is the length of the edges used by exactly one
+ * face of that region; the total perimeter counts edges used by exactly one
+ * face of the whole mesh (zero for a closed surface).
+ */
+struct MeshStats {
+    double total_area = 0.0;
+    double total_perimeter = 0.0;
+    std::vector<double> region_area;
+    std::vector<double> region_perimeter;
+};
+
+/**
+ * @brief Compute the surface area of a mesh
+ *
+ * Face areas come from cross products of the indexed vertex coordinates and
+ * are summed in parallel blocks with compensated summation.
+ *
+ * @param mesh Mesh to measure
+ * @return Total surface area
+ * @throws std::invalid_argument If a face references a missing vertex
+ */
+double meshSurfaceArea(const TriangleMesh& mesh);
+
+/**
+ * @brief Compute total and per-region area and perimeter of a mesh
+ * @param mesh Mesh to measure
+ * @return Mesh statistics
+ * @throws std::invalid_argument If the mesh is malformed
+ */
+MeshStats computeMeshStats(const TriangleMesh& mesh);
+
+/**
+ * @brief Read a binary STL file into an indexed mesh
+ *
+ * Triangles are read in fixed-size chunks; vertices with identical
+ * coordinates are welded so that edges can be matched. Assumes a
+ * little-endian host, as the STL format is little-endian.
+ *
+ * @param in Binary input stream
+ * @return Indexed mesh (single region)
+ * @throws std::runtime_error If the stream is truncated
+ */
+TriangleMesh readBinaryStl(std::istream& in);
+
+/**
+ * @brief Compute the surface area of a binary STL stream without storing it
+ * @param in Binary input stream
+ * @return Total surface area
+ * @throws std::runtime_error If the stream is truncated
+ */
+double binaryStlSurfaceArea(std::istream& in);
+
+/**
+ * @brief Read a Wavefront OBJ stream into an indexed mesh
+ *
+ * Supports v and f records (including v/vt/vn and negative indices);
+ * polygons are fan-triangulated. Each g or o record starts a new region.
+ *
+ * @param in Text input stream
+ * @return Indexed mesh with one region per group
+ * @throws std::runtime_error On malformed records
+ */
+TriangleMesh readObj(std::istream& in);
+
+} // namespace geometry
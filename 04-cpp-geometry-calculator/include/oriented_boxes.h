@@ -0,0 +1,140 @@
+#pragma once
+
+#include "placement.h"
+#include <array>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Rectangle in the plane with arbitrary orientation
+ */
+struct OrientedBox {
+    Point center;
+    double width = 0.0;   ///< Extent along the box's x axis
+    double height = 0.0;  ///< Extent along the box's y axis
+    double angle = 0.0;   ///< Rotation of the box's x axis in radians, in [0, pi/2)
+
+    double area() const { return width * height; }
+    double perimeter() const { return 2.0 * (width + height); }
+
+    /**
+     * @brief Compute the corners
+     * @return Corners in counter-clockwise order
+     */
+    std::array<Point, 4> corners() const;
+};
+
+/**
+ * @brief Quantity an oriented bounding box minimizes
+ */
+enum class BoxCriterion {
+    MinArea,
+    MinPerimeter
+};
+
+/**
+ * @brief Columnar oriented bounding boxes, one row per shape or group
+ */
+struct OrientedBoxColumns {
+    std::vector<double> center_x;
+    std::vector<double> center_y;
+    std::vector<double> width;
+    std::vector<double> height;
+    std::vector<double> angle;
+
+    size_t size() const { return width.size(); }
+
+    /**
+     * @brief Resize every column
+     * @param count Number of rows
+     */
+    void resize(size_t count);
+
+    /**
+     * @brief Store a box in a row
+     * @param row Row index
+     * @param box Box to store
+     */
+    void set(size_t row, const OrientedBox& box);
+
+    /**
+     * @brief Read a row as a box
+     * @param row Row index
+     * @return Box
+     */
+    OrientedBox box(size_t row) const;
+};
+
+/**
+ * @brief Compute the convex hull of a point set (Andrew's monotone chain)
+ * @param points Points in any order
+ * @return Hull vertices in counter-clockwise order without collinear points
+ */
+std::vector<Point> convexHull(std::vector<Point> points);
+
+/**
+ * @brief Compute the minimum oriented bounding box of a point set
+ *
+ * Rotating calipers over the convex hull: the optimal box for both
+ * criteria has a side flush with a hull edge, so every edge is tried with
+ * the three other supporting points advanced monotonically, in O(h) after
+ * the O(n log n) hull.
+ *
+ * @param points Points (at least one)
+ * @param criterion Quantity to minimize
+ * @return Minimum box
+ * @throws std::invalid_argument If points is empty
+ */
+OrientedBox minimumBoundingBox(const std::vector<Point>& points,
+                               BoxCriterion criterion = BoxCriterion::MinArea);
+
+/**
+ * @brief Compute the minimum oriented bounding box of a placed shape
+ *
+ * Circles and rectangles use closed forms; triangles use rotating
+ * calipers over their vertices. Paths use the hull of their flattened
+ * outline, grown by the tolerance so the box still encloses the curves.
+ *
+ * @param placed Placed shape
+ * @param criterion Quantity to minimize
+ * @param tolerance Maximum deviation allowed for curved boundaries
+ * @return Minimum box
+ */
+OrientedBox minimumBoundingBox(const PlacedShape& placed,
+                               BoxCriterion criterion = BoxCriterion::MinArea,
+                               double tolerance = 1e-6);
+
+/**
+ * @brief Compute the minimum oriented bounding box of every shape in parallel
+ * @param shapes Placed shapes
+ * @param criterion Quantity to minimize
+ * @param tolerance Maximum deviation allowed for curved boundaries
+ * @return One row per shape
+ */
+OrientedBoxColumns orientedBoxes(const std::vector<PlacedShape>& shapes,
+                                 BoxCriterion criterion = BoxCriterion::MinArea,
+                                 double tolerance = 1e-6);
+
+/**
+ * @brief Compute the minimum oriented bounding box of groups of shapes in parallel
+ *
+ * Curved boundaries are approximated by inscribed outlines and the box is
+ * grown by the largest outline gap, so it always encloses the group and
+ * is within twice that gap of the optimum in each dimension.
+ *
+ * @param shapes Placed shapes
+ * @param group_of Group index of each shape
+ * @param groups Number of groups (empty groups get a zero box)
+ * @param criterion Quantity to minimize
+ * @param tolerance Maximum deviation allowed for curved boundaries
+ * @return One row per group
+ * @throws std::invalid_argument If group_of and shapes differ in size
+ * @throws std::out_of_range If a group index is >= groups
+ */
+OrientedBoxColumns groupOrientedBoxes(const std::vector<PlacedShape>& shapes,
+                                      const std::vector<size_t>& group_of, size_t groups,
+                                      BoxCriterion criterion = BoxCriterion::MinArea,
+                                      double tolerance = 1e-6);
+
+} // namespace geometry
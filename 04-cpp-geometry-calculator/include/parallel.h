@@ -0,0 +1,92 @@
+#pragma once
+
+#include "tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Number of worker threads used by parallel algorithms
+ * @return Hardware concurrency (at least 1)
+ */
+inline size_t workerCount() {
+    size_t n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * @brief Run body(i) for every i in [0, count) across worker threads
+ *
+ * Work items are handed out dynamically in blocks of grain_size, so items
+ * with very uneven cost still balance across threads. The first exception
+ * thrown by body is rethrown on the calling thread.
+ *
+ * @param count Number of work items
+ * @param body Callable invoked as body(size_t index)
+ * @param grain_size Number of consecutive items claimed at a time
+ */
+template <typename Body>
+void parallelFor(size_t count, Body&& body, size_t grain_size = 1) {
+    if (count == 0) {
+        return;
+    }
+    grain_size = std::max<size_t>(grain_size, 1);
+    size_t blocks = (count + grain_size - 1) / grain_size;
+    size_t threads = std::min(workerCount(), blocks);
+
+    if (threads <= 1) {
+        GEOMETRY_TRACE_SCOPE("parallel", "parallelFor block", 0);
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto worker = [&]() {
+        try {
+            for (;;) {
+                size_t begin = next.fetch_add(grain_size);
+                if (begin >= count) {
+                    break;
+                }
+                size_t end = std::min(begin + grain_size, count);
+                GEOMETRY_TRACE_SCOPE("parallel", "parallelFor block", begin);
+                for (size_t i = begin; i < end; ++i) {
+                    body(i);
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next.store(count);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace geometry
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "shapes/shape.h"
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Point in the plane
+ */
+struct Point {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+/**
+ * @brief Axis-aligned bounding box
+ */
+struct BoundingBox {
+    double min_x = 0.0;
+    double min_y = 0.0;
+    double max_x = 0.0;
+    double max_y = 0.0;
+
+    /**
+     * @brief Check if two boxes overlap or touch
+     * @param other Box to test against
+     * @return True if the closed boxes intersect
+     */
+    bool intersects(const BoundingBox& other) const {
+        return min_x <= other.max_x && other.min_x <= max_x &&
+               min_y <= other.max_y && other.min_y <= max_y;
+    }
+};
+
+/**
+ * @brief Shape placed in the plane at a given position
+ *
+ * Placement conventions:
+ * - Circle: position is the center
+ * - Rectangle: position is the lower-left corner, sides are axis-aligned
+ * - Triangle: position is the first vertex, side a runs along +x and the
+ *   third vertex lies above it (counter-clockwise winding)
+ * - Path: position offsets the path's own coordinates
+ */
+struct PlacedShape {
+    const Shape* shape = nullptr;
+    Point position;
+};
+
+/**
+ * @brief Compute the bounding box of a placed shape
+ * @param placed Placed shape
+ * @return Tight axis-aligned bounding box
+ */
+BoundingBox placedBounds(const PlacedShape& placed);
+
+/**
+ * @brief Compute the counter-clockwise vertices of a placed polygonal shape
+ * @param placed Placed rectangle or triangle
+ * @return Vertices in counter-clockwise order
+ * @throws std::invalid_argument If the shape is not polygonal
+ */
+std::vector<Point> placedVertices(const PlacedShape& placed);
+
+/**
+ * @brief Approximate the outline of a placed shape with a polygon
+ *
+ * The polygon is convex for every kind except Path.
+ *
+ * @param placed Placed shape
+ * @param tolerance Maximum distance between a curved boundary and its
+ *        inscribed chords (ignored for polygonal shapes)
+ * @return Vertices in counter-clockwise order
+ */
+std::vector<Point> placedOutline(const PlacedShape& placed, double tolerance);
+
+/**
+ * @brief Number of chords used to approximate a circle within tolerance
+ * @param radius Circle radius
+ * @param tolerance Maximum sagitta of each chord
+ * @return Segment count (at least 16)
+ */
+size_t circleSegmentCount(double radius, double tolerance);
+
+} // namespace geometry
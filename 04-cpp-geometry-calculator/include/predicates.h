@@ -0,0 +1,133 @@
+#pragma once
+
+#include "placement.h"
+#include <cmath>
+
+namespace geometry {
+
+/// Half the distance between 1 and the next double (unit roundoff)
+constexpr double kRoundoff = 0x1p-53;
+
+/// Relative error bound of the floating-point orientation determinant
+constexpr double kOrientationErrorBound = (3.0 + 16.0 * kRoundoff) * kRoundoff;
+
+/// Relative error bound of the floating-point in-circle determinant
+constexpr double kInCircleErrorBound = (10.0 + 96.0 * kRoundoff) * kRoundoff;
+
+/**
+ * @brief Exact orientation of three points using expansion arithmetic
+ * @param a First point
+ * @param b Second point
+ * @param c Third point
+ * @return 1 if a, b, c turn counter-clockwise, -1 if clockwise, 0 if collinear
+ */
+int orientationExact(const Point& a, const Point& b, const Point& c);
+
+/**
+ * @brief Exact position of a point relative to a circle using expansion arithmetic
+ * @param a First point on the circle
+ * @param b Second point on the circle
+ * @param c Third point on the circle
+ * @param d Point to classify
+ * @return For counter-clockwise a, b, c: 1 if d is inside, -1 if outside, 0 if on the circle
+ *         (the sign flips for clockwise a, b, c)
+ */
+int inCircleExact(const Point& a, const Point& b, const Point& c, const Point& d);
+
+/**
+ * @brief Robust orientation of three points
+ *
+ * Evaluates the determinant in doubles and returns its sign when it is
+ * larger than the rounding error bound; only near-degenerate inputs fall
+ * back to orientationExact().
+ *
+ * @param a First point
+ * @param b Second point
+ * @param c Third point
+ * @return 1 if a, b, c turn counter-clockwise, -1 if clockwise, 0 if collinear
+ */
+inline int orientation(const Point& a, const Point& b, const Point& c) {
+    double left = (a.x - c.x) * (b.y - c.y);
+    double right = (a.y - c.y) * (b.x - c.x);
+    double det = left - right;
+    double bound = kOrientationErrorBound * (std::abs(left) + std::abs(right));
+    if (det > bound) {
+        return 1;
+    }
+    if (-det > bound) {
+        return -1;
+    }
+    return orientationExact(a, b, c);
+}
+
+/**
+ * @brief Robust position of a point relative to the circle through three points
+ *
+ * Filtered like orientation(), falling back to inCircleExact().
+ *
+ * @param a First point on the circle
+ * @param b Second point on the circle
+ * @param c Third point on the circle
+ * @param d Point to classify
+ * @return For counter-clockwise a, b, c: 1 if d is inside, -1 if outside, 0 if on the circle
+ *         (the sign flips for clockwise a, b, c)
+ */
+inline int inCircle(const Point& a, const Point& b, const Point& c, const Point& d) {
+    double adx = a.x - d.x, ady = a.y - d.y;
+    double bdx = b.x - d.x, bdy = b.y - d.y;
+    double cdx = c.x - d.x, cdy = c.y - d.y;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                       (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                       (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    double bound = kInCircleErrorBound * permanent;
+    if (det > bound) {
+        return 1;
+    }
+    if (-det > bound) {
+        return -1;
+    }
+    return inCircleExact(a, b, c, d);
+}
+
+/**
+ * @brief Exactly decide whether a + b > c
+ *
+ * The rounded sum decides unless it equals c, in which case the sign of
+ * its rounding error does.
+ *
+ * @param a First summand
+ * @param b Second summand
+ * @param c Bound
+ * @return True if the exact sum exceeds c (false if any value is NaN)
+ */
+inline bool sumExceeds(double a, double b, double c) {
+    double sum = a + b;
+    if (sum != c) {
+        return sum > c;
+    }
+    double virtual_b = sum - a;
+    double error = (a - (sum - virtual_b)) + (b - virtual_b);
+    return error > 0.0;
+}
+
+/**
+ * @brief Exactly check the strict triangle inequality
+ * @param a First side
+ * @param b Second side
+ * @param c Third side
+ * @return True if every pair of sides sums to more than the remaining side
+ */
+inline bool satisfiesTriangleInequality(double a, double b, double c) {
+    return sumExceeds(a, b, c) && sumExceeds(b, c, a) && sumExceeds(a, c, b);
+}
+
+} // namespace geometry
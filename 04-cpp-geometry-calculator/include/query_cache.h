@@ -0,0 +1,173 @@
+#pragma once
+
+#include "shapes/shape.h"
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace geometry {
+
+/**
+ * @brief Aggregate computed by a ShapeQuery
+ */
+enum class QueryAggregate {
+    Count,
+    TotalArea,
+    TotalPerimeter,
+    UnionPerimeter
+};
+
+/**
+ * @brief Bit of a shape kind in ShapeQuery::kinds
+ * @param kind Shape kind
+ * @return Single-bit mask
+ */
+constexpr uint32_t kindMask(ShapeKind kind) {
+    return 1u << static_cast<uint32_t>(kind);
+}
+
+/// Mask accepting every shape kind
+constexpr uint32_t kAllShapeKinds = kindMask(ShapeKind::Circle) | kindMask(ShapeKind::Rectangle) |
+                                    kindMask(ShapeKind::Triangle) | kindMask(ShapeKind::Path);
+
+/**
+ * @brief Aggregate over the shapes matching a filter
+ */
+struct ShapeQuery {
+    QueryAggregate aggregate = QueryAggregate::TotalArea;
+    uint32_t kinds = kAllShapeKinds;                          ///< Accepted kinds (kindMask bits)
+    double min_area = 0.0;                                    ///< Smallest accepted area
+    double max_area = std::numeric_limits<double>::infinity(); ///< Largest accepted area
+    double tolerance = 1e-6;                                  ///< Curve tolerance (union perimeter only)
+
+    bool operator==(const ShapeQuery& other) const {
+        return aggregate == other.aggregate && kinds == other.kinds &&
+               min_area == other.min_area && max_area == other.max_area &&
+               tolerance == other.tolerance;
+    }
+
+    /**
+     * @brief Check whether a shape passes the filter
+     * @param shape Shape to test
+     * @return True if the shape's kind and area are accepted
+     */
+    bool matches(const Shape& shape) const;
+};
+
+/**
+ * @brief Canonical form of a query
+ *
+ * Queries that always produce the same result normalize to the same value:
+ * unknown kind bits are dropped, area bounds are clamped to the possible
+ * range, every empty filter maps to a single form, and the tolerance is
+ * zeroed for aggregates that ignore it.
+ *
+ * @param query Query to normalize
+ * @return Normalized query
+ * @throws std::invalid_argument If a bound or the tolerance is NaN, or the
+ *         tolerance of a union perimeter query is not positive
+ */
+ShapeQuery normalizeQuery(const ShapeQuery& query);
+
+/**
+ * @brief 64-bit hash of a query
+ * @param query Query to hash (normally already normalized)
+ * @return Well-mixed hash value
+ */
+uint64_t queryHash(const ShapeQuery& query);
+
+/**
+ * @brief Bounded LRU cache of query results tagged with a data version
+ *
+ * An entry is only returned for the version it was computed at; a lookup
+ * with a newer version drops it. Owners therefore invalidate every entry
+ * in O(1) by bumping their version. Thread-safe, so concurrent const
+ * queries can share one cache.
+ */
+class QueryCache {
+private:
+    struct Entry {
+        ShapeQuery query;
+        uint64_t version;
+        double value;
+    };
+
+    struct QueryHasher {
+        size_t operator()(const ShapeQuery& query) const {
+            return static_cast<size_t>(queryHash(query));
+        }
+    };
+
+    size_t capacity_;
+    std::list<Entry> entries_;  ///< Most recently used first
+    std::unordered_map<ShapeQuery, std::list<Entry>::iterator, QueryHasher> index_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    mutable std::mutex mutex_;
+
+public:
+    /**
+     * @brief Construct an empty cache
+     * @param capacity Maximum number of entries (0 disables caching)
+     */
+    explicit QueryCache(size_t capacity = 64);
+
+    QueryCache(QueryCache&& other) noexcept;
+    QueryCache& operator=(QueryCache&& other) noexcept;
+
+    /**
+     * @brief Look up a result
+     * @param query Normalized query
+     * @param version Current data version
+     * @return Cached value, if present for this version
+     */
+    std::optional<double> find(const ShapeQuery& query, uint64_t version);
+
+    /**
+     * @brief Store a result, evicting the least recently used entry if full
+     * @param query Normalized query
+     * @param version Data version the value was computed at
+     * @param value Query result
+     */
+    void insert(const ShapeQuery& query, uint64_t version, double value);
+
+    /**
+     * @brief Change the maximum number of entries
+     * @param capacity New capacity (0 disables caching)
+     */
+    void setCapacity(size_t capacity);
+
+    /**
+     * @brief Get the maximum number of entries
+     * @return Capacity
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Get the number of stored entries
+     * @return Entry count
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the number of successful lookups
+     * @return Hit count
+     */
+    uint64_t hits() const;
+
+    /**
+     * @brief Get the number of failed lookups
+     * @return Miss count
+     */
+    uint64_t misses() const;
+
+    /**
+     * @brief Drop every entry and reset the counters
+     */
+    void clear();
+};
+
+} // namespace geometry
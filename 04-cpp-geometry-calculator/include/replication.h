@@ -0,0 +1,165 @@
+#pragma once
+
+#include "calculator_observer.h"
+#include "geometry_calculator.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Streams a calculator's shape changes to a follower as binary frames
+ *
+ * Attaches itself as the calculator's observer and encodes each add,
+ * replacement, move, removal and clear into a buffer. The buffer is sent
+ * as one frame when it reaches the frame size or on flush(). Each frame
+ * carries a sequence number and the shape count and content hash (see
+ * ContentTree) the replica must have once it is applied, so the follower
+ * detects gaps and divergence. The first frame is a snapshot of the
+ * current shapes.
+ *
+ * Frames use the host's byte order, for followers on the same machine
+ * connected through a socket or pipe. Writes block while the channel is
+ * full, so a follower that falls behind slows the leader down rather than
+ * losing changes. Attributes are not replicated.
+ *
+ * A channel failure never interrupts the calculator's own mutation: the
+ * leader detaches, drops what it buffered, and reports the error from
+ * failed() and every later flush().
+ */
+class ReplicationLeader : private CalculatorObserver {
+public:
+    static constexpr size_t kDefaultFrameBytes = 64 * 1024;
+
+    /**
+     * @brief Start replicating a calculator
+     * @param calculator Calculator to observe (must outlive the leader)
+     * @param fd Connected stream socket or pipe (not closed by the leader)
+     * @param frame_bytes Buffered bytes that trigger a frame
+     * @throws std::runtime_error If the snapshot cannot be written
+     */
+    ReplicationLeader(GeometryCalculator& calculator, int fd, size_t frame_bytes = kDefaultFrameBytes);
+
+    /**
+     * @brief Send pending changes and detach from the calculator
+     */
+    ~ReplicationLeader() override;
+
+    ReplicationLeader(const ReplicationLeader&) = delete;
+    ReplicationLeader& operator=(const ReplicationLeader&) = delete;
+
+    /**
+     * @brief Send buffered changes as a frame now
+     * @throws std::runtime_error If the channel fails now or failed earlier
+     */
+    void flush();
+
+    /**
+     * @brief Check whether the channel failed and replication stopped
+     * @return True once a write has failed
+     */
+    bool failed() const { return !error_.empty(); }
+
+    /**
+     * @brief Get the sequence number of the last frame sent
+     * @return Sequence number (frames are numbered from 1)
+     */
+    uint64_t sequence() const { return sequence_; }
+
+    /**
+     * @brief Get the number of bytes buffered for the next frame
+     * @return Pending payload bytes
+     */
+    size_t pendingBytes() const;
+
+private:
+    GeometryCalculator& calculator_;
+    int fd_;
+    size_t frame_bytes_;
+    uint64_t sequence_ = 0;
+    std::vector<unsigned char> frame_;  ///< Header space followed by the encoded changes
+    ContentTree replica_;               ///< Content the follower will have once it applies frame_
+    std::string error_;                 ///< Channel error that stopped replication, if any
+
+    void shapeAdded(const Shape& shape, const Point& position) override;
+    void shapeReplaced(size_t index, const Shape& shape) override;
+    void shapeMoved(size_t index, const Point& position) override;
+    void shapesRemoved(const std::vector<size_t>& indices) override;
+    void cleared() override;
+    void opFinished();
+    void send();
+};
+
+/**
+ * @brief Applies a leader's frames to a local calculator
+ *
+ * Reads happen on the caller's thread in poll(); between polls the replica
+ * can serve queries through calculator(), and after the leader is gone it
+ * can take over with takeOver().
+ */
+class ReplicationFollower {
+public:
+    /**
+     * @brief Follow a leader
+     * @param fd Connected stream socket or pipe (not closed by the follower)
+     */
+    explicit ReplicationFollower(int fd);
+
+    /**
+     * @brief Apply every complete frame that has arrived
+     *
+     * Waits up to timeout for data if none is pending, then drains the
+     * channel without blocking.
+     *
+     * @param timeout Longest wait for the first bytes
+     * @return Number of frames applied
+     * @throws std::runtime_error If a frame is malformed or out of sequence,
+     *         the replica diverges from the leader, or the channel fails
+     * @throws std::logic_error After takeOver()
+     */
+    size_t poll(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    /**
+     * @brief Get the replica
+     * @return Calculator holding the leader's shapes as of sequence()
+     */
+    const GeometryCalculator& calculator() const { return calculator_; }
+
+    /**
+     * @brief Get the sequence number of the last frame applied
+     * @return Sequence number (0 before the snapshot arrives)
+     */
+    uint64_t sequence() const { return sequence_; }
+
+    /**
+     * @brief Check whether the leader closed the channel
+     * @return True once end of stream was read
+     */
+    bool closed() const { return closed_; }
+
+    /**
+     * @brief Take the replica, e.g. to promote this process to leader
+     *
+     * The follower stops following: unread data is dropped and poll()
+     * throws from then on.
+     *
+     * @return Calculator with the replicated shapes as of sequence()
+     */
+    GeometryCalculator takeOver();
+
+private:
+    int fd_;
+    GeometryCalculator calculator_;
+    uint64_t sequence_ = 0;
+    bool closed_ = false;
+    bool taken_over_ = false;
+    std::vector<unsigned char> received_;
+
+    size_t applyFrames();
+};
+
+} // namespace geometry
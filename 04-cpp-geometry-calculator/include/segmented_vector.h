@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Vector stored in fixed-size segments that never relocate
+ *
+ * Appending allocates a new segment when the last one is full and only
+ * the small directory of segment pointers ever grows, so push_back costs
+ * the same at fifty million elements as at fifty, existing elements keep
+ * their addresses, and no append copies the contents. Elements are
+ * reached with a shift and a mask; loops that need contiguous memory work
+ * one segment at a time.
+ *
+ * @tparam T Default-constructible, copyable element type
+ * @tparam SegmentSize Elements per segment (a power of two)
+ */
+template <typename T, size_t SegmentSize = 4096>
+class SegmentedVector {
+    static_assert(SegmentSize > 0 && (SegmentSize & (SegmentSize - 1)) == 0,
+                  "Segment size must be a power of two");
+
+private:
+    std::vector<std::unique_ptr<T[]>> segments_;
+    size_t size_ = 0;
+
+public:
+    static constexpr size_t kSegmentSize = SegmentSize;
+
+    SegmentedVector() = default;
+    SegmentedVector(SegmentedVector&&) noexcept = default;
+    SegmentedVector& operator=(SegmentedVector&&) noexcept = default;
+
+    SegmentedVector(const SegmentedVector& other) { *this = other; }
+
+    SegmentedVector& operator=(const SegmentedVector& other) {
+        if (this != &other) {
+            clear();
+            for (size_t s = 0; s < other.segmentCount(); ++s) {
+                segments_.push_back(std::make_unique<T[]>(SegmentSize));
+                std::copy(other.segment(s), other.segment(s) + other.segmentLength(s),
+                          segments_.back().get());
+            }
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t index) { return segments_[index / SegmentSize][index % SegmentSize]; }
+    const T& operator[](size_t index) const { return segments_[index / SegmentSize][index % SegmentSize]; }
+
+    /**
+     * @brief Append an element
+     * @param value Element to copy
+     */
+    void push_back(const T& value) {
+        if (size_ == segments_.size() * SegmentSize) {
+            segments_.push_back(std::make_unique<T[]>(SegmentSize));
+        }
+        (*this)[size_++] = value;
+    }
+
+    /**
+     * @brief Grow or shrink, filling new elements with a value
+     * @param count New size
+     * @param value Value of added elements
+     */
+    void resize(size_t count, const T& value = T()) {
+        while (size_ < count) {
+            push_back(value);
+        }
+        size_ = count;
+        segments_.resize((count + SegmentSize - 1) / SegmentSize);
+    }
+
+    /**
+     * @brief Replace the contents with copies of a value
+     * @param count New size
+     * @param value Element value
+     */
+    void assign(size_t count, const T& value) {
+        clear();
+        resize(count, value);
+    }
+
+    /**
+     * @brief Reserve the segment directory (segments are allocated on demand)
+     * @param count Expected size
+     */
+    void reserve(size_t count) { segments_.reserve((count + SegmentSize - 1) / SegmentSize); }
+
+    /**
+     * @brief Remove all elements and free the segments
+     */
+    void clear() {
+        segments_.clear();
+        size_ = 0;
+    }
+
+    /**
+     * @brief Remove an element; later elements move down by one
+     * @param index Element index (must be valid)
+     */
+    void erase(size_t index) {
+        for (size_t i = index + 1; i < size_; ++i) {
+            (*this)[i - 1] = (*this)[i];
+        }
+        resize(size_ - 1);
+    }
+
+    /**
+     * @brief Remove several elements in one compaction pass
+     * @param indices Distinct valid indices in ascending order
+     */
+    void eraseSorted(const std::vector<size_t>& indices) {
+        size_t next = 0;
+        size_t write = 0;
+        for (size_t i = 0; i < size_; ++i) {
+            if (next < indices.size() && indices[next] == i) {
+                ++next;
+                continue;
+            }
+            if (write != i) {
+                (*this)[write] = (*this)[i];
+            }
+            ++write;
+        }
+        resize(write);
+    }
+
+    /**
+     * @brief Get the number of allocated segments
+     * @return Segment count
+     */
+    size_t segmentCount() const { return segments_.size(); }
+
+    /**
+     * @brief Get the elements of a segment
+     * @param s Segment index
+     * @return Pointer to segmentLength(s) contiguous elements
+     */
+    T* segment(size_t s) { return segments_[s].get(); }
+    const T* segment(size_t s) const { return segments_[s].get(); }
+
+    /**
+     * @brief Get the number of elements in use in a segment
+     * @param s Segment index
+     * @return Elements in use
+     */
+    size_t segmentLength(size_t s) const { return std::min(SegmentSize, size_ - s * SegmentSize); }
+};
+
+} // namespace geometry
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "placement.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Pair of shape indices into a DistanceShapes set
+ */
+struct ShapePair {
+    size_t first = 0;
+    size_t second = 0;
+};
+
+/**
+ * @brief Placed circles, rectangles and triangles prepared for batch distance queries
+ *
+ * Every shape is stored as up to four counter-clockwise vertices plus a
+ * radius in structure-of-arrays form: a circle is its center with its
+ * radius, a triangle repeats its last vertex. The kernels then run a
+ * fixed number of vertex/edge steps per pair with no virtual calls, and
+ * pairs of the same kind combination are gathered into contiguous blocks
+ * so the compiler can vectorize across pairs.
+ */
+class DistanceShapes {
+private:
+    static constexpr size_t kMaxVertices = 4;
+
+    std::vector<uint8_t> round_;  // 1 for circles
+    std::vector<double> x_[kMaxVertices];
+    std::vector<double> y_[kMaxVertices];
+    std::vector<double> radius_;
+    std::vector<double> bound_x_;       // Bounding circle center
+    std::vector<double> bound_y_;
+    std::vector<double> bound_radius_;
+
+    // Writes distances, or flags when distances is null
+    void run(const std::vector<ShapePair>& pairs, double threshold, double* distances,
+             uint8_t* flags) const;
+
+public:
+    /**
+     * @brief Prepare placed shapes
+     * @param shapes Placed circles, rectangles and triangles
+     * @throws std::invalid_argument For paths or null shapes
+     */
+    explicit DistanceShapes(const std::vector<PlacedShape>& shapes);
+
+    /**
+     * @brief Get the number of shapes
+     * @return Shape count
+     */
+    size_t size() const { return radius_.size(); }
+
+    /**
+     * @brief Compute the exact minimum distance of every pair
+     *
+     * The distance is between the filled shapes, so it is zero when they
+     * overlap or touch.
+     *
+     * @param pairs Shape index pairs
+     * @return One distance per pair
+     * @throws std::out_of_range If a pair refers to a missing shape
+     */
+    std::vector<double> distances(const std::vector<ShapePair>& pairs) const;
+
+    /**
+     * @brief Check which pairs are closer than a threshold
+     *
+     * Cheaper than distances(): pairs whose bounding circles are already
+     * far enough apart are rejected before the exact kernel, and the
+     * remaining pairs compare squared distances without square roots.
+     *
+     * @param pairs Shape index pairs
+     * @param threshold Clearance (no pair is closer than a threshold <= 0)
+     * @return One flag per pair, 1 if the distance is below the threshold
+     * @throws std::out_of_range If a pair refers to a missing shape
+     */
+    std::vector<uint8_t> within(const std::vector<ShapePair>& pairs, double threshold) const;
+};
+
+/**
+ * @brief Compute the exact minimum distance between two placed shapes
+ * @param a First shape (circle, rectangle or triangle)
+ * @param b Second shape (circle, rectangle or triangle)
+ * @return Distance, zero when the shapes overlap or touch
+ * @throws std::invalid_argument For paths or null shapes
+ */
+double minimumDistance(const PlacedShape& a, const PlacedShape& b);
+
+} // namespace geometry
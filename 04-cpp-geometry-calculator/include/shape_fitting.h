@@ -0,0 +1,96 @@
+#pragma once
+
+#include "placement.h"
+#include "shapes/shape.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace geometry {
+
+class GeometryCalculator;
+
+/**
+ * @brief 2D point cloud stored as separate coordinate arrays
+ *
+ * Structure-of-arrays layout keeps the residual kernels contiguous so the
+ * compiler can vectorize them.
+ */
+struct PointCloud {
+    std::vector<double> x;
+    std::vector<double> y;
+
+    /**
+     * @brief Append a point
+     * @param point Point to append
+     */
+    void add(const Point& point) {
+        x.push_back(point.x);
+        y.push_back(point.y);
+    }
+
+    /**
+     * @brief Get the number of points
+     * @return Point count
+     */
+    size_t size() const { return x.size(); }
+};
+
+/**
+ * @brief Parameters of a RANSAC fit
+ */
+struct FitOptions {
+    size_t iterations = 256;        ///< Hypotheses drawn per model
+    double inlier_threshold = 0.01; ///< Maximum distance of an inlier to the shape
+    double min_inlier_ratio = 0.5;  ///< Fraction of inliers required for success
+    uint64_t seed = 1;              ///< Random seed, fits are deterministic
+};
+
+/**
+ * @brief Outcome of fitting one point cloud
+ */
+struct FitResult {
+    std::unique_ptr<Shape> shape;  ///< Fitted shape, null when the fit failed
+    Point position;                ///< Placement position of the fitted shape
+    size_t inliers = 0;            ///< Points within the inlier threshold
+    double rms_residual = 0.0;     ///< Root mean square residual of the inliers
+};
+
+/**
+ * @brief Fit a shape to boundary points with RANSAC and least squares
+ *
+ * Hypotheses are scored in parallel with branch-free residual kernels, and
+ * the best one is refined by least squares over its inliers:
+ * - Circle: circumcircle of 3 samples, refined by an algebraic (Kasa) fit
+ * - Rectangle: axis-aligned box spanned by 4 samples, each side refined to
+ *   the mean of the points closest to it
+ * - Triangle: three lines found by sequential RANSAC and refined by total
+ *   least squares, intersected pairwise into vertices. Placements cannot
+ *   carry rotation, so the position is the start of the counter-clockwise
+ *   edge closest to +x; the placed triangle matches the fitted one only
+ *   when that edge is horizontal
+ *
+ * @param cloud Points sampled on the shape boundary
+ * @param kind Kind of shape to fit
+ * @param options Fit parameters
+ * @return Fit result (shape is null if too few inliers were found)
+ * @throws std::invalid_argument If kind is ShapeKind::Path
+ */
+FitResult fitShape(const PointCloud& cloud, ShapeKind kind, const FitOptions& options = {});
+
+/**
+ * @brief Fit many point clouds in parallel and add the shapes to a calculator
+ *
+ * Clouds are fitted concurrently; successful fits are added in input order.
+ * Fitted triangles are added unrotated (see fitShape).
+ *
+ * @param clouds Point clouds, one shape each
+ * @param kind Kind of shape to fit
+ * @param calculator Calculator receiving the fitted shapes and positions
+ * @param options Fit parameters (the seed is varied per cloud)
+ * @return Number of shapes added
+ */
+size_t fitShapesInto(const std::vector<PointCloud>& clouds, ShapeKind kind,
+                     GeometryCalculator& calculator, const FitOptions& options = {});
+
+} // namespace geometry
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "shapes/shape.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Canonical, quantized description of a shape's dimensions
+ *
+ * Parameters are sorted where the shape is symmetric in them (a 4x6 and a
+ * 6x4 rectangle share a signature) and rounded to a fixed quantum, so that
+ * shapes of equal size map to the same signature. Paths are described by
+ * their area, perimeter and segment count.
+ */
+struct ShapeSignature {
+    ShapeKind kind = ShapeKind::Circle;
+    std::array<double, 3> parameters{};
+
+    bool operator==(const ShapeSignature& other) const {
+        return kind == other.kind && parameters == other.parameters;
+    }
+};
+
+/**
+ * @brief Build the canonical signature of a shape
+ * @param shape Shape to describe
+ * @param quantum Rounding step applied to every parameter (must be positive)
+ * @return Canonical signature
+ */
+ShapeSignature canonicalSignature(const Shape& shape, double quantum = 1e-6);
+
+/**
+ * @brief 64-bit hash of a signature
+ * @param signature Signature to hash
+ * @return Well-mixed hash value
+ */
+uint64_t signatureHash(const ShapeSignature& signature);
+
+/**
+ * @brief Frequency estimate reported by HeavyHitterSketch
+ */
+struct HeavyHitter {
+    ShapeSignature signature;
+    uint64_t count = 0;  ///< Upper bound on the true frequency
+    uint64_t error = 0;  ///< count - error is a lower bound on the true frequency
+};
+
+/**
+ * @brief Space-Saving heavy-hitter sketch over shape signatures
+ *
+ * Tracks at most capacity counters in fixed memory. Any signature whose
+ * frequency exceeds n / capacity is guaranteed to be tracked. Counters live
+ * in a min-heap indexed by an open-addressing hash table, so an update costs
+ * O(log capacity) independent of the stream length.
+ */
+class HeavyHitterSketch {
+private:
+    struct Counter {
+        ShapeSignature signature;
+        uint64_t hash = 0;
+        uint64_t count = 0;
+        uint64_t error = 0;
+    };
+
+    size_t capacity_;
+    std::vector<Counter> counters_;
+    std::vector<uint32_t> heap_;
+    std::vector<uint32_t> heap_position_;
+    std::vector<int32_t> table_;
+    uint64_t total_ = 0;
+
+    size_t findSlot(uint64_t hash) const;
+    void eraseSlot(size_t slot);
+    void siftDown(size_t position);
+    void swapHeap(size_t a, size_t b);
+    void increment(const ShapeSignature& signature, uint64_t hash,
+                   uint64_t count, uint64_t error);
+
+public:
+    /**
+     * @brief Construct an empty sketch
+     * @param capacity Maximum number of tracked signatures (must be positive)
+     */
+    explicit HeavyHitterSketch(size_t capacity = 64);
+
+    /**
+     * @brief Record one occurrence of a signature
+     * @param signature Shape signature
+     */
+    void add(const ShapeSignature& signature);
+
+    /**
+     * @brief Merge another sketch into this one
+     * @param other Sketch built over a different stream
+     */
+    void merge(const HeavyHitterSketch& other);
+
+    /**
+     * @brief Get the most frequent signatures
+     * @param k Maximum number of entries to return
+     * @return Entries sorted by decreasing count
+     */
+    std::vector<HeavyHitter> topK(size_t k) const;
+
+    /**
+     * @brief Get the number of recorded occurrences
+     * @return Stream length
+     */
+    uint64_t total() const { return total_; }
+
+    /**
+     * @brief Get the maximum number of tracked signatures
+     * @return Capacity
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Forget all recorded occurrences
+     */
+    void clear();
+};
+
+/**
+ * @brief HyperLogLog distinct counter over 64-bit hashes
+ *
+ * Uses 2^precision one-byte registers; the relative standard error of the
+ * estimate is about 1.04 / sqrt(2^precision).
+ */
+class DistinctCounter {
+private:
+    unsigned precision_;
+    std::vector<uint8_t> registers_;
+
+public:
+    /**
+     * @brief Construct an empty counter
+     * @param precision Number of index bits, between 4 and 18
+     */
+    explicit DistinctCounter(unsigned precision = 12);
+
+    /**
+     * @brief Record a hashed item
+     * @param hash Well-mixed 64-bit hash of the item
+     */
+    void add(uint64_t hash);
+
+    /**
+     * @brief Merge another counter with the same precision
+     * @param other Counter to merge
+     */
+    void merge(const DistinctCounter& other);
+
+    /**
+     * @brief Estimate the number of distinct items recorded
+     * @return Cardinality estimate
+     */
+    double estimate() const;
+
+    /**
+     * @brief Forget all recorded items
+     */
+    void clear();
+};
+
+/**
+ * @brief Heavy-hitter and distinct-count statistics over added shapes
+ *
+ * Statistics are insert-only: they describe every shape added since the
+ * last clear(), including shapes later removed or replaced.
+ */
+class ShapeStatistics {
+private:
+    double quantum_;
+    HeavyHitterSketch heavy_hitters_;
+    DistinctCounter distinct_;
+
+public:
+    /**
+     * @brief Construct empty statistics
+     * @param quantum Rounding step used to canonicalize shape parameters
+     * @param capacity Number of heavy-hitter counters
+     * @param precision HyperLogLog precision
+     */
+    explicit ShapeStatistics(double quantum = 1e-6, size_t capacity = 64,
+                             unsigned precision = 12);
+
+    /**
+     * @brief Record a shape
+     * @param shape Shape to record
+     */
+    void add(const Shape& shape);
+
+    /**
+     * @brief Merge statistics gathered elsewhere (same configuration)
+     * @param other Statistics to merge
+     */
+    void merge(const ShapeStatistics& other);
+
+    /**
+     * @brief Get the most common shape dimensions
+     * @param k Maximum number of entries
+     * @return Entries sorted by decreasing count
+     */
+    std::vector<HeavyHitter> mostCommon(size_t k) const { return heavy_hitters_.topK(k); }
+
+    /**
+     * @brief Estimate the number of distinct shapes recorded
+     * @return Cardinality estimate
+     */
+    double distinctCount() const { return distinct_.estimate(); }
+
+    /**
+     * @brief Get the number of shapes recorded
+     * @return Shape count
+     */
+    uint64_t recordedCount() const { return heavy_hitters_.total(); }
+
+    /**
+     * @brief Forget all recorded shapes
+     */
+    void clear();
+};
+
+} // namespace geometry
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "placement.h"
+#include "shapes/shape.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Chunked storage for shapes and their positions
+ *
+ * Shapes live in chunks of at most kChunkCapacity entries. Appending
+ * another store splices its chunks in O(chunks) without touching the
+ * shapes, and erasing shifts only the rest of one chunk. An index is
+ * located by binary search over the chunk start offsets, which is O(1)
+ * while every chunk but the last is full.
+ *
+ * Appends never move stored shapes, and positions move only while the
+ * first chunk fills: every later chunk is allocated at full capacity, and
+ * growing the chunk directory moves only the chunks' vector headers
+ * (about one per thousand shapes), so append latency stays flat.
+ */
+class ShapeStore {
+public:
+    static constexpr size_t kChunkCapacity = 1024;
+
+    /**
+     * @brief Consecutive shapes and their positions
+     */
+    struct Chunk {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        std::vector<Point> positions;
+
+        size_t size() const { return shapes.size(); }
+    };
+
+    ShapeStore() = default;
+    ShapeStore(ShapeStore&& other) noexcept { *this = std::move(other); }
+
+    ShapeStore& operator=(ShapeStore&& other) noexcept {
+        if (this != &other) {
+            chunks_ = std::move(other.chunks_);
+            offsets_ = std::move(other.offsets_);
+            size_ = other.size_;
+            other.clear();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Append a shape
+     * @param shape Shape (will be moved)
+     * @param position Placement position
+     */
+    void push(std::unique_ptr<Shape> shape, const Point& position);
+
+    /**
+     * @brief Move all shapes of another store to the end of this one
+     *
+     * Chunks are moved, not their shapes; a small leading chunk of other is
+     * folded into this store's last chunk when it fits, so repeatedly
+     * splicing small stores does not fragment the storage.
+     *
+     * @param other Store to take the shapes from (left empty)
+     */
+    void splice(ShapeStore& other);
+
+    /**
+     * @brief Remove a shape; later shapes move down by one
+     * @param index Shape index (must be valid)
+     */
+    void erase(size_t index);
+
+    /**
+     * @brief Remove several shapes in one compaction pass
+     * @param indices Distinct valid shape indices in ascending order
+     */
+    void eraseSorted(const std::vector<size_t>& indices);
+
+    /**
+     * @brief Remove all shapes
+     */
+    void clear();
+
+    /**
+     * @brief Reserve chunk bookkeeping for a number of shapes
+     * @param count Expected total number of shapes
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Get the number of shapes
+     * @return Number of shapes
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Access the shape slot at an index
+     * @param index Shape index (must be valid)
+     * @return Owning pointer to the shape
+     */
+    std::unique_ptr<Shape>& shape(size_t index) {
+        auto [c, i] = locate(index);
+        return chunks_[c].shapes[i];
+    }
+
+    /**
+     * @brief Get the shape at an index
+     * @param index Shape index (must be valid)
+     * @return Shape
+     */
+    const Shape& shape(size_t index) const {
+        auto [c, i] = locate(index);
+        return *chunks_[c].shapes[i];
+    }
+
+    /**
+     * @brief Access the position at an index
+     * @param index Shape index (must be valid)
+     * @return Placement position
+     */
+    Point& position(size_t index) {
+        auto [c, i] = locate(index);
+        return chunks_[c].positions[i];
+    }
+
+    /**
+     * @brief Get the position at an index
+     * @param index Shape index (must be valid)
+     * @return Placement position
+     */
+    const Point& position(size_t index) const {
+        auto [c, i] = locate(index);
+        return chunks_[c].positions[i];
+    }
+
+    /**
+     * @brief Get the number of chunks
+     * @return Chunk count
+     */
+    size_t chunkCount() const { return chunks_.size(); }
+
+    /**
+     * @brief Access a chunk
+     * @param c Chunk index
+     * @return Chunk
+     */
+    Chunk& chunk(size_t c) { return chunks_[c]; }
+    const Chunk& chunk(size_t c) const { return chunks_[c]; }
+
+    /**
+     * @brief Visit every shape in order
+     * @param visit Callable invoked as visit(const Shape&, const Point&)
+     */
+    template <typename Visit>
+    void forEach(Visit&& visit) const {
+        for (const auto& chunk : chunks_) {
+            for (size_t i = 0; i < chunk.size(); ++i) {
+                visit(*chunk.shapes[i], chunk.positions[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Visit shapes in order starting at an index, until visit returns false
+     * @param index First shape index (nothing is visited if past the end)
+     * @param visit Callable invoked as visit(size_t index, const Shape&, const Point&)
+     */
+    template <typename Visit>
+    void visitFrom(size_t index, Visit&& visit) const {
+        if (index >= size_) {
+            return;
+        }
+        auto [c, i] = locate(index);
+        for (; c < chunks_.size(); ++c, i = 0) {
+            const Chunk& chunk = chunks_[c];
+            for (; i < chunk.size(); ++i, ++index) {
+                if (!visit(index, *chunk.shapes[i], chunk.positions[i])) {
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<Chunk> chunks_;
+    std::vector<size_t> offsets_;  ///< Index of each chunk's first shape
+    size_t size_ = 0;
+
+    std::pair<size_t, size_t> locate(size_t index) const;
+};
+
+} // namespace geometry
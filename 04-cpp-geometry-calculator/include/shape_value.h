@@ -0,0 +1,105 @@
+#pragma once
+
+#include "shapes/shape.h"
+#include <array>
+#include <cmath>
+#include <memory>
+
+namespace geometry {
+
+/**
+ * @brief Shape stored by value: a kind tag and up to three dimensions
+ *
+ * A 32-byte alternative to a heap-allocated Shape for circles, rectangles
+ * and triangles. Area and perimeter use the same formulas as the shape
+ * classes, so results match them exactly.
+ */
+struct ShapeValue {
+    std::array<double, 3> dimensions{};  ///< Circle: radius; Rectangle: width, height; Triangle: sides
+    ShapeKind kind = ShapeKind::Circle;
+
+    /**
+     * @brief Create a circle
+     * @param radius Circle radius (must be positive)
+     * @return Shape value
+     */
+    static ShapeValue circle(double radius);
+
+    /**
+     * @brief Create a rectangle
+     * @param width Rectangle width (must be positive)
+     * @param height Rectangle height (must be positive)
+     * @return Shape value
+     */
+    static ShapeValue rectangle(double width, double height);
+
+    /**
+     * @brief Create a triangle
+     * @param side_a First side (must be positive)
+     * @param side_b Second side (must be positive)
+     * @param side_c Third side (must be positive)
+     * @return Shape value
+     */
+    static ShapeValue triangle(double side_a, double side_b, double side_c);
+
+    /**
+     * @brief Copy the dimensions of a shape object
+     * @param shape Circle, rectangle or triangle
+     * @return Shape value
+     * @throws std::invalid_argument For paths, which have no fixed-size form
+     */
+    static ShapeValue fromShape(const Shape& shape);
+
+    /**
+     * @brief Create the equivalent shape object
+     * @return Heap-allocated shape
+     */
+    std::unique_ptr<Shape> toShape() const;
+
+    /**
+     * @brief Calculate the area
+     * @return Area
+     */
+    double area() const {
+        const auto& d = dimensions;
+        switch (kind) {
+            case ShapeKind::Circle:
+                return M_PI * d[0] * d[0];
+            case ShapeKind::Rectangle:
+                return d[0] * d[1];
+            case ShapeKind::Triangle: {
+                // Heron's formula, as in Triangle::area()
+                double s = (d[0] + d[1] + d[2]) / 2.0;
+                return std::sqrt(s * (s - d[0]) * (s - d[1]) * (s - d[2]));
+            }
+            case ShapeKind::Path:
+                break;
+        }
+        return 0.0;
+    }
+
+    /**
+     * @brief Calculate the perimeter
+     * @return Perimeter
+     */
+    double perimeter() const {
+        const auto& d = dimensions;
+        switch (kind) {
+            case ShapeKind::Circle:
+                return 2 * M_PI * d[0];
+            case ShapeKind::Rectangle:
+                return 2 * (d[0] + d[1]);
+            case ShapeKind::Triangle:
+                return d[0] + d[1] + d[2];
+            case ShapeKind::Path:
+                break;
+        }
+        return 0.0;
+    }
+
+    bool operator==(const ShapeValue& other) const {
+        return kind == other.kind && dimensions == other.dimensions;
+    }
+};
+
+} // namespace geometry
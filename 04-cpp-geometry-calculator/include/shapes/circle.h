@@ -35,6 +35,7 @@ public:
     double area() const override;
     double perimeter() const override;
     std::string name() const override;
+    ShapeKind kind() const override { return ShapeKind::Circle; }
     bool isValid() const override;
 };
 
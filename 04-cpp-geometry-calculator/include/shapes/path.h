@@ -0,0 +1,129 @@
+#pragma once
+
+#include "shape.h"
+#include "placement.h"
+#include <array>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief One segment of a Path boundary
+ */
+struct PathSegment {
+    enum class Type {
+        Line,
+        Arc,
+        Cubic
+    };
+
+    Type type = Type::Line;
+    std::array<Point, 4> points{};  ///< Line: points[0..1], Cubic: points[0..3], Arc: center
+    double radius = 0.0;            ///< Arc radius
+    double start_angle = 0.0;       ///< Arc start angle in radians
+    double sweep = 0.0;             ///< Arc sweep in radians (positive is counter-clockwise)
+
+    /**
+     * @brief Create a straight segment
+     * @param from Start point
+     * @param to End point
+     */
+    static PathSegment line(const Point& from, const Point& to);
+
+    /**
+     * @brief Create a circular arc
+     * @param center Arc center
+     * @param radius Arc radius (must be positive)
+     * @param start_angle Angle of the start point in radians
+     * @param sweep Signed angle swept in radians
+     */
+    static PathSegment arc(const Point& center, double radius, double start_angle, double sweep);
+
+    /**
+     * @brief Create a cubic Bezier segment
+     * @param p0 Start point
+     * @param p1 First control point
+     * @param p2 Second control point
+     * @param p3 End point
+     */
+    static PathSegment cubic(const Point& p0, const Point& p1, const Point& p2, const Point& p3);
+
+    /**
+     * @brief Get the start point of the segment
+     * @return Start point
+     */
+    Point start() const;
+
+    /**
+     * @brief Get the end point of the segment
+     * @return End point
+     */
+    Point end() const;
+};
+
+/**
+ * @brief Closed shape bounded by line, arc and cubic Bezier segments
+ *
+ * The area comes from Green's theorem, which has a closed form for every
+ * segment type. The perimeter is closed form for lines and arcs and uses
+ * 8-point Gauss-Legendre quadrature for Bezier segments, evaluated for all
+ * segments at once in structure-of-arrays batches; only segments whose
+ * estimate does not converge are subdivided adaptively. Both values are
+ * computed once on construction, so aggregating paths costs the same as
+ * aggregating simple shapes.
+ *
+ * The boundary must be closed and must not self-intersect.
+ */
+class Path : public Shape {
+private:
+    std::vector<PathSegment> segments_;
+    double area_;
+    double perimeter_;
+
+public:
+    /**
+     * @brief Construct a path from contiguous segments
+     * @param segments Segments, each starting where the previous one ends,
+     *        the last one ending where the first one starts
+     */
+    explicit Path(std::vector<PathSegment> segments);
+
+    /**
+     * @brief Create a rectangle with rounded corners
+     * @param width Rectangle width (must be positive)
+     * @param height Rectangle height (must be positive)
+     * @param radius Corner radius (positive, at most half the smaller side)
+     * @return Path with its lower-left corner at the origin
+     */
+    static Path roundedRectangle(double width, double height, double radius);
+
+    /**
+     * @brief Get the segments
+     * @return Boundary segments
+     */
+    const std::vector<PathSegment>& segments() const { return segments_; }
+
+    /**
+     * @brief Get the exact bounding box of the boundary
+     * @return Axis-aligned bounding box in path coordinates
+     */
+    BoundingBox bounds() const;
+
+    /**
+     * @brief Approximate the boundary with a counter-clockwise polygon
+     * @param tolerance Maximum distance between the curve and its chords
+     * @param weights Optional output: curve length divided by chord length
+     *        for each polygon edge
+     * @return Polygon vertices
+     */
+    std::vector<Point> flatten(double tolerance, std::vector<double>* weights = nullptr) const;
+
+    // Shape interface implementation
+    double area() const override;
+    double perimeter() const override;
+    std::string name() const override;
+    ShapeKind kind() const override { return ShapeKind::Path; }
+    bool isValid() const override;
+};
+
+} // namespace geometry
@@ -43,6 +43,7 @@ public:
     double area() const override;
     double perimeter() const override;
     std::string name() const override;
+    ShapeKind kind() const override { return ShapeKind::Rectangle; }
     bool isValid() const override;
 };
 
@@ -4,6 +4,16 @@
 
 namespace geometry {
 
+/**
+ * @brief Concrete shape type tag, used to dispatch without RTTI
+ */
+enum class ShapeKind {
+    Circle,
+    Rectangle,
+    Triangle,
+    Path
+};
+
 /**
  * @brief Abstract base class for geometric shapes
  */
@@ -29,6 +39,12 @@ public:
      */
     virtual std::string name() const = 0;
     
+    /**
+     * @brief Get the concrete kind of the shape
+     * @return Shape kind tag
+     */
+    virtual ShapeKind kind() const = 0;
+    
     /**
      * @brief Check if the shape is valid
      * @return True if valid, false otherwise
@@ -2,6 +2,7 @@
 
 #include "shape.h"
 #include <cmath>
+#include <tuple>
 
 namespace geometry {
 
@@ -53,6 +54,7 @@ public:
     double area() const override;
     double perimeter() const override;
     std::string name() const override;
+    ShapeKind kind() const override { return ShapeKind::Triangle; }
     bool isValid() const override;
 
 private:
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "shape_value.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace geometry {
+
+/**
+ * @brief Compact calculator for collections of a few shapes
+ *
+ * Shapes are stored by value (ShapeValue) in an inline buffer of
+ * InlineCapacity entries; nothing is allocated on the heap until the
+ * buffer overflows, after which storage grows geometrically. Intended for
+ * holding millions of calculators with a handful of unplaced shapes each,
+ * where GeometryCalculator's per-instance vectors, statistics and one heap
+ * block per shape dominate memory. Paths are not supported.
+ *
+ * @tparam InlineCapacity Number of shapes stored without heap allocation
+ */
+template <size_t InlineCapacity = 8>
+class SmallGeometryCalculator {
+    static_assert(InlineCapacity > 0, "Inline capacity must be positive");
+
+private:
+    ShapeValue inline_[InlineCapacity];
+    std::unique_ptr<ShapeValue[]> heap_;
+    uint32_t size_ = 0;
+    uint32_t capacity_ = static_cast<uint32_t>(InlineCapacity);
+
+    ShapeValue* data() { return heap_ ? heap_.get() : inline_; }
+    const ShapeValue* data() const { return heap_ ? heap_.get() : inline_; }
+
+    void grow() {
+        if (capacity_ > std::numeric_limits<uint32_t>::max() / 2) {
+            throw std::length_error("Too many shapes");
+        }
+        uint32_t capacity = capacity_ * 2;
+        auto storage = std::make_unique<ShapeValue[]>(capacity);
+        std::copy(data(), data() + size_, storage.get());
+        heap_ = std::move(storage);
+        capacity_ = capacity;
+    }
+
+public:
+    SmallGeometryCalculator() = default;
+
+    SmallGeometryCalculator(const SmallGeometryCalculator& other) { *this = other; }
+
+    SmallGeometryCalculator& operator=(const SmallGeometryCalculator& other) {
+        if (this != &other) {
+            clear();
+            if (other.size_ > InlineCapacity) {
+                heap_ = std::make_unique<ShapeValue[]>(other.size_);
+                capacity_ = other.size_;
+            }
+            std::copy(other.data(), other.data() + other.size_, data());
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    SmallGeometryCalculator(SmallGeometryCalculator&& other) noexcept { *this = std::move(other); }
+
+    SmallGeometryCalculator& operator=(SmallGeometryCalculator&& other) noexcept {
+        if (this != &other) {
+            heap_ = std::move(other.heap_);
+            if (!heap_) {
+                std::copy(other.inline_, other.inline_ + other.size_, inline_);
+            }
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.size_ = 0;
+            other.capacity_ = static_cast<uint32_t>(InlineCapacity);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Add a shape value
+     * @param shape Shape to add
+     */
+    void addShape(const ShapeValue& shape) {
+        if (size_ == capacity_) {
+            grow();
+        }
+        data()[size_++] = shape;
+    }
+
+    /**
+     * @brief Add a copy of a shape object (ignored if null or invalid)
+     * @param shape Circle, rectangle or triangle
+     * @throws std::invalid_argument For paths
+     */
+    void addShape(const std::unique_ptr<Shape>& shape) {
+        if (shape && shape->isValid()) {
+            addShape(ShapeValue::fromShape(*shape));
+        }
+    }
+
+    /**
+     * @brief Get the number of shapes
+     * @return Number of shapes
+     */
+    size_t shapeCount() const { return size_; }
+
+    /**
+     * @brief Check whether the shapes still fit in the inline buffer
+     * @return True if no heap storage is in use
+     */
+    bool isInline() const { return !heap_; }
+
+    /**
+     * @brief Calculate total area of all shapes
+     * @return Sum of all areas
+     */
+    double totalArea() const {
+        double total = 0.0;
+        const ShapeValue* shapes = data();
+        for (uint32_t i = 0; i < size_; ++i) {
+            total += shapes[i].area();
+        }
+        return total;
+    }
+
+    /**
+     * @brief Calculate total perimeter of all shapes
+     * @return Sum of all perimeters
+     */
+    double totalPerimeter() const {
+        double total = 0.0;
+        const ShapeValue* shapes = data();
+        for (uint32_t i = 0; i < size_; ++i) {
+            total += shapes[i].perimeter();
+        }
+        return total;
+    }
+
+    /**
+     * @brief Get shape by index
+     * @param index Shape index
+     * @return Pointer to the shape value (nullptr if invalid index)
+     */
+    const ShapeValue* getShape(size_t index) const {
+        return index < size_ ? data() + index : nullptr;
+    }
+
+    /**
+     * @brief Remove all shapes and release heap storage
+     */
+    void clear() {
+        heap_.reset();
+        size_ = 0;
+        capacity_ = static_cast<uint32_t>(InlineCapacity);
+    }
+};
+
+} // namespace geometry
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Work-stealing thread pool
+ *
+ * Every worker owns a deque of tasks. Tasks submitted from a worker go to
+ * the back of its own deque and are popped from the back (most recent
+ * first, cache-warm); idle workers steal from the front of other deques.
+ * Tasks submitted from outside the pool are spread round-robin.
+ */
+class TaskPool {
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> next_queue_{0};
+    bool stopping_ = false;
+
+    bool takeTask(size_t home, std::function<void()>& task);
+    void workerLoop(size_t index);
+
+public:
+    /**
+     * @brief Start the worker threads
+     * @param threads Number of workers (at least one is started)
+     */
+    explicit TaskPool(size_t threads = workerCount());
+
+    /**
+     * @brief Finish the queued tasks and join the workers
+     */
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    /**
+     * @brief Queue a task for execution
+     * @param task Callable to run on a worker; it must not throw
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Run one queued task on the calling thread, if there is one
+     * @return True if a task was run
+     */
+    bool runPending();
+
+    /**
+     * @brief Check whether the calling thread is one of this pool's workers
+     * @return True on a worker thread
+     */
+    bool onWorkerThread() const;
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Worker count
+     */
+    size_t threadCount() const { return threads_.size(); }
+};
+
+/**
+ * @brief Dependency graph of tasks executed on a TaskPool
+ *
+ * A node is either a single task or a chunked task made of independent
+ * chunk-level tasks. Edges come in two forms:
+ * - precede(a, b): b starts once all of a has completed
+ * - stream(a, b): chunk i of b starts as soon as chunk i of a completes, so
+ *   consecutive stages overlap instead of running as separate phases
+ *
+ * Chunks of an ordered node additionally run one after another, which
+ * lets a stage commit results in input order while its neighbours stay
+ * parallel. The graph can be run any number of times.
+ */
+class TaskGraph {
+public:
+    using NodeId = size_t;
+
+private:
+    struct Task {
+        std::function<void()> body;
+        std::vector<size_t> successors;
+        size_t dependencies = 0;
+        size_t node = 0;  ///< Node the task belongs to
+    };
+
+    struct Node {
+        std::string name;
+        size_t first_task;
+        size_t chunks;
+        size_t join_task;  ///< Completes when every chunk has completed
+    };
+
+    struct RunState;
+
+    std::vector<Task> tasks_;
+    std::vector<Node> nodes_;
+
+    const Node& node(NodeId id) const;
+    void addEdge(size_t from, size_t to);
+    void execute(size_t task, RunState& state, TaskPool& pool) const;
+
+public:
+    /**
+     * @brief Add a single task
+     * @param name Node name, used in error messages
+     * @param body Callable run once per graph execution
+     * @return Node id
+     */
+    NodeId addTask(std::string name, std::function<void()> body);
+
+    /**
+     * @brief Add a task split into independent chunks
+     * @param name Node name, used in error messages
+     * @param chunks Number of chunks (must be positive)
+     * @param body Callable invoked as body(size_t chunk)
+     * @param ordered If true, chunk i starts only after chunk i - 1
+     * @return Node id
+     */
+    NodeId addChunkedTask(std::string name, size_t chunks,
+                          std::function<void(size_t)> body, bool ordered = false);
+
+    /**
+     * @brief Make a node wait for another node to complete
+     * @param before Node that must complete first
+     * @param after Node that waits
+     */
+    void precede(NodeId before, NodeId after);
+
+    /**
+     * @brief Connect two nodes chunk by chunk
+     * @param upstream Producing node
+     * @param downstream Consuming node with the same number of chunks
+     */
+    void stream(NodeId upstream, NodeId downstream);
+
+    /**
+     * @brief Execute the graph and wait for it to complete
+     *
+     * Once a task throws, tasks that have not started yet are skipped and
+     * the first exception is rethrown here.
+     *
+     * @param pool Pool running the tasks
+     * @throws std::invalid_argument If the graph contains a cycle
+     */
+    void run(TaskPool& pool);
+
+    /**
+     * @brief Get the number of nodes
+     * @return Node count
+     */
+    size_t nodeCount() const { return nodes_.size(); }
+
+    /**
+     * @brief Get the number of chunk-level tasks
+     * @return Task count, including internal join tasks
+     */
+    size_t taskCount() const { return tasks_.size(); }
+
+    /**
+     * @brief Get the name of a node
+     * @param id Node id
+     * @return Node name
+     */
+    const std::string& name(NodeId id) const { return node(id).name; }
+
+    /**
+     * @brief Get the number of chunks of a node
+     * @param id Node id
+     * @return Chunk count (1 for single tasks)
+     */
+    size_t chunkCount(NodeId id) const { return node(id).chunks; }
+};
+
+} // namespace geometry
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Instrumentation of internal parallel work is compiled in only when
+ * GEOMETRY_ENABLE_TRACING is non-zero (CMake option of the same name).
+ * The recording API below is always available.
+ */
+#ifndef GEOMETRY_ENABLE_TRACING
+#define GEOMETRY_ENABLE_TRACING 0
+#endif
+
+#define GEOMETRY_TRACE_CONCAT_INNER(a, b) a##b
+#define GEOMETRY_TRACE_CONCAT(a, b) GEOMETRY_TRACE_CONCAT_INNER(a, b)
+
+#if GEOMETRY_ENABLE_TRACING
+/// Record the enclosing scope as a trace event; arguments are not evaluated when disabled
+#define GEOMETRY_TRACE_SCOPE(category, name, arg) \
+    ::geometry::TraceScope GEOMETRY_TRACE_CONCAT(trace_scope_, __LINE__)(category, name, arg)
+#else
+#define GEOMETRY_TRACE_SCOPE(category, name, arg) static_cast<void>(0)
+#endif
+
+namespace geometry {
+
+/**
+ * @brief Enable or pause recording (enabled by default)
+ * @param enabled True to record events
+ */
+void setTracingEnabled(bool enabled);
+
+/**
+ * @brief Check whether events are recorded
+ * @return True if recording
+ */
+bool tracingEnabled();
+
+/**
+ * @brief Set the number of events kept per thread, discarding recorded events
+ *
+ * Each thread records into its own ring buffer; once full, the oldest
+ * events are overwritten. Buffers of exited threads are reused by new
+ * threads, so short-lived worker threads do not accumulate buffers.
+ *
+ * @param events Ring buffer capacity (at least 1)
+ */
+void setTraceBufferCapacity(size_t events);
+
+/**
+ * @brief Get the monotonic trace clock
+ * @return Nanoseconds since the first use of the trace clock
+ */
+uint64_t traceClock();
+
+/**
+ * @brief Record a completed event in the calling thread's ring buffer
+ * @param category Category literal (must outlive the trace)
+ * @param name Event name (copied, truncated to 47 characters)
+ * @param start_ns Start time from traceClock()
+ * @param duration_ns Duration in nanoseconds
+ * @param arg Event argument, e.g. a chunk index
+ */
+void recordTraceEvent(const char* category, const char* name, uint64_t start_ns,
+                      uint64_t duration_ns, uint64_t arg);
+
+/**
+ * @brief Get the number of events currently held in all ring buffers
+ * @return Event count
+ */
+size_t traceEventCount();
+
+/**
+ * @brief Discard all recorded events
+ */
+void clearTrace();
+
+/**
+ * @brief Format the recorded events as Chrome trace-event JSON
+ *
+ * The result loads in chrome://tracing and Perfetto. Each ring buffer
+ * appears as one thread. Call while traced work is idle to get a
+ * consistent snapshot.
+ *
+ * @return JSON object with a traceEvents array
+ */
+std::string traceJson();
+
+/**
+ * @brief Records the lifetime of a scope as one trace event
+ */
+class TraceScope {
+private:
+    const char* category_;
+    const char* name_;
+    uint64_t arg_;
+    uint64_t start_ = 0;
+    bool active_;
+
+public:
+    /**
+     * @brief Start timing a scope
+     * @param category Category literal
+     * @param name Event name (must stay valid until the scope ends)
+     * @param arg Event argument
+     */
+    TraceScope(const char* category, const char* name, uint64_t arg = 0)
+        : category_(category), name_(name), arg_(arg), active_(tracingEnabled()) {
+        if (active_) {
+            start_ = traceClock();
+        }
+    }
+
+    ~TraceScope() {
+        if (active_) {
+            recordTraceEvent(category_, name_, start_, traceClock() - start_, arg_);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+} // namespace geometry
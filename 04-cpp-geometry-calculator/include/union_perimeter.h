@@ -0,0 +1,82 @@
+#pragma once
+
+#include "deadline.h"
+#include "placement.h"
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Perimeter of the union of placed shapes
+ *
+ * Shapes are first grouped into connected clusters of overlapping bounding
+ * boxes (see overlappingPairs()); clusters are independent and are
+ * processed in parallel. Clusters made only of rectangles use an exact
+ * O(n log n) sweep line with a segment tree. In other clusters curves are
+ * approximated by chords within tolerance, each chord weighted by the
+ * curve length it stands for, and every outline edge is clipped against
+ * its overlapping neighbours: an interval tree over each outline's edges
+ * yields the few edges near it, where it is split, and the edges a
+ * horizontal line through each piece crosses, which classify the piece.
+ * For E edges in a cluster this costs O(E log E) plus O(d (log E + c)) per
+ * edge, where d is the number of neighbours whose box the edge meets and c
+ * the number of their edges near it (a handful unless outlines run along
+ * each other). Since E grows as tolerance^-1/2 per curve, tight tolerances
+ * are paid for linearly, not quadratically.
+ *
+ * Boundary shared by two touching shapes is interior to the union and is
+ * not counted; coincident edges facing the same way are counted once.
+ *
+ * @param shapes Placed shapes
+ * @param tolerance Maximum deviation allowed for curved boundaries
+ * @return Length of the outer and inner contours of the union
+ */
+double unionPerimeter(const std::vector<PlacedShape>& shapes, double tolerance = 1e-6);
+
+/**
+ * @brief Perimeter of the union of placed shapes, within a deadline
+ *
+ * Clusters are computed in a spread-out order and stop being started once
+ * the deadline expires; the estimate extrapolates the finished clusters by
+ * shape count. The cluster decomposition itself (the sweep of
+ * overlappingPairs()) always runs to completion.
+ *
+ * @param shapes Placed shapes
+ * @param deadline Deadline or cancellation token
+ * @param tolerance Maximum deviation allowed for curved boundaries
+ * @return Exact perimeter, or partial perimeter with coverage and estimate
+ */
+PartialResult unionPerimeter(const std::vector<PlacedShape>& shapes, const Deadline& deadline,
+                             double tolerance = 1e-6);
+
+/**
+ * @brief Exact perimeter of a union of axis-aligned rectangles
+ * @param rects Rectangles given as bounding boxes
+ * @return Union perimeter
+ */
+double rectangleUnionPerimeter(const std::vector<BoundingBox>& rects);
+
+/**
+ * @brief Find all pairs of intersecting (or touching) boxes
+ *
+ * Sweeps over x, keeping the boxes the sweep line crosses in an ordered
+ * set by lower y and a segment tree over y for stabbing queries, so n
+ * boxes with k overlapping pairs cost O((n + k) log n).
+ *
+ * @param boxes Boxes to test
+ * @return Index pairs (i, j) with i < j
+ */
+std::vector<std::pair<size_t, size_t>> overlappingPairs(const std::vector<BoundingBox>& boxes);
+
+/**
+ * @brief Group boxes into connected components of the overlap graph
+ * @param boxes Boxes to group
+ * @param pairs Overlapping pairs, as returned by overlappingPairs()
+ * @return Clusters of box indices, each sorted ascending
+ */
+std::vector<std::vector<size_t>> overlapClusters(
+    const std::vector<BoundingBox>& boxes,
+    const std::vector<std::pair<size_t, size_t>>& pairs);
+
+} // namespace geometry
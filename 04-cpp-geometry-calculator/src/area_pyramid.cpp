@@ -0,0 +1,212 @@
+#include "area_pyramid.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t kMaxLevels = 16;
+
+/**
+ * @brief Tile ranges of a region along one axis (inclusive, empty when lo > hi)
+ */
+struct AxisRanges {
+    long outer_lo;
+    long outer_hi;
+    long inner_lo;
+    long inner_hi;
+};
+
+long toIndex(double value, long lo, long hi) {
+    return static_cast<long>(std::min(std::max(value, static_cast<double>(lo)), static_cast<double>(hi)));
+}
+
+AxisRanges axisRanges(double lo, double hi, double world_lo, double world_hi, size_t tiles) {
+    double scale = static_cast<double>(tiles) / (world_hi - world_lo);
+    double u0 = (lo - world_lo) * scale;
+    double u1 = (hi - world_lo) * scale;
+    long last = static_cast<long>(tiles) - 1;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    AxisRanges ranges;
+    ranges.outer_lo = toIndex(std::floor(u0), 0, last);
+    ranges.outer_hi = toIndex(std::floor(u1), 0, last);
+    // Edge tiles extend without bound, so only unbounded regions contain them
+    ranges.inner_lo = u0 == -inf ? 0 : toIndex(std::ceil(u0), 1, last + 1);
+    ranges.inner_hi = u1 == inf ? last : toIndex(std::floor(u1) - 1.0, -1, last - 1);
+    return ranges;
+}
+
+void addChannels(const double* values, double sign, RegionTotals& totals) {
+    totals.count += sign * values[0];
+    totals.area += sign * values[1];
+    for (size_t k = 0; k < kShapeKindCount; ++k) {
+        totals.kind_count[k] += sign * values[2 + k];
+        totals.kind_area[k] += sign * values[2 + kShapeKindCount + k];
+    }
+}
+
+} // namespace
+
+AreaPyramid::AreaPyramid(const BoundingBox& bounds, size_t levels, size_t max_pending)
+    : bounds_(bounds), max_pending_(max_pending) {
+    if (!(bounds.max_x > bounds.min_x) || !(bounds.max_y > bounds.min_y) ||
+        !std::isfinite(bounds.max_x - bounds.min_x) || !std::isfinite(bounds.max_y - bounds.min_y)) {
+        throw std::invalid_argument("Pyramid bounds must be finite and non-empty");
+    }
+    if (levels == 0 || levels > kMaxLevels) {
+        throw std::invalid_argument("Pyramid needs between 1 and 16 levels");
+    }
+    levels_.resize(levels);
+    for (size_t l = 0; l < levels; ++l) {
+        Level& level = levels_[l];
+        level.size = size_t{1} << l;
+        level.tiles.assign(level.size * level.size * kChannels, 0.0);
+        level.table.assign((level.size + 1) * (level.size + 1) * kChannels, 0.0);
+    }
+}
+
+AreaPyramid::Entry AreaPyramid::entryFor(const PlacedShape& placed) const {
+    BoundingBox box = placedBounds(placed);
+    size_t tiles = levels_.back().size;
+    long last = static_cast<long>(tiles) - 1;
+    double cx = (box.min_x + box.max_x) / 2.0;
+    double cy = (box.min_y + box.max_y) / 2.0;
+
+    Entry entry;
+    entry.tile_x = static_cast<size_t>(toIndex(
+        std::floor((cx - bounds_.min_x) * tiles / (bounds_.max_x - bounds_.min_x)), 0, last));
+    entry.tile_y = static_cast<size_t>(toIndex(
+        std::floor((cy - bounds_.min_y) * tiles / (bounds_.max_y - bounds_.min_y)), 0, last));
+
+    size_t kind = static_cast<size_t>(placed.shape->kind());
+    double area = placed.shape->area();
+    entry.values[0] = 1.0;
+    entry.values[1] = area;
+    entry.values[2 + kind] = 1.0;
+    entry.values[2 + kShapeKindCount + kind] = area;
+    return entry;
+}
+
+void AreaPyramid::add(const Entry& entry) {
+    size_t finest = levels_.size() - 1;
+    for (size_t l = 0; l < levels_.size(); ++l) {
+        Level& level = levels_[l];
+        size_t x = entry.tile_x >> (finest - l);
+        size_t y = entry.tile_y >> (finest - l);
+        double* tile = &level.tiles[(y * level.size + x) * kChannels];
+        for (size_t c = 0; c < kChannels; ++c) {
+            tile[c] += entry.values[c];
+        }
+    }
+}
+
+void AreaPyramid::rebuildTables() {
+    for (Level& level : levels_) {
+        size_t n = level.size;
+        size_t stride = (n + 1) * kChannels;
+        double* table = level.table.data();
+        const double* tiles = level.tiles.data();
+
+        // Row prefix sums, then column prefix sums, each parallel across lines
+        parallelFor(n, [&](size_t y) {
+            double* row = table + (y + 1) * stride;
+            const double* source = tiles + y * n * kChannels;
+            for (size_t x = 0; x < n; ++x) {
+                for (size_t c = 0; c < kChannels; ++c) {
+                    row[(x + 1) * kChannels + c] = row[x * kChannels + c] + source[x * kChannels + c];
+                }
+            }
+        }, 16);
+        parallelFor(n, [&](size_t x) {
+            for (size_t y = 1; y < n; ++y) {
+                double* cell = table + (y + 1) * stride + (x + 1) * kChannels;
+                const double* above = cell - stride;
+                for (size_t c = 0; c < kChannels; ++c) {
+                    cell[c] += above[c];
+                }
+            }
+        }, 16);
+    }
+    pending_.clear();
+}
+
+void AreaPyramid::build(const std::vector<PlacedShape>& shapes) {
+    std::vector<Entry> entries(shapes.size());
+    parallelFor(shapes.size(), [&](size_t i) { entries[i] = entryFor(shapes[i]); }, 256);
+
+    size_t finest = levels_.size() - 1;
+    parallelFor(levels_.size(), [&](size_t l) {
+        Level& level = levels_[l];
+        std::fill(level.tiles.begin(), level.tiles.end(), 0.0);
+        for (const Entry& entry : entries) {
+            size_t x = entry.tile_x >> (finest - l);
+            size_t y = entry.tile_y >> (finest - l);
+            double* tile = &level.tiles[(y * level.size + x) * kChannels];
+            for (size_t c = 0; c < kChannels; ++c) {
+                tile[c] += entry.values[c];
+            }
+        }
+    });
+    rebuildTables();
+}
+
+void AreaPyramid::insert(const PlacedShape& placed) {
+    Entry entry = entryFor(placed);
+    add(entry);
+    pending_.push_back(entry);
+    if (pending_.size() >= max_pending_) {
+        rebuildTables();
+    }
+}
+
+void AreaPyramid::flush() {
+    if (!pending_.empty()) {
+        rebuildTables();
+    }
+}
+
+void AreaPyramid::accumulate(const Level& level, size_t x0, size_t y0, size_t x1, size_t y1,
+                             RegionTotals& totals) const {
+    size_t stride = (level.size + 1) * kChannels;
+    const double* table = level.table.data();
+    addChannels(table + (y1 + 1) * stride + (x1 + 1) * kChannels, 1.0, totals);
+    addChannels(table + y0 * stride + (x1 + 1) * kChannels, -1.0, totals);
+    addChannels(table + (y1 + 1) * stride + x0 * kChannels, -1.0, totals);
+    addChannels(table + y0 * stride + x0 * kChannels, 1.0, totals);
+}
+
+RegionAggregate AreaPyramid::query(const BoundingBox& region, size_t level_index) const {
+    const Level& level = levels_.at(level_index);
+    RegionAggregate result;
+    if (!(region.min_x <= region.max_x) || !(region.min_y <= region.max_y)) {
+        return result;
+    }
+
+    AxisRanges x = axisRanges(region.min_x, region.max_x, bounds_.min_x, bounds_.max_x, level.size);
+    AxisRanges y = axisRanges(region.min_y, region.max_y, bounds_.min_y, bounds_.max_y, level.size);
+    bool inner = x.inner_lo <= x.inner_hi && y.inner_lo <= y.inner_hi;
+    accumulate(level, x.outer_lo, y.outer_lo, x.outer_hi, y.outer_hi, result.outer);
+    if (inner) {
+        accumulate(level, x.inner_lo, y.inner_lo, x.inner_hi, y.inner_hi, result.inner);
+    }
+
+    size_t shift = levels_.size() - 1 - level_index;
+    for (const Entry& entry : pending_) {
+        long tx = static_cast<long>(entry.tile_x >> shift);
+        long ty = static_cast<long>(entry.tile_y >> shift);
+        if (tx >= x.outer_lo && tx <= x.outer_hi && ty >= y.outer_lo && ty <= y.outer_hi) {
+            addChannels(entry.values.data(), 1.0, result.outer);
+        }
+        if (inner && tx >= x.inner_lo && tx <= x.inner_hi && ty >= y.inner_lo && ty <= y.inner_hi) {
+            addChannels(entry.values.data(), 1.0, result.inner);
+        }
+    }
+    return result;
+}
+
+} // namespace geometry
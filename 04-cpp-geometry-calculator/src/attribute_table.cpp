@@ -0,0 +1,336 @@
+#include "attribute_table.h"
+#include "parallel.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t kMaxCategories = size_t{std::numeric_limits<uint16_t>::max()} + 1;
+
+/**
+ * @brief Weight resolved to a column, or to no column for a constant weight
+ */
+struct Term {
+    const SegmentedVector<double>* column;
+    double factor;
+
+    /// Values of a segment, and their stride (0 for a constant weight)
+    std::pair<const double*, size_t> segment(size_t s) const {
+        static const double one = 1.0;
+        return column ? std::make_pair(column->segment(s), size_t{1}) : std::make_pair(&one, size_t{0});
+    }
+};
+
+} // namespace
+
+uint16_t AttributeTable::Column::intern(const std::string& category) {
+    auto it = lookup.find(category);
+    if (it != lookup.end()) {
+        return it->second;
+    }
+    if (dictionary.size() >= kMaxCategories) {
+        throw std::length_error("Too many categories in attribute column");
+    }
+    uint16_t code = static_cast<uint16_t>(dictionary.size());
+    dictionary.push_back(category);
+    lookup.emplace(category, code);
+    return code;
+}
+
+AttributeTable::Column& AttributeTable::column(const std::string& name, bool categorical) {
+    return const_cast<Column&>(std::as_const(*this).column(name, categorical));
+}
+
+const AttributeTable::Column& AttributeTable::column(const std::string& name, bool categorical) const {
+    auto it = columns_.find(name);
+    if (it == columns_.end()) {
+        throw std::invalid_argument("Unknown attribute column: " + name);
+    }
+    if (it->second.categorical != categorical) {
+        throw std::invalid_argument("Attribute column " + name + " is " +
+                                    (it->second.categorical ? "categorical" : "numeric"));
+    }
+    return it->second;
+}
+
+void AttributeTable::requireCategories(const std::string& name,
+                                       const std::unordered_set<std::string>& categories) const {
+    const Column& target = column(name, true);
+    size_t added = 0;
+    for (const std::string& category : categories) {
+        added += target.lookup.count(category) == 0;
+    }
+    if (target.dictionary.size() + added > kMaxCategories) {
+        throw std::length_error("Too many categories in attribute column");
+    }
+}
+
+void AttributeTable::checkRow(size_t row) const {
+    if (row >= rowCount()) {
+        throw std::out_of_range("Shape index out of range");
+    }
+}
+
+void AttributeTable::addNumeric(const std::string& name, double default_value) {
+    if (name.empty() || has(name)) {
+        throw std::invalid_argument("Attribute column names must be unique and non-empty");
+    }
+    Column& column = columns_[name];
+    column.default_number = default_value;
+    column.numbers.assign(rowCount(), default_value);
+}
+
+void AttributeTable::addCategorical(const std::string& name, const std::string& default_category) {
+    if (name.empty() || has(name)) {
+        throw std::invalid_argument("Attribute column names must be unique and non-empty");
+    }
+    Column& column = columns_[name];
+    column.categorical = true;
+    column.default_code = column.intern(default_category);
+    column.codes.assign(rowCount(), column.default_code);
+}
+
+bool AttributeTable::drop(const std::string& name) {
+    return columns_.erase(name) != 0;
+}
+
+void AttributeTable::set(size_t row, const std::string& name, double value) {
+    checkRow(row);
+    column(name, false).numbers[row] = value;
+}
+
+void AttributeTable::set(size_t row, const std::string& name, const std::string& category) {
+    checkRow(row);
+    Column& target = column(name, true);
+    target.codes[row] = target.intern(category);
+}
+
+double AttributeTable::number(size_t row, const std::string& name) const {
+    checkRow(row);
+    return column(name, false).numbers[row];
+}
+
+const std::string& AttributeTable::category(size_t row, const std::string& name) const {
+    checkRow(row);
+    const Column& source = column(name, true);
+    return source.dictionary[source.codes[row]];
+}
+
+void AttributeTable::appendRow(double area, double perimeter) {
+    area_.push_back(area);
+    perimeter_.push_back(perimeter);
+    for (auto& [name, column] : columns_) {
+        if (column.categorical) {
+            column.codes.push_back(column.default_code);
+        } else {
+            column.numbers.push_back(column.default_number);
+        }
+    }
+}
+
+void AttributeTable::setMetrics(size_t row, double area, double perimeter) {
+    checkRow(row);
+    area_[row] = area;
+    perimeter_[row] = perimeter;
+}
+
+void AttributeTable::eraseRow(size_t row) {
+    checkRow(row);
+    area_.erase(row);
+    perimeter_.erase(row);
+    for (auto& [name, column] : columns_) {
+        if (column.categorical) {
+            column.codes.erase(row);
+        } else {
+            column.numbers.erase(row);
+        }
+    }
+}
+
+void AttributeTable::eraseRows(const std::vector<size_t>& rows) {
+    area_.eraseSorted(rows);
+    perimeter_.eraseSorted(rows);
+    for (auto& [name, column] : columns_) {
+        if (column.categorical) {
+            column.codes.eraseSorted(rows);
+        } else {
+            column.numbers.eraseSorted(rows);
+        }
+    }
+}
+
+void AttributeTable::checkAppend(const AttributeTable& other) const {
+    for (const auto& [name, theirs] : other.columns_) {
+        auto it = columns_.find(name);
+        if (it != columns_.end() && it->second.categorical != theirs.categorical) {
+            throw std::invalid_argument("Attribute column " + name + " has different types");
+        }
+    }
+    for (const auto& [name, theirs] : other.columns_) {
+        if (theirs.categorical && has(name)) {
+            requireCategories(name, std::unordered_set<std::string>(theirs.dictionary.begin(),
+                                                                    theirs.dictionary.end()));
+        }
+    }
+}
+
+void AttributeTable::append(const AttributeTable& other) {
+    checkAppend(other);
+    size_t old_rows = rowCount();
+
+    // checkAppend() made room for every category re-coded here
+    std::unordered_map<std::string, std::vector<uint16_t>> recode;
+    for (const auto& [name, theirs] : other.columns_) {
+        auto it = columns_.find(name);
+        if (theirs.categorical && it != columns_.end()) {
+            std::vector<uint16_t>& codes = recode[name];
+            for (const std::string& category : theirs.dictionary) {
+                codes.push_back(it->second.intern(category));
+            }
+        }
+    }
+    for (const auto& [name, theirs] : other.columns_) {
+        if (!has(name)) {
+            Column& column = columns_[name];
+            column.categorical = theirs.categorical;
+            column.default_number = theirs.default_number;
+            column.dictionary = theirs.dictionary;
+            column.lookup = theirs.lookup;
+            column.default_code = theirs.default_code;
+            column.numbers.assign(theirs.categorical ? 0 : old_rows, theirs.default_number);
+            column.codes.assign(theirs.categorical ? old_rows : 0, theirs.default_code);
+        }
+    }
+
+    for (size_t i = 0; i < other.rowCount(); ++i) {
+        area_.push_back(other.area_[i]);
+        perimeter_.push_back(other.perimeter_[i]);
+    }
+    for (auto& [name, column] : columns_) {
+        auto it = other.columns_.find(name);
+        if (it == other.columns_.end()) {
+            if (column.categorical) {
+                column.codes.resize(rowCount(), column.default_code);
+            } else {
+                column.numbers.resize(rowCount(), column.default_number);
+            }
+        } else if (!column.categorical) {
+            for (size_t i = 0; i < it->second.numbers.size(); ++i) {
+                column.numbers.push_back(it->second.numbers[i]);
+            }
+        } else {
+            auto codes = recode.find(name);
+            for (size_t i = 0; i < it->second.codes.size(); ++i) {
+                uint16_t code = it->second.codes[i];
+                column.codes.push_back(codes == recode.end() ? code : codes->second[code]);
+            }
+        }
+    }
+}
+
+AttributeTable AttributeTable::select(const std::vector<size_t>& rows) const {
+    AttributeTable result;
+    result.reserve(rows.size());
+    for (size_t row : rows) {
+        result.area_.push_back(area_[row]);
+        result.perimeter_.push_back(perimeter_[row]);
+    }
+    for (const auto& [name, source] : columns_) {
+        Column& column = result.columns_[name];
+        column.categorical = source.categorical;
+        column.default_number = source.default_number;
+        column.dictionary = source.dictionary;
+        column.lookup = source.lookup;
+        column.default_code = source.default_code;
+        for (size_t row : rows) {
+            if (source.categorical) {
+                column.codes.push_back(source.codes[row]);
+            } else {
+                column.numbers.push_back(source.numbers[row]);
+            }
+        }
+    }
+    return result;
+}
+
+void AttributeTable::clearRows() {
+    area_.clear();
+    perimeter_.clear();
+    for (auto& [name, column] : columns_) {
+        column.codes.clear();
+        column.numbers.clear();
+    }
+}
+
+void AttributeTable::reserve(size_t count) {
+    area_.reserve(count);
+    perimeter_.reserve(count);
+    for (auto& [name, column] : columns_) {
+        if (column.categorical) {
+            column.codes.reserve(count);
+        } else {
+            column.numbers.reserve(count);
+        }
+    }
+}
+
+GroupedTotals AttributeTable::aggregate(const WeightedAggregate& aggregate) const {
+    auto resolve = [this](const AttributeWeight& weight) {
+        if (weight.column.empty()) {
+            return Term{nullptr, weight.factor};
+        }
+        return Term{&column(weight.column, false).numbers, weight.factor};
+    };
+    Term area = resolve(aggregate.area);
+    Term perimeter = resolve(aggregate.perimeter);
+    Term offset = resolve(aggregate.offset);
+
+    GroupedTotals result;
+    const SegmentedVector<uint16_t>* codes = nullptr;
+    if (aggregate.group_by.empty()) {
+        result.groups.emplace_back();
+    } else {
+        const Column& groups = column(aggregate.group_by, true);
+        result.groups = groups.dictionary;
+        codes = &groups.codes;
+    }
+    size_t group_count = result.groups.size();
+
+    // One fused pass per segment into segment-local sums, combined in order
+    size_t segments = area_.segmentCount();
+    std::vector<double> segment_totals(segments * group_count, 0.0);
+    std::vector<size_t> segment_counts(segments * group_count, 0);
+    parallelFor(segments, [&](size_t s) {
+        double* totals = &segment_totals[s * group_count];
+        size_t* counts = &segment_counts[s * group_count];
+        const double* areas = area_.segment(s);
+        const double* perimeters = perimeter_.segment(s);
+        const uint16_t* groups = codes ? codes->segment(s) : nullptr;
+        auto [area_weights, area_stride] = area.segment(s);
+        auto [perimeter_weights, perimeter_stride] = perimeter.segment(s);
+        auto [offsets, offset_stride] = offset.segment(s);
+        for (size_t i = 0; i < area_.segmentLength(s); ++i) {
+            size_t group = groups ? groups[i] : 0;
+            totals[group] += areas[i] * area.factor * area_weights[i * area_stride] +
+                             perimeters[i] * perimeter.factor * perimeter_weights[i * perimeter_stride] +
+                             offset.factor * offsets[i * offset_stride];
+            ++counts[group];
+        }
+    });
+
+    result.totals.assign(group_count, 0.0);
+    result.counts.assign(group_count, 0);
+    for (size_t s = 0; s < segments; ++s) {
+        for (size_t g = 0; g < group_count; ++g) {
+            result.totals[g] += segment_totals[s * group_count + g];
+            result.counts[g] += segment_counts[s * group_count + g];
+        }
+    }
+    return result;
+}
+
+} // namespace geometry
@@ -0,0 +1,406 @@
+#include "background_index.h"
+#include "tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace geometry {
+
+namespace {
+
+// Shapes read between two cancellation checks
+constexpr size_t kCancelCheckInterval = 256;
+
+struct Build {
+    CancellationToken token;
+    std::shared_ptr<IndexBuildBudget> budget;
+    std::atomic<size_t> read{0};
+    size_t total = 0;
+    bool reading = false;  // Guarded by the state mutex
+    bool done = false;     // Guarded by the state mutex
+};
+
+struct Worker {
+    std::thread thread;
+    std::shared_ptr<Build> build;
+};
+
+} // namespace
+
+void AreaIndex::add(size_t, const Shape& shape, const Point&) {
+    entries_[static_cast<size_t>(shape.kind())].push_back({shape.area(), shape.perimeter()});
+}
+
+void AreaIndex::finish() {
+    for (size_t k = 0; k < kShapeKindCount; ++k) {
+        auto& entries = entries_[k];
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry& a, const Entry& b) { return a.area < b.area; });
+        auto& areas = area_prefix_[k];
+        auto& perimeters = perimeter_prefix_[k];
+        areas.assign(entries.size() + 1, 0.0);
+        perimeters.assign(entries.size() + 1, 0.0);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            areas[i + 1] = areas[i] + entries[i].area;
+            perimeters[i + 1] = perimeters[i] + entries[i].perimeter;
+        }
+    }
+}
+
+std::optional<double> AreaIndex::evaluate(const ShapeQuery& query) const {
+    if (query.aggregate == QueryAggregate::UnionPerimeter) {
+        return std::nullopt;
+    }
+
+    double total = 0.0;
+    for (size_t k = 0; k < kShapeKindCount; ++k) {
+        if ((query.kinds & kindMask(static_cast<ShapeKind>(k))) == 0) {
+            continue;
+        }
+        const auto& entries = entries_[k];
+        auto lo = std::lower_bound(entries.begin(), entries.end(), query.min_area,
+                                   [](const Entry& e, double area) { return e.area < area; });
+        auto hi = std::upper_bound(lo, entries.end(), query.max_area,
+                                   [](double area, const Entry& e) { return area < e.area; });
+        size_t first = static_cast<size_t>(lo - entries.begin());
+        size_t last = static_cast<size_t>(hi - entries.begin());
+
+        switch (query.aggregate) {
+            case QueryAggregate::Count:
+                total += static_cast<double>(last - first);
+                break;
+            case QueryAggregate::TotalArea:
+                total += area_prefix_[k][last] - area_prefix_[k][first];
+                break;
+            case QueryAggregate::TotalPerimeter:
+                total += perimeter_prefix_[k][last] - perimeter_prefix_[k][first];
+                break;
+            case QueryAggregate::UnionPerimeter:
+                break;
+        }
+    }
+    return total;
+}
+
+size_t AreaIndex::bytes() const {
+    size_t total = 0;
+    for (size_t k = 0; k < kShapeKindCount; ++k) {
+        total += entries_[k].capacity() * sizeof(Entry);
+        total += (area_prefix_[k].capacity() + perimeter_prefix_[k].capacity()) * sizeof(double);
+    }
+    return total;
+}
+
+void SpatialIndex::add(size_t index, const Shape& shape, const Point& position) {
+    BoundingBox box = placedBounds({&shape, position});
+    max_width_ = std::max(max_width_, box.max_x - box.min_x);
+    entries_.push_back({box, index});
+}
+
+void SpatialIndex::finish() {
+    std::sort(entries_.begin(), entries_.end(),
+              [](const Entry& a, const Entry& b) { return a.box.min_x < b.box.min_x; });
+}
+
+std::vector<size_t> SpatialIndex::intersecting(const BoundingBox& box) const {
+    // Boxes starting further left than the widest box cannot reach the query;
+    // the slack covers rounding in the subtraction
+    double reach = max_width_ + (std::abs(box.min_x) + max_width_) * 1e-12;
+    double start = box.min_x - reach;
+    auto it = std::partition_point(entries_.begin(), entries_.end(),
+                                   [start](const Entry& e) { return e.box.min_x < start; });
+
+    std::vector<size_t> result;
+    for (; it != entries_.end() && it->box.min_x <= box.max_x; ++it) {
+        if (it->box.intersects(box)) {
+            result.push_back(it->index);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::shared_ptr<IndexBuildBudget> IndexBuildBudget::shared() {
+    static auto budget = std::make_shared<IndexBuildBudget>(size_t{256} << 20);
+    return budget;
+}
+
+bool IndexBuildBudget::acquire(size_t bytes, const CancellationToken& token) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    released_.wait(lock, [&] {
+        return token.cancelled() || in_use_ == 0 || in_use_ + bytes <= limit_;
+    });
+    if (token.cancelled()) {
+        return false;
+    }
+    in_use_ += bytes;
+    return true;
+}
+
+void IndexBuildBudget::release(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_use_ -= std::min(bytes, in_use_);
+    }
+    released_.notify_all();
+}
+
+void IndexBuildBudget::wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    released_.notify_all();
+}
+
+size_t IndexBuildBudget::inUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_use_;
+}
+
+struct BackgroundIndexes::State {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::shared_ptr<IndexBuildBudget> budget = IndexBuildBudget::shared();
+    std::array<bool, kIndexKindCount> requested{};
+    std::array<std::shared_ptr<Build>, kIndexKindCount> builds;
+    std::shared_ptr<const AreaIndex> area;
+    std::shared_ptr<const SpatialIndex> spatial;
+    std::vector<Worker> workers;
+
+    ~State() {
+        std::vector<Worker> remaining;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& worker : workers) {
+                worker.build->token.cancel();
+                worker.build->budget->wake();
+            }
+            builds = {};
+            remaining.swap(workers);
+        }
+        for (auto& worker : remaining) {
+            worker.thread.join();
+        }
+    }
+
+    bool ready(size_t k) const {
+        return k == static_cast<size_t>(IndexKind::Area) ? area != nullptr : spatial != nullptr;
+    }
+
+    /**
+     * @brief Cancel a build and wait until no cancelled build reads the store
+     */
+    void cancel(std::unique_lock<std::mutex>& lock, size_t k) {
+        if (auto build = std::move(builds[k])) {
+            build->token.cancel();
+            build->budget->wake();
+        }
+        changed.wait(lock, [this] {
+            return std::none_of(workers.begin(), workers.end(), [](const Worker& worker) {
+                return worker.build->reading && worker.build->token.cancelled();
+            });
+        });
+    }
+
+    /**
+     * @brief Start building a requested index that is neither ready nor building
+     */
+    void start(size_t k, const ShapeStore& store) {
+        if (!requested[k] || builds[k] || ready(k)) {
+            return;
+        }
+
+        // Reap finished workers
+        auto finished = std::partition(workers.begin(), workers.end(), [](const Worker& worker) {
+            return !worker.build->done;
+        });
+        for (auto it = finished; it != workers.end(); ++it) {
+            it->thread.join();
+        }
+        workers.erase(finished, workers.end());
+
+        auto build = std::make_shared<Build>();
+        build->budget = budget;
+        build->total = store.size();
+        builds[k] = build;
+        if (k == static_cast<size_t>(IndexKind::Area)) {
+            workers.push_back({std::thread([this, k, build, &store] {
+                run<AreaIndex>(k, build, store, &State::area);
+            }), build});
+        } else {
+            workers.push_back({std::thread([this, k, build, &store] {
+                run<SpatialIndex>(k, build, store, &State::spatial);
+            }), build});
+        }
+    }
+
+    /**
+     * @brief Build body: wait for budget, read the store, then sort privately
+     */
+    template <typename Index>
+    void run(size_t k, std::shared_ptr<Build> build, const ShapeStore& store,
+             std::shared_ptr<const Index> State::*slot) {
+        size_t bytes = Index::buildBytes(build->total);
+        std::shared_ptr<Index> index;
+        if (build->budget->acquire(bytes, build->token)) {
+            bool reading;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                reading = build->reading = !build->token.cancelled();
+            }
+            if (reading) {
+                GEOMETRY_TRACE_SCOPE("index",
+                                     k == static_cast<size_t>(IndexKind::Area)
+                                         ? "area index build"
+                                         : "spatial index build",
+                                     build->total);
+                index = std::make_shared<Index>();
+                store.visitFrom(0, [&](size_t i, const Shape& shape, const Point& position) {
+                    if (i % kCancelCheckInterval == 0 && build->token.cancelled()) {
+                        index.reset();
+                        return false;
+                    }
+                    index->add(i, shape, position);
+                    build->read.store(i + 1, std::memory_order_relaxed);
+                    return true;
+                });
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    build->reading = false;
+                }
+                changed.notify_all();
+                if (index && !build->token.cancelled()) {
+                    index->finish();
+                }
+            }
+            build->budget->release(bytes);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (builds[k] == build) {
+                if (index && !build->token.cancelled()) {
+                    this->*slot = std::move(index);
+                }
+                builds[k].reset();
+            }
+            build->done = true;
+        }
+        changed.notify_all();
+    }
+};
+
+BackgroundIndexes::BackgroundIndexes() : state_(std::make_unique<State>()) {}
+
+BackgroundIndexes::~BackgroundIndexes() = default;
+
+BackgroundIndexes::BackgroundIndexes(BackgroundIndexes&& other)
+    : state_(std::make_unique<State>()) {
+    *this = std::move(other);
+}
+
+BackgroundIndexes& BackgroundIndexes::operator=(BackgroundIndexes&& other) {
+    if (this != &other) {
+        {
+            // Other's builds read a store that is about to move
+            std::unique_lock<std::mutex> lock(other.state_->mutex);
+            for (size_t k = 0; k < kIndexKindCount; ++k) {
+                other.state_->cancel(lock, k);
+            }
+        }
+        auto fresh = std::make_unique<State>();
+        fresh->budget = other.state_->budget;
+        state_ = std::move(other.state_);
+        other.state_ = std::move(fresh);
+    }
+    return *this;
+}
+
+void BackgroundIndexes::request(IndexKind kind, const ShapeStore& store) {
+    size_t k = static_cast<size_t>(kind);
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->requested[k] = true;
+    state_->start(k, store);
+}
+
+void BackgroundIndexes::drop(IndexKind kind) {
+    size_t k = static_cast<size_t>(kind);
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->requested[k] = false;
+    state_->cancel(lock, k);
+    if (kind == IndexKind::Area) {
+        state_->area.reset();
+    } else {
+        state_->spatial.reset();
+    }
+}
+
+void BackgroundIndexes::invalidate() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->area.reset();
+    state_->spatial.reset();
+    for (size_t k = 0; k < kIndexKindCount; ++k) {
+        state_->cancel(lock, k);
+    }
+}
+
+void BackgroundIndexes::ensureBuilding(IndexKind kind, const ShapeStore& store) const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->start(static_cast<size_t>(kind), store);
+}
+
+void BackgroundIndexes::setBudget(std::shared_ptr<IndexBuildBudget> budget) {
+    if (!budget) {
+        throw std::invalid_argument("Index build budget must not be null");
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->budget = std::move(budget);
+}
+
+std::shared_ptr<const AreaIndex> BackgroundIndexes::area(const ShapeStore& store) const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->start(static_cast<size_t>(IndexKind::Area), store);
+    return state_->area;
+}
+
+std::shared_ptr<const SpatialIndex> BackgroundIndexes::spatial(const ShapeStore& store) const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->start(static_cast<size_t>(IndexKind::Spatial), store);
+    return state_->spatial;
+}
+
+IndexStatus BackgroundIndexes::status(IndexKind kind) const {
+    size_t k = static_cast<size_t>(kind);
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    IndexStatus status;
+    status.requested = state_->requested[k];
+    status.ready = state_->ready(k);
+    if (const auto& build = state_->builds[k]) {
+        status.building = true;
+        size_t read = build->read.load(std::memory_order_relaxed);
+        status.progress = build->total == 0
+            ? 0.0
+            : static_cast<double>(read) / static_cast<double>(build->total);
+    }
+    if (status.ready) {
+        status.progress = 1.0;
+        status.bytes = kind == IndexKind::Area ? state_->area->bytes() : state_->spatial->bytes();
+    }
+    return status;
+}
+
+bool BackgroundIndexes::wait(IndexKind kind, const ShapeStore& store,
+                             std::chrono::nanoseconds timeout) const {
+    size_t k = static_cast<size_t>(kind);
+    ensureBuilding(kind, store);
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->changed.wait_for(lock, timeout, [&] {
+        return state_->ready(k) || !state_->builds[k];
+    });
+    return state_->ready(k);
+}
+
+} // namespace geometry
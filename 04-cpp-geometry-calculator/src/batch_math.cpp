@@ -0,0 +1,413 @@
+#include "batch_math.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t kBlock = 256;
+
+// Adding and subtracting 1.5 * 2^52 rounds to the nearest integer without a
+// library call, which keeps the reduction loops vectorizable
+constexpr double kRoundShifter = 6755399441055744.0;
+
+// pi/2 as a 33-bit head, so n * head is exact for |n| < 2^20, plus a tail
+constexpr double kTwoOverPi = 6.36619772367581382433e-01;
+constexpr double kPio2Head = 1.57079632673412561417e+00;
+constexpr double kPio2Tail = 6.07710050650619224932e-11;
+constexpr double kMaxReducedAngle = 1647099.0;  // 2^20 * pi/2
+
+// The two-part reduction by n * pi/2 is off by about n * 2^-86 (the tail's
+// rounding and that of n * tail); below n * 2^-31 that error exceeds 2^-55
+// of the reduced angle and a longer pi/2 is needed
+constexpr double kCancellationLimit = 0x1p-31;
+
+// Minimax kernels on [-pi/4, pi/4] from fdlibm: double precision ...
+constexpr double kS1 = -1.66666666666666324348e-01;
+constexpr double kS2 = 8.33333333332248946124e-03;
+constexpr double kS3 = -1.98412698298579493134e-04;
+constexpr double kS4 = 2.75573137070700676789e-06;
+constexpr double kS5 = -2.50507602534068634195e-08;
+constexpr double kS6 = 1.58969099521155010221e-10;
+constexpr double kC1 = 4.16666666666666019037e-02;
+constexpr double kC2 = -1.38888888888741095749e-03;
+constexpr double kC3 = 2.48015872894767294178e-05;
+constexpr double kC4 = -2.75573143513906633035e-07;
+constexpr double kC5 = 2.08757232129817482790e-09;
+constexpr double kC6 = -1.13596475577881948265e-11;
+
+// ... and single precision, evaluated in double
+constexpr double kFastS1 = -0.166666666416265235595;
+constexpr double kFastS2 = 0.0083333293858894631756;
+constexpr double kFastS3 = -0.000198393348360966317347;
+constexpr double kFastS4 = 0.0000027183114939898219064;
+constexpr double kFastC0 = -0.499999997251031003120;
+constexpr double kFastC1 = 0.0416666233237390631894;
+constexpr double kFastC2 = -0.00138867637746099294692;
+constexpr double kFastC3 = 0.0000243904487962774090654;
+
+// atan(u) = u - u * p(u^2) on |u| < 7/16, again from fdlibm
+constexpr double kAtan[11] = {
+    3.33333333333329318027e-01,  -1.99999999998764832476e-01, 1.42857142725034663711e-01,
+    -1.11111104054623557880e-01, 9.09088713343650656196e-02,  -7.69187620504482999495e-02,
+    6.66107313738753120669e-02,  -5.83357013379057348645e-02, 4.97687799461593236017e-02,
+    -3.65315727442169155270e-02, 1.62858201153657823623e-02,
+};
+constexpr double kFastAtan[5] = {
+    3.3333328366e-01, -1.9999158382e-01, 1.4253635705e-01, -1.0648017377e-01, 6.1687607318e-02,
+};
+constexpr double kAtanBreak[2] = {0.4375, 0.6875};
+constexpr double kAtanHi[3] = {0.0, 4.63647609000806093515e-01, 7.85398163397448278999e-01};
+constexpr double kAtanLo[3] = {0.0, 2.26987774529616870924e-17, 3.06161699786838301793e-17};
+constexpr double kPio2Hi = 1.57079632679489655800e+00;
+constexpr double kPio2Lo = 6.12323399573676603587e-17;
+constexpr double kPiHi = 3.14159265358979311600e+00;
+constexpr double kPiLo = 1.22464679914735317720e-16;
+
+// Legs beyond these overflow or underflow when squared in double, and in
+// single precision for the fast tier
+constexpr double kMaxUnscaled = 1e150;
+constexpr double kMinUnscaled = 1e-150;
+constexpr double kMaxSingle = 1e15;
+constexpr double kMinSingle = 1e-15;
+
+// Veltkamp splitting constant 2^27 + 1
+constexpr double kSplitter = 134217729.0;
+
+// Mean steps per tier, and the flattest axis ratio for which they
+// converge to the tier's accuracy
+constexpr int kFaithfulMeanSteps = 7;
+constexpr int kFastMeanSteps = 5;
+constexpr int kMaxMeanSteps = 64;
+constexpr double kMeanTolerance = 1e-15;
+constexpr double kFaithfulMinRatio = 1e-4;
+constexpr double kFastMinRatio = 5e-3;
+
+/**
+ * @brief Run a branch-free kernel block by block and redo the elements it flags
+ *
+ * kernel(begin, n, r0, r1, flags) fills n results starting at begin and
+ * flags the elements it cannot handle; fallback(i, r0, r1) recomputes one
+ * of them. Results are staged in local buffers, so outputs may alias
+ * inputs and the fallback still sees the original arguments.
+ */
+template <typename Kernel, typename Fallback>
+void runBlocks(size_t count, double* out0, double* out1, Kernel kernel, Fallback fallback) {
+    double r0[kBlock];
+    double r1[kBlock];
+    bool flags[kBlock];
+    for (size_t begin = 0; begin < count; begin += kBlock) {
+        size_t n = std::min(kBlock, count - begin);
+        kernel(begin, n, r0, r1, flags);
+        for (size_t k = 0; k < n; ++k) {
+            if (flags[k]) {
+                fallback(begin + k, r0[k], r1[k]);
+            }
+        }
+        std::copy(r0, r0 + n, out0 + begin);
+        if (out1) {
+            std::copy(r1, r1 + n, out1 + begin);
+        }
+    }
+}
+
+double singleSqrt(double value) {
+    return static_cast<double>(std::sqrt(static_cast<float>(value)));
+}
+
+/**
+ * @brief Exact square as a head and a tail (Dekker)
+ */
+void twoSquare(double v, double& head, double& tail) {
+    double c = kSplitter * v;
+    double hi = c - (c - v);
+    double lo = v - hi;
+    head = v * v;
+    tail = ((hi * hi - head) + 2.0 * hi * lo) + lo * lo;
+}
+
+double sinKernel(double x, double y) {
+    double z = x * x;
+    double v = z * x;
+    double r = kS2 + z * (kS3 + z * (kS4 + z * (kS5 + z * kS6)));
+    return x - ((z * (0.5 * y - v * r) - y) - v * kS1);
+}
+
+double cosKernel(double x, double y) {
+    double z = x * x;
+    double r = z * (kC1 + z * (kC2 + z * (kC3 + z * (kC4 + z * (kC5 + z * kC6)))));
+    double hz = 0.5 * z;
+    double w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+double fastSinKernel(double x) {
+    double z = x * x;
+    double s = z * x;
+    return (x + s * (kFastS1 + z * kFastS2)) + s * (z * z) * (kFastS3 + z * kFastS4);
+}
+
+double fastCosKernel(double x) {
+    double z = x * x;
+    double w = z * z;
+    return ((1.0 + z * kFastC0) + w * kFastC1) + (w * z) * (kFastC2 + z * kFastC3);
+}
+
+/**
+ * @brief Sine and cosine of the reduced angle placed in quadrant q
+ */
+void placeQuadrant(long q, double s, double c, double& sin_out, double& cos_out) {
+    double sv = (q & 1) ? c : s;
+    double cv = (q & 1) ? s : c;
+    sin_out = (q & 2) ? -sv : sv;
+    cos_out = ((q + 1) & 2) ? -cv : cv;
+}
+
+template <bool Fast>
+void sinCosBlock(const double* angle, size_t n, double* sin_out, double* cos_out, bool* flags) {
+    for (size_t k = 0; k < n; ++k) {
+        double x = angle[k];
+        bool in_range = std::abs(x) <= kMaxReducedAngle;
+        double fn = in_range ? (x * kTwoOverPi + kRoundShifter) - kRoundShifter : 0.0;
+        double r = x - fn * kPio2Head;
+        double w = fn * kPio2Tail;
+        double y0 = r - w;
+        long q = static_cast<long>(fn);
+        if (Fast) {
+            flags[k] = !in_range;
+            placeQuadrant(q, fastSinKernel(y0), fastCosKernel(y0), sin_out[k], cos_out[k]);
+        } else {
+            double y1 = (r - y0) - w;
+            flags[k] = !in_range || std::abs(y0) < std::abs(fn) * kCancellationLimit;
+            placeQuadrant(q, sinKernel(y0, y1), cosKernel(y0, y1), sin_out[k], cos_out[k]);
+        }
+    }
+}
+
+/**
+ * @brief Exact product as a head and a tail (Dekker)
+ */
+void twoProduct(double a, double b, double& head, double& tail) {
+    double ca = kSplitter * a;
+    double ah = ca - (ca - a);
+    double al = a - ah;
+    double cb = kSplitter * b;
+    double bh = cb - (cb - b);
+    double bl = b - bh;
+    head = a * b;
+    tail = ((ah * bh - head) + ah * bl + al * bh) + al * bl;
+}
+
+template <bool Fast>
+void atan2Block(const double* y, const double* x, size_t n, double* out, bool* flags) {
+    for (size_t k = 0; k < n; ++k) {
+        double ax = std::abs(x[k]);
+        double ay = std::abs(y[k]);
+        bool swap = ay > ax;
+        double num = swap ? ax : ay;
+        double den = swap ? ay : ax;
+        // Zero, infinite and NaN arguments take the library's special cases
+        flags[k] = !(den > 0.0 && den <= kMaxUnscaled * kMaxUnscaled && num <= den);
+        num = flags[k] ? 0.0 : num;
+        den = flags[k] ? 1.0 : den;
+
+        // atan(num / den) on [0, 1] as atan(c) + atan(u) for c = 0, 1/2 or 1,
+        // with the numerators of u exact by Sterbenz's lemma
+        double t = num / den;
+        int id = t < kAtanBreak[0] ? 0 : (t < kAtanBreak[1] ? 1 : 2);
+        double u = id == 0 ? t : (id == 1 ? (2.0 * num - den) / (2.0 * den + num) : (num - den) / (num + den));
+        double z = u * u;
+        double w = z * z;
+        double p;
+        double tail = 0.0;
+        if (Fast) {
+            p = z * (kFastAtan[0] + w * (kFastAtan[2] + w * kFastAtan[4])) +
+                w * (kFastAtan[1] + w * kFastAtan[3]);
+        } else {
+            p = z * (kAtan[0] + w * (kAtan[2] + w * (kAtan[4] + w * (kAtan[6] + w * (kAtan[8] + w * kAtan[10]))))) +
+                w * (kAtan[1] + w * (kAtan[3] + w * (kAtan[5] + w * (kAtan[7] + w * kAtan[9]))));
+            // Remainder of the direct division, so t's rounding does not reach the result
+            double head, product_tail;
+            twoProduct(t, den, head, product_tail);
+            tail = id == 0 ? ((num - head) - product_tail) / den : 0.0;
+        }
+        double small = id == 0 ? u - (u * p - tail) : u - (u * p - kAtanLo[id]);
+
+        // Fold the octant back, adding the two large constants exactly so
+        // the result is rounded once
+        bool negative_x = std::signbit(x[k]);
+        double sign = swap != negative_x ? -1.0 : 1.0;
+        double offset_hi = swap ? kPio2Hi : (negative_x ? kPiHi : 0.0);
+        double offset_lo = swap ? kPio2Lo : (negative_x ? kPiLo : 0.0);
+        double head = offset_hi + sign * kAtanHi[id];
+        double bv = head - offset_hi;
+        double head_tail = (offset_hi - (head - bv)) + (sign * kAtanHi[id] - bv);
+        out[k] = std::copysign(head + ((head_tail + offset_lo) + sign * small), y[k]);
+    }
+}
+
+/**
+ * @brief Ellipse perimeter 2 pi N(a^2, b^2) / M(a, b) after a number of steps
+ *
+ * M is the arithmetic-geometric mean and N the modified mean of Adlaj,
+ * "An eloquent formula for the perimeter of an ellipse" (2012). N is
+ * tracked as x with the gaps d = x - z and e = y - z, and the gap
+ * difference g = d - e is updated in closed form, so no step subtracts
+ * nearly equal numbers and converged steps leave the result unchanged.
+ *
+ * @param steps Mean steps to run, or 0 to run until both means converge
+ */
+double meanPerimeter(double a, double b, int steps) {
+    double scale = std::max(a, b);
+    double m_a = 1.0;
+    double m_b = std::min(a, b) / scale;
+    double x = 1.0;
+    double e = m_b * m_b;
+    double g = (m_a - m_b) * (m_a + m_b);
+    for (int step = 0; steps == 0 ? step < kMaxMeanSteps && (g > kMeanTolerance * x ||
+                                                             m_a - m_b > kMeanTolerance * m_a)
+                                  : step < steps;
+         ++step) {
+        double m_next = 0.5 * (m_a + m_b);
+        m_b = std::sqrt(m_a * m_b);
+        m_a = m_next;
+        double root_d = std::sqrt(e + g);
+        double root_e = std::sqrt(e);
+        double spread = root_d + root_e;
+        x -= 0.5 * g;
+        g = g * g / (2.0 * spread * spread);
+        e = 2.0 * root_d * root_e;
+    }
+    return 2.0 * M_PI * scale * x / (0.5 * (m_a + m_b));
+}
+
+} // namespace
+
+void batchSqrt(const double* x, double* out, size_t count, MathAccuracy) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = std::sqrt(x[i]);
+    }
+}
+
+void batchHypot(const double* x, const double* y, double* out, size_t count, MathAccuracy accuracy) {
+    if (accuracy == MathAccuracy::Reference) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = std::hypot(x[i], y[i]);
+        }
+        return;
+    }
+    bool fast = accuracy == MathAccuracy::Fast;
+    double max_leg = fast ? kMaxSingle : kMaxUnscaled;
+    double min_leg = fast ? kMinSingle : kMinUnscaled;
+    runBlocks(
+        count, out, nullptr,
+        [&](size_t begin, size_t n, double* r0, double*, bool* flags) {
+            for (size_t k = 0; k < n; ++k) {
+                double ax = std::abs(x[begin + k]);
+                double ay = std::abs(y[begin + k]);
+                double m = std::max(ax, ay);
+                flags[k] = !(m <= max_leg) || (m < min_leg && m > 0.0);
+                ax = flags[k] ? 0.0 : ax;
+                ay = flags[k] ? 0.0 : ay;
+                if (fast) {
+                    r0[k] = singleSqrt(ax * ax + ay * ay);
+                    continue;
+                }
+                // One Newton step on the exact residual h^2 - x^2 - y^2
+                double xh, xt, yh, yt;
+                twoSquare(ax, xh, xt);
+                twoSquare(ay, yh, yt);
+                double sum = xh + yh;
+                double bv = sum - xh;
+                double sum_tail = (xh - (sum - bv)) + (yh - bv);
+                double h = std::sqrt(sum);
+                double hh, ht;
+                twoSquare(h, hh, ht);
+                double residual = (hh - sum) + ((ht - xt - yt) - sum_tail);
+                r0[k] = h > 0.0 ? h - residual / (2.0 * h) : 0.0;
+            }
+        },
+        [&](size_t i, double& r0, double&) { r0 = std::hypot(x[i], y[i]); });
+}
+
+void batchSinCos(const double* angle, double* sin_out, double* cos_out, size_t count,
+                 MathAccuracy accuracy) {
+    if (accuracy == MathAccuracy::Reference) {
+        for (size_t i = 0; i < count; ++i) {
+            double x = angle[i];
+            sin_out[i] = std::sin(x);
+            cos_out[i] = std::cos(x);
+        }
+        return;
+    }
+    bool fast = accuracy == MathAccuracy::Fast;
+    runBlocks(
+        count, sin_out, cos_out,
+        [&](size_t begin, size_t n, double* r0, double* r1, bool* flags) {
+            if (fast) {
+                sinCosBlock<true>(angle + begin, n, r0, r1, flags);
+            } else {
+                sinCosBlock<false>(angle + begin, n, r0, r1, flags);
+            }
+        },
+        [&](size_t i, double& r0, double& r1) {
+            r0 = std::sin(angle[i]);
+            r1 = std::cos(angle[i]);
+        });
+}
+
+void batchAtan2(const double* y, const double* x, double* out, size_t count, MathAccuracy accuracy) {
+    if (accuracy == MathAccuracy::Reference) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = std::atan2(y[i], x[i]);
+        }
+        return;
+    }
+    bool fast = accuracy == MathAccuracy::Fast;
+    runBlocks(
+        count, out, nullptr,
+        [&](size_t begin, size_t n, double* r0, double*, bool* flags) {
+            if (fast) {
+                atan2Block<true>(y + begin, x + begin, n, r0, flags);
+            } else {
+                atan2Block<false>(y + begin, x + begin, n, r0, flags);
+            }
+        },
+        [&](size_t i, double& r0, double&) { r0 = std::atan2(y[i], x[i]); });
+}
+
+void batchEllipsePerimeter(const double* a, const double* b, double* out, size_t count,
+                           MathAccuracy accuracy) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!(a[i] > 0 && b[i] > 0 && std::isfinite(a[i]) && std::isfinite(b[i]))) {
+            throw std::invalid_argument("Semi-axes must be positive and finite");
+        }
+    }
+    if (accuracy == MathAccuracy::Reference) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = meanPerimeter(a[i], b[i], 0);
+        }
+        return;
+    }
+    bool fast = accuracy == MathAccuracy::Fast;
+    double min_ratio = fast ? kFastMinRatio : kFaithfulMinRatio;
+    runBlocks(
+        count, out, nullptr,
+        [&](size_t begin, size_t n, double* r0, double*, bool* flags) {
+            for (size_t k = 0; k < n; ++k) {
+                double ai = a[begin + k];
+                double bi = b[begin + k];
+                flags[k] = std::min(ai, bi) < min_ratio * std::max(ai, bi);
+                r0[k] = fast ? meanPerimeter(ai, bi, kFastMeanSteps) : meanPerimeter(ai, bi, kFaithfulMeanSteps);
+            }
+        },
+        [&](size_t i, double& r0, double&) {
+            bool faithful_converges = std::min(a[i], b[i]) >= kFaithfulMinRatio * std::max(a[i], b[i]);
+            r0 = fast && faithful_converges ? meanPerimeter(a[i], b[i], kFaithfulMeanSteps)
+                                            : meanPerimeter(a[i], b[i], 0);
+        });
+}
+
+} // namespace geometry
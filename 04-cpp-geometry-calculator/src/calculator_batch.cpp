@@ -0,0 +1,80 @@
+#include "calculator_batch.h"
+#include "geometry_calculator.h"
+#include <stdexcept>
+
+namespace geometry {
+
+CalculatorBatch::CalculatorBatch(GeometryCalculator& calculator)
+    : calculator_(&calculator), version_(calculator.version()), base_count_(calculator.shapeCount()) {}
+
+void CalculatorBatch::checkIndex(size_t index) const {
+    if (index >= base_count_ + added_.size()) {
+        throw std::out_of_range("Shape index out of range");
+    }
+}
+
+size_t CalculatorBatch::addShape(std::unique_ptr<Shape> shape, const Point& position) {
+    if (!shape || !shape->isValid()) {
+        return npos;
+    }
+    added_.push_back(std::move(shape));
+    added_positions_.push_back(position);
+    return base_count_ + added_.size() - 1;
+}
+
+void CalculatorBatch::replaceShape(size_t index, std::unique_ptr<Shape> shape) {
+    checkIndex(index);
+    if (!shape || !shape->isValid()) {
+        throw std::invalid_argument("Replacement shape must be valid");
+    }
+    replaced_.emplace_back(index, std::move(shape));
+}
+
+void CalculatorBatch::setPosition(size_t index, const Point& position) {
+    checkIndex(index);
+    moved_.emplace_back(index, position);
+}
+
+void CalculatorBatch::removeShape(size_t index) {
+    checkIndex(index);
+    removed_.push_back(index);
+}
+
+void CalculatorBatch::setAttribute(size_t index, const std::string& name, double value) {
+    checkIndex(index);
+    calculator_->attributes().requireColumn(name, false);
+    numbers_.push_back({index, name, value});
+}
+
+void CalculatorBatch::setAttribute(size_t index, const std::string& name, const std::string& category) {
+    checkIndex(index);
+    calculator_->attributes().requireColumn(name, true);
+    categories_.push_back({index, name, category});
+}
+
+size_t CalculatorBatch::editCount() const {
+    return added_.size() + replaced_.size() + moved_.size() + removed_.size() + numbers_.size() +
+           categories_.size();
+}
+
+void CalculatorBatch::commit() {
+    if (calculator_->version() != version_ || calculator_->shapeCount() != base_count_) {
+        throw std::logic_error("Calculator changed since the batch began");
+    }
+    calculator_->applyBatch(*this);
+    discard();
+}
+
+void CalculatorBatch::discard() {
+    added_.clear();
+    added_positions_.clear();
+    replaced_.clear();
+    moved_.clear();
+    removed_.clear();
+    numbers_.clear();
+    categories_.clear();
+    version_ = calculator_->version();
+    base_count_ = calculator_->shapeCount();
+}
+
+} // namespace geometry
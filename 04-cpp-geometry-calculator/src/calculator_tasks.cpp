@@ -0,0 +1,74 @@
+#include "calculator_tasks.h"
+#include <stdexcept>
+
+namespace geometry {
+
+IngestNodes addIngestNodes(TaskGraph& graph, GeometryCalculator& calculator, size_t chunks,
+                           std::function<ShapeBatch(size_t)> loader) {
+    if (!loader) {
+        throw std::invalid_argument("Ingest loader must be callable");
+    }
+
+    // One slot per chunk; each stage only touches the slot of its own chunk
+    auto batches = std::make_shared<std::vector<ShapeBatch>>(chunks);
+
+    IngestNodes nodes;
+    nodes.load = graph.addChunkedTask("load", chunks, [batches, loader](size_t chunk) {
+        (*batches)[chunk] = loader(chunk);
+    });
+
+    nodes.validate = graph.addChunkedTask("validate", chunks, [batches](size_t chunk) {
+        ShapeBatch& batch = (*batches)[chunk];
+        if (!batch.positions.empty() && batch.positions.size() != batch.shapes.size()) {
+            throw std::invalid_argument("Shape batch must have one position per shape");
+        }
+        if (batch.positions.empty()) {
+            batch.positions.resize(batch.shapes.size());
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < batch.shapes.size(); ++i) {
+            if (batch.shapes[i] && batch.shapes[i]->isValid()) {
+                batch.shapes[kept] = std::move(batch.shapes[i]);
+                batch.positions[kept] = batch.positions[i];
+                ++kept;
+            }
+        }
+        batch.shapes.resize(kept);
+        batch.positions.resize(kept);
+    });
+
+    nodes.commit = graph.addChunkedTask("commit", chunks, [batches, &calculator](size_t chunk) {
+        ShapeBatch batch = std::move((*batches)[chunk]);
+        for (size_t i = 0; i < batch.shapes.size(); ++i) {
+            calculator.addShape(std::move(batch.shapes[i]), batch.positions[i]);
+        }
+    }, true);
+
+    graph.stream(nodes.load, nodes.validate);
+    graph.stream(nodes.validate, nodes.commit);
+    return nodes;
+}
+
+TaskGraph::NodeId addTotalAreaNode(TaskGraph& graph, const GeometryCalculator& calculator,
+                                   double& result) {
+    return graph.addTask("total area", [&calculator, &result]() {
+        result = calculator.totalArea();
+    });
+}
+
+TaskGraph::NodeId addTotalPerimeterNode(TaskGraph& graph, const GeometryCalculator& calculator,
+                                        double& result) {
+    return graph.addTask("total perimeter", [&calculator, &result]() {
+        result = calculator.totalPerimeter();
+    });
+}
+
+TaskGraph::NodeId addUnionPerimeterNode(TaskGraph& graph, const GeometryCalculator& calculator,
+                                        double& result, double tolerance) {
+    return graph.addTask("union perimeter", [&calculator, &result, tolerance]() {
+        result = calculator.unionPerimeter(tolerance);
+    });
+}
+
+} // namespace geometry
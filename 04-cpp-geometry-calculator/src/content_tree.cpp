@@ -0,0 +1,474 @@
+#include "content_tree.h"
+#include "hashing.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <tuple>
+
+namespace geometry {
+
+namespace {
+
+using Node = ContentTree::Node;
+using Leaves = ContentTree::Leaves;
+
+constexpr uint64_t kModulus = (1ULL << 61) - 1;
+constexpr uint64_t kBase = 0x0e3779b97f4a7c15ULL;
+constexpr size_t kBlock = ContentTree::kLeavesPerBlock;
+
+/// Largest edit distance aligned exactly; beyond it the residual span is compared by position
+constexpr size_t kMaxScriptEdits = 512;
+
+uint64_t reduce(uint64_t x) {
+    x = (x & kModulus) + (x >> 61);
+    return x >= kModulus ? x - kModulus : x;
+}
+
+/**
+ * @brief a * b mod 2^61 - 1 for a, b < 2^61 using 32-bit halves
+ */
+uint64_t mulMod(uint64_t a, uint64_t b) {
+    uint64_t a_hi = a >> 32;
+    uint64_t a_lo = a & 0xffffffffULL;
+    uint64_t b_hi = b >> 32;
+    uint64_t b_lo = b & 0xffffffffULL;
+    uint64_t lo = a_lo * b_lo;
+    uint64_t mid = a_hi * b_lo + a_lo * b_hi;
+    uint64_t hi = a_hi * b_hi;
+    // 2^61 = 1, so 2^64 = 8 and mid * 2^32 splits at bit 29
+    uint64_t sum = (lo & kModulus) + (lo >> 61) + (hi << 3) + (mid >> 29) +
+                   ((mid & ((1ULL << 29) - 1)) << 32);
+    return reduce((sum & kModulus) + (sum >> 61));
+}
+
+uint64_t addMod(uint64_t a, uint64_t b) {
+    uint64_t sum = a + b;
+    return sum >= kModulus ? sum - kModulus : sum;
+}
+
+/**
+ * @brief Hash of the concatenation of two sequences
+ */
+Node combine(const Node& left, const Node& right) {
+    return {addMod(mulMod(left.hash, right.power), right.hash), mulMod(left.power, right.power)};
+}
+
+Node fold(const uint64_t* leaves, size_t count) {
+    Node node;
+    for (size_t i = 0; i < count; ++i) {
+        node.hash = addMod(mulMod(node.hash, kBase), leaves[i]);
+        node.power = mulMod(node.power, kBase);
+    }
+    return node;
+}
+
+size_t blockCount(size_t leaves) {
+    return (leaves + kBlock - 1) / kBlock;
+}
+
+/**
+ * @brief Turn a run of deletions and insertions into modifications, removals and additions
+ */
+void flushRun(std::vector<size_t>& deleted, std::vector<size_t>& inserted, ContentDiff& diff) {
+    size_t paired = std::min(deleted.size(), inserted.size());
+    for (size_t i = 0; i < paired; ++i) {
+        diff.modified.emplace_back(deleted[i], inserted[i]);
+    }
+    diff.removed.insert(diff.removed.end(), deleted.begin() + paired, deleted.end());
+    diff.added.insert(diff.added.end(), inserted.begin() + paired, inserted.end());
+    deleted.clear();
+    inserted.clear();
+}
+
+/**
+ * @brief Compare two equally long spans position by position
+ */
+void diffPositional(const Leaves& a, size_t a_offset, const Leaves& b, size_t b_offset, size_t count,
+                    ContentDiff& diff) {
+    for (size_t i = 0; i < count; ++i) {
+        if (a[a_offset + i] != b[b_offset + i]) {
+            diff.modified.emplace_back(a_offset + i, b_offset + i);
+        }
+    }
+}
+
+/**
+ * @brief Length of the common run of two trees' leaves from a pair of positions
+ *
+ * A block's worth of leaves is compared directly; longer runs are measured
+ * by galloping and bisecting over range hashes, in O(log^2 n) whatever
+ * their length.
+ */
+size_t commonRun(const ContentTree& a, size_t i, const ContentTree& b, size_t j, size_t limit) {
+    size_t run = 0;
+    for (; run < limit && run < kBlock; ++run) {
+        if (a.leaf(i + run) != b.leaf(j + run)) {
+            return run;
+        }
+    }
+    auto equal = [&](size_t length) {
+        return a.rangeHash(i + run, i + run + length) == b.rangeHash(j + run, j + run + length);
+    };
+    for (size_t step = kBlock; run < limit; step *= 2) {
+        size_t length = std::min(step, limit - run);
+        if (!equal(length)) {
+            size_t lo = 0;
+            size_t hi = length - 1;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo + 1) / 2;
+                if (equal(mid)) {
+                    lo = mid;
+                } else {
+                    hi = mid - 1;
+                }
+            }
+            return run + lo;
+        }
+        run += length;
+    }
+    return run;
+}
+
+/**
+ * @brief Align two spans with a shortest edit script (Myers' greedy algorithm)
+ *
+ * Snakes advance over equal runs with commonRun(), so D edits cost about
+ * O(D^2 log^2 n) however long the spans are.
+ *
+ * @return false if more than kMaxScriptEdits edits are needed
+ */
+bool diffScript(const ContentTree& a, size_t a_count, size_t a_offset, const ContentTree& b, size_t b_count,
+                size_t b_offset, ContentDiff& diff) {
+    const ptrdiff_t n = static_cast<ptrdiff_t>(a_count);
+    const ptrdiff_t m = static_cast<ptrdiff_t>(b_count);
+    const ptrdiff_t max_edits = static_cast<ptrdiff_t>(std::min(a_count + b_count, kMaxScriptEdits));
+    const ptrdiff_t offset = max_edits + 1;
+
+    // frontier[offset + k] is the furthest x reached on diagonal k = x - y;
+    // trace[d] keeps diagonals -d - 1 .. d + 1 as they stood before round d
+    std::vector<ptrdiff_t> frontier(static_cast<size_t>(2 * max_edits + 3), 0);
+    std::vector<std::vector<ptrdiff_t>> trace;
+    ptrdiff_t edits = -1;
+    for (ptrdiff_t d = 0; d <= max_edits && edits < 0; ++d) {
+        trace.emplace_back(frontier.begin() + (offset - d - 1), frontier.begin() + (offset + d + 2));
+        for (ptrdiff_t k = -d; k <= d; k += 2) {
+            ptrdiff_t x = (k == -d || (k != d && frontier[offset + k - 1] < frontier[offset + k + 1]))
+                              ? frontier[offset + k + 1]
+                              : frontier[offset + k - 1] + 1;
+            ptrdiff_t y = x - k;
+            if (x < n && y < m) {
+                ptrdiff_t run = static_cast<ptrdiff_t>(commonRun(a, a_offset + static_cast<size_t>(x), b,
+                                                                 b_offset + static_cast<size_t>(y),
+                                                                 static_cast<size_t>(std::min(n - x, m - y))));
+                x += run;
+                y += run;
+            }
+            frontier[offset + k] = x;
+            if (x >= n && y >= m) {
+                edits = d;
+                break;
+            }
+        }
+    }
+    if (edits < 0) {
+        return false;
+    }
+
+    // Walk back from (n, m), recording edits in reverse; -1 marks a run of equal entries
+    struct Edit {
+        bool insert;
+        ptrdiff_t index;
+    };
+    std::vector<Edit> script;
+    ptrdiff_t x = n;
+    ptrdiff_t y = m;
+    for (ptrdiff_t d = edits; d >= 0; --d) {
+        const std::vector<ptrdiff_t>& before = trace[static_cast<size_t>(d)];
+        auto at = [&](ptrdiff_t k) { return before[static_cast<size_t>(k + d + 1)]; };
+        ptrdiff_t k = x - y;
+        ptrdiff_t prev_k = (k == -d || (k != d && at(k - 1) < at(k + 1))) ? k + 1 : k - 1;
+        ptrdiff_t prev_x = at(prev_k);
+        ptrdiff_t prev_y = prev_x - prev_k;
+        if (x > prev_x && y > prev_y) {
+            script.push_back({false, -1});
+            ptrdiff_t snake = std::min(x - prev_x, y - prev_y);
+            x -= snake;
+            y -= snake;
+        }
+        if (d > 0) {
+            script.push_back(x == prev_x ? Edit{true, prev_y} : Edit{false, prev_x});
+        }
+        x = prev_x;
+        y = prev_y;
+    }
+
+    std::vector<size_t> deleted;
+    std::vector<size_t> inserted;
+    for (auto it = script.rbegin(); it != script.rend(); ++it) {
+        if (it->index < 0) {
+            flushRun(deleted, inserted, diff);
+        } else if (it->insert) {
+            inserted.push_back(b_offset + static_cast<size_t>(it->index));
+        } else {
+            deleted.push_back(a_offset + static_cast<size_t>(it->index));
+        }
+    }
+    flushRun(deleted, inserted, diff);
+    return true;
+}
+
+} // namespace
+
+uint64_t shapeContentHash(const Shape& shape, const Point& position) {
+    uint64_t hash = mix64(static_cast<uint64_t>(shape.kind()) + 1);
+    auto add = [&hash](double value) { hash = mix64(hash ^ doubleBits(value)); };
+
+    switch (shape.kind()) {
+        case ShapeKind::Circle:
+            add(static_cast<const Circle&>(shape).radius());
+            break;
+        case ShapeKind::Rectangle: {
+            const auto& rectangle = static_cast<const Rectangle&>(shape);
+            add(rectangle.width());
+            add(rectangle.height());
+            break;
+        }
+        case ShapeKind::Triangle: {
+            double a, b, c;
+            std::tie(a, b, c) = static_cast<const Triangle&>(shape).sides();
+            add(a);
+            add(b);
+            add(c);
+            break;
+        }
+        case ShapeKind::Path:
+            for (const PathSegment& segment : static_cast<const Path&>(shape).segments()) {
+                hash = mix64(hash ^ static_cast<uint64_t>(segment.type));
+                for (const Point& point : segment.points) {
+                    add(point.x);
+                    add(point.y);
+                }
+                add(segment.radius);
+                add(segment.start_angle);
+                add(segment.sweep);
+            }
+            break;
+    }
+    add(position.x);
+    add(position.y);
+    return hash;
+}
+
+void ContentTree::push(uint64_t content) {
+    uint64_t leaf = reduce(content);
+    leaves_.push_back(leaf);
+    // One more step of the fold extends the last block's hash
+    size_t block = blockCount(leaves_.size()) - 1;
+    Node node = leaves_.size() % kBlock == 1 ? Node{} : levels_[0][block];
+    updateBlock(block, combine(node, Node{leaf, kBase}));
+}
+
+void ContentTree::set(size_t index, uint64_t content) {
+    leaves_[index] = reduce(content);
+    updateBlock(index / kBlock, blockNode(index / kBlock));
+}
+
+void ContentTree::erase(size_t index) {
+    leaves_.erase(index);
+    rebuild(index / kBlock);
+}
+
+void ContentTree::eraseSorted(const std::vector<size_t>& indices) {
+    if (indices.empty()) {
+        return;
+    }
+    leaves_.eraseSorted(indices);
+    rebuild(indices.front() / kBlock);
+}
+
+void ContentTree::append(const ContentTree& other) {
+    size_t first = leaves_.size() / kBlock;
+    for (size_t i = 0; i < other.size(); ++i) {
+        leaves_.push_back(other.leaves_[i]);
+    }
+    rebuild(first);
+}
+
+ContentTree ContentTree::select(const std::vector<size_t>& rows) const {
+    ContentTree result;
+    result.leaves_.reserve(rows.size());
+    for (size_t row : rows) {
+        result.leaves_.push_back(leaves_[row]);
+    }
+    result.rebuild();
+    return result;
+}
+
+void ContentTree::clear() {
+    leaves_.clear();
+    levels_.clear();
+}
+
+Node ContentTree::blockNode(size_t block) const {
+    size_t begin = block * kBlock;
+    return fold(&leaves_[begin], std::min(kBlock, leaves_.size() - begin));
+}
+
+Node ContentTree::parentNode(size_t level, size_t index) const {
+    const Level& below = levels_[level - 1];
+    size_t right = 2 * index + 1;
+    return right < below.size() ? combine(below[2 * index], below[right]) : below[2 * index];
+}
+
+void ContentTree::updateBlock(size_t block, Node node) {
+    // A block one past the end extends each level by at most one node
+    size_t index = block;
+    for (size_t level = 0;; ++level, index /= 2) {
+        if (level == levels_.size()) {
+            levels_.emplace_back();
+        }
+        Level& nodes = levels_[level];
+        if (index == nodes.size()) {
+            nodes.push_back(node);
+        } else {
+            nodes[index] = node;
+        }
+        if (nodes.size() == 1) {
+            break;
+        }
+        if (index & 1) {
+            node = combine(nodes[index - 1], node);
+        } else if (index + 1 < nodes.size()) {
+            node = combine(node, nodes[index + 1]);
+        }
+    }
+}
+
+void ContentTree::rebuild(size_t first_block) {
+    size_t count = blockCount(leaves_.size());
+    if (count == 0) {
+        levels_.clear();
+        return;
+    }
+    for (size_t level = 0;; ++level, count = (count + 1) / 2, first_block /= 2) {
+        if (level == levels_.size()) {
+            levels_.emplace_back();
+        }
+        Level& nodes = levels_[level];
+        nodes.resize(count);
+        for (size_t index = first_block; index < count; ++index) {
+            nodes[index] = level == 0 ? blockNode(index) : parentNode(level, index);
+        }
+        if (count == 1) {
+            levels_.resize(level + 1);
+            return;
+        }
+    }
+}
+
+Node ContentTree::range(size_t begin, size_t end) const {
+    if (begin >= end) {
+        return Node{};
+    }
+    size_t first = begin / kBlock;
+    size_t last = (end - 1) / kBlock;
+    if (first == last) {
+        return fold(&leaves_[begin], end - begin);
+    }
+
+    // Partial blocks at either end are folded directly, whole blocks come from the tree
+    size_t lo = first + 1;
+    size_t hi = last;
+    Node head = begin % kBlock == 0 ? levels_[0][first] : fold(&leaves_[begin], lo * kBlock - begin);
+    Node tail = fold(&leaves_[last * kBlock], end - last * kBlock);
+    Node left;
+    Node right;
+    for (size_t level = 0; lo < hi; ++level, lo /= 2, hi /= 2) {
+        const Level& nodes = levels_[level];
+        if (lo & 1) {
+            left = combine(left, nodes[lo++]);
+        }
+        if (hi & 1) {
+            right = combine(nodes[--hi], right);
+        }
+    }
+    return combine(combine(head, combine(left, right)), tail);
+}
+
+ContentDiff diffContent(const ContentTree& before, const ContentTree& after) {
+    ContentDiff diff;
+    if (before == after) {
+        return diff;
+    }
+    const size_t n = before.size();
+    const size_t m = after.size();
+
+    // Longest common prefix, then the longest common suffix of what remains
+    size_t shorter = std::min(n, m);
+    size_t lo = 0;
+    size_t hi = shorter;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (before.range(0, mid) == after.range(0, mid)) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    size_t prefix = lo;
+    lo = 0;
+    hi = shorter - prefix;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (before.range(n - mid, n) == after.range(m - mid, m)) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    size_t suffix = lo;
+
+    size_t a_count = n - prefix - suffix;
+    size_t b_count = m - prefix - suffix;
+    if (diffScript(before, a_count, prefix, after, b_count, prefix, diff)) {
+        return diff;
+    }
+
+    // Too many edits to align: compare by position instead
+    if (n == m) {
+        // Same shape of tree: descend only where the hashes disagree, left to right
+        std::vector<std::pair<size_t, size_t>> pending = {{before.levels_.size() - 1, 0}};
+        while (!pending.empty()) {
+            size_t level, index;
+            std::tie(level, index) = pending.back();
+            pending.pop_back();
+            if (before.levels_[level][index] == after.levels_[level][index]) {
+                continue;
+            }
+            if (level > 0) {
+                if (2 * index + 1 < before.levels_[level - 1].size()) {
+                    pending.emplace_back(level - 1, 2 * index + 1);
+                }
+                pending.emplace_back(level - 1, 2 * index);
+                continue;
+            }
+            size_t begin = index * kBlock;
+            size_t count = std::min(kBlock, n - begin);
+            diffPositional(before.leaves_, begin, after.leaves_, begin, count, diff);
+        }
+        return diff;
+    }
+    size_t common = std::min(a_count, b_count);
+    diffPositional(before.leaves_, prefix, after.leaves_, prefix, common, diff);
+    for (size_t i = common; i < a_count; ++i) {
+        diff.removed.push_back(prefix + i);
+    }
+    for (size_t i = common; i < b_count; ++i) {
+        diff.added.push_back(prefix + i);
+    }
+    return diff;
+}
+
+} // namespace geometry
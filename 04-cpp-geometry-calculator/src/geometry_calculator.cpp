@@ -1,65 +1,647 @@
 #include "geometry_calculator.h"
+#include "parallel.h"
+#include "tracing.h"
+#include "union_perimeter.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <sstream>
 #include <iomanip>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 namespace geometry {
 
+namespace {
+
+// Shapes processed between two deadline checks
+constexpr size_t kDeadlineCheckInterval = 256;
+
+/**
+ * @brief Next value of the process-wide version counter
+ *
+ * Versions are never shared between calculators, so a partial result,
+ * cached value or batch tagged with one cannot be taken for another
+ * calculator's shapes, or for shapes moved in from elsewhere.
+ */
+uint64_t nextVersion() {
+    static std::atomic<uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+template <typename Value>
+PartialResult sumWithin(size_t count, uint64_t version, QueryAggregate aggregate, const Deadline& deadline,
+                        const PartialResult* resume, Value value) {
+    PartialResult result;
+    result.total = count;
+    result.version = version;
+    result.aggregate = static_cast<uint32_t>(aggregate);
+    // Only a sum of the same aggregate over the same, unchanged shapes can be continued
+    if (resume && resume->version == version && resume->aggregate == result.aggregate &&
+        resume->total == count && resume->processed <= count) {
+        result.value = resume->value;
+        result.processed = resume->processed;
+    }
+
+    if (result.processed < count) {
+        size_t stride = spreadStride(count);
+        size_t index = spreadIndex(result.processed, stride, count);
+        do {
+            size_t end = std::min(count, result.processed + kDeadlineCheckInterval);
+            for (; result.processed < end; ++result.processed) {
+                result.value += value(index);
+                index += stride;
+                if (index >= count) {
+                    index -= count;
+                }
+            }
+        } while (result.processed < count && !deadline.expired());
+    }
+
+    result.estimate = result.exact() || result.processed == 0
+        ? result.value
+        : result.value * static_cast<double>(count) / static_cast<double>(result.processed);
+    return result;
+}
+
+} // namespace
+
+GeometryCalculator::GeometryCalculator(GeometryCalculator&& other) {
+    *this = std::move(other);
+}
+
+GeometryCalculator& GeometryCalculator::operator=(GeometryCalculator&& other) {
+    if (this != &other) {
+        // Stop background reads of both stores before either changes
+        indexes_.invalidate();
+        indexes_ = std::move(other.indexes_);
+        shapes_ = std::move(other.shapes_);
+        statistics_ = std::move(other.statistics_);
+        other.statistics_ = ShapeStatistics();
+        version_ = nextVersion();
+        cache_ = std::move(other.cache_);
+        views_ = std::move(other.views_);
+        other.views_ = ViewSet();
+        attributes_ = std::move(other.attributes_);
+        other.attributes_ = AttributeTable();
+        content_ = std::move(other.content_);
+        other.content_.clear();
+        other.version_ = nextVersion();
+        if (other.observer_) {
+            other.observer_->cleared();
+        }
+        if (observer_) {
+            observer_->cleared();
+            shapes_.forEach([&](const Shape& shape, const Point& position) {
+                // Checked per shape: an observer may detach itself
+                if (observer_) {
+                    observer_->shapeAdded(shape, position);
+                }
+            });
+        }
+    }
+    return *this;
+}
+
 void GeometryCalculator::addShape(std::unique_ptr<Shape> shape) {
+    addShape(std::move(shape), Point{});
+}
+
+void GeometryCalculator::addShape(std::unique_ptr<Shape> shape, const Point& position) {
     if (shape && shape->isValid()) {
-        shapes_.push_back(std::move(shape));
+        indexes_.invalidate();
+        statistics_.add(*shape);
+        if (!views_.empty()) {
+            views_.apply(shapeFeatures(*shape), 1.0);
+        }
+        attributes_.appendRow(shape->area(), shape->perimeter());
+        content_.push(shapeContentHash(*shape, position));
+        const Shape& added = *shape;
+        shapes_.push(std::move(shape), position);
+        version_ = nextVersion();
+        if (observer_) {
+            observer_->shapeAdded(added, position);
+        }
+    }
+}
+
+void GeometryCalculator::replaceShape(size_t index, std::unique_ptr<Shape> shape) {
+    if (index >= shapes_.size()) {
+        throw std::out_of_range("Shape index out of range");
+    }
+    if (!shape || !shape->isValid()) {
+        throw std::invalid_argument("Replacement shape must be valid");
+    }
+    indexes_.invalidate();
+    statistics_.add(*shape);
+    std::unique_ptr<Shape>& slot = shapes_.shape(index);
+    if (!views_.empty()) {
+        views_.apply(shapeFeatures(*slot), -1.0);
+        views_.apply(shapeFeatures(*shape), 1.0);
+    }
+    attributes_.setMetrics(index, shape->area(), shape->perimeter());
+    content_.set(index, shapeContentHash(*shape, shapes_.position(index)));
+    slot = std::move(shape);
+    version_ = nextVersion();
+    if (observer_) {
+        observer_->shapeReplaced(index, *slot);
+    }
+}
+
+void GeometryCalculator::removeShape(size_t index) {
+    if (index >= shapes_.size()) {
+        throw std::out_of_range("Shape index out of range");
+    }
+    indexes_.invalidate();
+    if (!views_.empty()) {
+        views_.apply(shapeFeatures(std::as_const(shapes_).shape(index)), -1.0);
+    }
+    shapes_.erase(index);
+    attributes_.eraseRow(index);
+    content_.erase(index);
+    version_ = nextVersion();
+    if (observer_) {
+        observer_->shapesRemoved({index});
+    }
+}
+
+void GeometryCalculator::setPosition(size_t index, const Point& position) {
+    if (index >= shapes_.size()) {
+        throw std::out_of_range("Shape index out of range");
+    }
+    indexes_.invalidate();
+    shapes_.position(index) = position;
+    content_.set(index, shapeContentHash(std::as_const(shapes_).shape(index), position));
+    version_ = nextVersion();
+    if (observer_) {
+        observer_->shapeMoved(index, position);
     }
 }
 
+void GeometryCalculator::applyBatch(CalculatorBatch& batch) {
+    // Columns may have been dropped, and dictionaries filled, since the
+    // edits were buffered; check both before changing anything
+    for (const auto& edit : batch.numbers_) {
+        attributes_.requireColumn(edit.column, false);
+    }
+    std::unordered_map<std::string, std::unordered_set<std::string>> categories;
+    for (const auto& edit : batch.categories_) {
+        categories[edit.column].insert(edit.category);
+    }
+    for (const auto& [column, values] : categories) {
+        attributes_.requireCategories(column, values);
+    }
+    if (batch.editCount() == 0) {
+        return;
+    }
+    GEOMETRY_TRACE_SCOPE("mutation", "applyBatch", batch.editCount());
+    indexes_.invalidate();
+
+    shapes_.reserve(shapes_.size() + batch.added_.size());
+    attributes_.reserve(shapes_.size() + batch.added_.size());
+    content_.reserve(shapes_.size() + batch.added_.size());
+    for (size_t k = 0; k < batch.added_.size(); ++k) {
+        std::unique_ptr<Shape>& shape = batch.added_[k];
+        statistics_.add(*shape);
+        if (!views_.empty()) {
+            views_.apply(shapeFeatures(*shape), 1.0);
+        }
+        attributes_.appendRow(shape->area(), shape->perimeter());
+        content_.push(shapeContentHash(*shape, batch.added_positions_[k]));
+        const Shape& added = *shape;
+        shapes_.push(std::move(shape), batch.added_positions_[k]);
+        if (observer_) {
+            observer_->shapeAdded(added, batch.added_positions_[k]);
+        }
+    }
+
+    // Replacements in index order; the last one buffered for an index wins
+    auto& replaced = batch.replaced_;
+    std::stable_sort(replaced.begin(), replaced.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (size_t r = 0; r < replaced.size(); ++r) {
+        if (r + 1 < replaced.size() && replaced[r + 1].first == replaced[r].first) {
+            continue;
+        }
+        auto& [index, shape] = replaced[r];
+        statistics_.add(*shape);
+        std::unique_ptr<Shape>& slot = shapes_.shape(index);
+        if (!views_.empty()) {
+            views_.apply(shapeFeatures(*slot), -1.0);
+            views_.apply(shapeFeatures(*shape), 1.0);
+        }
+        attributes_.setMetrics(index, shape->area(), shape->perimeter());
+        slot = std::move(shape);
+        if (observer_) {
+            observer_->shapeReplaced(index, *slot);
+        }
+    }
+
+    for (const auto& [index, position] : batch.moved_) {
+        shapes_.position(index) = position;
+        if (observer_) {
+            observer_->shapeMoved(index, position);
+        }
+    }
+
+    // Rehash replaced and moved shapes once their final content is in place
+    for (const auto& entry : replaced) {
+        content_.set(entry.first, shapeContentHash(std::as_const(shapes_).shape(entry.first),
+                                                   shapes_.position(entry.first)));
+    }
+    for (const auto& entry : batch.moved_) {
+        content_.set(entry.first, shapeContentHash(std::as_const(shapes_).shape(entry.first),
+                                                   shapes_.position(entry.first)));
+    }
+    for (const auto& edit : batch.numbers_) {
+        attributes_.set(edit.index, edit.column, edit.value);
+    }
+    for (const auto& edit : batch.categories_) {
+        attributes_.set(edit.index, edit.column, edit.category);
+    }
+
+    auto& removed = batch.removed_;
+    std::sort(removed.begin(), removed.end());
+    removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+    if (!views_.empty()) {
+        for (size_t index : removed) {
+            views_.apply(shapeFeatures(std::as_const(shapes_).shape(index)), -1.0);
+        }
+    }
+    shapes_.eraseSorted(removed);
+    attributes_.eraseRows(removed);
+    content_.eraseSorted(removed);
+    version_ = nextVersion();
+    if (observer_ && !removed.empty()) {
+        observer_->shapesRemoved(removed);
+    }
+}
+
+void GeometryCalculator::merge(GeometryCalculator& other) {
+    if (&other == this) {
+        return;
+    }
+    // Everything that can fail is checked before the first change
+    attributes_.checkAppend(other.attributes_);
+    indexes_.invalidate();
+    other.indexes_.invalidate();
+    if (!views_.empty()) {
+        for (size_t id : views_.merge(other.views_)) {
+            other.shapes_.forEach([&](const Shape& shape, const Point&) {
+                views_.applyTo(id, shapeFeatures(shape), 1.0);
+            });
+        }
+    }
+    if (observer_) {
+        other.shapes_.forEach([&](const Shape& shape, const Point& position) {
+            if (observer_) {
+                observer_->shapeAdded(shape, position);
+            }
+        });
+    }
+    statistics_.merge(other.statistics_);
+    attributes_.append(other.attributes_);
+    content_.append(other.content_);
+    shapes_.splice(other.shapes_);
+    version_ = nextVersion();
+
+    other.statistics_.clear();
+    other.attributes_.clearRows();
+    other.content_.clear();
+    other.views_.reset();
+    other.version_ = nextVersion();
+    if (other.observer_) {
+        other.observer_->cleared();
+    }
+}
+
+std::vector<GeometryCalculator> GeometryCalculator::partition(
+    size_t parts, const std::function<size_t(const Shape&)>& selector) {
+    std::vector<GeometryCalculator> outputs(parts);
+    size_t chunks = shapes_.chunkCount();
+    indexes_.invalidate();
+
+    // Select every output before moving anything, so a bad index leaves
+    // this calculator intact
+    std::vector<std::vector<size_t>> targets(chunks);
+    parallelFor(chunks, [&](size_t c) {
+        const auto& chunk = shapes_.chunk(c);
+        targets[c].resize(chunk.size());
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            size_t part = selector(*chunk.shapes[i]);
+            if (part >= parts) {
+                throw std::out_of_range("Partition index out of range");
+            }
+            targets[c][i] = part;
+        }
+    });
+
+    // Attribute rows follow their shapes in order
+    std::vector<std::vector<size_t>> rows(parts);
+    size_t row = 0;
+    for (const auto& chunk_targets : targets) {
+        for (size_t part : chunk_targets) {
+            rows[part].push_back(row++);
+        }
+    }
+
+    // Scatter each chunk into one piece per output
+    std::vector<std::vector<ShapeStore>> pieces(chunks);
+    parallelFor(chunks, [&](size_t c) {
+        auto& chunk = shapes_.chunk(c);
+        pieces[c].resize(parts);
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            pieces[c][targets[c][i]].push(std::move(chunk.shapes[i]), chunk.positions[i]);
+        }
+    });
+
+    // Splice the pieces of each output in chunk order
+    parallelFor(parts, [&](size_t p) {
+        GeometryCalculator& output = outputs[p];
+        for (auto& piece : pieces) {
+            output.shapes_.splice(piece[p]);
+        }
+        output.shapes_.forEach([&](const Shape& shape, const Point&) {
+            output.statistics_.add(shape);
+        });
+        output.attributes_ = attributes_.select(rows[p]);
+        output.content_ = content_.select(rows[p]);
+        output.version_ = nextVersion();
+    });
+
+    shapes_.clear();
+    statistics_.clear();
+    attributes_.clearRows();
+    content_.clear();
+    views_.reset();
+    version_ = nextVersion();
+    if (observer_) {
+        observer_->cleared();
+    }
+    return outputs;
+}
+
+void GeometryCalculator::reserve(size_t count) {
+    // Reserving may reallocate the chunk list that index builds walk
+    indexes_.invalidate();
+    shapes_.reserve(count);
+    attributes_.reserve(count);
+    content_.reserve(count);
+}
+
 size_t GeometryCalculator::shapeCount() const {
     return shapes_.size();
 }
 
 double GeometryCalculator::totalArea() const {
-    double total = 0.0;
-    for (const auto& shape : shapes_) {
-        total += shape->area();
-    }
-    return total;
+    return query(ShapeQuery{QueryAggregate::TotalArea});
 }
 
 double GeometryCalculator::totalPerimeter() const {
-    double total = 0.0;
-    for (const auto& shape : shapes_) {
-        total += shape->perimeter();
+    return query(ShapeQuery{QueryAggregate::TotalPerimeter});
+}
+
+PartialResult GeometryCalculator::totalArea(const Deadline& deadline,
+                                            const PartialResult* resume) const {
+    return sumWithin(shapes_.size(), version_, QueryAggregate::TotalArea, deadline, resume, [this](size_t i) {
+        return shapes_.shape(i).area();
+    });
+}
+
+PartialResult GeometryCalculator::totalPerimeter(const Deadline& deadline,
+                                                 const PartialResult* resume) const {
+    return sumWithin(shapes_.size(), version_, QueryAggregate::TotalPerimeter, deadline, resume,
+                     [this](size_t i) { return shapes_.shape(i).perimeter(); });
+}
+
+double GeometryCalculator::unionPerimeter(double tolerance) const {
+    ShapeQuery union_query{QueryAggregate::UnionPerimeter};
+    union_query.tolerance = tolerance;
+    return query(union_query);
+}
+
+PartialResult GeometryCalculator::unionPerimeter(const Deadline& deadline, double tolerance) const {
+    std::vector<PlacedShape> placed;
+    placed.reserve(shapes_.size());
+    shapes_.forEach([&](const Shape& shape, const Point& position) {
+        placed.push_back({&shape, position});
+    });
+    return geometry::unionPerimeter(placed, deadline, tolerance);
+}
+
+double GeometryCalculator::query(const ShapeQuery& query) const {
+    ShapeQuery normalized = normalizeQuery(query);
+    if (auto cached = cache_.find(normalized, version_)) {
+        return *cached;
     }
-    return total;
+    double value = evaluate(normalized);
+    cache_.insert(normalized, version_, value);
+    return value;
+}
+
+double GeometryCalculator::evaluate(const ShapeQuery& query) const {
+    GEOMETRY_TRACE_SCOPE("query", "evaluate", static_cast<uint64_t>(query.aggregate));
+    bool filtered = query.kinds != kAllShapeKinds || query.min_area > 0.0 ||
+                    query.max_area != std::numeric_limits<double>::infinity();
+    if (filtered && query.aggregate != QueryAggregate::UnionPerimeter) {
+        if (auto index = indexes_.area(shapes_)) {
+            return *index->evaluate(query);
+        }
+    }
+
+    switch (query.aggregate) {
+        case QueryAggregate::Count: {
+            if (!filtered) {
+                return static_cast<double>(shapes_.size());
+            }
+            size_t count = 0;
+            shapes_.forEach([&](const Shape& shape, const Point&) {
+                count += query.matches(shape) ? 1 : 0;
+            });
+            return static_cast<double>(count);
+        }
+        case QueryAggregate::TotalArea: {
+            double total = 0.0;
+            shapes_.forEach([&](const Shape& shape, const Point&) {
+                if (!filtered || query.matches(shape)) {
+                    total += shape.area();
+                }
+            });
+            return total;
+        }
+        case QueryAggregate::TotalPerimeter: {
+            double total = 0.0;
+            shapes_.forEach([&](const Shape& shape, const Point&) {
+                if (!filtered || query.matches(shape)) {
+                    total += shape.perimeter();
+                }
+            });
+            return total;
+        }
+        case QueryAggregate::UnionPerimeter: {
+            std::vector<PlacedShape> placed;
+            placed.reserve(shapes_.size());
+            shapes_.forEach([&](const Shape& shape, const Point& position) {
+                if (!filtered || query.matches(shape)) {
+                    placed.push_back({&shape, position});
+                }
+            });
+            return geometry::unionPerimeter(placed, query.tolerance);
+        }
+    }
+    return 0.0;
+}
+
+std::vector<size_t> GeometryCalculator::shapesIntersecting(const BoundingBox& box) const {
+    if (auto index = indexes_.spatial(shapes_)) {
+        return index->intersecting(box);
+    }
+    std::vector<size_t> result;
+    size_t i = 0;
+    shapes_.forEach([&](const Shape& shape, const Point& position) {
+        if (placedBounds({&shape, position}).intersects(box)) {
+            result.push_back(i);
+        }
+        ++i;
+    });
+    return result;
+}
+
+void GeometryCalculator::buildIndex(IndexKind kind) {
+    indexes_.request(kind, shapes_);
+}
+
+void GeometryCalculator::dropIndex(IndexKind kind) {
+    indexes_.drop(kind);
+}
+
+IndexStatus GeometryCalculator::indexStatus(IndexKind kind) const {
+    return indexes_.status(kind);
+}
+
+bool GeometryCalculator::waitForIndex(IndexKind kind, std::chrono::nanoseconds timeout) const {
+    return indexes_.wait(kind, shapes_, timeout);
+}
+
+void GeometryCalculator::setIndexBuildBudget(std::shared_ptr<IndexBuildBudget> budget) {
+    indexes_.setBudget(std::move(budget));
+}
+
+size_t GeometryCalculator::createView(const std::string& name, const ViewDefinition& definition) {
+    size_t id = views_.add(name, definition);
+    shapes_.forEach([&](const Shape& shape, const Point&) {
+        views_.applyTo(id, shapeFeatures(shape), 1.0);
+    });
+    return id;
+}
+
+bool GeometryCalculator::dropView(const std::string& name) {
+    return views_.remove(name);
+}
+
+void GeometryCalculator::addNumericAttribute(const std::string& name, double default_value) {
+    attributes_.addNumeric(name, default_value);
+}
+
+void GeometryCalculator::addCategoricalAttribute(const std::string& name,
+                                                 const std::string& default_category) {
+    attributes_.addCategorical(name, default_category);
+}
+
+bool GeometryCalculator::dropAttribute(const std::string& name) {
+    return attributes_.drop(name);
+}
+
+void GeometryCalculator::setAttribute(size_t index, const std::string& name, double value) {
+    attributes_.set(index, name, value);
+}
+
+void GeometryCalculator::setAttribute(size_t index, const std::string& name,
+                                      const std::string& category) {
+    attributes_.set(index, name, category);
+}
+
+GroupedTotals GeometryCalculator::weightedAggregate(const WeightedAggregate& aggregate) const {
+    GEOMETRY_TRACE_SCOPE("query", "weightedAggregate", attributes_.rowCount());
+    return attributes_.aggregate(aggregate);
 }
 
 std::string GeometryCalculator::getShapesInfo() const {
     std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
-    
     oss << "=== Geometry Calculator Results ===\n";
     oss << "Total shapes: " << shapes_.size() << "\n\n";
-    
-    for (size_t i = 0; i < shapes_.size(); ++i) {
-        const auto& shape = shapes_[i];
-        oss << "Shape " << (i + 1) << ": " << shape->name() << "\n";
-        oss << "  Area: " << shape->area() << "\n";
-        oss << "  Perimeter: " << shape->perimeter() << "\n\n";
-    }
-    
+    oss << reportPage(0, shapes_.size()).text;
+    oss << reportFooter();
+    return oss.str();
+}
+
+ReportPage GeometryCalculator::reportPage(size_t cursor, size_t page_size) const {
+    return reportPage(cursor, page_size, ShapeQuery{});
+}
+
+ReportPage GeometryCalculator::reportPage(size_t cursor, size_t page_size,
+                                          const ShapeQuery& filter) const {
+    GEOMETRY_TRACE_SCOPE("report", "reportPage", cursor);
+    bool filtered = filter.kinds != kAllShapeKinds || filter.min_area > 0.0 ||
+                    filter.max_area != std::numeric_limits<double>::infinity();
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    ReportPage page;
+    page.next = std::min(cursor, shapes_.size());
+    if (page_size > 0) {
+        shapes_.visitFrom(cursor, [&](size_t index, const Shape& shape, const Point&) {
+            page.next = index + 1;
+            if (!filtered || filter.matches(shape)) {
+                oss << "Shape " << (index + 1) << ": " << shape.name() << "\n";
+                oss << "  Area: " << shape.area() << "\n";
+                oss << "  Perimeter: " << shape.perimeter() << "\n\n";
+                ++page.count;
+            }
+            return page.count < page_size;
+        });
+    }
+    page.text = oss.str();
+    page.has_more = page.next < shapes_.size();
+    return page;
+}
+
+std::string GeometryCalculator::reportFooter() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
     oss << "Totals:\n";
     oss << "  Total Area: " << totalArea() << "\n";
     oss << "  Total Perimeter: " << totalPerimeter() << "\n";
-    
     return oss.str();
 }
 
 void GeometryCalculator::clear() {
+    indexes_.invalidate();
     shapes_.clear();
+    statistics_.clear();
+    views_.reset();
+    attributes_.clearRows();
+    content_.clear();
+    version_ = nextVersion();
+    if (observer_) {
+        observer_->cleared();
+    }
 }
 
 const Shape* GeometryCalculator::getShape(size_t index) const {
     if (index >= shapes_.size()) {
         return nullptr;
     }
-    return shapes_[index].get();
+    return &shapes_.shape(index);
+}
+
+PlacedShape GeometryCalculator::getPlacedShape(size_t index) const {
+    if (index >= shapes_.size()) {
+        return {};
+    }
+    return {&shapes_.shape(index), shapes_.position(index)};
 }
 
 } // namespace geometry
@@ -0,0 +1,228 @@
+#include "materialized_views.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define GEOMETRY_RESTRICT __restrict
+#else
+#define GEOMETRY_RESTRICT
+#endif
+
+using FeatureColumns = std::array<const double*, kShapeFeatureCount>;
+
+/**
+ * @brief Add one shape to every view in a single fused pass
+ *
+ * Written so the loop vectorizes without fast-math: all columns are loaded
+ * unconditionally, the filter outcome only selects a loaded value, and the
+ * arithmetic happens after the select. The outputs are restrict-qualified
+ * so no runtime overlap checks against the input columns are needed.
+ */
+void accumulateViews(size_t count, const std::array<double, kShapeFeatureCount>& f, double sign,
+                     const double* accepts, const FeatureColumns& min, const FeatureColumns& max,
+                     const double* count_weight, const double* area_weight,
+                     const double* perimeter_weight, double* GEOMETRY_RESTRICT sums,
+                     double* GEOMETRY_RESTRICT compensation) {
+    const double f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3];
+    const double area = f[static_cast<size_t>(ShapeFeature::Area)];
+    const double perimeter = f[static_cast<size_t>(ShapeFeature::Perimeter)];
+    const double *min0 = min[0], *min1 = min[1], *min2 = min[2], *min3 = min[3];
+    const double *max0 = max[0], *max1 = max[1], *max2 = max[2], *max3 = max[3];
+
+    for (size_t v = 0; v < count; ++v) {
+        double accept = accepts[v];
+        bool inside = (f0 >= min0[v]) & (f0 <= max0[v]) & (f1 >= min1[v]) & (f1 <= max1[v]) &
+                      (f2 >= min2[v]) & (f2 <= max2[v]) & (f3 >= min3[v]) & (f3 <= max3[v]);
+        double selected = inside ? accept : 0.0;
+        double delta = sign * selected *
+                       (count_weight[v] + area_weight[v] * area + perimeter_weight[v] * perimeter);
+
+        // Kahan-compensated accumulation
+        double y = delta - compensation[v];
+        double t = sums[v] + y;
+        compensation[v] = (t - sums[v]) - y;
+        sums[v] = t;
+    }
+}
+
+} // namespace
+
+ShapeFeatures shapeFeatures(const Shape& shape) {
+    ShapeFeatures features;
+    features.kind = shape.kind();
+    auto& v = features.values;
+    v[static_cast<size_t>(ShapeFeature::Area)] = shape.area();
+    v[static_cast<size_t>(ShapeFeature::Perimeter)] = shape.perimeter();
+
+    double lo = 0.0;
+    double hi = 0.0;
+    switch (shape.kind()) {
+        case ShapeKind::Circle:
+            lo = hi = static_cast<const Circle&>(shape).radius();
+            break;
+        case ShapeKind::Rectangle: {
+            const auto& rect = static_cast<const Rectangle&>(shape);
+            lo = std::min(rect.width(), rect.height());
+            hi = std::max(rect.width(), rect.height());
+            break;
+        }
+        case ShapeKind::Triangle: {
+            auto [a, b, c] = static_cast<const Triangle&>(shape).sides();
+            lo = std::min({a, b, c});
+            hi = std::max({a, b, c});
+            break;
+        }
+        case ShapeKind::Path: {
+            BoundingBox box = static_cast<const Path&>(shape).bounds();
+            lo = std::min(box.max_x - box.min_x, box.max_y - box.min_y);
+            hi = std::max(box.max_x - box.min_x, box.max_y - box.min_y);
+            break;
+        }
+    }
+    v[static_cast<size_t>(ShapeFeature::MinDimension)] = lo;
+    v[static_cast<size_t>(ShapeFeature::MaxDimension)] = hi;
+    return features;
+}
+
+size_t ViewSet::add(const std::string& name, const ViewDefinition& definition) {
+    if (name.empty()) {
+        throw std::invalid_argument("View name must not be empty");
+    }
+    if (ids_.count(name) != 0) {
+        throw std::invalid_argument("View '" + name + "' already exists");
+    }
+    if (definition.aggregate == QueryAggregate::UnionPerimeter) {
+        throw std::invalid_argument("Union perimeter cannot be maintained incrementally");
+    }
+    for (size_t f = 0; f < kShapeFeatureCount; ++f) {
+        if (std::isnan(definition.min[f]) || std::isnan(definition.max[f])) {
+            throw std::invalid_argument("View bounds must not be NaN");
+        }
+    }
+
+    size_t id = names_.size();
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    for (size_t k = 0; k < kShapeKindCount; ++k) {
+        bool accepted = (definition.kinds & kindMask(static_cast<ShapeKind>(k))) != 0;
+        accepts_[k].push_back(accepted ? 1.0 : 0.0);
+    }
+    for (size_t f = 0; f < kShapeFeatureCount; ++f) {
+        min_[f].push_back(definition.min[f]);
+        max_[f].push_back(definition.max[f]);
+    }
+    count_weight_.push_back(definition.aggregate == QueryAggregate::Count ? 1.0 : 0.0);
+    area_weight_.push_back(definition.aggregate == QueryAggregate::TotalArea ? 1.0 : 0.0);
+    perimeter_weight_.push_back(definition.aggregate == QueryAggregate::TotalPerimeter ? 1.0 : 0.0);
+    sums_.push_back(0.0);
+    compensation_.push_back(0.0);
+    ++active_;
+    return id;
+}
+
+bool ViewSet::remove(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+        return false;
+    }
+    size_t id = it->second;
+    ids_.erase(it);
+    names_[id].clear();
+    // A view accepting no kind never changes again
+    for (auto& accepts : accepts_) {
+        accepts[id] = 0.0;
+    }
+    sums_[id] = 0.0;
+    compensation_[id] = 0.0;
+    --active_;
+    return true;
+}
+
+void ViewSet::apply(const ShapeFeatures& features, double sign) {
+    accumulateViews(names_.size(), features.values, sign,
+                    accepts_[static_cast<size_t>(features.kind)].data(),
+                    {min_[0].data(), min_[1].data(), min_[2].data(), min_[3].data()},
+                    {max_[0].data(), max_[1].data(), max_[2].data(), max_[3].data()},
+                    count_weight_.data(), area_weight_.data(), perimeter_weight_.data(),
+                    sums_.data(), compensation_.data());
+}
+
+void ViewSet::applyTo(size_t id, const ShapeFeatures& features, double sign) {
+    value(id);  // Validates the id
+    const auto& f = features.values;
+    bool inside = accepts_[static_cast<size_t>(features.kind)][id] != 0.0;
+    for (size_t k = 0; k < kShapeFeatureCount; ++k) {
+        inside = inside && f[k] >= min_[k][id] && f[k] <= max_[k][id];
+    }
+    if (!inside) {
+        return;
+    }
+    double weight = count_weight_[id] +
+                    area_weight_[id] * f[static_cast<size_t>(ShapeFeature::Area)] +
+                    perimeter_weight_[id] * f[static_cast<size_t>(ShapeFeature::Perimeter)];
+    double y = sign * weight - compensation_[id];
+    double t = sums_[id] + y;
+    compensation_[id] = (t - sums_[id]) - y;
+    sums_[id] = t;
+}
+
+std::vector<size_t> ViewSet::merge(const ViewSet& other) {
+    std::vector<size_t> unmerged;
+    for (size_t id = 0; id < names_.size(); ++id) {
+        if (names_[id].empty()) {
+            continue;
+        }
+        auto it = other.ids_.find(names_[id]);
+        bool same = it != other.ids_.end();
+        size_t o = same ? it->second : 0;
+        for (size_t k = 0; same && k < kShapeKindCount; ++k) {
+            same = accepts_[k][id] == other.accepts_[k][o];
+        }
+        for (size_t f = 0; same && f < kShapeFeatureCount; ++f) {
+            same = min_[f][id] == other.min_[f][o] && max_[f][id] == other.max_[f][o];
+        }
+        same = same && count_weight_[id] == other.count_weight_[o] &&
+               area_weight_[id] == other.area_weight_[o] &&
+               perimeter_weight_[id] == other.perimeter_weight_[o];
+        if (!same) {
+            unmerged.push_back(id);
+            continue;
+        }
+        double y = (other.sums_[o] - other.compensation_[o]) - compensation_[id];
+        double t = sums_[id] + y;
+        compensation_[id] = (t - sums_[id]) - y;
+        sums_[id] = t;
+    }
+    return unmerged;
+}
+
+size_t ViewSet::id(const std::string& name) const {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+        throw std::invalid_argument("No view named '" + name + "'");
+    }
+    return it->second;
+}
+
+double ViewSet::value(size_t id) const {
+    if (id >= names_.size() || names_[id].empty()) {
+        throw std::out_of_range("Invalid view id");
+    }
+    return sums_[id];
+}
+
+void ViewSet::reset() {
+    std::fill(sums_.begin(), sums_.end(), 0.0);
+    std::fill(compensation_.begin(), compensation_.end(), 0.0);
+}
+
+} // namespace geometry
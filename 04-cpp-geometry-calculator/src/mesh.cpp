@@ -0,0 +1,385 @@
+#include "mesh.h"
+#include "batch_math.h"
+#include "parallel.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t kFacesPerBlock = 16384;
+constexpr size_t kStlHeaderSize = 80;
+constexpr size_t kStlRecordSize = 50;
+constexpr size_t kStlChunkRecords = 4096;
+
+/**
+ * @brief Neumaier compensated sum
+ */
+class CompensatedSum {
+private:
+    double sum_ = 0.0;
+    double compensation_ = 0.0;
+
+public:
+    void add(double value) {
+        double t = sum_ + value;
+        if (std::abs(sum_) >= std::abs(value)) {
+            compensation_ += (sum_ - t) + value;
+        } else {
+            compensation_ += (value - t) + sum_;
+        }
+        sum_ = t;
+    }
+
+    double value() const { return sum_ + compensation_; }
+};
+
+/**
+ * @brief Squared length of a triangle's cross-product normal (four times its squared area)
+ */
+double normalLengthSquared(double ax, double ay, double az, double bx, double by, double bz,
+                           double cx, double cy, double cz) {
+    double ux = bx - ax;
+    double uy = by - ay;
+    double uz = bz - az;
+    double vx = cx - ax;
+    double vy = cy - ay;
+    double vz = cz - az;
+    double nx = uy * vz - uz * vy;
+    double ny = uz * vx - ux * vz;
+    double nz = ux * vy - uy * vx;
+    return nx * nx + ny * ny + nz * nz;
+}
+
+double triangleArea(double ax, double ay, double az, double bx, double by, double bz,
+                    double cx, double cy, double cz) {
+    return 0.5 * std::sqrt(normalLengthSquared(ax, ay, az, bx, by, bz, cx, cy, cz));
+}
+
+void validateMesh(const TriangleMesh& mesh) {
+    if (mesh.x.size() != mesh.y.size() || mesh.x.size() != mesh.z.size()) {
+        throw std::invalid_argument("Mesh coordinate arrays differ in length");
+    }
+    if (mesh.indices.size() % 3 != 0) {
+        throw std::invalid_argument("Mesh index count must be a multiple of 3");
+    }
+    if (!mesh.regions.empty() && mesh.regions.size() != mesh.faceCount()) {
+        throw std::invalid_argument("Mesh must have one region id per face");
+    }
+    size_t n = mesh.vertexCount();
+    for (uint32_t index : mesh.indices) {
+        if (index >= n) {
+            throw std::invalid_argument("Mesh face references a missing vertex");
+        }
+    }
+}
+
+/**
+ * @brief Compute per-face areas in parallel blocks
+ * @param face_areas Optional output of one area per face
+ * @return Total area
+ */
+double faceAreas(const TriangleMesh& mesh, std::vector<double>* face_areas) {
+    size_t faces = mesh.faceCount();
+    size_t blocks = (faces + kFacesPerBlock - 1) / kFacesPerBlock;
+    std::vector<double> partial(blocks, 0.0);
+    if (face_areas) {
+        face_areas->resize(faces);
+    }
+
+    const double* x = mesh.x.data();
+    const double* y = mesh.y.data();
+    const double* z = mesh.z.data();
+    const uint32_t* idx = mesh.indices.data();
+    parallelFor(blocks, [&](size_t block) {
+        size_t begin = block * kFacesPerBlock;
+        size_t end = std::min(begin + kFacesPerBlock, faces);
+        std::vector<double> norms(end - begin);
+        for (size_t f = begin; f < end; ++f) {
+            uint32_t a = idx[3 * f];
+            uint32_t b = idx[3 * f + 1];
+            uint32_t c = idx[3 * f + 2];
+            norms[f - begin] = normalLengthSquared(x[a], y[a], z[a], x[b], y[b], z[b], x[c], y[c], z[c]);
+        }
+        batchSqrt(norms.data(), norms.data(), norms.size());
+
+        CompensatedSum sum;
+        for (size_t f = begin; f < end; ++f) {
+            double area = 0.5 * norms[f - begin];
+            if (face_areas) {
+                (*face_areas)[f] = area;
+            }
+            sum.add(area);
+        }
+        partial[block] = sum.value();
+    });
+
+    CompensatedSum total;
+    for (double value : partial) {
+        total.add(value);
+    }
+    return total.value();
+}
+
+struct EdgeRecord {
+    uint64_t key;
+    uint32_t region;
+};
+
+uint32_t readUint32(const char* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+float readFloat(const char* bytes) {
+    float value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Read a binary STL stream chunk by chunk
+ * @param visit Callable invoked with the 9 vertex coordinates of each triangle
+ */
+template <typename Visit>
+void streamBinaryStl(std::istream& in, Visit&& visit) {
+    char header[kStlHeaderSize + sizeof(uint32_t)];
+    if (!in.read(header, sizeof(header))) {
+        throw std::runtime_error("STL stream is truncated");
+    }
+    uint32_t count = readUint32(header + kStlHeaderSize);
+
+    std::vector<char> buffer(kStlChunkRecords * kStlRecordSize);
+    for (uint32_t done = 0; done < count;) {
+        size_t records = std::min<size_t>(kStlChunkRecords, count - done);
+        if (!in.read(buffer.data(), static_cast<std::streamsize>(records * kStlRecordSize))) {
+            throw std::runtime_error("STL stream is truncated");
+        }
+        for (size_t r = 0; r < records; ++r) {
+            // Skip the 12-byte facet normal
+            const char* record = buffer.data() + r * kStlRecordSize + 12;
+            std::array<double, 9> v;
+            for (size_t k = 0; k < 9; ++k) {
+                v[k] = readFloat(record + 4 * k);
+            }
+            visit(v);
+        }
+        done += static_cast<uint32_t>(records);
+    }
+}
+
+struct VertexKey {
+    std::array<uint32_t, 3> bits;
+
+    bool operator==(const VertexKey& other) const { return bits == other.bits; }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (uint32_t b : key.bits) {
+            h = (h ^ b) * 0x100000001b3ULL;
+        }
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+long parseObjIndex(const char*& cursor, size_t vertex_count) {
+    char* end = nullptr;
+    long index = std::strtol(cursor, &end, 10);
+    if (end == cursor || index == 0) {
+        throw std::runtime_error("Malformed OBJ face index");
+    }
+    cursor = end;
+    // Skip texture and normal references
+    while (*cursor && *cursor != ' ' && *cursor != '\t' && *cursor != '\r') {
+        ++cursor;
+    }
+    long resolved = index > 0 ? index - 1 : static_cast<long>(vertex_count) + index;
+    if (resolved < 0) {
+        throw std::runtime_error("OBJ face index out of range");
+    }
+    return resolved;
+}
+
+} // namespace
+
+double meshSurfaceArea(const TriangleMesh& mesh) {
+    validateMesh(mesh);
+    return faceAreas(mesh, nullptr);
+}
+
+MeshStats computeMeshStats(const TriangleMesh& mesh) {
+    validateMesh(mesh);
+    MeshStats stats;
+    std::vector<double> areas;
+    stats.total_area = faceAreas(mesh, &areas);
+
+    size_t faces = mesh.faceCount();
+    uint32_t region_count = static_cast<uint32_t>(std::max<size_t>(mesh.region_names.size(), 1));
+    for (uint32_t region : mesh.regions) {
+        region_count = std::max(region_count, region + 1);
+    }
+    auto regionOf = [&](size_t f) { return mesh.regions.empty() ? 0u : mesh.regions[f]; };
+
+    std::vector<CompensatedSum> region_area(region_count);
+    for (size_t f = 0; f < faces; ++f) {
+        region_area[regionOf(f)].add(areas[f]);
+    }
+    stats.region_area.resize(region_count);
+    for (uint32_t r = 0; r < region_count; ++r) {
+        stats.region_area[r] = region_area[r].value();
+    }
+
+    // Boundary edges are those used by exactly one face
+    std::vector<EdgeRecord> edges(3 * faces);
+    parallelFor(faces, [&](size_t f) {
+        for (size_t k = 0; k < 3; ++k) {
+            uint64_t a = mesh.indices[3 * f + k];
+            uint64_t b = mesh.indices[3 * f + (k + 1) % 3];
+            edges[3 * f + k] = {std::min(a, b) << 32 | std::max(a, b),
+                                static_cast<uint32_t>(regionOf(f))};
+        }
+    }, kFacesPerBlock);
+    std::sort(edges.begin(), edges.end(), [](const EdgeRecord& a, const EdgeRecord& b) {
+        return a.key != b.key ? a.key < b.key : a.region < b.region;
+    });
+
+    auto edgeLength = [&](uint64_t key) {
+        uint32_t a = static_cast<uint32_t>(key >> 32);
+        uint32_t b = static_cast<uint32_t>(key);
+        return std::sqrt((mesh.x[a] - mesh.x[b]) * (mesh.x[a] - mesh.x[b]) +
+                         (mesh.y[a] - mesh.y[b]) * (mesh.y[a] - mesh.y[b]) +
+                         (mesh.z[a] - mesh.z[b]) * (mesh.z[a] - mesh.z[b]));
+    };
+
+    CompensatedSum total_perimeter;
+    std::vector<CompensatedSum> region_perimeter(region_count);
+    for (size_t i = 0; i < edges.size();) {
+        size_t key_end = i;
+        while (key_end < edges.size() && edges[key_end].key == edges[i].key) {
+            ++key_end;
+        }
+        double length = edgeLength(edges[i].key);
+        if (key_end - i == 1) {
+            total_perimeter.add(length);
+        }
+        for (size_t j = i; j < key_end;) {
+            size_t region_end = j;
+            while (region_end < key_end && edges[region_end].region == edges[j].region) {
+                ++region_end;
+            }
+            if (region_end - j == 1) {
+                region_perimeter[edges[j].region].add(length);
+            }
+            j = region_end;
+        }
+        i = key_end;
+    }
+
+    stats.total_perimeter = total_perimeter.value();
+    stats.region_perimeter.resize(region_count);
+    for (uint32_t r = 0; r < region_count; ++r) {
+        stats.region_perimeter[r] = region_perimeter[r].value();
+    }
+    return stats;
+}
+
+TriangleMesh readBinaryStl(std::istream& in) {
+    TriangleMesh mesh;
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> welded;
+    streamBinaryStl(in, [&](const std::array<double, 9>& v) {
+        uint32_t corner[3];
+        for (size_t k = 0; k < 3; ++k) {
+            VertexKey key;
+            for (size_t d = 0; d < 3; ++d) {
+                float f = static_cast<float>(v[3 * k + d]);
+                std::memcpy(&key.bits[d], &f, sizeof(f));
+            }
+            auto it = welded.find(key);
+            if (it == welded.end()) {
+                it = welded.emplace(key, mesh.addVertex(v[3 * k], v[3 * k + 1], v[3 * k + 2])).first;
+            }
+            corner[k] = it->second;
+        }
+        mesh.addFace(corner[0], corner[1], corner[2]);
+    });
+    return mesh;
+}
+
+double binaryStlSurfaceArea(std::istream& in) {
+    CompensatedSum total;
+    streamBinaryStl(in, [&](const std::array<double, 9>& v) {
+        total.add(triangleArea(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8]));
+    });
+    return total.value();
+}
+
+TriangleMesh readObj(std::istream& in) {
+    TriangleMesh mesh;
+    long current_region = -1;
+    std::string line;
+    std::vector<long> polygon;
+    while (std::getline(in, line)) {
+        const char* cursor = line.c_str();
+        while (*cursor == ' ' || *cursor == '\t') {
+            ++cursor;
+        }
+
+        if (cursor[0] == 'v' && (cursor[1] == ' ' || cursor[1] == '\t')) {
+            char* end = nullptr;
+            double coords[3];
+            const char* p = cursor + 1;
+            for (double& c : coords) {
+                c = std::strtod(p, &end);
+                if (end == p) {
+                    throw std::runtime_error("Malformed OBJ vertex");
+                }
+                p = end;
+            }
+            mesh.addVertex(coords[0], coords[1], coords[2]);
+        } else if (cursor[0] == 'f' && (cursor[1] == ' ' || cursor[1] == '\t')) {
+            if (current_region < 0) {
+                mesh.region_names.push_back("default");
+                current_region = 0;
+            }
+            polygon.clear();
+            const char* p = cursor + 1;
+            for (;;) {
+                while (*p == ' ' || *p == '\t' || *p == '\r') {
+                    ++p;
+                }
+                if (*p == '\0') {
+                    break;
+                }
+                polygon.push_back(parseObjIndex(p, mesh.vertexCount()));
+            }
+            if (polygon.size() < 3) {
+                throw std::runtime_error("OBJ face needs at least 3 vertices");
+            }
+            for (size_t k = 1; k + 1 < polygon.size(); ++k) {
+                mesh.addFace(static_cast<uint32_t>(polygon[0]), static_cast<uint32_t>(polygon[k]),
+                             static_cast<uint32_t>(polygon[k + 1]));
+                mesh.regions.push_back(static_cast<uint32_t>(current_region));
+            }
+        } else if ((cursor[0] == 'g' || cursor[0] == 'o') &&
+                   (cursor[1] == ' ' || cursor[1] == '\t' || cursor[1] == '\0')) {
+            std::string name = cursor[1] ? std::string(cursor + 2) : std::string();
+            while (!name.empty() && (name.back() == '\r' || name.back() == ' ')) {
+                name.pop_back();
+            }
+            mesh.region_names.push_back(name);
+            current_region = static_cast<long>(mesh.region_names.size() - 1);
+        }
+    }
+    return mesh;
+}
+
+} // namespace geometry
@@ -0,0 +1,263 @@
+#include "oriented_boxes.h"
+#include "parallel.h"
+#include "predicates.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+double dot(double ux, double uy, const Point& p) {
+    return ux * p.x + uy * p.y;
+}
+
+double cost(double width, double height, BoxCriterion criterion) {
+    return criterion == BoxCriterion::MinArea ? width * height : width + height;
+}
+
+/**
+ * @brief Bring the angle into [0, pi/2), swapping the sides when rotating by a quarter turn
+ */
+OrientedBox normalized(OrientedBox box) {
+    box.angle = std::fmod(box.angle, M_PI);
+    if (box.angle < 0.0) {
+        box.angle += M_PI;
+    }
+    if (box.angle >= M_PI / 2.0) {
+        box.angle -= M_PI / 2.0;
+        std::swap(box.width, box.height);
+    }
+    return box;
+}
+
+/**
+ * @brief Rotating calipers over a counter-clockwise convex polygon
+ */
+OrientedBox calipers(const std::vector<Point>& hull, BoxCriterion criterion) {
+    size_t m = hull.size();
+    if (m == 1) {
+        return {hull[0], 0.0, 0.0, 0.0};
+    }
+    if (m == 2) {
+        double dx = hull[1].x - hull[0].x;
+        double dy = hull[1].y - hull[0].y;
+        Point mid{(hull[0].x + hull[1].x) / 2.0, (hull[0].y + hull[1].y) / 2.0};
+        return normalized({mid, std::hypot(dx, dy), 0.0, std::atan2(dy, dx)});
+    }
+
+    auto next = [m](size_t i) { return i + 1 == m ? 0 : i + 1; };
+    OrientedBox best;
+    double best_cost = std::numeric_limits<double>::infinity();
+    size_t far = 1;    // Farthest from the edge
+    size_t right = 1;  // Furthest along the edge direction
+    size_t left = 0;   // Furthest against the edge direction
+
+    for (size_t i = 0; i < m; ++i) {
+        const Point& a = hull[i];
+        const Point& b = hull[next(i)];
+        double length = std::hypot(b.x - a.x, b.y - a.y);
+        double ux = (b.x - a.x) / length;
+        double uy = (b.y - a.y) / length;
+        double nx = -uy;  // Interior side of a counter-clockwise edge
+        double ny = ux;
+
+        // Each supporting point only moves forward; the step bounds guard
+        // against cycling on ties
+        for (size_t s = 0; s < m && dot(nx, ny, hull[next(far)]) > dot(nx, ny, hull[far]); ++s) {
+            far = next(far);
+        }
+        for (size_t s = 0; s < m && dot(ux, uy, hull[next(right)]) > dot(ux, uy, hull[right]); ++s) {
+            right = next(right);
+        }
+        if (i == 0) {
+            left = far;
+        }
+        for (size_t s = 0; s < m && dot(ux, uy, hull[next(left)]) < dot(ux, uy, hull[left]); ++s) {
+            left = next(left);
+        }
+
+        double lo = dot(ux, uy, hull[left]) - dot(ux, uy, a);
+        double hi = dot(ux, uy, hull[right]) - dot(ux, uy, a);
+        double width = hi - lo;
+        double height = dot(nx, ny, hull[far]) - dot(nx, ny, a);
+        double c = cost(width, height, criterion);
+        if (c < best_cost) {
+            best_cost = c;
+            double along = (lo + hi) / 2.0;
+            best.center = {a.x + ux * along + nx * height / 2.0,
+                           a.y + uy * along + ny * height / 2.0};
+            best.width = width;
+            best.height = height;
+            best.angle = std::atan2(uy, ux);
+        }
+    }
+    return normalized(best);
+}
+
+OrientedBox grown(OrientedBox box, double margin) {
+    box.width += 2.0 * margin;
+    box.height += 2.0 * margin;
+    return box;
+}
+
+/**
+ * @brief Largest distance between a shape and its placedOutline()
+ */
+double outlineGap(const PlacedShape& placed, double tolerance) {
+    switch (placed.shape->kind()) {
+        case ShapeKind::Circle: {
+            double r = static_cast<const Circle*>(placed.shape)->radius();
+            double n = static_cast<double>(circleSegmentCount(r, tolerance));
+            return r * (1.0 - std::cos(M_PI / n));
+        }
+        case ShapeKind::Path:
+            return tolerance;
+        default:
+            return 0.0;
+    }
+}
+
+} // namespace
+
+std::array<Point, 4> OrientedBox::corners() const {
+    double ux = std::cos(angle) * width / 2.0;
+    double uy = std::sin(angle) * width / 2.0;
+    double vx = -std::sin(angle) * height / 2.0;
+    double vy = std::cos(angle) * height / 2.0;
+    return {{{center.x - ux - vx, center.y - uy - vy},
+             {center.x + ux - vx, center.y + uy - vy},
+             {center.x + ux + vx, center.y + uy + vy},
+             {center.x - ux + vx, center.y - uy + vy}}};
+}
+
+void OrientedBoxColumns::resize(size_t count) {
+    center_x.resize(count);
+    center_y.resize(count);
+    width.resize(count);
+    height.resize(count);
+    angle.resize(count);
+}
+
+void OrientedBoxColumns::set(size_t row, const OrientedBox& box) {
+    center_x[row] = box.center.x;
+    center_y[row] = box.center.y;
+    width[row] = box.width;
+    height[row] = box.height;
+    angle[row] = box.angle;
+}
+
+OrientedBox OrientedBoxColumns::box(size_t row) const {
+    return {{center_x[row], center_y[row]}, width[row], height[row], angle[row]};
+}
+
+std::vector<Point> convexHull(std::vector<Point> points) {
+    std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    points.erase(std::unique(points.begin(), points.end(),
+                             [](const Point& a, const Point& b) { return a.x == b.x && a.y == b.y; }),
+                 points.end());
+    if (points.size() < 3) {
+        return points;
+    }
+
+    std::vector<Point> hull(2 * points.size());
+    size_t k = 0;
+    for (const Point& p : points) {  // Lower hull
+        while (k >= 2 && orientation(hull[k - 2], hull[k - 1], p) <= 0) {
+            --k;
+        }
+        hull[k++] = p;
+    }
+    size_t lower = k + 1;
+    for (size_t i = points.size() - 1; i-- > 0;) {  // Upper hull
+        while (k >= lower && orientation(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+            --k;
+        }
+        hull[k++] = points[i];
+    }
+    hull.resize(k - 1);  // The last point repeats the first
+    return hull;
+}
+
+OrientedBox minimumBoundingBox(const std::vector<Point>& points, BoxCriterion criterion) {
+    if (points.empty()) {
+        throw std::invalid_argument("Bounding box needs at least one point");
+    }
+    return calipers(convexHull(points), criterion);
+}
+
+OrientedBox minimumBoundingBox(const PlacedShape& placed, BoxCriterion criterion,
+                               double tolerance) {
+    const Point& p = placed.position;
+    switch (placed.shape->kind()) {
+        case ShapeKind::Circle: {
+            double d = 2.0 * static_cast<const Circle*>(placed.shape)->radius();
+            return {p, d, d, 0.0};
+        }
+        case ShapeKind::Rectangle: {
+            const auto* rect = static_cast<const Rectangle*>(placed.shape);
+            return {{p.x + rect->width() / 2.0, p.y + rect->height() / 2.0},
+                    rect->width(), rect->height(), 0.0};
+        }
+        case ShapeKind::Triangle:
+            return minimumBoundingBox(placedVertices(placed), criterion);
+        case ShapeKind::Path:
+            return grown(minimumBoundingBox(placedOutline(placed, tolerance), criterion),
+                         outlineGap(placed, tolerance));
+    }
+    return {};
+}
+
+OrientedBoxColumns orientedBoxes(const std::vector<PlacedShape>& shapes, BoxCriterion criterion,
+                                 double tolerance) {
+    OrientedBoxColumns columns;
+    columns.resize(shapes.size());
+    parallelFor(shapes.size(), [&](size_t i) {
+        columns.set(i, minimumBoundingBox(shapes[i], criterion, tolerance));
+    }, 64);
+    return columns;
+}
+
+OrientedBoxColumns groupOrientedBoxes(const std::vector<PlacedShape>& shapes,
+                                      const std::vector<size_t>& group_of, size_t groups,
+                                      BoxCriterion criterion, double tolerance) {
+    if (group_of.size() != shapes.size()) {
+        throw std::invalid_argument("Every shape needs a group index");
+    }
+    std::vector<std::vector<size_t>> members(groups);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (group_of[i] >= groups) {
+            throw std::out_of_range("Group index out of range");
+        }
+        members[group_of[i]].push_back(i);
+    }
+
+    OrientedBoxColumns columns;
+    columns.resize(groups);
+    parallelFor(groups, [&](size_t g) {
+        if (members[g].empty()) {
+            return;
+        }
+        if (members[g].size() == 1) {
+            columns.set(g, minimumBoundingBox(shapes[members[g][0]], criterion, tolerance));
+            return;
+        }
+        std::vector<Point> points;
+        double gap = 0.0;
+        for (size_t i : members[g]) {
+            std::vector<Point> outline = placedOutline(shapes[i], tolerance);
+            points.insert(points.end(), outline.begin(), outline.end());
+            gap = std::max(gap, outlineGap(shapes[i], tolerance));
+        }
+        columns.set(g, grown(minimumBoundingBox(points, criterion), gap));
+    });
+    return columns;
+}
+
+} // namespace geometry
@@ -0,0 +1,105 @@
+#include "placement.h"
+#include "batch_math.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t kMinCircleSegments = 16;
+constexpr size_t kMaxCircleSegments = 1 << 16;
+
+} // namespace
+
+BoundingBox placedBounds(const PlacedShape& placed) {
+    const Point& p = placed.position;
+    if (placed.shape->kind() == ShapeKind::Circle) {
+        double r = static_cast<const Circle*>(placed.shape)->radius();
+        return {p.x - r, p.y - r, p.x + r, p.y + r};
+    }
+
+    if (placed.shape->kind() == ShapeKind::Path) {
+        BoundingBox box = static_cast<const Path*>(placed.shape)->bounds();
+        return {box.min_x + p.x, box.min_y + p.y, box.max_x + p.x, box.max_y + p.y};
+    }
+
+    std::vector<Point> vertices = placedVertices(placed);
+    BoundingBox box{vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y};
+    for (const Point& v : vertices) {
+        box.min_x = std::min(box.min_x, v.x);
+        box.min_y = std::min(box.min_y, v.y);
+        box.max_x = std::max(box.max_x, v.x);
+        box.max_y = std::max(box.max_y, v.y);
+    }
+    return box;
+}
+
+std::vector<Point> placedVertices(const PlacedShape& placed) {
+    const Point& p = placed.position;
+    switch (placed.shape->kind()) {
+        case ShapeKind::Rectangle: {
+            const auto* rect = static_cast<const Rectangle*>(placed.shape);
+            double w = rect->width();
+            double h = rect->height();
+            return {{p.x, p.y}, {p.x + w, p.y}, {p.x + w, p.y + h}, {p.x, p.y + h}};
+        }
+        case ShapeKind::Triangle: {
+            auto [a, b, c] = static_cast<const Triangle*>(placed.shape)->sides();
+            double x = (a * a + c * c - b * b) / (2.0 * a);
+            double y = std::sqrt(std::max(0.0, c * c - x * x));
+            return {{p.x, p.y}, {p.x + a, p.y}, {p.x + x, p.y + y}};
+        }
+        default:
+            throw std::invalid_argument("Shape has no polygonal vertices");
+    }
+}
+
+std::vector<Point> placedOutline(const PlacedShape& placed, double tolerance) {
+    if (placed.shape->kind() == ShapeKind::Path) {
+        std::vector<Point> outline = static_cast<const Path*>(placed.shape)->flatten(tolerance);
+        for (Point& p : outline) {
+            p.x += placed.position.x;
+            p.y += placed.position.y;
+        }
+        return outline;
+    }
+    if (placed.shape->kind() != ShapeKind::Circle) {
+        return placedVertices(placed);
+    }
+
+    double r = static_cast<const Circle*>(placed.shape)->radius();
+    size_t n = circleSegmentCount(r, tolerance);
+    std::vector<double> sines(n);
+    std::vector<double> cosines(n);
+    for (size_t i = 0; i < n; ++i) {
+        sines[i] = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+    }
+    batchSinCos(sines.data(), sines.data(), cosines.data(), n);
+
+    std::vector<Point> outline(n);
+    for (size_t i = 0; i < n; ++i) {
+        outline[i] = {placed.position.x + r * cosines[i], placed.position.y + r * sines[i]};
+    }
+    return outline;
+}
+
+size_t circleSegmentCount(double radius, double tolerance) {
+    if (tolerance <= 0) {
+        throw std::invalid_argument("Tolerance must be positive");
+    }
+    if (tolerance >= radius) {
+        return kMinCircleSegments;
+    }
+    // Sagitta of a chord spanning angle 2*theta is r * (1 - cos(theta))
+    double theta = std::acos(1.0 - tolerance / radius);
+    double n = std::ceil(M_PI / theta);
+    return std::clamp(static_cast<size_t>(n), kMinCircleSegments, kMaxCircleSegments);
+}
+
+} // namespace geometry
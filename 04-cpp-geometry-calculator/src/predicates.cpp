@@ -0,0 +1,145 @@
+#include "predicates.h"
+#include <vector>
+
+namespace geometry {
+
+namespace {
+
+/**
+ * Expansions are sums of non-overlapping doubles stored in increasing
+ * magnitude with zeros removed, so the sign of the last component is the
+ * sign of the sum. Operations follow Shewchuk, "Adaptive Precision
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+ */
+using Expansion = std::vector<double>;
+
+void twoSum(double a, double b, double& sum, double& error) {
+    sum = a + b;
+    double virtual_b = sum - a;
+    double virtual_a = sum - virtual_b;
+    error = (a - virtual_a) + (b - virtual_b);
+}
+
+void twoProduct(double a, double b, double& product, double& error) {
+    product = a * b;
+    error = std::fma(a, b, -product);
+}
+
+Expansion difference(double a, double b) {
+    double sum, error;
+    twoSum(a, -b, sum, error);
+    Expansion result;
+    if (error != 0.0) {
+        result.push_back(error);
+    }
+    if (sum != 0.0) {
+        result.push_back(sum);
+    }
+    return result;
+}
+
+Expansion grow(const Expansion& e, double b) {
+    Expansion result;
+    result.reserve(e.size() + 1);
+    double q = b;
+    for (double component : e) {
+        double h;
+        twoSum(q, component, q, h);
+        if (h != 0.0) {
+            result.push_back(h);
+        }
+    }
+    if (q != 0.0) {
+        result.push_back(q);
+    }
+    return result;
+}
+
+Expansion add(const Expansion& e, const Expansion& f) {
+    Expansion result = e;
+    for (double component : f) {
+        result = grow(result, component);
+    }
+    return result;
+}
+
+Expansion negate(Expansion e) {
+    for (double& component : e) {
+        component = -component;
+    }
+    return e;
+}
+
+Expansion scale(const Expansion& e, double b) {
+    Expansion result;
+    if (e.empty() || b == 0.0) {
+        return result;
+    }
+    result.reserve(2 * e.size());
+    double q, h;
+    twoProduct(e[0], b, q, h);
+    if (h != 0.0) {
+        result.push_back(h);
+    }
+    for (size_t i = 1; i < e.size(); ++i) {
+        double product, product_error, sum;
+        twoProduct(e[i], b, product, product_error);
+        twoSum(q, product_error, sum, h);
+        if (h != 0.0) {
+            result.push_back(h);
+        }
+        twoSum(product, sum, q, h);
+        if (h != 0.0) {
+            result.push_back(h);
+        }
+    }
+    if (q != 0.0) {
+        result.push_back(q);
+    }
+    return result;
+}
+
+Expansion multiply(const Expansion& e, const Expansion& f) {
+    Expansion result;
+    for (double component : f) {
+        result = add(result, scale(e, component));
+    }
+    return result;
+}
+
+int sign(const Expansion& e) {
+    if (e.empty()) {
+        return 0;
+    }
+    return e.back() > 0.0 ? 1 : -1;
+}
+
+} // namespace
+
+int orientationExact(const Point& a, const Point& b, const Point& c) {
+    Expansion acx = difference(a.x, c.x);
+    Expansion acy = difference(a.y, c.y);
+    Expansion bcx = difference(b.x, c.x);
+    Expansion bcy = difference(b.y, c.y);
+    return sign(add(multiply(acx, bcy), negate(multiply(acy, bcx))));
+}
+
+int inCircleExact(const Point& a, const Point& b, const Point& c, const Point& d) {
+    Expansion adx = difference(a.x, d.x), ady = difference(a.y, d.y);
+    Expansion bdx = difference(b.x, d.x), bdy = difference(b.y, d.y);
+    Expansion cdx = difference(c.x, d.x), cdy = difference(c.y, d.y);
+
+    auto lift = [](const Expansion& x, const Expansion& y) {
+        return add(multiply(x, x), multiply(y, y));
+    };
+    auto cross = [](const Expansion& ux, const Expansion& uy, const Expansion& vx, const Expansion& vy) {
+        return add(multiply(ux, vy), negate(multiply(uy, vx)));
+    };
+
+    Expansion det = multiply(lift(adx, ady), cross(bdx, bdy, cdx, cdy));
+    det = add(det, multiply(lift(bdx, bdy), cross(cdx, cdy, adx, ady)));
+    det = add(det, multiply(lift(cdx, cdy), cross(adx, ady, bdx, bdy)));
+    return sign(det);
+}
+
+} // namespace geometry
@@ -0,0 +1,152 @@
+#include "query_cache.h"
+#include "hashing.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace geometry {
+
+bool ShapeQuery::matches(const Shape& shape) const {
+    if ((kinds & kindMask(shape.kind())) == 0) {
+        return false;
+    }
+    double area = shape.area();
+    return area >= min_area && area <= max_area;
+}
+
+ShapeQuery normalizeQuery(const ShapeQuery& query) {
+    if (std::isnan(query.min_area) || std::isnan(query.max_area) || std::isnan(query.tolerance)) {
+        throw std::invalid_argument("Query bounds and tolerance must not be NaN");
+    }
+
+    ShapeQuery normalized = query;
+    normalized.kinds &= kAllShapeKinds;
+    // Shape areas are positive, so negative lower bounds filter nothing;
+    // adding 0.0 also turns -0.0 into +0.0
+    normalized.min_area = std::max(query.min_area, 0.0) + 0.0;
+    normalized.max_area = query.max_area + 0.0;
+
+    if (normalized.kinds == 0 || normalized.max_area < normalized.min_area) {
+        normalized.kinds = 0;
+        normalized.min_area = 0.0;
+        normalized.max_area = std::numeric_limits<double>::infinity();
+    }
+
+    if (normalized.aggregate == QueryAggregate::UnionPerimeter) {
+        if (normalized.tolerance <= 0.0) {
+            throw std::invalid_argument("Union perimeter tolerance must be positive");
+        }
+    } else {
+        normalized.tolerance = 0.0;
+    }
+    return normalized;
+}
+
+uint64_t queryHash(const ShapeQuery& query) {
+    uint64_t h = mix64(static_cast<uint64_t>(query.aggregate));
+    h = mix64(h ^ query.kinds);
+    h = mix64(h ^ doubleBits(query.min_area));
+    h = mix64(h ^ doubleBits(query.max_area));
+    return mix64(h ^ doubleBits(query.tolerance));
+}
+
+QueryCache::QueryCache(size_t capacity) : capacity_(capacity) {}
+
+QueryCache::QueryCache(QueryCache&& other) noexcept {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    capacity_ = other.capacity_;
+    entries_ = std::move(other.entries_);
+    index_ = std::move(other.index_);
+    hits_ = other.hits_;
+    misses_ = other.misses_;
+}
+
+QueryCache& QueryCache::operator=(QueryCache&& other) noexcept {
+    if (this != &other) {
+        std::scoped_lock lock(mutex_, other.mutex_);
+        capacity_ = other.capacity_;
+        entries_ = std::move(other.entries_);
+        index_ = std::move(other.index_);
+        hits_ = other.hits_;
+        misses_ = other.misses_;
+    }
+    return *this;
+}
+
+std::optional<double> QueryCache::find(const ShapeQuery& query, uint64_t version) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(query);
+    if (it == index_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+    if (it->second->version != version) {
+        // Computed before the last mutation
+        entries_.erase(it->second);
+        index_.erase(it);
+        ++misses_;
+        return std::nullopt;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    ++hits_;
+    return it->second->value;
+}
+
+void QueryCache::insert(const ShapeQuery& query, uint64_t version, double value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+    auto it = index_.find(query);
+    if (it != index_.end()) {
+        it->second->version = version;
+        it->second->value = value;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+    if (entries_.size() == capacity_) {
+        index_.erase(entries_.back().query);
+        entries_.pop_back();
+    }
+    entries_.push_front({query, version, value});
+    index_.emplace(query, entries_.begin());
+}
+
+void QueryCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    while (entries_.size() > capacity_) {
+        index_.erase(entries_.back().query);
+        entries_.pop_back();
+    }
+}
+
+size_t QueryCache::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+size_t QueryCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t QueryCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t QueryCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void QueryCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+} // namespace geometry
@@ -0,0 +1,395 @@
+#include "replication.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <tuple>
+#include <unistd.h>
+
+namespace geometry {
+
+namespace {
+
+constexpr uint32_t kFrameMagic = 0x50524347;  // "GCRP"
+constexpr size_t kReadBytes = 64 * 1024;
+
+struct FrameHeader {
+    uint32_t magic;
+    uint32_t payload_bytes;
+    uint64_t sequence;
+    uint64_t shape_count;
+    uint64_t content_hash;
+};
+
+enum class DeltaOp : uint8_t {
+    Add = 1,
+    Replace,
+    Move,
+    Remove,
+    Clear
+};
+
+template <typename T>
+void put(std::vector<unsigned char>& out, T value) {
+    size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+void putPoint(std::vector<unsigned char>& out, const Point& point) {
+    put(out, point.x);
+    put(out, point.y);
+}
+
+void putShape(std::vector<unsigned char>& out, const Shape& shape) {
+    put(out, static_cast<uint8_t>(shape.kind()));
+    switch (shape.kind()) {
+        case ShapeKind::Circle:
+            put(out, static_cast<const Circle&>(shape).radius());
+            break;
+        case ShapeKind::Rectangle: {
+            const auto& rectangle = static_cast<const Rectangle&>(shape);
+            put(out, rectangle.width());
+            put(out, rectangle.height());
+            break;
+        }
+        case ShapeKind::Triangle: {
+            double a, b, c;
+            std::tie(a, b, c) = static_cast<const Triangle&>(shape).sides();
+            put(out, a);
+            put(out, b);
+            put(out, c);
+            break;
+        }
+        case ShapeKind::Path: {
+            const auto& segments = static_cast<const Path&>(shape).segments();
+            put(out, static_cast<uint64_t>(segments.size()));
+            for (const PathSegment& segment : segments) {
+                put(out, static_cast<uint8_t>(segment.type));
+                for (const Point& point : segment.points) {
+                    putPoint(out, point);
+                }
+                put(out, segment.radius);
+                put(out, segment.start_angle);
+                put(out, segment.sweep);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Bounds-checked cursor over a frame payload
+ */
+class FrameReader {
+public:
+    FrameReader(const unsigned char* data, size_t size) : data_(data), end_(data + size) {}
+
+    bool done() const { return data_ == end_; }
+
+    template <typename T>
+    T get() {
+        if (static_cast<size_t>(end_ - data_) < sizeof(T)) {
+            throw std::runtime_error("Replication frame is truncated");
+        }
+        T value;
+        std::memcpy(&value, data_, sizeof(T));
+        data_ += sizeof(T);
+        return value;
+    }
+
+    Point getPoint() {
+        double x = get<double>();
+        double y = get<double>();
+        return Point{x, y};
+    }
+
+    std::unique_ptr<Shape> getShape() {
+        switch (static_cast<ShapeKind>(get<uint8_t>())) {
+            case ShapeKind::Circle:
+                return std::make_unique<Circle>(get<double>());
+            case ShapeKind::Rectangle: {
+                double width = get<double>();
+                double height = get<double>();
+                return std::make_unique<Rectangle>(width, height);
+            }
+            case ShapeKind::Triangle: {
+                double a = get<double>();
+                double b = get<double>();
+                double c = get<double>();
+                return std::make_unique<Triangle>(a, b, c);
+            }
+            case ShapeKind::Path: {
+                uint64_t count = get<uint64_t>();
+                std::vector<PathSegment> segments;
+                for (uint64_t s = 0; s < count; ++s) {
+                    PathSegment segment;
+                    segment.type = static_cast<PathSegment::Type>(get<uint8_t>());
+                    for (Point& point : segment.points) {
+                        point = getPoint();
+                    }
+                    segment.radius = get<double>();
+                    segment.start_angle = get<double>();
+                    segment.sweep = get<double>();
+                    segments.push_back(segment);
+                }
+                return std::make_unique<Path>(std::move(segments));
+            }
+        }
+        throw std::runtime_error("Malformed replication frame");
+    }
+
+private:
+    const unsigned char* data_;
+    const unsigned char* end_;
+};
+
+void applyDeltas(GeometryCalculator& calculator, FrameReader& reader) {
+    while (!reader.done()) {
+        switch (static_cast<DeltaOp>(reader.get<uint8_t>())) {
+            case DeltaOp::Add: {
+                std::unique_ptr<Shape> shape = reader.getShape();
+                calculator.addShape(std::move(shape), reader.getPoint());
+                break;
+            }
+            case DeltaOp::Replace: {
+                size_t index = reader.get<uint64_t>();
+                calculator.replaceShape(index, reader.getShape());
+                break;
+            }
+            case DeltaOp::Move: {
+                size_t index = reader.get<uint64_t>();
+                calculator.setPosition(index, reader.getPoint());
+                break;
+            }
+            case DeltaOp::Remove: {
+                uint64_t count = reader.get<uint64_t>();
+                if (count == 1) {
+                    calculator.removeShape(reader.get<uint64_t>());
+                    break;
+                }
+                CalculatorBatch batch = calculator.beginBatch();
+                for (uint64_t i = 0; i < count; ++i) {
+                    batch.removeShape(reader.get<uint64_t>());
+                }
+                batch.commit();
+                break;
+            }
+            case DeltaOp::Clear:
+                calculator.clear();
+                break;
+            default:
+                throw std::runtime_error("Malformed replication frame");
+        }
+    }
+}
+
+[[noreturn]] void throwChannelError(const char* operation) {
+    throw std::runtime_error(std::string("Replication ") + operation + " failed: " + std::strerror(errno));
+}
+
+void writeAll(int fd, const unsigned char* data, size_t size) {
+    while (size > 0) {
+        // MSG_NOSIGNAL turns a closed socket into EPIPE instead of SIGPIPE
+        ssize_t written = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0 && errno == ENOTSOCK) {
+            written = ::write(fd, data, size);
+        }
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwChannelError("write");
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+} // namespace
+
+ReplicationLeader::ReplicationLeader(GeometryCalculator& calculator, int fd, size_t frame_bytes)
+    : calculator_(calculator), fd_(fd), frame_bytes_(frame_bytes), frame_(sizeof(FrameHeader)) {
+    cleared();
+    for (size_t i = 0; i < calculator_.shapeCount(); ++i) {
+        PlacedShape placed = calculator_.getPlacedShape(i);
+        shapeAdded(*placed.shape, placed.position);
+    }
+    flush();
+    calculator_.setObserver(this);
+}
+
+ReplicationLeader::~ReplicationLeader() {
+    calculator_.setObserver(nullptr);
+    if (!failed()) {
+        try {
+            send();
+        } catch (const std::runtime_error&) {
+            // The follower is gone; nothing left to deliver to
+        }
+    }
+}
+
+size_t ReplicationLeader::pendingBytes() const {
+    return frame_.size() - sizeof(FrameHeader);
+}
+
+void ReplicationLeader::flush() {
+    if (failed()) {
+        throw std::runtime_error(error_);
+    }
+    send();
+}
+
+void ReplicationLeader::send() {
+    if (pendingBytes() == 0) {
+        return;
+    }
+    FrameHeader header{kFrameMagic, static_cast<uint32_t>(pendingBytes()), sequence_ + 1, replica_.size(),
+                       replica_.rootHash()};
+    std::memcpy(frame_.data(), &header, sizeof(header));
+    try {
+        writeAll(fd_, frame_.data(), frame_.size());
+    } catch (const std::runtime_error& error) {
+        // Stop replicating; the replica can no longer be brought in line
+        error_ = error.what();
+        frame_.resize(sizeof(FrameHeader));
+        calculator_.setObserver(nullptr);
+        throw;
+    }
+    ++sequence_;
+    frame_.resize(sizeof(FrameHeader));
+}
+
+void ReplicationLeader::shapeAdded(const Shape& shape, const Point& position) {
+    put(frame_, DeltaOp::Add);
+    putShape(frame_, shape);
+    putPoint(frame_, position);
+    replica_.push(shapeContentHash(shape, position));
+    opFinished();
+}
+
+void ReplicationLeader::shapeReplaced(size_t index, const Shape& shape) {
+    put(frame_, DeltaOp::Replace);
+    put(frame_, static_cast<uint64_t>(index));
+    putShape(frame_, shape);
+    replica_.set(index, shapeContentHash(shape, calculator_.getPlacedShape(index).position));
+    opFinished();
+}
+
+void ReplicationLeader::shapeMoved(size_t index, const Point& position) {
+    put(frame_, DeltaOp::Move);
+    put(frame_, static_cast<uint64_t>(index));
+    putPoint(frame_, position);
+    replica_.set(index, shapeContentHash(*calculator_.getShape(index), position));
+    opFinished();
+}
+
+void ReplicationLeader::shapesRemoved(const std::vector<size_t>& indices) {
+    put(frame_, DeltaOp::Remove);
+    put(frame_, static_cast<uint64_t>(indices.size()));
+    for (size_t index : indices) {
+        put(frame_, static_cast<uint64_t>(index));
+    }
+    replica_.eraseSorted(indices);
+    opFinished();
+}
+
+void ReplicationLeader::cleared() {
+    put(frame_, DeltaOp::Clear);
+    replica_.clear();
+    opFinished();
+}
+
+void ReplicationLeader::opFinished() {
+    if (pendingBytes() >= frame_bytes_) {
+        try {
+            send();
+        } catch (const std::runtime_error&) {
+            // Recorded in error_; the calculator's mutation must go on
+        }
+    }
+}
+
+ReplicationFollower::ReplicationFollower(int fd) : fd_(fd) {}
+
+GeometryCalculator ReplicationFollower::takeOver() {
+    taken_over_ = true;
+    received_.clear();
+    return std::move(calculator_);
+}
+
+size_t ReplicationFollower::poll(std::chrono::milliseconds timeout) {
+    if (taken_over_) {
+        throw std::logic_error("Replication follower was taken over");
+    }
+    size_t applied = 0;
+    int wait = static_cast<int>(timeout.count());
+    while (!closed_) {
+        pollfd entry{fd_, POLLIN, 0};
+        int ready = ::poll(&entry, 1, wait);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwChannelError("poll");
+        }
+        if (ready == 0) {
+            break;
+        }
+
+        size_t old_size = received_.size();
+        received_.resize(old_size + kReadBytes);
+        ssize_t got = ::read(fd_, received_.data() + old_size, kReadBytes);
+        received_.resize(old_size + static_cast<size_t>(got > 0 ? got : 0));
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwChannelError("read");
+        }
+        closed_ = got == 0;
+        applied += applyFrames();
+        wait = 0;
+    }
+    return applied;
+}
+
+size_t ReplicationFollower::applyFrames() {
+    size_t applied = 0;
+    size_t offset = 0;
+    while (received_.size() - offset >= sizeof(FrameHeader)) {
+        FrameHeader header;
+        std::memcpy(&header, received_.data() + offset, sizeof(header));
+        if (header.magic != kFrameMagic) {
+            throw std::runtime_error("Malformed replication frame");
+        }
+        size_t frame_size = sizeof(FrameHeader) + header.payload_bytes;
+        if (received_.size() - offset < frame_size) {
+            break;
+        }
+        if (header.sequence != sequence_ + 1) {
+            throw std::runtime_error("Replication frame out of sequence");
+        }
+
+        FrameReader reader(received_.data() + offset + sizeof(FrameHeader), header.payload_bytes);
+        applyDeltas(calculator_, reader);
+        if (calculator_.shapeCount() != header.shape_count ||
+            calculator_.content().rootHash() != header.content_hash) {
+            throw std::runtime_error("Replica diverged from leader");
+        }
+        sequence_ = header.sequence;
+        offset += frame_size;
+        ++applied;
+    }
+    received_.erase(received_.begin(), received_.begin() + static_cast<ptrdiff_t>(offset));
+    return applied;
+}
+
+} // namespace geometry
@@ -0,0 +1,240 @@
+#include "shape_distance.h"
+#include "batch_math.h"
+#include "parallel.h"
+#include "shapes/circle.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t kVertices = 4;
+constexpr size_t kBlock = 128;
+
+/**
+ * @brief Operands of one kind combination gathered from a block of pairs
+ *
+ * For mixed pairs the circle is always operand a.
+ */
+struct PairBlock {
+    size_t count = 0;
+    size_t pair[kBlock];
+    double ax[kVertices][kBlock];
+    double ay[kVertices][kBlock];
+    double bx[kVertices][kBlock];
+    double by[kVertices][kBlock];
+    double radius[kBlock];   // Sum of both radii
+    double contact[kBlock];  // 1 if the polygons overlap
+    double dist2[kBlock];    // Squared distance between the cores
+};
+
+/**
+ * @brief Squared distance from (px, py), relative to the segment start, to a segment
+ */
+inline double segmentDistance2(double px, double py, double ex, double ey) {
+    double len2 = std::max(ex * ex + ey * ey, std::numeric_limits<double>::min());
+    double t = std::min(std::max((px * ex + py * ey) / len2, 0.0), 1.0);
+    double dx = px - t * ex;
+    double dy = py - t * ey;
+    return dx * dx + dy * dy;
+}
+
+void circleCircle(PairBlock& block) {
+    for (size_t k = 0; k < block.count; ++k) {
+        double dx = block.bx[0][k] - block.ax[0][k];
+        double dy = block.by[0][k] - block.ay[0][k];
+        block.contact[k] = 0.0;
+        block.dist2[k] = dx * dx + dy * dy;
+    }
+}
+
+void circlePolygon(PairBlock& block) {
+    for (size_t k = 0; k < block.count; ++k) {
+        double best = std::numeric_limits<double>::infinity();
+        double min_cross = std::numeric_limits<double>::infinity();
+        for (size_t j = 0; j < kVertices; ++j) {
+            size_t n = (j + 1) % kVertices;
+            double ex = block.bx[n][k] - block.bx[j][k];
+            double ey = block.by[n][k] - block.by[j][k];
+            double px = block.ax[0][k] - block.bx[j][k];
+            double py = block.ay[0][k] - block.by[j][k];
+            best = std::min(best, segmentDistance2(px, py, ex, ey));
+            min_cross = std::min(min_cross, ex * py - ey * px);
+        }
+        block.contact[k] = min_cross >= 0.0 ? 1.0 : 0.0;
+        block.dist2[k] = best;
+    }
+}
+
+/**
+ * @brief Vertex-to-edge distances of q against the edges of p, and whether an edge of p separates q
+ */
+inline void polygonEdges(const double (&px)[kVertices][kBlock], const double (&py)[kVertices][kBlock],
+                         const double (&qx)[kVertices][kBlock], const double (&qy)[kVertices][kBlock],
+                         size_t k, double& best, double& separated) {
+    for (size_t i = 0; i < kVertices; ++i) {
+        size_t n = (i + 1) % kVertices;
+        double ex = px[n][k] - px[i][k];
+        double ey = py[n][k] - py[i][k];
+        double max_cross = -std::numeric_limits<double>::infinity();
+        for (size_t j = 0; j < kVertices; ++j) {
+            double rx = qx[j][k] - px[i][k];
+            double ry = qy[j][k] - py[i][k];
+            best = std::min(best, segmentDistance2(rx, ry, ex, ey));
+            max_cross = std::max(max_cross, ex * ry - ey * rx);
+        }
+        // Degenerate (repeated-vertex) edges give zero crosses and never separate
+        separated = std::max(separated, max_cross < 0.0 ? 1.0 : 0.0);
+    }
+}
+
+void polygonPolygon(PairBlock& block) {
+    for (size_t k = 0; k < block.count; ++k) {
+        double best = std::numeric_limits<double>::infinity();
+        double separated = 0.0;
+        polygonEdges(block.ax, block.ay, block.bx, block.by, k, best, separated);
+        polygonEdges(block.bx, block.by, block.ax, block.ay, k, best, separated);
+        block.contact[k] = 1.0 - separated;
+        block.dist2[k] = best;
+    }
+}
+
+void checkPairs(const std::vector<ShapePair>& pairs, size_t count) {
+    for (const ShapePair& pair : pairs) {
+        if (pair.first >= count || pair.second >= count) {
+            throw std::out_of_range("Shape pair index out of range");
+        }
+    }
+}
+
+} // namespace
+
+DistanceShapes::DistanceShapes(const std::vector<PlacedShape>& shapes) {
+    size_t count = shapes.size();
+    round_.resize(count);
+    for (size_t v = 0; v < kMaxVertices; ++v) {
+        x_[v].resize(count);
+        y_[v].resize(count);
+    }
+    radius_.resize(count);
+    bound_x_.resize(count);
+    bound_y_.resize(count);
+    bound_radius_.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const PlacedShape& placed = shapes[i];
+        if (!placed.shape || placed.shape->kind() == ShapeKind::Path) {
+            throw std::invalid_argument("Distance kernels support circles, rectangles and triangles");
+        }
+        std::vector<Point> vertices;
+        if (placed.shape->kind() == ShapeKind::Circle) {
+            round_[i] = 1;
+            radius_[i] = static_cast<const Circle*>(placed.shape)->radius();
+            vertices.push_back(placed.position);
+        } else {
+            vertices = placedVertices(placed);
+        }
+
+        double cx = 0.0;
+        double cy = 0.0;
+        for (size_t v = 0; v < kMaxVertices; ++v) {
+            const Point& p = vertices[std::min(v, vertices.size() - 1)];
+            x_[v][i] = p.x;
+            y_[v][i] = p.y;
+        }
+        for (const Point& p : vertices) {
+            cx += p.x / static_cast<double>(vertices.size());
+            cy += p.y / static_cast<double>(vertices.size());
+        }
+        double reach = 0.0;
+        for (const Point& p : vertices) {
+            reach = std::max(reach, std::hypot(p.x - cx, p.y - cy));
+        }
+        bound_x_[i] = cx;
+        bound_y_[i] = cy;
+        bound_radius_[i] = reach + radius_[i];
+    }
+}
+
+void DistanceShapes::run(const std::vector<ShapePair>& pairs, double threshold, double* distances,
+                         uint8_t* flags) const {
+    size_t blocks = (pairs.size() + kBlock - 1) / kBlock;
+    parallelFor(blocks, [&](size_t b) {
+        size_t begin = b * kBlock;
+        size_t end = std::min(begin + kBlock, pairs.size());
+        PairBlock groups[3];  // Polygon-polygon, circle-polygon, circle-circle
+
+        for (size_t p = begin; p < end; ++p) {
+            size_t a = pairs[p].first;
+            size_t c = pairs[p].second;
+            if (!distances) {
+                flags[p] = 0;
+                // Bounding circles already at least the threshold apart
+                double gap = std::hypot(bound_x_[c] - bound_x_[a], bound_y_[c] - bound_y_[a]) -
+                             bound_radius_[a] - bound_radius_[c];
+                if (gap >= threshold) {
+                    continue;
+                }
+            }
+            if (round_[c] && !round_[a]) {
+                std::swap(a, c);
+            }
+            PairBlock& group = groups[round_[a] + round_[c]];
+            size_t k = group.count++;
+            group.pair[k] = p;
+            for (size_t v = 0; v < kVertices; ++v) {
+                group.ax[v][k] = x_[v][a];
+                group.ay[v][k] = y_[v][a];
+                group.bx[v][k] = x_[v][c];
+                group.by[v][k] = y_[v][c];
+            }
+            group.radius[k] = radius_[a] + radius_[c];
+        }
+
+        polygonPolygon(groups[0]);
+        circlePolygon(groups[1]);
+        circleCircle(groups[2]);
+
+        for (PairBlock& group : groups) {
+            double core[kBlock];
+            if (distances) {
+                batchSqrt(group.dist2, core, group.count);
+            }
+            for (size_t k = 0; k < group.count; ++k) {
+                if (distances) {
+                    double gap = std::max(core[k] - group.radius[k], 0.0);
+                    distances[group.pair[k]] = group.contact[k] != 0.0 ? 0.0 : gap;
+                } else {
+                    double reach = threshold + group.radius[k];
+                    flags[group.pair[k]] = group.contact[k] != 0.0 || group.dist2[k] < reach * reach;
+                }
+            }
+        }
+    }, 4);
+}
+
+std::vector<double> DistanceShapes::distances(const std::vector<ShapePair>& pairs) const {
+    checkPairs(pairs, size());
+    std::vector<double> result(pairs.size());
+    run(pairs, 0.0, result.data(), nullptr);
+    return result;
+}
+
+std::vector<uint8_t> DistanceShapes::within(const std::vector<ShapePair>& pairs,
+                                            double threshold) const {
+    checkPairs(pairs, size());
+    std::vector<uint8_t> result(pairs.size(), 0);
+    if (threshold > 0.0) {
+        run(pairs, threshold, nullptr, result.data());
+    }
+    return result;
+}
+
+double minimumDistance(const PlacedShape& a, const PlacedShape& b) {
+    return DistanceShapes({a, b}).distances({{0, 1}})[0];
+}
+
+} // namespace geometry
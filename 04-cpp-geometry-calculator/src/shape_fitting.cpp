@@ -0,0 +1,529 @@
+#include "shape_fitting.h"
+#include "geometry_calculator.h"
+#include "parallel.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+/**
+ * @brief Hypotheses scored per parallel work item
+ */
+constexpr size_t kHypothesisGrain = 16;
+
+struct CircleModel {
+    double cx, cy, r;
+};
+
+struct BoxModel {
+    double x0, y0, x1, y1;
+};
+
+/**
+ * @brief Line a*x + b*y + c = 0 with unit normal (a, b)
+ */
+struct LineModel {
+    double a, b, c;
+};
+
+// Residual kernels: branch-free loops over contiguous arrays
+
+size_t countCircleInliers(const double* x, const double* y, size_t n,
+                          const CircleModel& m, double threshold) {
+    double inner = std::max(0.0, m.r - threshold);
+    double inner_sq = inner * inner;
+    double outer_sq = (m.r + threshold) * (m.r + threshold);
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = x[i] - m.cx;
+        double dy = y[i] - m.cy;
+        double d_sq = dx * dx + dy * dy;
+        count += static_cast<size_t>((d_sq >= inner_sq) & (d_sq <= outer_sq));
+    }
+    return count;
+}
+
+size_t countBoxInliers(const double* x, const double* y, size_t n,
+                       const BoxModel& m, double threshold) {
+    double threshold_sq = threshold * threshold;
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = std::max(std::max(m.x0 - x[i], x[i] - m.x1), 0.0);
+        double dy = std::max(std::max(m.y0 - y[i], y[i] - m.y1), 0.0);
+        double inside = std::min(std::min(x[i] - m.x0, m.x1 - x[i]),
+                                 std::min(y[i] - m.y0, m.y1 - y[i]));
+        double outside_sq = dx * dx + dy * dy;
+        count += static_cast<size_t>((outside_sq <= threshold_sq) & (inside <= threshold));
+    }
+    return count;
+}
+
+size_t countLineInliers(const double* x, const double* y, size_t n,
+                        const LineModel& m, double threshold) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double d = m.a * x[i] + m.b * y[i] + m.c;
+        count += static_cast<size_t>(std::abs(d) <= threshold);
+    }
+    return count;
+}
+
+double boxResidual(double x, double y, const BoxModel& m) {
+    double dx = std::max(std::max(m.x0 - x, x - m.x1), 0.0);
+    double dy = std::max(std::max(m.y0 - y, y - m.y1), 0.0);
+    double inside = std::min(std::min(x - m.x0, m.x1 - x), std::min(y - m.y0, m.y1 - y));
+    return std::hypot(dx, dy) + std::max(inside, 0.0);
+}
+
+/**
+ * @brief Generic RANSAC driver
+ *
+ * Hypothesis h draws its samples from an RNG seeded with (seed, h), so the
+ * result does not depend on how hypotheses are spread across threads.
+ */
+template <typename Model, typename Sample, typename Score>
+bool runRansac(size_t iterations, uint64_t seed, bool parallel,
+               Sample&& sample, Score&& score, Model& best) {
+    std::vector<Model> models(iterations);
+    std::vector<size_t> scores(iterations, 0);
+    auto evaluate = [&](size_t h) {
+        std::mt19937_64 rng(seed * 0x9e3779b97f4a7c15ULL + h);
+        if (sample(rng, models[h])) {
+            scores[h] = score(models[h]);
+        }
+    };
+    if (parallel) {
+        parallelFor(iterations, evaluate, kHypothesisGrain);
+    } else {
+        for (size_t h = 0; h < iterations; ++h) {
+            evaluate(h);
+        }
+    }
+
+    auto it = std::max_element(scores.begin(), scores.end());
+    if (it == scores.end() || *it == 0) {
+        return false;
+    }
+    best = models[it - scores.begin()];
+    return true;
+}
+
+std::array<size_t, 3> sampleIndices3(std::mt19937_64& rng, size_t n) {
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    size_t a = pick(rng);
+    size_t b = pick(rng);
+    size_t c = pick(rng);
+    return {a, b, c};
+}
+
+bool circumcircle(double ax, double ay, double bx, double by, double cx, double cy,
+                  CircleModel& out) {
+    double d = 2.0 * (ax * (by - cy) + bx * (cy - ay) + cx * (ay - by));
+    if (std::abs(d) < 1e-12) {
+        return false;
+    }
+    double a2 = ax * ax + ay * ay;
+    double b2 = bx * bx + by * by;
+    double c2 = cx * cx + cy * cy;
+    out.cx = (a2 * (by - cy) + b2 * (cy - ay) + c2 * (ay - by)) / d;
+    out.cy = (a2 * (cx - bx) + b2 * (ax - cx) + c2 * (bx - ax)) / d;
+    out.r = std::hypot(ax - out.cx, ay - out.cy);
+    return std::isfinite(out.r) && out.r > 0;
+}
+
+/**
+ * @brief Solve a 3x3 linear system with Cramer's rule
+ */
+bool solve3(const double m[3][3], const double rhs[3], double out[3]) {
+    auto det = [](double a, double b, double c, double d, double e, double f,
+                  double g, double h, double i) {
+        return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    };
+    double d = det(m[0][0], m[0][1], m[0][2], m[1][0], m[1][1], m[1][2],
+                   m[2][0], m[2][1], m[2][2]);
+    if (std::abs(d) < 1e-300) {
+        return false;
+    }
+    out[0] = det(rhs[0], m[0][1], m[0][2], rhs[1], m[1][1], m[1][2],
+                 rhs[2], m[2][1], m[2][2]) / d;
+    out[1] = det(m[0][0], rhs[0], m[0][2], m[1][0], rhs[1], m[1][2],
+                 m[2][0], rhs[2], m[2][2]) / d;
+    out[2] = det(m[0][0], m[0][1], rhs[0], m[1][0], m[1][1], rhs[1],
+                 m[2][0], m[2][1], rhs[2]) / d;
+    return true;
+}
+
+/**
+ * @brief Algebraic least-squares circle fit over inliers of a model
+ */
+CircleModel refineCircle(const PointCloud& cloud, const CircleModel& model, double threshold) {
+    // Work relative to the current center for numerical stability
+    double m[3][3] = {};
+    double rhs[3] = {};
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        double x = cloud.x[i] - model.cx;
+        double y = cloud.y[i] - model.cy;
+        double d = std::sqrt(x * x + y * y);
+        if (std::abs(d - model.r) > threshold) {
+            continue;
+        }
+        double z = x * x + y * y;
+        double row[3] = {x, y, 1.0};
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                m[r][c] += row[r] * row[c];
+            }
+            rhs[r] -= row[r] * z;
+        }
+    }
+    double p[3];
+    if (!solve3(m, rhs, p)) {
+        return model;
+    }
+    CircleModel refined;
+    refined.cx = model.cx - p[0] / 2.0;
+    refined.cy = model.cy - p[1] / 2.0;
+    double r_sq = (p[0] * p[0] + p[1] * p[1]) / 4.0 - p[2];
+    if (r_sq <= 0) {
+        return model;
+    }
+    refined.r = std::sqrt(r_sq);
+    return refined;
+}
+
+/**
+ * @brief Move each box side to the mean coordinate of the inliers nearest to it
+ */
+BoxModel refineBox(const PointCloud& cloud, const BoxModel& model, double threshold) {
+    double sum[4] = {};
+    size_t count[4] = {};
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        double x = cloud.x[i];
+        double y = cloud.y[i];
+        if (boxResidual(x, y, model) > threshold) {
+            continue;
+        }
+        double d[4] = {std::abs(x - model.x0), std::abs(x - model.x1),
+                       std::abs(y - model.y0), std::abs(y - model.y1)};
+        int side = static_cast<int>(std::min_element(d, d + 4) - d);
+        sum[side] += side < 2 ? x : y;
+        ++count[side];
+    }
+    BoxModel refined = model;
+    double* sides[4] = {&refined.x0, &refined.x1, &refined.y0, &refined.y1};
+    for (int s = 0; s < 4; ++s) {
+        if (count[s] > 0) {
+            *sides[s] = sum[s] / static_cast<double>(count[s]);
+        }
+    }
+    return refined;
+}
+
+/**
+ * @brief Total least-squares line through the inliers of a model
+ */
+LineModel refineLine(const std::vector<double>& x, const std::vector<double>& y,
+                     const LineModel& model, double threshold) {
+    double mx = 0.0;
+    double my = 0.0;
+    size_t n = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (std::abs(model.a * x[i] + model.b * y[i] + model.c) <= threshold) {
+            mx += x[i];
+            my += y[i];
+            ++n;
+        }
+    }
+    if (n < 2) {
+        return model;
+    }
+    mx /= static_cast<double>(n);
+    my /= static_cast<double>(n);
+    double sxx = 0.0;
+    double syy = 0.0;
+    double sxy = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (std::abs(model.a * x[i] + model.b * y[i] + model.c) <= threshold) {
+            double dx = x[i] - mx;
+            double dy = y[i] - my;
+            sxx += dx * dx;
+            syy += dy * dy;
+            sxy += dx * dy;
+        }
+    }
+    double theta = 0.5 * std::atan2(2.0 * sxy, sxx - syy);
+    LineModel refined{-std::sin(theta), std::cos(theta), 0.0};
+    refined.c = -(refined.a * mx + refined.b * my);
+    return refined;
+}
+
+bool intersect(const LineModel& p, const LineModel& q, Point& out) {
+    double det = p.a * q.b - p.b * q.a;
+    if (std::abs(det) < 1e-12) {
+        return false;
+    }
+    out.x = (p.b * q.c - q.b * p.c) / det;
+    out.y = (q.a * p.c - p.a * q.c) / det;
+    return true;
+}
+
+double segmentDistance(double px, double py, const Point& a, const Point& b) {
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double t = ((px - a.x) * dx + (py - a.y) * dy) / (dx * dx + dy * dy);
+    t = std::clamp(t, 0.0, 1.0);
+    return std::hypot(px - (a.x + t * dx), py - (a.y + t * dy));
+}
+
+template <typename Residual>
+void scoreFit(const PointCloud& cloud, double threshold, Residual&& residual, FitResult& result) {
+    double sum_sq = 0.0;
+    size_t inliers = 0;
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        double r = residual(cloud.x[i], cloud.y[i]);
+        if (r <= threshold) {
+            sum_sq += r * r;
+            ++inliers;
+        }
+    }
+    result.inliers = inliers;
+    result.rms_residual = inliers > 0 ? std::sqrt(sum_sq / static_cast<double>(inliers)) : 0.0;
+}
+
+FitResult fitCircle(const PointCloud& cloud, const FitOptions& options, bool parallel) {
+    FitResult result;
+    size_t n = cloud.size();
+    const double* x = cloud.x.data();
+    const double* y = cloud.y.data();
+    double t = options.inlier_threshold;
+
+    CircleModel best;
+    bool found = runRansac<CircleModel>(
+        options.iterations, options.seed, parallel,
+        [&](std::mt19937_64& rng, CircleModel& model) {
+            auto s = sampleIndices3(rng, n);
+            return circumcircle(x[s[0]], y[s[0]], x[s[1]], y[s[1]], x[s[2]], y[s[2]], model);
+        },
+        [&](const CircleModel& model) { return countCircleInliers(x, y, n, model, t); },
+        best);
+    if (!found) {
+        return result;
+    }
+
+    CircleModel refined = refineCircle(cloud, best, t);
+    if (countCircleInliers(x, y, n, refined, t) < countCircleInliers(x, y, n, best, t)) {
+        refined = best;
+    }
+    scoreFit(cloud, t, [&](double px, double py) {
+        return std::abs(std::hypot(px - refined.cx, py - refined.cy) - refined.r);
+    }, result);
+    result.shape = std::make_unique<Circle>(refined.r);
+    result.position = {refined.cx, refined.cy};
+    return result;
+}
+
+FitResult fitRectangle(const PointCloud& cloud, const FitOptions& options, bool parallel) {
+    FitResult result;
+    size_t n = cloud.size();
+    const double* x = cloud.x.data();
+    const double* y = cloud.y.data();
+    double t = options.inlier_threshold;
+
+    BoxModel best;
+    bool found = runRansac<BoxModel>(
+        options.iterations, options.seed, parallel,
+        [&](std::mt19937_64& rng, BoxModel& model) {
+            std::uniform_int_distribution<size_t> pick(0, n - 1);
+            size_t first = pick(rng);
+            model = {x[first], y[first], x[first], y[first]};
+            for (int k = 1; k < 4; ++k) {
+                size_t i = pick(rng);
+                model.x0 = std::min(model.x0, x[i]);
+                model.x1 = std::max(model.x1, x[i]);
+                model.y0 = std::min(model.y0, y[i]);
+                model.y1 = std::max(model.y1, y[i]);
+            }
+            return model.x1 - model.x0 > t && model.y1 - model.y0 > t;
+        },
+        [&](const BoxModel& model) { return countBoxInliers(x, y, n, model, t); },
+        best);
+    if (!found) {
+        return result;
+    }
+
+    BoxModel refined = refineBox(cloud, best, t);
+    if (countBoxInliers(x, y, n, refined, t) < countBoxInliers(x, y, n, best, t) ||
+        refined.x1 <= refined.x0 || refined.y1 <= refined.y0) {
+        refined = best;
+    }
+    scoreFit(cloud, t, [&](double px, double py) { return boxResidual(px, py, refined); },
+             result);
+    result.shape = std::make_unique<Rectangle>(refined.x1 - refined.x0, refined.y1 - refined.y0);
+    result.position = {refined.x0, refined.y0};
+    return result;
+}
+
+FitResult fitTriangle(const PointCloud& cloud, const FitOptions& options, bool parallel) {
+    FitResult result;
+    double t = options.inlier_threshold;
+
+    // Sequential RANSAC: find the dominant line, remove its inliers, repeat
+    std::vector<double> x = cloud.x;
+    std::vector<double> y = cloud.y;
+    std::array<LineModel, 3> lines;
+    for (size_t k = 0; k < 3; ++k) {
+        size_t n = x.size();
+        if (n < 2) {
+            return result;
+        }
+        LineModel best;
+        bool found = runRansac<LineModel>(
+            options.iterations, options.seed + k, parallel,
+            [&](std::mt19937_64& rng, LineModel& model) {
+                std::uniform_int_distribution<size_t> pick(0, n - 1);
+                size_t i = pick(rng);
+                size_t j = pick(rng);
+                double dx = x[j] - x[i];
+                double dy = y[j] - y[i];
+                double len = std::hypot(dx, dy);
+                if (len <= t) {
+                    return false;
+                }
+                model = {-dy / len, dx / len, 0.0};
+                model.c = -(model.a * x[i] + model.b * y[i]);
+                return true;
+            },
+            [&](const LineModel& model) {
+                return countLineInliers(x.data(), y.data(), n, model, t);
+            },
+            best);
+        if (!found) {
+            return result;
+        }
+        lines[k] = refineLine(x, y, best, t);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (std::abs(lines[k].a * x[i] + lines[k].b * y[i] + lines[k].c) > t) {
+                x[kept] = x[i];
+                y[kept] = y[i];
+                ++kept;
+            }
+        }
+        x.resize(kept);
+        y.resize(kept);
+    }
+
+    std::array<Point, 3> v;
+    if (!intersect(lines[0], lines[1], v[0]) || !intersect(lines[1], lines[2], v[1]) ||
+        !intersect(lines[2], lines[0], v[2])) {
+        return result;
+    }
+    // Placements cannot rotate a triangle: side a always runs along +x from
+    // the position with the third vertex above it. Wind the vertices
+    // counter-clockwise and start at the edge closest to +x, so the placed
+    // triangle coincides with the fitted one whenever that edge is
+    // horizontal and is the least rotated copy otherwise.
+    double cross = (v[1].x - v[0].x) * (v[2].y - v[0].y) -
+                   (v[1].y - v[0].y) * (v[2].x - v[0].x);
+    if (cross < 0) {
+        std::swap(v[1], v[2]);
+    }
+    std::array<double, 3> sides;
+    size_t first = 0;
+    double best_along = -2.0;
+    for (size_t k = 0; k < 3; ++k) {
+        const Point& from = v[k];
+        const Point& to = v[(k + 1) % 3];
+        sides[k] = std::hypot(to.x - from.x, to.y - from.y);
+        double along = sides[k] > 0 ? (to.x - from.x) / sides[k] : -2.0;
+        if (along > best_along) {
+            best_along = along;
+            first = k;
+        }
+    }
+    double a = sides[first];
+    double b = sides[(first + 1) % 3];
+    double c = sides[(first + 2) % 3];
+    try {
+        result.shape = std::make_unique<Triangle>(a, b, c);
+    } catch (const std::invalid_argument&) {
+        return result;
+    }
+    scoreFit(cloud, t, [&](double px, double py) {
+        return std::min({segmentDistance(px, py, v[0], v[1]),
+                         segmentDistance(px, py, v[1], v[2]),
+                         segmentDistance(px, py, v[2], v[0])});
+    }, result);
+    result.position = v[first];
+    return result;
+}
+
+FitResult fit(const PointCloud& cloud, ShapeKind kind, const FitOptions& options, bool parallel) {
+    if (cloud.x.size() != cloud.y.size()) {
+        throw std::invalid_argument("Point cloud coordinate arrays differ in length");
+    }
+    if (options.inlier_threshold <= 0) {
+        throw std::invalid_argument("Inlier threshold must be positive");
+    }
+    if (cloud.size() < 3 || options.iterations == 0) {
+        return {};
+    }
+
+    FitResult result;
+    switch (kind) {
+        case ShapeKind::Circle:
+            result = fitCircle(cloud, options, parallel);
+            break;
+        case ShapeKind::Rectangle:
+            result = fitRectangle(cloud, options, parallel);
+            break;
+        case ShapeKind::Triangle:
+            result = fitTriangle(cloud, options, parallel);
+            break;
+        case ShapeKind::Path:
+            throw std::invalid_argument("Path shapes cannot be fitted");
+    }
+
+    double required = options.min_inlier_ratio * static_cast<double>(cloud.size());
+    if (static_cast<double>(result.inliers) < required) {
+        result.shape.reset();
+    }
+    return result;
+}
+
+} // namespace
+
+FitResult fitShape(const PointCloud& cloud, ShapeKind kind, const FitOptions& options) {
+    return fit(cloud, kind, options, true);
+}
+
+size_t fitShapesInto(const std::vector<PointCloud>& clouds, ShapeKind kind,
+                     GeometryCalculator& calculator, const FitOptions& options) {
+    std::vector<FitResult> results(clouds.size());
+    parallelFor(clouds.size(), [&](size_t i) {
+        FitOptions cloud_options = options;
+        cloud_options.seed = options.seed + i;
+        results[i] = fit(clouds[i], kind, cloud_options, false);
+    });
+
+    size_t added = 0;
+    calculator.reserve(calculator.shapeCount() + clouds.size());
+    for (FitResult& result : results) {
+        if (result.shape) {
+            calculator.addShape(std::move(result.shape), result.position);
+            ++added;
+        }
+    }
+    return added;
+}
+
+} // namespace geometry
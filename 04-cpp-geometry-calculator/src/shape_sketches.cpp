@@ -0,0 +1,350 @@
+#include "shape_sketches.h"
+#include "hashing.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace geometry {
+
+namespace {
+
+unsigned leadingZeros(uint64_t x) {
+    if (x == 0) {
+        return 64;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_clzll(x));
+#else
+    unsigned n = 0;
+    while ((x & (1ULL << 63)) == 0) {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+size_t tableSizeFor(size_t capacity) {
+    size_t size = 16;
+    while (size < 2 * capacity) {
+        size <<= 1;
+    }
+    return size;
+}
+
+} // namespace
+
+ShapeSignature canonicalSignature(const Shape& shape, double quantum) {
+    if (quantum <= 0) {
+        throw std::invalid_argument("Signature quantum must be positive");
+    }
+
+    ShapeSignature signature;
+    signature.kind = shape.kind();
+    auto& p = signature.parameters;
+    switch (shape.kind()) {
+        case ShapeKind::Circle:
+            p[0] = static_cast<const Circle&>(shape).radius();
+            break;
+        case ShapeKind::Rectangle: {
+            const auto& rect = static_cast<const Rectangle&>(shape);
+            p[0] = std::min(rect.width(), rect.height());
+            p[1] = std::max(rect.width(), rect.height());
+            break;
+        }
+        case ShapeKind::Triangle: {
+            auto [a, b, c] = static_cast<const Triangle&>(shape).sides();
+            p = {a, b, c};
+            std::sort(p.begin(), p.end());
+            break;
+        }
+        case ShapeKind::Path: {
+            const auto& path = static_cast<const Path&>(shape);
+            p = {path.area(), path.perimeter(), static_cast<double>(path.segments().size())};
+            break;
+        }
+    }
+    for (double& value : p) {
+        value = std::round(value / quantum) * quantum;
+    }
+    return signature;
+}
+
+uint64_t signatureHash(const ShapeSignature& signature) {
+    uint64_t h = mix64(static_cast<uint64_t>(signature.kind));
+    for (double value : signature.parameters) {
+        h = mix64(h ^ doubleBits(value));
+    }
+    return h;
+}
+
+// HeavyHitterSketch
+
+HeavyHitterSketch::HeavyHitterSketch(size_t capacity) : capacity_(capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Sketch capacity must be positive");
+    }
+    counters_.reserve(capacity);
+    heap_.reserve(capacity);
+    heap_position_.reserve(capacity);
+    table_.assign(tableSizeFor(capacity), -1);
+}
+
+size_t HeavyHitterSketch::findSlot(uint64_t hash) const {
+    size_t mask = table_.size() - 1;
+    size_t slot = hash & mask;
+    while (table_[slot] >= 0 && counters_[table_[slot]].hash != hash) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void HeavyHitterSketch::eraseSlot(size_t slot) {
+    // Backward-shift deletion keeps linear probe chains intact
+    size_t mask = table_.size() - 1;
+    size_t hole = slot;
+    size_t next = (hole + 1) & mask;
+    while (table_[next] >= 0) {
+        size_t home = counters_[table_[next]].hash & mask;
+        bool movable = hole <= next ? (home <= hole || home > next)
+                                    : (home <= hole && home > next);
+        if (movable) {
+            table_[hole] = table_[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    table_[hole] = -1;
+}
+
+void HeavyHitterSketch::swapHeap(size_t a, size_t b) {
+    std::swap(heap_[a], heap_[b]);
+    heap_position_[heap_[a]] = static_cast<uint32_t>(a);
+    heap_position_[heap_[b]] = static_cast<uint32_t>(b);
+}
+
+void HeavyHitterSketch::siftDown(size_t position) {
+    for (;;) {
+        size_t smallest = position;
+        size_t left = 2 * position + 1;
+        size_t right = left + 1;
+        if (left < heap_.size() &&
+            counters_[heap_[left]].count < counters_[heap_[smallest]].count) {
+            smallest = left;
+        }
+        if (right < heap_.size() &&
+            counters_[heap_[right]].count < counters_[heap_[smallest]].count) {
+            smallest = right;
+        }
+        if (smallest == position) {
+            return;
+        }
+        swapHeap(position, smallest);
+        position = smallest;
+    }
+}
+
+void HeavyHitterSketch::increment(const ShapeSignature& signature, uint64_t hash,
+                                  uint64_t count, uint64_t error) {
+    size_t slot = findSlot(hash);
+    if (table_[slot] >= 0) {
+        uint32_t id = static_cast<uint32_t>(table_[slot]);
+        counters_[id].count += count;
+        counters_[id].error += error;
+        siftDown(heap_position_[id]);
+        return;
+    }
+
+    if (counters_.size() < capacity_) {
+        uint32_t id = static_cast<uint32_t>(counters_.size());
+        counters_.push_back({signature, hash, count, error});
+        heap_.push_back(id);
+        heap_position_.push_back(id);
+        table_[slot] = static_cast<int32_t>(id);
+        // Sift up the new counter
+        size_t position = heap_.size() - 1;
+        while (position > 0) {
+            size_t parent = (position - 1) / 2;
+            if (counters_[heap_[parent]].count <= counters_[heap_[position]].count) {
+                break;
+            }
+            swapHeap(position, parent);
+            position = parent;
+        }
+        return;
+    }
+
+    // Evict the minimum counter and inherit its count as error bound
+    uint32_t id = heap_[0];
+    Counter& victim = counters_[id];
+    eraseSlot(findSlot(victim.hash));
+    uint64_t inherited = victim.count;
+    victim = {signature, hash, inherited + count, inherited + error};
+    table_[findSlot(hash)] = static_cast<int32_t>(id);
+    siftDown(0);
+}
+
+void HeavyHitterSketch::add(const ShapeSignature& signature) {
+    ++total_;
+    increment(signature, signatureHash(signature), 1, 0);
+}
+
+void HeavyHitterSketch::merge(const HeavyHitterSketch& other) {
+    struct Entry {
+        ShapeSignature signature;
+        uint64_t count;
+        uint64_t error;
+        bool in_this;
+        bool in_other;
+    };
+    uint64_t min_this = counters_.size() == capacity_ ? counters_[heap_[0]].count : 0;
+    uint64_t min_other = other.counters_.size() == other.capacity_
+                             ? other.counters_[other.heap_[0]].count : 0;
+
+    std::unordered_map<uint64_t, Entry> entries;
+    for (const Counter& c : counters_) {
+        entries[c.hash] = {c.signature, c.count, c.error, true, false};
+    }
+    for (const Counter& c : other.counters_) {
+        auto it = entries.find(c.hash);
+        if (it == entries.end()) {
+            entries[c.hash] = {c.signature, c.count, c.error, false, true};
+        } else {
+            it->second.count += c.count;
+            it->second.error += c.error;
+            it->second.in_other = true;
+        }
+    }
+
+    std::vector<std::pair<uint64_t, Entry>> merged(entries.begin(), entries.end());
+    for (auto& [hash, e] : merged) {
+        // A signature missing from a full sketch may have occurred up to
+        // that sketch's minimum count times
+        uint64_t missing = e.in_this ? min_other : min_this;
+        if (!(e.in_this && e.in_other)) {
+            e.count += missing;
+            e.error += missing;
+        }
+    }
+    std::sort(merged.begin(), merged.end(), [](const auto& a, const auto& b) {
+        return a.second.count != b.second.count ? a.second.count > b.second.count
+                                                : a.first < b.first;
+    });
+    if (merged.size() > capacity_) {
+        merged.resize(capacity_);
+    }
+
+    uint64_t total = total_ + other.total_;
+    clear();
+    total_ = total;
+    for (const auto& [hash, e] : merged) {
+        increment(e.signature, hash, e.count, e.error);
+    }
+}
+
+std::vector<HeavyHitter> HeavyHitterSketch::topK(size_t k) const {
+    std::vector<HeavyHitter> result;
+    result.reserve(counters_.size());
+    for (const Counter& c : counters_) {
+        result.push_back({c.signature, c.count, c.error});
+    }
+    std::sort(result.begin(), result.end(), [](const HeavyHitter& a, const HeavyHitter& b) {
+        return a.count > b.count;
+    });
+    if (result.size() > k) {
+        result.resize(k);
+    }
+    return result;
+}
+
+void HeavyHitterSketch::clear() {
+    counters_.clear();
+    heap_.clear();
+    heap_position_.clear();
+    std::fill(table_.begin(), table_.end(), -1);
+    total_ = 0;
+}
+
+// DistinctCounter
+
+DistinctCounter::DistinctCounter(unsigned precision) : precision_(precision) {
+    if (precision < 4 || precision > 18) {
+        throw std::invalid_argument("HyperLogLog precision must be between 4 and 18");
+    }
+    registers_.assign(size_t{1} << precision, 0);
+}
+
+void DistinctCounter::add(uint64_t hash) {
+    size_t index = hash >> (64 - precision_);
+    uint64_t rest = hash << precision_;
+    unsigned max_rank = 64 - precision_ + 1;
+    uint8_t rank = static_cast<uint8_t>(std::min(leadingZeros(rest) + 1, max_rank));
+    if (rank > registers_[index]) {
+        registers_[index] = rank;
+    }
+}
+
+void DistinctCounter::merge(const DistinctCounter& other) {
+    if (other.precision_ != precision_) {
+        throw std::invalid_argument("Cannot merge HyperLogLog counters of different precision");
+    }
+    for (size_t i = 0; i < registers_.size(); ++i) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+}
+
+double DistinctCounter::estimate() const {
+    double m = static_cast<double>(registers_.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t r : registers_) {
+        sum += std::ldexp(1.0, -static_cast<int>(r));
+        zeros += (r == 0);
+    }
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+    if (raw <= 2.5 * m && zeros > 0) {
+        // Linear counting is more accurate for small cardinalities
+        return m * std::log(m / static_cast<double>(zeros));
+    }
+    return raw;
+}
+
+void DistinctCounter::clear() {
+    std::fill(registers_.begin(), registers_.end(), 0);
+}
+
+// ShapeStatistics
+
+ShapeStatistics::ShapeStatistics(double quantum, size_t capacity, unsigned precision)
+    : quantum_(quantum), heavy_hitters_(capacity), distinct_(precision) {
+    if (quantum <= 0) {
+        throw std::invalid_argument("Signature quantum must be positive");
+    }
+}
+
+void ShapeStatistics::add(const Shape& shape) {
+    ShapeSignature signature = canonicalSignature(shape, quantum_);
+    heavy_hitters_.add(signature);
+    distinct_.add(signatureHash(signature));
+}
+
+void ShapeStatistics::merge(const ShapeStatistics& other) {
+    if (other.quantum_ != quantum_) {
+        throw std::invalid_argument("Cannot merge statistics with different quantum");
+    }
+    heavy_hitters_.merge(other.heavy_hitters_);
+    distinct_.merge(other.distinct_);
+}
+
+void ShapeStatistics::clear() {
+    heavy_hitters_.clear();
+    distinct_.clear();
+}
+
+} // namespace geometry
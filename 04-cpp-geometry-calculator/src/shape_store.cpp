@@ -0,0 +1,126 @@
+#include "shape_store.h"
+#include <algorithm>
+#include <iterator>
+
+namespace geometry {
+
+void ShapeStore::push(std::unique_ptr<Shape> shape, const Point& position) {
+    if (chunks_.empty() || chunks_.back().size() == kChunkCapacity) {
+        // Later chunks start at full capacity so they never reallocate; the
+        // first grows on demand to keep small stores small
+        bool full_size = !chunks_.empty();
+        chunks_.emplace_back();
+        offsets_.push_back(size_);
+        if (full_size) {
+            chunks_.back().shapes.reserve(kChunkCapacity);
+            chunks_.back().positions.reserve(kChunkCapacity);
+        }
+    }
+    chunks_.back().shapes.push_back(std::move(shape));
+    chunks_.back().positions.push_back(position);
+    ++size_;
+}
+
+void ShapeStore::splice(ShapeStore& other) {
+    if (&other == this || other.size_ == 0) {
+        return;
+    }
+
+    size_t first = 0;
+    if (!chunks_.empty() && chunks_.back().size() + other.chunks_.front().size() <= kChunkCapacity) {
+        // Fold the leading chunk in; bounded by kChunkCapacity moves
+        Chunk& last = chunks_.back();
+        Chunk& head = other.chunks_.front();
+        std::move(head.shapes.begin(), head.shapes.end(), std::back_inserter(last.shapes));
+        last.positions.insert(last.positions.end(), head.positions.begin(), head.positions.end());
+        first = 1;
+    }
+
+    for (size_t c = first; c < other.chunks_.size(); ++c) {
+        offsets_.push_back(size_ + other.offsets_[c]);
+        chunks_.push_back(std::move(other.chunks_[c]));
+    }
+    size_ += other.size_;
+    other.clear();
+}
+
+void ShapeStore::erase(size_t index) {
+    auto [c, i] = locate(index);
+    Chunk& chunk = chunks_[c];
+    chunk.shapes.erase(chunk.shapes.begin() + static_cast<std::ptrdiff_t>(i));
+    chunk.positions.erase(chunk.positions.begin() + static_cast<std::ptrdiff_t>(i));
+    if (chunk.size() == 0) {
+        chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(c));
+        offsets_.erase(offsets_.begin() + static_cast<std::ptrdiff_t>(c));
+    } else {
+        ++c;
+    }
+    for (; c < offsets_.size(); ++c) {
+        --offsets_[c];
+    }
+    --size_;
+}
+
+void ShapeStore::eraseSorted(const std::vector<size_t>& indices) {
+    if (indices.empty()) {
+        return;
+    }
+    size_t next = 0;
+    size_t base = 0;
+    std::vector<Chunk> kept;
+    kept.reserve(chunks_.size());
+    for (Chunk& chunk : chunks_) {
+        size_t count = chunk.size();
+        size_t write = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (next < indices.size() && indices[next] == base + i) {
+                ++next;
+                continue;
+            }
+            if (write != i) {
+                chunk.shapes[write] = std::move(chunk.shapes[i]);
+                chunk.positions[write] = chunk.positions[i];
+            }
+            ++write;
+        }
+        chunk.shapes.resize(write);
+        chunk.positions.resize(write);
+        base += count;
+        if (write > 0) {
+            kept.push_back(std::move(chunk));
+        }
+    }
+
+    chunks_ = std::move(kept);
+    offsets_.clear();
+    size_ = 0;
+    for (const Chunk& chunk : chunks_) {
+        offsets_.push_back(size_);
+        size_ += chunk.size();
+    }
+}
+
+void ShapeStore::clear() {
+    chunks_.clear();
+    offsets_.clear();
+    size_ = 0;
+}
+
+void ShapeStore::reserve(size_t count) {
+    size_t chunks = (count + kChunkCapacity - 1) / kChunkCapacity;
+    chunks_.reserve(chunks);
+    offsets_.reserve(chunks);
+}
+
+std::pair<size_t, size_t> ShapeStore::locate(size_t index) const {
+    // Fast path: correct whenever every chunk before the guessed one is full
+    size_t c = index / kChunkCapacity;
+    if (c < chunks_.size() && offsets_[c] <= index && index - offsets_[c] < chunks_[c].size()) {
+        return {c, index - offsets_[c]};
+    }
+    c = static_cast<size_t>(std::upper_bound(offsets_.begin(), offsets_.end(), index) -
+                            offsets_.begin()) - 1;
+    return {c, index - offsets_[c]};
+}
+
+} // namespace geometry
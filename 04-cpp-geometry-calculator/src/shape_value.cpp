@@ -0,0 +1,70 @@
+#include "shape_value.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <stdexcept>
+
+namespace geometry {
+
+ShapeValue ShapeValue::circle(double radius) {
+    Circle validated(radius);
+    ShapeValue value;
+    value.kind = ShapeKind::Circle;
+    value.dimensions = {validated.radius(), 0.0, 0.0};
+    return value;
+}
+
+ShapeValue ShapeValue::rectangle(double width, double height) {
+    Rectangle validated(width, height);
+    ShapeValue value;
+    value.kind = ShapeKind::Rectangle;
+    value.dimensions = {validated.width(), validated.height(), 0.0};
+    return value;
+}
+
+ShapeValue ShapeValue::triangle(double side_a, double side_b, double side_c) {
+    Triangle validated(side_a, side_b, side_c);
+    ShapeValue value;
+    value.kind = ShapeKind::Triangle;
+    value.dimensions = {side_a, side_b, side_c};
+    return value;
+}
+
+ShapeValue ShapeValue::fromShape(const Shape& shape) {
+    ShapeValue value;
+    value.kind = shape.kind();
+    switch (shape.kind()) {
+        case ShapeKind::Circle:
+            value.dimensions = {static_cast<const Circle&>(shape).radius(), 0.0, 0.0};
+            break;
+        case ShapeKind::Rectangle: {
+            const auto& rect = static_cast<const Rectangle&>(shape);
+            value.dimensions = {rect.width(), rect.height(), 0.0};
+            break;
+        }
+        case ShapeKind::Triangle: {
+            auto [a, b, c] = static_cast<const Triangle&>(shape).sides();
+            value.dimensions = {a, b, c};
+            break;
+        }
+        case ShapeKind::Path:
+            throw std::invalid_argument("Paths cannot be stored as shape values");
+    }
+    return value;
+}
+
+std::unique_ptr<Shape> ShapeValue::toShape() const {
+    switch (kind) {
+        case ShapeKind::Circle:
+            return std::make_unique<Circle>(dimensions[0]);
+        case ShapeKind::Rectangle:
+            return std::make_unique<Rectangle>(dimensions[0], dimensions[1]);
+        case ShapeKind::Triangle:
+            return std::make_unique<Triangle>(dimensions[0], dimensions[1], dimensions[2]);
+        case ShapeKind::Path:
+            break;
+    }
+    throw std::invalid_argument("Invalid shape value");
+}
+
+} // namespace geometry
@@ -0,0 +1,470 @@
+#include "shapes/path.h"
+#include "batch_math.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+// 8-point Gauss-Legendre rule on [-1, 1]
+constexpr std::array<double, 8> kGaussNodes = {
+    -0.9602898564975363, -0.7966664774136267, -0.5255324099163290, -0.1834346424956498,
+    0.1834346424956498,  0.5255324099163290,  0.7966664774136267,  0.9602898564975363,
+};
+constexpr std::array<double, 8> kGaussWeights = {
+    0.1012285362903763, 0.2223810344533745, 0.3137066458778873, 0.3626837833783620,
+    0.3626837833783620, 0.3137066458778873, 0.2223810344533745, 0.1012285362903763,
+};
+
+constexpr double kLengthTolerance = 1e-13;
+constexpr int kMaxSubdivisionDepth = 30;
+
+/**
+ * @brief Cubic Bezier control points in structure-of-arrays layout
+ */
+struct CubicBatch {
+    std::vector<double> x0, y0, x1, y1, x2, y2, x3, y3;
+
+    void add(const PathSegment& s) {
+        x0.push_back(s.points[0].x);
+        y0.push_back(s.points[0].y);
+        x1.push_back(s.points[1].x);
+        y1.push_back(s.points[1].y);
+        x2.push_back(s.points[2].x);
+        y2.push_back(s.points[2].y);
+        x3.push_back(s.points[3].x);
+        y3.push_back(s.points[3].y);
+    }
+
+    size_t size() const { return x0.size(); }
+};
+
+double cross(double ax, double ay, double bx, double by) {
+    return ax * by - ay * bx;
+}
+
+double cubicSpeed(const PathSegment& s, double t) {
+    const auto& p = s.points;
+    double u = 1.0 - t;
+    double b0 = 3.0 * u * u;
+    double b1 = 6.0 * t * u;
+    double b2 = 3.0 * t * t;
+    double dx = b0 * (p[1].x - p[0].x) + b1 * (p[2].x - p[1].x) + b2 * (p[3].x - p[2].x);
+    double dy = b0 * (p[1].y - p[0].y) + b1 * (p[2].y - p[1].y) + b2 * (p[3].y - p[2].y);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+Point cubicPoint(const PathSegment& s, double t) {
+    const auto& p = s.points;
+    double u = 1.0 - t;
+    double b0 = u * u * u;
+    double b1 = 3.0 * t * u * u;
+    double b2 = 3.0 * t * t * u;
+    double b3 = t * t * t;
+    return {b0 * p[0].x + b1 * p[1].x + b2 * p[2].x + b3 * p[3].x,
+            b0 * p[0].y + b1 * p[1].y + b2 * p[2].y + b3 * p[3].y};
+}
+
+double gaussLegendre(const PathSegment& s, double a, double b) {
+    double half = 0.5 * (b - a);
+    double mid = 0.5 * (a + b);
+    double sum = 0.0;
+    for (size_t k = 0; k < kGaussNodes.size(); ++k) {
+        sum += kGaussWeights[k] * cubicSpeed(s, mid + half * kGaussNodes[k]);
+    }
+    return sum * half;
+}
+
+/**
+ * @brief Gauss-Legendre arc length over [a, b] for every cubic in a batch
+ */
+void gaussLegendreBatch(const CubicBatch& c, double a, double b, std::vector<double>& out) {
+    size_t n = c.size();
+    out.assign(n, 0.0);
+    std::vector<double> speed(n);
+    double half = 0.5 * (b - a);
+    double mid = 0.5 * (a + b);
+    for (size_t k = 0; k < kGaussNodes.size(); ++k) {
+        double t = mid + half * kGaussNodes[k];
+        double u = 1.0 - t;
+        double b0 = 3.0 * u * u;
+        double b1 = 6.0 * t * u;
+        double b2 = 3.0 * t * t;
+        double w = kGaussWeights[k] * half;
+        for (size_t i = 0; i < n; ++i) {
+            double dx = b0 * (c.x1[i] - c.x0[i]) + b1 * (c.x2[i] - c.x1[i]) + b2 * (c.x3[i] - c.x2[i]);
+            double dy = b0 * (c.y1[i] - c.y0[i]) + b1 * (c.y2[i] - c.y1[i]) + b2 * (c.y3[i] - c.y2[i]);
+            speed[i] = dx * dx + dy * dy;
+        }
+        batchSqrt(speed.data(), speed.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] += w * speed[i];
+        }
+    }
+}
+
+double adaptiveLength(const PathSegment& s, double a, double b, double whole, int depth) {
+    double mid = 0.5 * (a + b);
+    double left = gaussLegendre(s, a, mid);
+    double right = gaussLegendre(s, mid, b);
+    double refined = left + right;
+    if (depth >= kMaxSubdivisionDepth ||
+        std::abs(refined - whole) <= kLengthTolerance * std::max(refined, 1e-300)) {
+        return refined;
+    }
+    return adaptiveLength(s, a, mid, left, depth + 1) + adaptiveLength(s, mid, b, right, depth + 1);
+}
+
+/**
+ * @brief Twice the signed area contributed by each cubic (Green's theorem)
+ */
+double cubicBatchDoubleArea(const CubicBatch& c) {
+    double sum = 0.0;
+    for (size_t i = 0; i < c.size(); ++i) {
+        double c01 = cross(c.x0[i], c.y0[i], c.x1[i], c.y1[i]);
+        double c02 = cross(c.x0[i], c.y0[i], c.x2[i], c.y2[i]);
+        double c03 = cross(c.x0[i], c.y0[i], c.x3[i], c.y3[i]);
+        double c12 = cross(c.x1[i], c.y1[i], c.x2[i], c.y2[i]);
+        double c13 = cross(c.x1[i], c.y1[i], c.x3[i], c.y3[i]);
+        double c23 = cross(c.x2[i], c.y2[i], c.x3[i], c.y3[i]);
+        sum += (6.0 * c01 + 3.0 * c02 + c03 + 3.0 * c12 + 3.0 * c13 + 6.0 * c23) / 10.0;
+    }
+    return sum;
+}
+
+double cubicBatchLength(const CubicBatch& c, const std::vector<PathSegment>& cubics) {
+    std::vector<double> whole;
+    std::vector<double> left;
+    std::vector<double> right;
+    gaussLegendreBatch(c, 0.0, 1.0, whole);
+    gaussLegendreBatch(c, 0.0, 0.5, left);
+    gaussLegendreBatch(c, 0.5, 1.0, right);
+
+    double length = 0.0;
+    for (size_t i = 0; i < c.size(); ++i) {
+        double refined = left[i] + right[i];
+        if (std::abs(refined - whole[i]) <= kLengthTolerance * std::max(refined, 1e-300)) {
+            length += refined;
+        } else {
+            length += adaptiveLength(cubics[i], 0.0, 0.5, left[i], 1) +
+                      adaptiveLength(cubics[i], 0.5, 1.0, right[i], 1);
+        }
+    }
+    return length;
+}
+
+bool samePoint(const Point& a, const Point& b) {
+    double scale = 1.0 + std::max({std::abs(a.x), std::abs(a.y), std::abs(b.x), std::abs(b.y)});
+    return std::abs(a.x - b.x) <= 1e-9 * scale && std::abs(a.y - b.y) <= 1e-9 * scale;
+}
+
+} // namespace
+
+// PathSegment
+
+PathSegment PathSegment::line(const Point& from, const Point& to) {
+    PathSegment s;
+    s.type = Type::Line;
+    s.points[0] = from;
+    s.points[1] = to;
+    return s;
+}
+
+PathSegment PathSegment::arc(const Point& center, double radius, double start_angle, double sweep) {
+    if (radius <= 0) {
+        throw std::invalid_argument("Arc radius must be positive");
+    }
+    PathSegment s;
+    s.type = Type::Arc;
+    s.points[0] = center;
+    s.radius = radius;
+    s.start_angle = start_angle;
+    s.sweep = sweep;
+    return s;
+}
+
+PathSegment PathSegment::cubic(const Point& p0, const Point& p1, const Point& p2, const Point& p3) {
+    PathSegment s;
+    s.type = Type::Cubic;
+    s.points = {p0, p1, p2, p3};
+    return s;
+}
+
+Point PathSegment::start() const {
+    if (type == Type::Arc) {
+        return {points[0].x + radius * std::cos(start_angle),
+                points[0].y + radius * std::sin(start_angle)};
+    }
+    return points[0];
+}
+
+Point PathSegment::end() const {
+    switch (type) {
+        case Type::Line:
+            return points[1];
+        case Type::Arc:
+            return {points[0].x + radius * std::cos(start_angle + sweep),
+                    points[0].y + radius * std::sin(start_angle + sweep)};
+        case Type::Cubic:
+            return points[3];
+    }
+    return points[0];
+}
+
+// Path
+
+Path::Path(std::vector<PathSegment> segments) : segments_(std::move(segments)) {
+    if (segments_.empty()) {
+        throw std::invalid_argument("Path must have at least one segment");
+    }
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        const PathSegment& next = segments_[(i + 1) % segments_.size()];
+        if (!samePoint(segments_[i].end(), next.start())) {
+            throw std::invalid_argument("Path segments must be contiguous and closed");
+        }
+    }
+
+    // Split segments by type so each kernel runs over homogeneous arrays
+    std::vector<double> lx0, ly0, lx1, ly1;
+    std::vector<double> ar, asw, acx, acy, as0;
+    CubicBatch cubic_batch;
+    std::vector<PathSegment> cubics;
+    for (const PathSegment& s : segments_) {
+        switch (s.type) {
+            case PathSegment::Type::Line:
+                lx0.push_back(s.points[0].x);
+                ly0.push_back(s.points[0].y);
+                lx1.push_back(s.points[1].x);
+                ly1.push_back(s.points[1].y);
+                break;
+            case PathSegment::Type::Arc:
+                acx.push_back(s.points[0].x);
+                acy.push_back(s.points[0].y);
+                ar.push_back(s.radius);
+                as0.push_back(s.start_angle);
+                asw.push_back(s.sweep);
+                break;
+            case PathSegment::Type::Cubic:
+                cubic_batch.add(s);
+                cubics.push_back(s);
+                break;
+        }
+    }
+
+    double double_area = 0.0;
+    double length = 0.0;
+    std::vector<double> ldx(lx0.size());
+    std::vector<double> ldy(lx0.size());
+    for (size_t i = 0; i < lx0.size(); ++i) {
+        ldx[i] = lx1[i] - lx0[i];
+        ldy[i] = ly1[i] - ly0[i];
+        double_area += cross(lx0[i], ly0[i], lx1[i], ly1[i]);
+    }
+    batchHypot(ldx.data(), ldy.data(), ldx.data(), ldx.size());
+    for (double line_length : ldx) {
+        length += line_length;
+    }
+
+    // Sines and cosines of every arc's start and end angle in one batch
+    size_t arcs = ar.size();
+    std::vector<double> angles(2 * arcs);
+    std::vector<double> cosines(2 * arcs);
+    for (size_t i = 0; i < arcs; ++i) {
+        angles[i] = as0[i];
+        angles[arcs + i] = as0[i] + asw[i];
+    }
+    batchSinCos(angles.data(), angles.data(), cosines.data(), angles.size());
+    for (size_t i = 0; i < arcs; ++i) {
+        double_area += ar[i] * ar[i] * asw[i] +
+                       ar[i] * acx[i] * (angles[arcs + i] - angles[i]) -
+                       ar[i] * acy[i] * (cosines[arcs + i] - cosines[i]);
+        length += ar[i] * std::abs(asw[i]);
+    }
+    double_area += cubicBatchDoubleArea(cubic_batch);
+    length += cubicBatchLength(cubic_batch, cubics);
+
+    area_ = std::abs(double_area) / 2.0;
+    perimeter_ = length;
+    if (!(area_ > 0) || !std::isfinite(area_) || !std::isfinite(perimeter_)) {
+        throw std::invalid_argument("Path must enclose a positive area");
+    }
+}
+
+Path Path::roundedRectangle(double width, double height, double radius) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Rectangle dimensions must be positive");
+    }
+    if (radius <= 0 || radius > std::min(width, height) / 2.0) {
+        throw std::invalid_argument("Corner radius must be positive and fit the rectangle");
+    }
+    const double w = width;
+    const double h = height;
+    const double r = radius;
+    return Path({
+        PathSegment::line({r, 0.0}, {w - r, 0.0}),
+        PathSegment::arc({w - r, r}, r, -M_PI / 2.0, M_PI / 2.0),
+        PathSegment::line({w, r}, {w, h - r}),
+        PathSegment::arc({w - r, h - r}, r, 0.0, M_PI / 2.0),
+        PathSegment::line({w - r, h}, {r, h}),
+        PathSegment::arc({r, h - r}, r, M_PI / 2.0, M_PI / 2.0),
+        PathSegment::line({0.0, h - r}, {0.0, r}),
+        PathSegment::arc({r, r}, r, M_PI, M_PI / 2.0),
+    });
+}
+
+std::vector<Point> Path::flatten(double tolerance, std::vector<double>* weights) const {
+    std::vector<Point> points;
+    std::vector<double> edge_weights;
+    for (const PathSegment& s : segments_) {
+        switch (s.type) {
+            case PathSegment::Type::Line:
+                points.push_back(s.points[0]);
+                edge_weights.push_back(1.0);
+                break;
+            case PathSegment::Type::Arc: {
+                double fraction = std::abs(s.sweep) / (2.0 * M_PI);
+                size_t full = circleSegmentCount(s.radius, tolerance);
+                size_t n = std::max<size_t>(1, static_cast<size_t>(std::ceil(full * fraction)));
+                double step = s.sweep / static_cast<double>(n);
+                double half = std::abs(step) / 2.0;
+                double weight = half > 0 ? half / std::sin(half) : 1.0;
+                for (size_t k = 0; k < n; ++k) {
+                    double angle = s.start_angle + step * static_cast<double>(k);
+                    points.push_back({s.points[0].x + s.radius * std::cos(angle),
+                                      s.points[0].y + s.radius * std::sin(angle)});
+                    edge_weights.push_back(weight);
+                }
+                break;
+            }
+            case PathSegment::Type::Cubic: {
+                const auto& p = s.points;
+                double ddx = std::max(std::abs(p[0].x - 2 * p[1].x + p[2].x),
+                                      std::abs(p[1].x - 2 * p[2].x + p[3].x));
+                double ddy = std::max(std::abs(p[0].y - 2 * p[1].y + p[2].y),
+                                      std::abs(p[1].y - 2 * p[2].y + p[3].y));
+                double bound = 0.75 * std::hypot(ddx, ddy);
+                size_t n = std::max<size_t>(1, static_cast<size_t>(
+                    std::ceil(std::sqrt(bound / tolerance))));
+                for (size_t k = 0; k < n; ++k) {
+                    double t0 = static_cast<double>(k) / static_cast<double>(n);
+                    double t1 = static_cast<double>(k + 1) / static_cast<double>(n);
+                    Point a = cubicPoint(s, t0);
+                    Point b = cubicPoint(s, t1);
+                    double chord = std::hypot(b.x - a.x, b.y - a.y);
+                    points.push_back(a);
+                    edge_weights.push_back(chord > 0 ? gaussLegendre(s, t0, t1) / chord : 1.0);
+                }
+                break;
+            }
+        }
+    }
+
+    // Drop zero-length edges
+    std::vector<Point> outline;
+    std::vector<double> outline_weights;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (!outline.empty() && samePoint(outline.back(), points[i])) {
+            outline_weights.back() = edge_weights[i];
+            continue;
+        }
+        outline.push_back(points[i]);
+        outline_weights.push_back(edge_weights[i]);
+    }
+    while (outline.size() > 1 && samePoint(outline.back(), outline.front())) {
+        outline.pop_back();
+        outline_weights.pop_back();
+    }
+
+    double signed_area = 0.0;
+    for (size_t i = 0; i < outline.size(); ++i) {
+        const Point& a = outline[i];
+        const Point& b = outline[(i + 1) % outline.size()];
+        signed_area += cross(a.x, a.y, b.x, b.y);
+    }
+    if (signed_area < 0) {
+        size_t n = outline.size();
+        std::reverse(outline.begin(), outline.end());
+        std::vector<double> reversed(n);
+        for (size_t j = 0; j < n; ++j) {
+            reversed[j] = outline_weights[(2 * n - 2 - j) % n];
+        }
+        outline_weights = std::move(reversed);
+    }
+
+    if (weights) {
+        *weights = std::move(outline_weights);
+    }
+    return outline;
+}
+
+BoundingBox Path::bounds() const {
+    Point first = segments_[0].start();
+    BoundingBox box{first.x, first.y, first.x, first.y};
+    auto extend = [&](const Point& p) {
+        box.min_x = std::min(box.min_x, p.x);
+        box.min_y = std::min(box.min_y, p.y);
+        box.max_x = std::max(box.max_x, p.x);
+        box.max_y = std::max(box.max_y, p.y);
+    };
+
+    for (const PathSegment& s : segments_) {
+        extend(s.end());
+        if (s.type == PathSegment::Type::Arc) {
+            // Axis extremes at multiples of pi/2 inside the sweep
+            double lo = std::min(s.start_angle, s.start_angle + s.sweep);
+            double hi = std::max(s.start_angle, s.start_angle + s.sweep);
+            for (double k = std::ceil(lo / (M_PI / 2.0)); k * (M_PI / 2.0) <= hi; k += 1.0) {
+                double angle = k * (M_PI / 2.0);
+                extend({s.points[0].x + s.radius * std::cos(angle),
+                        s.points[0].y + s.radius * std::sin(angle)});
+            }
+        } else if (s.type == PathSegment::Type::Cubic) {
+            // Roots of the derivative, per axis: a t^2 + b t + c = 0
+            const auto& p = s.points;
+            for (int axis = 0; axis < 2; ++axis) {
+                auto coord = [&](size_t i) { return axis == 0 ? p[i].x : p[i].y; };
+                double a = -coord(0) + 3 * coord(1) - 3 * coord(2) + coord(3);
+                double b = 2 * (coord(0) - 2 * coord(1) + coord(2));
+                double c = coord(1) - coord(0);
+                std::vector<double> roots;
+                if (std::abs(a) < 1e-12) {
+                    if (std::abs(b) > 1e-12) {
+                        roots.push_back(-c / b);
+                    }
+                } else {
+                    double disc = b * b - 4 * a * c;
+                    if (disc >= 0) {
+                        roots.push_back((-b + std::sqrt(disc)) / (2 * a));
+                        roots.push_back((-b - std::sqrt(disc)) / (2 * a));
+                    }
+                }
+                for (double t : roots) {
+                    if (t > 0 && t < 1) {
+                        extend(cubicPoint(s, t));
+                    }
+                }
+            }
+        }
+    }
+    return box;
+}
+
+double Path::area() const {
+    return area_;
+}
+
+double Path::perimeter() const {
+    return perimeter_;
+}
+
+std::string Path::name() const {
+    return "Path";
+}
+
+bool Path::isValid() const {
+    return area_ > 0 && std::isfinite(area_) && std::isfinite(perimeter_);
+}
+
+} // namespace geometry
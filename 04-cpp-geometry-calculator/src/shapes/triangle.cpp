@@ -1,4 +1,5 @@
 #include "shapes/triangle.h"
+#include "predicates.h"
 #include <stdexcept>
 #include <algorithm>
 
@@ -24,9 +25,7 @@ void Triangle::setSides(double side_a, double side_b, double side_c) {
     }
     
     // Check triangle inequality with new sides
-    if (side_a + side_b <= side_c || 
-        side_b + side_c <= side_a || 
-        side_a + side_c <= side_b) {
+    if (!geometry::satisfiesTriangleInequality(side_a, side_b, side_c)) {
         throw std::invalid_argument("Triangle inequality not satisfied");
     }
     
@@ -74,9 +73,8 @@ bool Triangle::isValid() const {
 }
 
 bool Triangle::satisfiesTriangleInequality() const {
-    return side_a_ + side_b_ > side_c_ &&
-           side_b_ + side_c_ > side_a_ &&
-           side_a_ + side_c_ > side_b_;
+    // Exact: rounded sums would reject slivers whose sides barely pass
+    return geometry::satisfiesTriangleInequality(side_a_, side_b_, side_c_);
 }
 
 } // namespace geometry
@@ -0,0 +1,297 @@
+#include "task_graph.h"
+#include "tracing.h"
+#include <stdexcept>
+
+namespace geometry {
+
+namespace {
+
+// Pool and queue index of the calling worker thread
+thread_local const TaskPool* current_pool = nullptr;
+thread_local size_t current_queue = 0;
+
+constexpr size_t kNoTask = static_cast<size_t>(-1);
+
+} // namespace
+
+TaskPool::TaskPool(size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back(&TaskPool::workerLoop, this, i);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void TaskPool::submit(std::function<void()> task) {
+    size_t index = onWorkerThread()
+        ? current_queue
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        pending_.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+bool TaskPool::runPending() {
+    std::function<void()> task;
+    if (!takeTask(onWorkerThread() ? current_queue : 0, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+bool TaskPool::onWorkerThread() const {
+    return current_pool == this;
+}
+
+bool TaskPool::takeTask(size_t home, std::function<void()>& task) {
+    // Own queue first, newest task first
+    {
+        Queue& queue = *queues_[home];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another queue
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        Queue& queue = *queues_[(home + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::workerLoop(size_t index) {
+    current_pool = this;
+    current_queue = index;
+
+    for (;;) {
+        std::function<void()> task;
+        if (takeTask(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this]() { return pending_.load() > 0 || stopping_; });
+        if (stopping_ && pending_.load() == 0) {
+            return;
+        }
+    }
+}
+
+struct TaskGraph::RunState {
+    std::unique_ptr<std::atomic<size_t>[]> dependencies;
+    std::atomic<size_t> remaining{0};
+    std::atomic<bool> failed{false};
+    std::atomic<bool> done{false};
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+const TaskGraph::Node& TaskGraph::node(NodeId id) const {
+    if (id >= nodes_.size()) {
+        throw std::invalid_argument("Invalid task graph node");
+    }
+    return nodes_[id];
+}
+
+void TaskGraph::addEdge(size_t from, size_t to) {
+    tasks_[from].successors.push_back(to);
+    ++tasks_[to].dependencies;
+}
+
+TaskGraph::NodeId TaskGraph::addTask(std::string name, std::function<void()> body) {
+    size_t task = tasks_.size();
+    tasks_.push_back({std::move(body), {}, 0, nodes_.size()});
+    nodes_.push_back({std::move(name), task, 1, task});
+    return nodes_.size() - 1;
+}
+
+TaskGraph::NodeId TaskGraph::addChunkedTask(std::string name, size_t chunks,
+                                            std::function<void(size_t)> body, bool ordered) {
+    if (chunks == 0) {
+        throw std::invalid_argument("Chunked task must have at least one chunk");
+    }
+    if (!body) {
+        throw std::invalid_argument("Chunked task must have a body");
+    }
+
+    auto shared_body = std::make_shared<std::function<void(size_t)>>(std::move(body));
+    size_t first = tasks_.size();
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        tasks_.push_back({[shared_body, chunk]() { (*shared_body)(chunk); }, {}, 0, nodes_.size()});
+        if (ordered && chunk > 0) {
+            addEdge(first + chunk - 1, first + chunk);
+        }
+    }
+
+    size_t join = first;
+    if (chunks > 1) {
+        join = tasks_.size();
+        tasks_.push_back({{}, {}, 0, nodes_.size()});
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            addEdge(first + chunk, join);
+        }
+    }
+
+    nodes_.push_back({std::move(name), first, chunks, join});
+    return nodes_.size() - 1;
+}
+
+void TaskGraph::precede(NodeId before, NodeId after) {
+    const Node& from = node(before);
+    const Node& to = node(after);
+    for (size_t chunk = 0; chunk < to.chunks; ++chunk) {
+        addEdge(from.join_task, to.first_task + chunk);
+    }
+}
+
+void TaskGraph::stream(NodeId upstream, NodeId downstream) {
+    const Node& from = node(upstream);
+    const Node& to = node(downstream);
+    if (from.chunks != to.chunks) {
+        throw std::invalid_argument("Streamed nodes '" + from.name + "' and '" + to.name +
+                                    "' must have the same number of chunks");
+    }
+    for (size_t chunk = 0; chunk < to.chunks; ++chunk) {
+        addEdge(from.first_task + chunk, to.first_task + chunk);
+    }
+}
+
+void TaskGraph::execute(size_t task, RunState& state, TaskPool& pool) const {
+    // Run the task, then continue inline with one of the successors it
+    // releases; the others go to the pool for idle workers to steal
+    while (task != kNoTask) {
+        if (!state.failed.load(std::memory_order_acquire) && tasks_[task].body) {
+            GEOMETRY_TRACE_SCOPE("task", nodes_[tasks_[task].node].name.c_str(),
+                                 task - nodes_[tasks_[task].node].first_task);
+            try {
+                tasks_[task].body();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (!state.error) {
+                    state.error = std::current_exception();
+                }
+                state.failed.store(true, std::memory_order_release);
+            }
+        }
+
+        size_t next = kNoTask;
+        for (size_t successor : tasks_[task].successors) {
+            if (state.dependencies[successor].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                continue;
+            }
+            if (next == kNoTask) {
+                next = successor;
+            } else {
+                pool.submit([this, successor, &state, &pool]() {
+                    execute(successor, state, pool);
+                });
+            }
+        }
+
+        if (state.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.done.store(true, std::memory_order_release);
+            state.finished.notify_all();
+        }
+        task = next;
+    }
+}
+
+void TaskGraph::run(TaskPool& pool) {
+    if (tasks_.empty()) {
+        return;
+    }
+
+    // Reject cycles up front (Kahn's algorithm); a cycle would never finish
+    std::vector<size_t> indegree(tasks_.size());
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+        indegree[i] = tasks_[i].dependencies;
+        if (indegree[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    std::vector<size_t> roots = ready;
+    size_t visited = 0;
+    while (!ready.empty()) {
+        size_t task = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (size_t successor : tasks_[task].successors) {
+            if (--indegree[successor] == 0) {
+                ready.push_back(successor);
+            }
+        }
+    }
+    if (visited != tasks_.size()) {
+        throw std::invalid_argument("Task graph contains a cycle");
+    }
+
+    RunState state;
+    state.dependencies = std::make_unique<std::atomic<size_t>[]>(tasks_.size());
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+        state.dependencies[i].store(tasks_[i].dependencies, std::memory_order_relaxed);
+    }
+    state.remaining.store(tasks_.size());
+
+    for (size_t root : roots) {
+        pool.submit([this, root, &state, &pool]() { execute(root, state, pool); });
+    }
+
+    if (pool.onWorkerThread()) {
+        // Nested run: keep this worker busy instead of blocking it
+        while (!state.done.load(std::memory_order_acquire)) {
+            if (!pool.runPending()) {
+                std::this_thread::yield();
+            }
+        }
+        // The last task may still be releasing the mutex
+        std::lock_guard<std::mutex> lock(state.mutex);
+    } else {
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.finished.wait(lock, [&state]() {
+            return state.done.load(std::memory_order_acquire);
+        });
+    }
+
+    if (state.error) {
+        std::rethrow_exception(state.error);
+    }
+}
+
+} // namespace geometry
@@ -0,0 +1,218 @@
+#include "tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t kNameLength = 48;
+
+struct TraceEvent {
+    char name[kNameLength];
+    const char* category;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint64_t arg;
+};
+
+struct ThreadBuffer {
+    std::mutex mutex;  // Uncontended except while dumping
+    std::vector<TraceEvent> events;
+    size_t capacity = 0;
+    uint64_t written = 0;
+    uint32_t tid = 0;
+
+    void reset(size_t new_capacity) {
+        events.clear();
+        events.shrink_to_fit();
+        capacity = new_capacity;
+        written = 0;
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::atomic<bool> enabled{true};
+    size_t capacity = 1 << 16;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::shared_ptr<ThreadBuffer>> free;
+
+    std::shared_ptr<ThreadBuffer> acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!free.empty()) {
+            auto buffer = std::move(free.back());
+            free.pop_back();
+            return buffer;
+        }
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->capacity = capacity;
+        buffer->tid = static_cast<uint32_t>(buffers.size() + 1);
+        buffers.push_back(buffer);
+        return buffer;
+    }
+
+    void release(std::shared_ptr<ThreadBuffer> buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free.push_back(std::move(buffer));
+    }
+};
+
+Registry& registry() {
+    // Never destroyed: worker threads may record during static destruction
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+/**
+ * @brief Per-thread handle that returns its buffer for reuse on thread exit
+ */
+struct LocalBuffer {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~LocalBuffer() {
+        if (buffer) {
+            registry().release(std::move(buffer));
+        }
+    }
+};
+
+thread_local LocalBuffer local_buffer;
+
+void appendEscaped(std::ostringstream& out, const char* text) {
+    for (; *text; ++text) {
+        char c = *text;
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+}
+
+// Chrome trace timestamps are microseconds
+void appendMicroseconds(std::ostringstream& out, uint64_t ns) {
+    out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+}
+
+} // namespace
+
+void setTracingEnabled(bool enabled) {
+    registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool tracingEnabled() {
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void setTraceBufferCapacity(size_t events) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.capacity = std::max<size_t>(events, 1);
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->reset(reg.capacity);
+    }
+}
+
+uint64_t traceClock() {
+    using Clock = std::chrono::steady_clock;
+    static const Clock::time_point epoch = Clock::now();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count());
+}
+
+void recordTraceEvent(const char* category, const char* name, uint64_t start_ns,
+                      uint64_t duration_ns, uint64_t arg) {
+    if (!local_buffer.buffer) {
+        local_buffer.buffer = registry().acquire();
+    }
+    ThreadBuffer& buffer = *local_buffer.buffer;
+
+    TraceEvent event;
+    std::strncpy(event.name, name, kNameLength - 1);
+    event.name[kNameLength - 1] = '\0';
+    event.category = category;
+    event.start_ns = start_ns;
+    event.duration_ns = duration_ns;
+    event.arg = arg;
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < buffer.capacity) {
+        buffer.events.push_back(event);
+    } else {
+        buffer.events[buffer.written % buffer.capacity] = event;
+    }
+    ++buffer.written;
+}
+
+size_t traceEventCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t count = 0;
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+void clearTrace() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->written = 0;
+    }
+}
+
+std::string traceJson() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    std::ostringstream out;
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    uint64_t dropped = 0;
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        if (buffer->events.empty()) {
+            continue;
+        }
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << buffer->tid << ",\"args\":{\"name\":\"geometry thread " << buffer->tid << "\"}}";
+        first = false;
+
+        // Oldest event first
+        size_t count = buffer->events.size();
+        size_t oldest = buffer->written > count ? buffer->written % count : 0;
+        dropped += buffer->written - count;
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->events[(oldest + i) % count];
+            out << ",\n{\"name\":\"";
+            appendEscaped(out, event.name);
+            out << "\",\"cat\":\"";
+            appendEscaped(out, event.category);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":";
+            appendMicroseconds(out, event.start_ns);
+            out << ",\"dur\":";
+            appendMicroseconds(out, event.duration_ns);
+            out << ",\"args\":{\"arg\":" << event.arg << "}}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << dropped << "}}";
+    return out.str();
+}
+
+} // namespace geometry
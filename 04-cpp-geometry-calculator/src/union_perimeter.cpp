@@ -0,0 +1,631 @@
+#include "union_perimeter.h"
+#include "parallel.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <set>
+
+namespace geometry {
+
+namespace {
+
+/**
+ * @brief Segment tree tracking the covered length of a set of intervals
+ */
+class CoverageTree {
+private:
+    std::vector<double> coords_;
+    std::vector<int> count_;
+    std::vector<double> covered_;
+
+    void update(size_t node, size_t lo, size_t hi, size_t from, size_t to, int delta) {
+        if (to <= lo || hi <= from) {
+            return;
+        }
+        if (from <= lo && hi <= to) {
+            count_[node] += delta;
+        } else {
+            size_t mid = (lo + hi) / 2;
+            update(2 * node, lo, mid, from, to, delta);
+            update(2 * node + 1, mid, hi, from, to, delta);
+        }
+        if (count_[node] > 0) {
+            covered_[node] = coords_[hi] - coords_[lo];
+        } else if (hi - lo == 1) {
+            covered_[node] = 0.0;
+        } else {
+            covered_[node] = covered_[2 * node] + covered_[2 * node + 1];
+        }
+    }
+
+public:
+    explicit CoverageTree(std::vector<double> coords)
+        : coords_(std::move(coords)),
+          count_(4 * coords_.size() + 4, 0),
+          covered_(4 * coords_.size() + 4, 0.0) {}
+
+    void add(double from, double to, int delta) {
+        size_t lo = std::lower_bound(coords_.begin(), coords_.end(), from) - coords_.begin();
+        size_t hi = std::lower_bound(coords_.begin(), coords_.end(), to) - coords_.begin();
+        update(1, 0, coords_.size() - 1, lo, hi, delta);
+    }
+
+    double covered() const { return covered_[1]; }
+};
+
+struct SweepEvent {
+    double position;
+    int delta;
+    double from;
+    double to;
+};
+
+/**
+ * @brief Length of union boundary edges perpendicular to the sweep axis
+ */
+double sweepBoundaryLength(const std::vector<BoundingBox>& rects, bool along_x) {
+    std::vector<SweepEvent> events;
+    std::vector<double> coords;
+    events.reserve(2 * rects.size());
+    coords.reserve(2 * rects.size());
+    for (const BoundingBox& r : rects) {
+        double lo = along_x ? r.min_x : r.min_y;
+        double hi = along_x ? r.max_x : r.max_y;
+        double from = along_x ? r.min_y : r.min_x;
+        double to = along_x ? r.max_y : r.max_x;
+        events.push_back({lo, +1, from, to});
+        events.push_back({hi, -1, from, to});
+        coords.push_back(from);
+        coords.push_back(to);
+    }
+    std::sort(coords.begin(), coords.end());
+    coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
+
+    // Insertions before removals at equal positions, so abutting
+    // rectangles merge instead of exposing their shared edge
+    std::sort(events.begin(), events.end(), [](const SweepEvent& a, const SweepEvent& b) {
+        if (a.position != b.position) {
+            return a.position < b.position;
+        }
+        return a.delta > b.delta;
+    });
+
+    CoverageTree tree(std::move(coords));
+    double length = 0.0;
+    double previous = 0.0;
+    for (const SweepEvent& e : events) {
+        tree.add(e.from, e.to, e.delta);
+        length += std::abs(tree.covered() - previous);
+        previous = tree.covered();
+    }
+    return length;
+}
+
+/**
+ * @brief Static interval tree over the y-extents of an outline's edges
+ *
+ * Edges are sorted by their lowest y and laid out as an implicit balanced
+ * tree in which each position also records the highest y below it, so the
+ * edges whose extent meets a y-interval are found in O(log m + k).
+ */
+class EdgeIndex {
+private:
+    struct Entry {
+        double lo;
+        double hi;
+        size_t edge;
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<double> max_hi_;  ///< Highest hi of the subtree rooted at each position
+
+    double build(size_t begin, size_t end) {
+        if (begin >= end) {
+            return -std::numeric_limits<double>::infinity();
+        }
+        size_t mid = begin + (end - begin) / 2;
+        max_hi_[mid] = std::max({entries_[mid].hi, build(begin, mid), build(mid + 1, end)});
+        return max_hi_[mid];
+    }
+
+    template <typename Visit>
+    void query(size_t begin, size_t end, double lo, double hi, Visit& visit) const {
+        if (begin >= end) {
+            return;
+        }
+        size_t mid = begin + (end - begin) / 2;
+        if (max_hi_[mid] < lo) {
+            return;
+        }
+        query(begin, mid, lo, hi, visit);
+        if (entries_[mid].lo > hi) {
+            return;
+        }
+        if (entries_[mid].hi >= lo) {
+            visit(entries_[mid].edge);
+        }
+        query(mid + 1, end, lo, hi, visit);
+    }
+
+public:
+    EdgeIndex() = default;
+
+    explicit EdgeIndex(const std::vector<Point>& vertices) {
+        entries_.reserve(vertices.size());
+        for (size_t e = 0; e < vertices.size(); ++e) {
+            const Point& a = vertices[e];
+            const Point& b = vertices[(e + 1) % vertices.size()];
+            entries_.push_back({std::min(a.y, b.y), std::max(a.y, b.y), e});
+        }
+        std::sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+            return a.lo < b.lo;
+        });
+        max_hi_.resize(entries_.size());
+        build(0, entries_.size());
+    }
+
+    /**
+     * @brief Visit every edge whose y-extent meets [lo, hi]
+     */
+    template <typename Visit>
+    void query(double lo, double hi, Visit&& visit) const {
+        query(0, entries_.size(), lo, hi, visit);
+    }
+};
+
+/**
+ * @brief Outline of a placed shape prepared for clipping
+ */
+struct Outline {
+    std::vector<Point> vertices;
+    std::vector<double> edge_weights;  ///< Boundary length per unit of chord length
+    EdgeIndex edges;
+};
+
+double cross(double ax, double ay, double bx, double by) {
+    return ax * by - ay * bx;
+}
+
+double pointSegmentDistance(const Point& p, const Point& a, const Point& b) {
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double len_sq = dx * dx + dy * dy;
+    double t = len_sq > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len_sq : 0.0;
+    t = std::clamp(t, 0.0, 1.0);
+    return std::hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+}
+
+/**
+ * @brief Buffers reused across the segments of a cluster
+ */
+struct ClipScratch {
+    std::vector<size_t> nearby;
+    std::vector<double> cuts;
+};
+
+/**
+ * @brief Clip the segment a->b against a simple polygon
+ *
+ * The segment is split where it crosses the polygon's edges and each piece
+ * is classified by its midpoint. Only the edges whose extent meets the
+ * segment's bounding box can cut it or pass within eps of a piece, and only
+ * the edges a horizontal line through the midpoint stabs can take part in
+ * the crossing-number test; both sets come from the outline's edge index.
+ *
+ * @param same_side_wins Whether a coincident edge facing the same way covers
+ * @param eps Distance below which a point counts as lying on an edge
+ * @param covered Receives the covered parameter intervals
+ */
+void clipSegment(const Point& a, const Point& b, const Outline& clip, bool same_side_wins, double eps,
+                 ClipScratch& scratch, std::vector<std::pair<double, double>>& covered) {
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double len_sq = dx * dx + dy * dy;
+    if (len_sq == 0) {
+        return;
+    }
+    const auto& v = clip.vertices;
+    double min_x = std::min(a.x, b.x) - eps;
+    double max_x = std::max(a.x, b.x) + eps;
+    std::vector<size_t>& nearby = scratch.nearby;
+    nearby.clear();
+    clip.edges.query(std::min(a.y, b.y) - eps, std::max(a.y, b.y) + eps, [&](size_t j) {
+        const Point& q0 = v[j];
+        const Point& q1 = v[(j + 1) % v.size()];
+        if (std::min(q0.x, q1.x) <= max_x && std::max(q0.x, q1.x) >= min_x) {
+            nearby.push_back(j);
+        }
+    });
+
+    std::vector<double>& cuts = scratch.cuts;
+    cuts.assign({0.0, 1.0});
+    for (size_t j : nearby) {
+        const Point& q0 = v[j];
+        const Point& q1 = v[(j + 1) % v.size()];
+        double ex = q1.x - q0.x;
+        double ey = q1.y - q0.y;
+        double denom = cross(dx, dy, ex, ey);
+        if (std::abs(denom) > 1e-15 * std::sqrt(len_sq * (ex * ex + ey * ey))) {
+            double t = cross(q0.x - a.x, q0.y - a.y, ex, ey) / denom;
+            double u = cross(q0.x - a.x, q0.y - a.y, dx, dy) / denom;
+            if (t > 0 && t < 1 && u >= 0 && u <= 1) {
+                cuts.push_back(t);
+            }
+        } else {
+            // Parallel edge: its endpoints may bound a shared stretch
+            for (const Point* q : {&q0, &q1}) {
+                double t = ((q->x - a.x) * dx + (q->y - a.y) * dy) / len_sq;
+                if (t > 0 && t < 1) {
+                    cuts.push_back(t);
+                }
+            }
+        }
+    }
+    std::sort(cuts.begin(), cuts.end());
+
+    for (size_t k = 0; k + 1 < cuts.size(); ++k) {
+        double t0 = cuts[k];
+        double t1 = cuts[k + 1];
+        if (t1 - t0 <= 1e-12) {
+            continue;
+        }
+        Point mid{a.x + 0.5 * (t0 + t1) * dx, a.y + 0.5 * (t0 + t1) * dy};
+
+        bool on_edge = false;
+        bool inside = false;
+        for (size_t j : nearby) {
+            const Point& q0 = v[j];
+            const Point& q1 = v[(j + 1) % v.size()];
+            if (pointSegmentDistance(mid, q0, q1) <= eps) {
+                bool same_direction = (q1.x - q0.x) * dx + (q1.y - q0.y) * dy > 0;
+                inside = !same_direction || same_side_wins;
+                on_edge = true;
+                break;
+            }
+        }
+        if (!on_edge) {
+            // Crossing-number test
+            clip.edges.query(mid.y, mid.y, [&](size_t j) {
+                const Point& q0 = v[j];
+                const Point& q1 = v[(j + 1) % v.size()];
+                if ((q0.y > mid.y) != (q1.y > mid.y)) {
+                    double x = q0.x + (mid.y - q0.y) * (q1.x - q0.x) / (q1.y - q0.y);
+                    if (x > mid.x) {
+                        inside = !inside;
+                    }
+                }
+            });
+        }
+        if (inside) {
+            covered.emplace_back(t0, t1);
+        }
+    }
+}
+
+double clusterPerimeterByClipping(const std::vector<PlacedShape>& shapes,
+                                  const std::vector<size_t>& cluster,
+                                  const std::vector<std::vector<size_t>>& neighbours,
+                                  const std::vector<size_t>& local,
+                                  const std::vector<BoundingBox>& boxes,
+                                  double tolerance) {
+    std::vector<Outline> outlines(cluster.size());
+    double extent = 0.0;
+    for (size_t k = 0; k < cluster.size(); ++k) {
+        size_t i = cluster[k];
+        Outline& outline = outlines[k];
+        if (shapes[i].shape->kind() == ShapeKind::Path) {
+            const auto* path = static_cast<const Path*>(shapes[i].shape);
+            outline.vertices = path->flatten(tolerance, &outline.edge_weights);
+            for (Point& p : outline.vertices) {
+                p.x += shapes[i].position.x;
+                p.y += shapes[i].position.y;
+            }
+        } else {
+            outline.vertices = placedOutline(shapes[i], tolerance);
+            double weight = 1.0;
+            if (shapes[i].shape->kind() == ShapeKind::Circle) {
+                double n = static_cast<double>(outline.vertices.size());
+                weight = (M_PI / n) / std::sin(M_PI / n);
+            }
+            outline.edge_weights.assign(outline.vertices.size(), weight);
+        }
+        outline.edges = EdgeIndex(outline.vertices);
+        const BoundingBox& box = boxes[i];
+        extent = std::max({extent, std::abs(box.min_x), std::abs(box.max_x),
+                           std::abs(box.min_y), std::abs(box.max_y),
+                           box.max_x - box.min_x, box.max_y - box.min_y});
+    }
+    double eps = 1e-9 * std::max(extent, 1.0);
+
+    double perimeter = 0.0;
+    ClipScratch scratch;
+    std::vector<std::pair<double, double>> covered;
+    for (size_t k = 0; k < cluster.size(); ++k) {
+        size_t i = cluster[k];
+        const auto& v = outlines[k].vertices;
+        for (size_t e = 0; e < v.size(); ++e) {
+            const Point& a = v[e];
+            const Point& b = v[(e + 1) % v.size()];
+            covered.clear();
+            for (size_t j : neighbours[i]) {
+                // Most edges of a shape lie clear of any one neighbour
+                const BoundingBox& box = boxes[j];
+                if (std::max(a.x, b.x) < box.min_x - eps || std::min(a.x, b.x) > box.max_x + eps ||
+                    std::max(a.y, b.y) < box.min_y - eps || std::min(a.y, b.y) > box.max_y + eps) {
+                    continue;
+                }
+                clipSegment(a, b, outlines[local[j]], j < i, eps, scratch, covered);
+            }
+            std::sort(covered.begin(), covered.end());
+            double hidden = 0.0;
+            double reach = 0.0;
+            for (const auto& [from, to] : covered) {
+                double start = std::max(from, reach);
+                if (to > start) {
+                    hidden += to - start;
+                    reach = to;
+                }
+            }
+            double length = std::hypot(b.x - a.x, b.y - a.y) * outlines[k].edge_weights[e];
+            perimeter += length * std::max(0.0, 1.0 - hidden);
+        }
+    }
+    return perimeter;
+}
+
+/**
+ * @brief Boxes active in the overlap sweep, searchable by y-extent
+ *
+ * A box meets a query range [lo, hi] if it starts inside it or starts
+ * below it and reaches lo. The first kind is found in an ordered set keyed
+ * by the start, the second by a stabbing query on a segment tree over the
+ * compressed y coordinates whose nodes list the boxes they canonically
+ * cover. Removed boxes leave those lists lazily, when a query passes them.
+ */
+class ActiveBoxes {
+private:
+    const std::vector<BoundingBox>& boxes_;
+    std::vector<double> coords_;
+    std::vector<std::vector<size_t>> lists_;
+    std::vector<char> active_;
+    std::set<std::pair<double, size_t>> by_start_;
+
+    size_t coordinate(double y) const {
+        return std::lower_bound(coords_.begin(), coords_.end(), y) - coords_.begin();
+    }
+
+    void insert(size_t node, size_t lo, size_t hi, size_t from, size_t to, size_t box) {
+        if (to < lo || hi < from) {
+            return;
+        }
+        if (from <= lo && hi <= to) {
+            lists_[node].push_back(box);
+            return;
+        }
+        size_t mid = (lo + hi) / 2;
+        insert(2 * node, lo, mid, from, to, box);
+        insert(2 * node + 1, mid + 1, hi, from, to, box);
+    }
+
+public:
+    explicit ActiveBoxes(const std::vector<BoundingBox>& boxes)
+        : boxes_(boxes), active_(boxes.size(), 0) {
+        coords_.reserve(2 * boxes.size());
+        for (const BoundingBox& box : boxes) {
+            coords_.push_back(box.min_y);
+            coords_.push_back(box.max_y);
+        }
+        std::sort(coords_.begin(), coords_.end());
+        coords_.erase(std::unique(coords_.begin(), coords_.end()), coords_.end());
+        lists_.resize(4 * coords_.size() + 4);
+    }
+
+    void insert(size_t box) {
+        active_[box] = 1;
+        by_start_.emplace(boxes_[box].min_y, box);
+        insert(1, 0, coords_.size() - 1, coordinate(boxes_[box].min_y), coordinate(boxes_[box].max_y), box);
+    }
+
+    void remove(size_t box) {
+        active_[box] = 0;
+        by_start_.erase({boxes_[box].min_y, box});
+    }
+
+    /**
+     * @brief Visit every active box whose y-extent meets [lo, hi]
+     * @param lo Start of the range; must be one of the boxes' coordinates
+     */
+    template <typename Visit>
+    void overlapping(double lo, double hi, Visit&& visit) {
+        for (auto it = by_start_.lower_bound({lo, 0}); it != by_start_.end() && it->first <= hi; ++it) {
+            visit(it->second);
+        }
+        size_t point = coordinate(lo);
+        size_t node = 1;
+        size_t begin = 0;
+        size_t end = coords_.size() - 1;
+        while (true) {
+            std::vector<size_t>& list = lists_[node];
+            for (size_t n = 0; n < list.size();) {
+                size_t box = list[n];
+                if (!active_[box]) {
+                    list[n] = list.back();
+                    list.pop_back();
+                    continue;
+                }
+                if (boxes_[box].min_y < lo) {
+                    visit(box);
+                }
+                ++n;
+            }
+            if (begin == end) {
+                break;
+            }
+            size_t mid = (begin + end) / 2;
+            if (point <= mid) {
+                node = 2 * node;
+                end = mid;
+            } else {
+                node = 2 * node + 1;
+                begin = mid + 1;
+            }
+        }
+    }
+};
+
+} // namespace
+
+double rectangleUnionPerimeter(const std::vector<BoundingBox>& rects) {
+    if (rects.empty()) {
+        return 0.0;
+    }
+    return sweepBoundaryLength(rects, true) + sweepBoundaryLength(rects, false);
+}
+
+std::vector<std::pair<size_t, size_t>> overlappingPairs(const std::vector<BoundingBox>& boxes) {
+    std::vector<size_t> order(boxes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return boxes[a].min_x < boxes[b].min_x;
+    });
+
+    // Boxes leave the sweep once it passes their right edge
+    std::vector<std::pair<size_t, size_t>> pairs;
+    if (boxes.empty()) {
+        return pairs;
+    }
+    ActiveBoxes active(boxes);
+    using Expiry = std::pair<double, size_t>;
+    std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> expiry;
+    for (size_t i : order) {
+        const BoundingBox& box = boxes[i];
+        while (!expiry.empty() && expiry.top().first < box.min_x) {
+            active.remove(expiry.top().second);
+            expiry.pop();
+        }
+        active.overlapping(box.min_y, box.max_y, [&](size_t j) {
+            pairs.emplace_back(std::min(i, j), std::max(i, j));
+        });
+        active.insert(i);
+        expiry.emplace(box.max_x, i);
+    }
+    return pairs;
+}
+
+std::vector<std::vector<size_t>> overlapClusters(
+    const std::vector<BoundingBox>& boxes,
+    const std::vector<std::pair<size_t, size_t>>& pairs) {
+    std::vector<size_t> parent(boxes.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](size_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+    for (const auto& [a, b] : pairs) {
+        size_t ra = find(a);
+        size_t rb = find(b);
+        if (ra != rb) {
+            parent[std::max(ra, rb)] = std::min(ra, rb);
+        }
+    }
+
+    std::vector<std::vector<size_t>> clusters;
+    std::vector<size_t> cluster_of(boxes.size(), boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        size_t root = find(i);
+        if (cluster_of[root] == boxes.size()) {
+            cluster_of[root] = clusters.size();
+            clusters.emplace_back();
+        }
+        clusters[cluster_of[root]].push_back(i);
+    }
+    return clusters;
+}
+
+double unionPerimeter(const std::vector<PlacedShape>& shapes, double tolerance) {
+    return unionPerimeter(shapes, Deadline(), tolerance).value;
+}
+
+PartialResult unionPerimeter(const std::vector<PlacedShape>& shapes, const Deadline& deadline,
+                             double tolerance) {
+    std::vector<BoundingBox> boxes(shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        boxes[i] = placedBounds(shapes[i]);
+    }
+    auto pairs = overlappingPairs(boxes);
+    auto clusters = overlapClusters(boxes, pairs);
+
+    // Position of each shape within its cluster
+    std::vector<size_t> local(shapes.size());
+    for (const auto& cluster : clusters) {
+        for (size_t k = 0; k < cluster.size(); ++k) {
+            local[cluster[k]] = k;
+        }
+    }
+
+    std::vector<std::vector<size_t>> neighbours(shapes.size());
+    for (const auto& [a, b] : pairs) {
+        neighbours[a].push_back(b);
+        neighbours[b].push_back(a);
+    }
+
+    std::vector<double> results(clusters.size(), 0.0);
+    std::vector<char> finished(clusters.size(), 0);
+    std::atomic<bool> stop{false};
+    size_t stride = spreadStride(clusters.size());
+    parallelFor(clusters.size(), [&](size_t k) {
+        if (stop.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (deadline.expired()) {
+            stop.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        size_t c = spreadIndex(k, stride, clusters.size());
+        const auto& cluster = clusters[c];
+        finished[c] = 1;
+        if (cluster.size() == 1) {
+            results[c] = shapes[cluster[0]].shape->perimeter();
+            return;
+        }
+        bool all_rectangles = std::all_of(cluster.begin(), cluster.end(), [&](size_t i) {
+            return shapes[i].shape->kind() == ShapeKind::Rectangle;
+        });
+        if (all_rectangles) {
+            std::vector<BoundingBox> rects;
+            rects.reserve(cluster.size());
+            for (size_t i : cluster) {
+                rects.push_back(boxes[i]);
+            }
+            results[c] = rectangleUnionPerimeter(rects);
+        } else {
+            results[c] = clusterPerimeterByClipping(shapes, cluster, neighbours, local,
+                                                    boxes, tolerance);
+        }
+    });
+
+    PartialResult result;
+    result.total = shapes.size();
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        if (finished[c]) {
+            result.value += results[c];
+            result.processed += clusters[c].size();
+        }
+    }
+    result.estimate = result.exact() || result.processed == 0
+        ? result.value
+        : result.value * static_cast<double>(result.total) / static_cast<double>(result.processed);
+    return result;
+}
+
+} // namespace geometry
@@ -0,0 +1,83 @@
+#include "alloc_counter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace geometry {
+
+namespace {
+
+thread_local AllocationStats thread_stats;
+
+void* countedAllocate(std::size_t size) {
+    ++thread_stats.allocations;
+    thread_stats.bytes += size;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAllocate(std::size_t size, std::align_val_t alignment) {
+    ++thread_stats.allocations;
+    thread_stats.bytes += size;
+    auto align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded);
+}
+
+void countedFree(void* p) noexcept {
+    if (p) {
+        ++thread_stats.deallocations;
+        std::free(p);
+    }
+}
+
+} // namespace
+
+AllocationStats threadAllocationStats() {
+    return thread_stats;
+}
+
+} // namespace geometry
+
+using geometry::countedAllocate;
+using geometry::countedFree;
+
+void* operator new(std::size_t size) {
+    if (void* p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = countedAllocate(size, alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { countedFree(p); }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace geometry {
+
+/**
+ * @brief Heap activity of the calling thread
+ *
+ * Counted by the operator new/delete replacements in alloc_counter.cpp,
+ * which every binary linking that file gets. Counters are per thread, so
+ * work on background threads does not disturb a measurement.
+ */
+struct AllocationStats {
+    uint64_t allocations = 0;    ///< Calls to any operator new
+    uint64_t deallocations = 0;  ///< Calls to any operator delete (non-null)
+    uint64_t bytes = 0;          ///< Bytes requested from operator new
+};
+
+/**
+ * @brief Get the calling thread's totals since it started
+ * @return Allocation statistics
+ */
+AllocationStats threadAllocationStats();
+
+/**
+ * @brief Measures the allocations made by the calling thread during its lifetime
+ */
+class AllocationScope {
+private:
+    AllocationStats start_;
+
+public:
+    AllocationScope() : start_(threadAllocationStats()) {}
+
+    /**
+     * @brief Get the activity since construction
+     * @return Allocation statistics
+     */
+    AllocationStats stats() const {
+        AllocationStats now = threadAllocationStats();
+        return {now.allocations - start_.allocations, now.deallocations - start_.deallocations,
+                now.bytes - start_.bytes};
+    }
+
+    uint64_t allocations() const { return stats().allocations; }
+    uint64_t bytes() const { return stats().bytes; }
+};
+
+} // namespace geometry
+
+/// Check that a statement performs no heap allocation on the calling thread
+#define EXPECT_NO_ALLOCATIONS(statement)                                              \
+    do {                                                                              \
+        ::geometry::AllocationScope allocation_scope_;                                \
+        statement;                                                                    \
+        uint64_t allocations_ = allocation_scope_.allocations();                      \
+        EXPECT_EQ(allocations_, 0u) << "Allocations in: " #statement;                 \
+    } while (0)
+
+/// Like EXPECT_NO_ALLOCATIONS, but aborts the test on failure
+#define ASSERT_NO_ALLOCATIONS(statement)                                              \
+    do {                                                                              \
+        ::geometry::AllocationScope allocation_scope_;                                \
+        statement;                                                                    \
+        uint64_t allocations_ = allocation_scope_.allocations();                      \
+        ASSERT_EQ(allocations_, 0u) << "Allocations in: " #statement;                 \
+    } while (0)
+
+/// Check that a statement performs at most a given number of heap allocations
+#define EXPECT_ALLOCATIONS_AT_MOST(limit, statement)                                  \
+    do {                                                                              \
+        ::geometry::AllocationScope allocation_scope_;                                \
+        statement;                                                                    \
+        uint64_t allocations_ = allocation_scope_.allocations();                      \
+        EXPECT_LE(allocations_, static_cast<uint64_t>(limit)) << "Allocations in: " #statement; \
+    } while (0)
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "alloc_counter.h"
+#include "geometry_calculator.h"
+#include "small_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+
+using namespace geometry;
+
+class AllocationsTest : public ::testing::Test {
+protected:
+    GeometryCalculator calculator;
+
+    void SetUp() override {
+        for (int i = 1; i <= 100; ++i) {
+            calculator.addShape(std::make_unique<Circle>(i * 0.1), Point{i * 1.0, 0.0});
+            calculator.addShape(std::make_unique<Rectangle>(i * 0.1, 2.0));
+            calculator.addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0));
+        }
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+TEST_F(AllocationsTest, CounterSeesAllocations) {
+    AllocationScope scope;
+    auto shape = std::make_unique<Circle>(1.0);
+    EXPECT_EQ(scope.allocations(), 1u);
+    EXPECT_EQ(scope.bytes(), sizeof(Circle));
+    shape.reset();
+    EXPECT_EQ(scope.stats().deallocations, 1u);
+
+    EXPECT_ALLOCATIONS_AT_MOST(1, shape = std::make_unique<Circle>(2.0));
+}
+
+TEST_F(AllocationsTest, ShapeMeasuresDoNotAllocate) {
+    Circle circle(1.5);
+    Rectangle rectangle(2.0, 3.0);
+    Triangle triangle(3.0, 4.0, 5.0);
+    double total = 0.0;
+    EXPECT_NO_ALLOCATIONS(total += circle.area() + circle.perimeter());
+    EXPECT_NO_ALLOCATIONS(total += rectangle.area() + rectangle.perimeter());
+    EXPECT_NO_ALLOCATIONS(total += triangle.area() + triangle.perimeter() + triangle.isValid());
+    EXPECT_GT(total, 0.0);
+}
+
+TEST_F(AllocationsTest, CalculatorReadPathsDoNotAllocate) {
+    ShapeQuery circles{QueryAggregate::Count, kindMask(ShapeKind::Circle)};
+    calculator.totalArea();
+    calculator.totalPerimeter();
+    calculator.query(circles);
+
+    Deadline unlimited;  // The token's shared flag is allocated here, not per query
+    double total = 0.0;
+    EXPECT_NO_ALLOCATIONS(total += calculator.totalArea());
+    EXPECT_NO_ALLOCATIONS(total += calculator.totalPerimeter());
+    EXPECT_NO_ALLOCATIONS(total += calculator.query(circles));
+    EXPECT_NO_ALLOCATIONS(total += calculator.shapeCount());
+    EXPECT_NO_ALLOCATIONS(total += calculator.getShape(150)->area());
+    EXPECT_NO_ALLOCATIONS(total += calculator.getPlacedShape(3).position.x);
+    EXPECT_NO_ALLOCATIONS(total += calculator.totalArea(unlimited).value);
+    EXPECT_GT(total, 0.0);
+}
+
+TEST_F(AllocationsTest, ViewMaintenanceDoesNotAllocate) {
+    ViewSet views;
+    views.add("all", ViewDefinition{});
+    views.add("small", ViewDefinition{}.where(ShapeFeature::Area, 0.0, 1.0));
+    ShapeFeatures features = shapeFeatures(Circle(1.0));
+    EXPECT_NO_ALLOCATIONS(views.apply(features, 1.0));
+    EXPECT_NO_ALLOCATIONS(views.apply(features, -1.0));
+
+    calculator.createView("circles", ViewDefinition{});
+    auto replacement = std::make_unique<Circle>(2.0);
+    EXPECT_NO_ALLOCATIONS(calculator.setPosition(0, Point{5.0, 5.0}));
+    EXPECT_NO_ALLOCATIONS(calculator.replaceShape(0, std::move(replacement)));
+}
+
+TEST_F(AllocationsTest, SmallCalculatorInlinePathDoesNotAllocate) {
+    SmallGeometryCalculator<4> small;
+    ShapeValue circle = ShapeValue::circle(1.0);
+    EXPECT_NO_ALLOCATIONS({
+        for (int i = 0; i < 4; ++i) {
+            small.addShape(circle);
+        }
+    });
+    double total = 0.0;
+    EXPECT_NO_ALLOCATIONS(total += small.totalArea() + small.totalPerimeter());
+    EXPECT_ALLOCATIONS_AT_MOST(1, small.addShape(circle));
+    EXPECT_GT(total, 0.0);
+}
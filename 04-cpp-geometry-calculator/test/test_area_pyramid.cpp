@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "area_pyramid.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+
+using namespace geometry;
+
+class AreaPyramidTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> coord(-10.0, 110.0);
+        std::uniform_real_distribution<double> size(0.5, 2.0);
+        for (size_t i = 0; i < 600; ++i) {
+            switch (i % 3) {
+                case 0: owned.push_back(std::make_unique<Circle>(size(rng))); break;
+                case 1: owned.push_back(std::make_unique<Rectangle>(size(rng), size(rng))); break;
+                default: owned.push_back(std::make_unique<Triangle>(3.0, 4.0, 5.0)); break;
+            }
+            shapes.push_back({owned.back().get(), {coord(rng), coord(rng)}});
+        }
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    RegionTotals exact(const BoundingBox& region) const {
+        RegionTotals totals;
+        for (const PlacedShape& placed : shapes) {
+            BoundingBox box = placedBounds(placed);
+            double cx = (box.min_x + box.max_x) / 2.0;
+            double cy = (box.min_y + box.max_y) / 2.0;
+            if (cx >= region.min_x && cx <= region.max_x && cy >= region.min_y && cy <= region.max_y) {
+                size_t kind = static_cast<size_t>(placed.shape->kind());
+                totals.count += 1.0;
+                totals.area += placed.shape->area();
+                totals.kind_count[kind] += 1.0;
+                totals.kind_area[kind] += placed.shape->area();
+            }
+        }
+        return totals;
+    }
+
+    std::vector<std::unique_ptr<Shape>> owned;
+    std::vector<PlacedShape> shapes;
+    const BoundingBox world{0.0, 0.0, 100.0, 100.0};
+};
+
+TEST_F(AreaPyramidTest, AlignedRegionIsExact) {
+    Rectangle unit(1.0, 1.0);
+    std::vector<PlacedShape> grid;
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            grid.push_back({&unit, {x * 8.0 + 3.0, y * 8.0 + 3.0}});
+        }
+    }
+    AreaPyramid pyramid({0.0, 0.0, 64.0, 64.0}, 4);
+    pyramid.build(grid);
+
+    // Tiles of 8 x 8 at level 3: the region covers 3 x 2 of them exactly
+    RegionAggregate result = pyramid.query({8.0, 16.0, 32.0, 32.0}, 3);
+    EXPECT_DOUBLE_EQ(result.inner.count, 6.0);
+    EXPECT_DOUBLE_EQ(result.inner.area, 6.0);
+    EXPECT_DOUBLE_EQ(result.inner.kind_count[static_cast<size_t>(ShapeKind::Rectangle)], 6.0);
+    // The closed region touches the next row and column of tiles
+    EXPECT_DOUBLE_EQ(result.outer.count, 12.0);
+}
+
+TEST_F(AreaPyramidTest, BoundsHoldAtEveryLevel) {
+    AreaPyramid pyramid(world, 7);
+    pyramid.build(shapes);
+
+    for (const BoundingBox& region : {BoundingBox{12.3, 40.1, 57.9, 88.8}, BoundingBox{-5.0, -5.0, 20.0, 3.0},
+                                      BoundingBox{50.0, 50.0, 50.5, 50.5}}) {
+        RegionTotals truth = exact(region);
+        double previous_gap = std::numeric_limits<double>::infinity();
+        for (size_t level = 0; level < pyramid.levelCount(); ++level) {
+            RegionAggregate result = pyramid.query(region, level);
+            EXPECT_LE(result.inner.count, truth.count);
+            EXPECT_GE(result.outer.count, truth.count);
+            EXPECT_LE(result.inner.area, truth.area + 1e-9);
+            EXPECT_GE(result.outer.area, truth.area - 1e-9);
+            for (size_t k = 0; k < kShapeKindCount; ++k) {
+                EXPECT_LE(result.inner.kind_count[k], truth.kind_count[k]);
+                EXPECT_GE(result.outer.kind_count[k], truth.kind_count[k]);
+            }
+            double gap = result.outer.count - result.inner.count;
+            EXPECT_LE(gap, previous_gap);
+            previous_gap = gap;
+        }
+    }
+}
+
+TEST_F(AreaPyramidTest, UnboundedRegionCountsEverything) {
+    AreaPyramid pyramid(world, 5);
+    pyramid.build(shapes);
+    const double inf = std::numeric_limits<double>::infinity();
+
+    RegionAggregate all = pyramid.query({-inf, -inf, inf, inf});
+    RegionTotals truth = exact({-inf, -inf, inf, inf});
+    EXPECT_DOUBLE_EQ(all.inner.count, static_cast<double>(shapes.size()));
+    EXPECT_DOUBLE_EQ(all.outer.count, static_cast<double>(shapes.size()));
+    EXPECT_NEAR(all.inner.area, truth.area, 1e-9);
+}
+
+TEST_F(AreaPyramidTest, InsertsMatchBuild) {
+    AreaPyramid built(world, 6);
+    built.build(shapes);
+    AreaPyramid inserted(world, 6, 128);
+    for (const PlacedShape& placed : shapes) {
+        inserted.insert(placed);
+    }
+    EXPECT_LT(inserted.pendingCount(), 128u);
+    EXPECT_GT(inserted.pendingCount(), 0u);
+
+    BoundingBox region{20.0, 30.0, 70.0, 45.0};
+    for (size_t level = 0; level < 6; ++level) {
+        RegionAggregate a = built.query(region, level);
+        RegionAggregate b = inserted.query(region, level);
+        EXPECT_DOUBLE_EQ(a.inner.count, b.inner.count);
+        EXPECT_DOUBLE_EQ(a.outer.count, b.outer.count);
+        EXPECT_NEAR(a.outer.area, b.outer.area, 1e-9);
+    }
+
+    inserted.flush();
+    EXPECT_EQ(inserted.pendingCount(), 0u);
+    EXPECT_DOUBLE_EQ(inserted.query(region).outer.count, built.query(region).outer.count);
+}
+
+TEST_F(AreaPyramidTest, InvalidArguments) {
+    EXPECT_THROW(AreaPyramid({0.0, 0.0, 0.0, 1.0}), std::invalid_argument);
+    EXPECT_THROW(AreaPyramid(world, 0), std::invalid_argument);
+    EXPECT_THROW(AreaPyramid(world, 17), std::invalid_argument);
+
+    AreaPyramid pyramid(world, 3);
+    EXPECT_THROW(pyramid.query(world, 3), std::out_of_range);
+    EXPECT_EQ(pyramid.tilesPerSide(2), 4u);
+    EXPECT_DOUBLE_EQ(pyramid.query({5.0, 5.0, 1.0, 1.0}).outer.count, 0.0);
+}
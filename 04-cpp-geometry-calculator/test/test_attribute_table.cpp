@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cmath>
+#include <string>
+
+using namespace geometry;
+
+class AttributeTableTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        calc.addShape(std::make_unique<Rectangle>(2.0, 3.0));  // Area 6, perimeter 10
+        calc.addShape(std::make_unique<Circle>(1.0));          // Area pi, perimeter 2 pi
+        calc.addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0));  // Area 6, perimeter 12
+        calc.addNumericAttribute("price", 1.0);
+        calc.addCategoricalAttribute("material", "steel");
+        calc.setAttribute(1, "price", 4.0);
+        calc.setAttribute(1, "material", "wood");
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    GeometryCalculator calc;
+};
+
+TEST_F(AttributeTableTest, CostGroupedByMaterial) {
+    WeightedAggregate cost{AttributeWeight::of("price"), AttributeWeight::constant(0.5), {}, "material"};
+    GroupedTotals totals = calc.weightedAggregate(cost);
+
+    ASSERT_EQ(totals.groups.size(), 2u);
+    EXPECT_EQ(totals.groups[0], "steel");
+    EXPECT_EQ(totals.groups[1], "wood");
+    EXPECT_NEAR(totals.totals[0], 6.0 + 5.0 + 6.0 + 6.0, 1e-12);
+    EXPECT_NEAR(totals.totals[1], 4.0 * M_PI + M_PI, 1e-12);
+    EXPECT_EQ(totals.counts[0], 2u);
+    EXPECT_EQ(totals.counts[1], 1u);
+
+    WeightedAggregate count{{}, {}, AttributeWeight::constant(1.0), ""};
+    GroupedTotals ungrouped = calc.weightedAggregate(count);
+    ASSERT_EQ(ungrouped.totals.size(), 1u);
+    EXPECT_DOUBLE_EQ(ungrouped.totals[0], 3.0);
+}
+
+TEST_F(AttributeTableTest, LargeAggregateMatchesLoop) {
+    GeometryCalculator large;
+    large.addNumericAttribute("price");
+    large.addCategoricalAttribute("batch");
+    double expected = 0.0;
+    for (size_t i = 0; i < 10000; ++i) {
+        large.addShape(std::make_unique<Rectangle>(1.0 + i % 5, 2.0));
+        large.setAttribute(i, "price", static_cast<double>(i % 3));
+        large.setAttribute(i, "batch", i % 2 ? "odd" : "even");
+        if (i % 2) {
+            expected += (1.0 + i % 5) * 2.0 * static_cast<double>(i % 3);
+        }
+    }
+    GroupedTotals totals = large.weightedAggregate({AttributeWeight::of("price"), {}, {}, "batch"});
+    ASSERT_EQ(totals.groups.size(), 3u);  // "", "even", "odd"
+    EXPECT_EQ(totals.groups[2], "odd");
+    EXPECT_DOUBLE_EQ(totals.totals[2], expected);
+    EXPECT_EQ(totals.counts[0], 0u);
+    EXPECT_EQ(totals.counts[2], 5000u);
+}
+
+TEST_F(AttributeTableTest, RowsFollowShapes) {
+    calc.removeShape(0);
+    EXPECT_EQ(calc.attributes().rowCount(), 2u);
+    EXPECT_EQ(calc.attributes().category(0, "material"), "wood");
+    EXPECT_DOUBLE_EQ(calc.attributes().number(0, "price"), 4.0);
+
+    calc.replaceShape(0, std::make_unique<Rectangle>(1.0, 1.0));
+    GroupedTotals totals = calc.weightedAggregate({AttributeWeight::of("price"), {}, {}, "material"});
+    EXPECT_DOUBLE_EQ(totals.totals[1], 4.0);
+
+    calc.addShape(std::make_unique<Circle>(2.0));
+    EXPECT_EQ(calc.attributes().category(2, "material"), "steel");
+    EXPECT_DOUBLE_EQ(calc.attributes().number(2, "price"), 1.0);
+
+    calc.clear();
+    EXPECT_EQ(calc.attributes().rowCount(), 0u);
+    EXPECT_TRUE(calc.attributes().has("price"));
+}
+
+TEST_F(AttributeTableTest, MergeAlignsColumnsAndCategories) {
+    GeometryCalculator other;
+    other.addShape(std::make_unique<Circle>(2.0));
+    other.addCategoricalAttribute("material", "wood");
+    other.addNumericAttribute("weight", 7.0);
+
+    calc.merge(other);
+    ASSERT_EQ(calc.shapeCount(), 4u);
+    EXPECT_EQ(calc.attributes().category(3, "material"), "wood");
+    EXPECT_DOUBLE_EQ(calc.attributes().number(3, "price"), 1.0);
+    EXPECT_DOUBLE_EQ(calc.attributes().number(0, "weight"), 7.0);
+    EXPECT_EQ(other.attributes().rowCount(), 0u);
+
+    GeometryCalculator mismatched;
+    mismatched.addShape(std::make_unique<Circle>(1.0));
+    mismatched.addNumericAttribute("material");
+    EXPECT_THROW(calc.merge(mismatched), std::invalid_argument);
+    EXPECT_EQ(calc.shapeCount(), 4u);
+    EXPECT_EQ(mismatched.shapeCount(), 1u);
+}
+
+TEST_F(AttributeTableTest, MergeIntoFullDictionaryChangesNothing) {
+    // 65536 codes: the default category and 65535 others
+    GeometryCalculator full;
+    full.addShape(std::make_unique<Circle>(1.0));
+    full.addCategoricalAttribute("tag", "none");
+    for (size_t i = 1; i < 65536; ++i) {
+        full.setAttribute(0, "tag", "tag " + std::to_string(i));
+    }
+    full.createView("count", ViewDefinition{});
+    double distinct = full.statistics().distinctCount();
+
+    GeometryCalculator other;
+    other.addShape(std::make_unique<Circle>(2.0));
+    other.addShape(std::make_unique<Rectangle>(1.0, 2.0));
+    other.addCategoricalAttribute("tag", "one too many");
+    uint64_t version = full.version();
+
+    EXPECT_THROW(full.merge(other), std::length_error);
+    EXPECT_EQ(full.shapeCount(), 1u);
+    EXPECT_EQ(full.version(), version);
+    EXPECT_DOUBLE_EQ(full.views().value("count"), 1.0);
+    EXPECT_DOUBLE_EQ(full.statistics().distinctCount(), distinct);
+    EXPECT_EQ(full.attributes().rowCount(), 1u);
+    EXPECT_EQ(other.shapeCount(), 2u);
+    EXPECT_EQ(other.attributes().category(1, "tag"), "one too many");
+}
+
+TEST_F(AttributeTableTest, PartitionCarriesAttributes) {
+    auto parts = calc.partition(2, [](const Shape& shape) {
+        return shape.kind() == ShapeKind::Circle ? size_t{1} : size_t{0};
+    });
+    ASSERT_EQ(parts[1].shapeCount(), 1u);
+    EXPECT_EQ(parts[1].attributes().category(0, "material"), "wood");
+    EXPECT_EQ(parts[0].attributes().rowCount(), 2u);
+    EXPECT_EQ(calc.attributes().rowCount(), 0u);
+}
+
+TEST_F(AttributeTableTest, InvalidColumns) {
+    EXPECT_THROW(calc.addNumericAttribute("price"), std::invalid_argument);
+    EXPECT_THROW(calc.addNumericAttribute(""), std::invalid_argument);
+    EXPECT_THROW(calc.setAttribute(0, "price", "cheap"), std::invalid_argument);
+    EXPECT_THROW(calc.setAttribute(0, "material", 2.0), std::invalid_argument);
+    EXPECT_THROW(calc.setAttribute(3, "price", 2.0), std::out_of_range);
+    EXPECT_THROW(calc.weightedAggregate({AttributeWeight::of("missing"), {}, {}, ""}),
+                 std::invalid_argument);
+    EXPECT_THROW(calc.weightedAggregate({{}, {}, {}, "price"}), std::invalid_argument);
+    EXPECT_TRUE(calc.dropAttribute("price"));
+    EXPECT_FALSE(calc.dropAttribute("price"));
+}
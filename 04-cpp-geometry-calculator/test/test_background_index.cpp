@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "background_index.h"
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+using namespace geometry;
+using namespace std::chrono_literals;
+
+class BackgroundIndexTest : public ::testing::Test {
+protected:
+    GeometryCalculator calculator;
+
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    static void fill(GeometryCalculator& target, size_t count, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> size(0.5, 5.0);
+        std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+        for (size_t i = 0; i < count; ++i) {
+            Point position{coordinate(rng), coordinate(rng)};
+            switch (i % 3) {
+                case 0:
+                    target.addShape(std::make_unique<Circle>(size(rng)), position);
+                    break;
+                case 1:
+                    target.addShape(std::make_unique<Rectangle>(size(rng), size(rng)), position);
+                    break;
+                default: {
+                    double side = size(rng);
+                    target.addShape(std::make_unique<Triangle>(side, side, side), position);
+                    break;
+                }
+            }
+        }
+    }
+
+    static std::vector<ShapeQuery> filteredQueries() {
+        std::vector<ShapeQuery> queries;
+        for (auto aggregate : {QueryAggregate::Count, QueryAggregate::TotalArea,
+                               QueryAggregate::TotalPerimeter}) {
+            ShapeQuery circles{aggregate, kindMask(ShapeKind::Circle)};
+            ShapeQuery band{aggregate};
+            band.min_area = 3.0;
+            band.max_area = 12.5;
+            queries.push_back(circles);
+            queries.push_back(band);
+        }
+        return queries;
+    }
+};
+
+TEST_F(BackgroundIndexTest, AreaIndexMatchesScan) {
+    fill(calculator, 20000, 1);
+    std::vector<double> scanned;
+    for (const auto& query : filteredQueries()) {
+        scanned.push_back(calculator.query(query));
+    }
+
+    calculator.buildIndex(IndexKind::Area);
+    ASSERT_TRUE(calculator.waitForIndex(IndexKind::Area, 30s));
+    IndexStatus status = calculator.indexStatus(IndexKind::Area);
+    EXPECT_TRUE(status.requested);
+    EXPECT_TRUE(status.ready);
+    EXPECT_DOUBLE_EQ(status.progress, 1.0);
+    EXPECT_GT(status.bytes, 0u);
+
+    calculator.queryCache().clear();
+    auto queries = filteredQueries();
+    for (size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_NEAR(calculator.query(queries[i]), scanned[i], 1e-9 * scanned[i]) << i;
+    }
+}
+
+TEST_F(BackgroundIndexTest, SpatialIndexMatchesScan) {
+    fill(calculator, 5000, 2);
+    BoundingBox box{-10.0, -20.0, 15.0, 5.0};
+    auto scanned = calculator.shapesIntersecting(box);
+    EXPECT_FALSE(scanned.empty());
+
+    calculator.buildIndex(IndexKind::Spatial);
+    ASSERT_TRUE(calculator.waitForIndex(IndexKind::Spatial, 30s));
+    EXPECT_EQ(calculator.shapesIntersecting(box), scanned);
+    EXPECT_FALSE(calculator.indexStatus(IndexKind::Area).requested);
+}
+
+TEST_F(BackgroundIndexTest, MutationsInvalidateAndRebuild) {
+    fill(calculator, 3000, 3);
+    calculator.buildIndex(IndexKind::Area);
+    ShapeQuery circles{QueryAggregate::Count, kindMask(ShapeKind::Circle)};
+
+    // Mutate while the build may still be running
+    calculator.addShape(std::make_unique<Circle>(1.0));
+    calculator.removeShape(0);
+    EXPECT_FALSE(calculator.indexStatus(IndexKind::Area).ready);
+    EXPECT_DOUBLE_EQ(calculator.query(circles), 1000.0);
+
+    ASSERT_TRUE(calculator.waitForIndex(IndexKind::Area, 30s));
+    calculator.replaceShape(1, std::make_unique<Circle>(2.0));
+    EXPECT_FALSE(calculator.indexStatus(IndexKind::Area).ready);
+    ASSERT_TRUE(calculator.waitForIndex(IndexKind::Area, 30s));
+    EXPECT_DOUBLE_EQ(calculator.query(circles), 1001.0);
+
+    GeometryCalculator moved = std::move(calculator);
+    EXPECT_TRUE(moved.indexStatus(IndexKind::Area).requested);
+    EXPECT_DOUBLE_EQ(moved.query(circles), 1001.0);
+    EXPECT_EQ(calculator.shapeCount(), 0u);
+
+    moved.dropIndex(IndexKind::Area);
+    EXPECT_FALSE(moved.indexStatus(IndexKind::Area).requested);
+    EXPECT_FALSE(moved.waitForIndex(IndexKind::Area, 1ms));
+}
+
+TEST_F(BackgroundIndexTest, BudgetCapsConcurrentBuilds) {
+    IndexBuildBudget budget(100);
+    CancellationToken token;
+    EXPECT_TRUE(budget.acquire(60, token));
+    EXPECT_TRUE(budget.acquire(40, token));
+    EXPECT_EQ(budget.inUse(), 100u);
+
+    CancellationToken cancelled;
+    cancelled.cancel();
+    EXPECT_FALSE(budget.acquire(10, cancelled));
+    budget.release(60);
+    budget.release(40);
+    EXPECT_TRUE(budget.acquire(1000, token));  // Oversized builds run alone
+    budget.release(1000);
+
+    // A budget smaller than one build serializes the builds of two calculators
+    auto tiny = std::make_shared<IndexBuildBudget>(1);
+    GeometryCalculator other;
+    fill(calculator, 4000, 4);
+    fill(other, 4000, 5);
+    calculator.setIndexBuildBudget(tiny);
+    other.setIndexBuildBudget(tiny);
+    calculator.buildIndex(IndexKind::Area);
+    other.buildIndex(IndexKind::Spatial);
+    EXPECT_TRUE(calculator.waitForIndex(IndexKind::Area, 30s));
+    EXPECT_TRUE(other.waitForIndex(IndexKind::Spatial, 30s));
+    EXPECT_EQ(tiny->inUse(), 0u);
+    EXPECT_THROW(calculator.setIndexBuildBudget(nullptr), std::invalid_argument);
+}
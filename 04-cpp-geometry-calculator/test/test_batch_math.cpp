@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include "batch_math.h"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace geometry;
+
+namespace {
+
+constexpr MathAccuracy kTiers[] = {MathAccuracy::Reference, MathAccuracy::Faithful, MathAccuracy::Fast};
+
+/**
+ * @brief Error of a double result in units of the last place of the exact value
+ */
+double ulpError(long double exact, double value) {
+    double rounded = static_cast<double>(exact);
+    double ulp = std::nextafter(std::abs(rounded), std::numeric_limits<double>::infinity()) -
+                 std::abs(rounded);
+    return static_cast<double>(std::abs(static_cast<long double>(value) - exact)) / ulp;
+}
+
+double relativeError(long double exact, double value) {
+    return static_cast<double>(std::abs((static_cast<long double>(value) - exact) / exact));
+}
+
+std::vector<double> uniform(size_t count, double lo, double hi, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    std::vector<double> values(count);
+    for (double& v : values) {
+        v = dist(rng);
+    }
+    return values;
+}
+
+} // namespace
+
+class BatchMathTest : public ::testing::Test {
+protected:
+    const size_t n = 20000;
+    std::vector<double> angle = uniform(n, -100.0, 100.0, 1);
+    std::vector<double> x = uniform(n, -10.0, 10.0, 2);
+    std::vector<double> y = uniform(n, -10.0, 10.0, 3);
+
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    bool hasExtendedReference() const {
+        return std::numeric_limits<long double>::digits > std::numeric_limits<double>::digits;
+    }
+};
+
+TEST_F(BatchMathTest, FaithfulTierWithinOneUlp) {
+    if (!hasExtendedReference()) {
+        GTEST_SKIP() << "Needs an extended-precision long double";
+    }
+    std::vector<double> s(n), c(n), t(n), h(n), r(n);
+    batchSinCos(angle.data(), s.data(), c.data(), n, MathAccuracy::Faithful);
+    batchAtan2(y.data(), x.data(), t.data(), n, MathAccuracy::Faithful);
+    batchHypot(x.data(), y.data(), h.data(), n, MathAccuracy::Faithful);
+    batchSqrt(h.data(), r.data(), n, MathAccuracy::Faithful);
+
+    for (size_t i = 0; i < n; ++i) {
+        long double a = angle[i];
+        long double lx = x[i];
+        long double ly = y[i];
+        ASSERT_LE(ulpError(std::sin(a), s[i]), 1.0) << angle[i];
+        ASSERT_LE(ulpError(std::cos(a), c[i]), 1.0) << angle[i];
+        ASSERT_LE(ulpError(std::atan2(ly, lx), t[i]), 1.0) << y[i] << ", " << x[i];
+        ASSERT_LE(ulpError(std::hypot(lx, ly), h[i]), 1.0) << x[i] << ", " << y[i];
+        ASSERT_EQ(r[i], std::sqrt(h[i]));
+    }
+}
+
+TEST_F(BatchMathTest, FaithfulSinCosOnLargeAngles) {
+    if (!hasExtendedReference()) {
+        GTEST_SKIP() << "Needs an extended-precision long double";
+    }
+    // Across the reduced range, plus doubles next to multiples of pi/2
+    // where the reduction cancels
+    std::vector<double> a = uniform(n, 1e4, 1.6e6, 4);
+    for (size_t k = 1; k < 1000000; k = k * 3 + 1) {
+        a.push_back(static_cast<double>(static_cast<long double>(k) * 1.5707963267948966192313216916397514L));
+    }
+    std::vector<double> s(a.size()), c(a.size());
+    batchSinCos(a.data(), s.data(), c.data(), a.size(), MathAccuracy::Faithful);
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        long double la = a[i];
+        ASSERT_LE(ulpError(std::sin(la), s[i]), 1.0) << a[i];
+        ASSERT_LE(ulpError(std::cos(la), c[i]), 1.0) << a[i];
+    }
+}
+
+TEST_F(BatchMathTest, FastTierWithinTolerance) {
+    if (!hasExtendedReference()) {
+        GTEST_SKIP() << "Needs an extended-precision long double";
+    }
+    std::vector<double> s(n), c(n), t(n), h(n), r(n);
+    batchSinCos(angle.data(), s.data(), c.data(), n, MathAccuracy::Fast);
+    batchAtan2(y.data(), x.data(), t.data(), n, MathAccuracy::Fast);
+    batchHypot(x.data(), y.data(), h.data(), n, MathAccuracy::Fast);
+    batchSqrt(angle.data(), r.data(), n, MathAccuracy::Fast);
+
+    for (size_t i = 0; i < n; ++i) {
+        long double a = angle[i];
+        long double lx = x[i];
+        long double ly = y[i];
+        ASSERT_LE(std::abs(std::sin(a) - s[i]), 1e-7) << angle[i];
+        ASSERT_LE(std::abs(std::cos(a) - c[i]), 1e-7) << angle[i];
+        ASSERT_LE(relativeError(std::atan2(ly, lx), t[i]), 1e-7) << y[i] << ", " << x[i];
+        ASSERT_LE(relativeError(std::hypot(lx, ly), h[i]), 1e-7) << x[i] << ", " << y[i];
+        if (angle[i] > 0) {
+            ASSERT_LE(relativeError(std::sqrt(a), r[i]), 1e-7) << angle[i];
+        }
+    }
+}
+
+TEST_F(BatchMathTest, SpecialArgumentsMatchLibrary) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> a = {0.0, -0.0, 1e300, -1e-300, 1e200, inf, -inf, nan, 5e6, 355.0, 1e20};
+    std::vector<double> b = {0.0, -1.0, 1e-300, 1e300, -1e200, 1.0, inf, 2.0, -0.0, 113.0, 1e-20};
+    size_t count = a.size();
+
+    for (MathAccuracy tier : kTiers) {
+        std::vector<double> s(count), c(count), t(count), h(count);
+        batchSinCos(a.data(), s.data(), c.data(), count, tier);
+        batchAtan2(a.data(), b.data(), t.data(), count, tier);
+        batchHypot(a.data(), b.data(), h.data(), count, tier);
+        for (size_t i = 0; i < count; ++i) {
+            bool big_angle = std::abs(a[i]) > 1e6;
+            if (std::isnan(std::sin(a[i])) || big_angle) {
+                EXPECT_EQ(std::isnan(s[i]), std::isnan(std::sin(a[i]))) << a[i];
+                if (big_angle && std::isfinite(a[i])) {
+                    EXPECT_EQ(s[i], std::sin(a[i])) << a[i];
+                    EXPECT_EQ(c[i], std::cos(a[i])) << a[i];
+                }
+            } else {
+                EXPECT_NEAR(s[i], std::sin(a[i]), 1e-7) << a[i];
+                EXPECT_NEAR(c[i], std::cos(a[i]), 1e-7) << a[i];
+            }
+            if (std::isnan(std::atan2(a[i], b[i]))) {
+                EXPECT_TRUE(std::isnan(t[i]));
+            } else {
+                EXPECT_NEAR(t[i], std::atan2(a[i], b[i]), 1e-7) << a[i] << ", " << b[i];
+                EXPECT_EQ(std::signbit(t[i]), std::signbit(std::atan2(a[i], b[i]))) << a[i] << ", " << b[i];
+            }
+            double exact = std::hypot(a[i], b[i]);
+            if (std::isnan(exact)) {
+                EXPECT_TRUE(std::isnan(h[i]));
+            } else if (std::isinf(exact) || exact == 0.0) {
+                EXPECT_EQ(h[i], exact);
+            } else {
+                EXPECT_NEAR(h[i] / exact, 1.0, 1e-7) << a[i] << ", " << b[i];
+            }
+        }
+    }
+}
+
+TEST_F(BatchMathTest, OutputsMayAliasInputs) {
+    std::vector<double> s = angle;
+    std::vector<double> c(n);
+    batchSinCos(s.data(), s.data(), c.data(), n);
+    std::vector<double> h = x;
+    batchHypot(h.data(), y.data(), h.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(s[i], std::sin(angle[i]), 1e-15);
+        EXPECT_NEAR(h[i], std::hypot(x[i], y[i]), 1e-14);
+    }
+}
+
+TEST_F(BatchMathTest, EllipsePerimeter) {
+    // Circle, 2:1 ellipses (4 a E(sqrt(3) / 2)) and nearly flat ones
+    std::vector<double> a = {3.0, 2.0, 1.0, 1.0, 1e-6};
+    std::vector<double> b = {3.0, 1.0, 0.5, 1e-9, 1.0};
+    std::vector<double> expected = {6.0 * M_PI, 9.688448220547676, 4.844224110273838, 4.0, 4.0000000000294036};
+    std::vector<double> out(a.size());
+    for (MathAccuracy tier : kTiers) {
+        batchEllipsePerimeter(a.data(), b.data(), out.data(), a.size(), tier);
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT_NEAR(out[i], expected[i], expected[i] * (tier == MathAccuracy::Fast ? 1e-7 : 1e-14)) << i;
+        }
+    }
+
+    // Every tier agrees with the reference across eccentricities
+    std::vector<double> major = uniform(n, 1.0, 2.0, 4);
+    std::vector<double> minor = uniform(n, 1e-6, 1.0, 5);
+    std::vector<double> reference(n), faithful(n), fast(n);
+    batchEllipsePerimeter(major.data(), minor.data(), reference.data(), n, MathAccuracy::Reference);
+    batchEllipsePerimeter(major.data(), minor.data(), faithful.data(), n, MathAccuracy::Faithful);
+    batchEllipsePerimeter(minor.data(), major.data(), fast.data(), n, MathAccuracy::Fast);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_NEAR(faithful[i], reference[i], 1e-14 * reference[i]);
+        ASSERT_NEAR(fast[i], reference[i], 1e-7 * reference[i]);
+    }
+
+    double bad_a = 1.0;
+    double bad_b = 0.0;
+    double result = 0.0;
+    EXPECT_THROW(batchEllipsePerimeter(&bad_a, &bad_b, &result, 1), std::invalid_argument);
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace geometry;
+
+class CalculatorBatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (GeometryCalculator* calc : {&batched, &sequential}) {
+            for (size_t i = 0; i < 3000; ++i) {
+                calc->addShape(makeShape(i), Point{static_cast<double>(i), 0.0});
+            }
+            calc->addNumericAttribute("price", 1.0);
+            calc->createView("large", ViewDefinition{QueryAggregate::TotalArea}
+                                          .where(ShapeFeature::Area, 50.0, 1e300));
+        }
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    static std::unique_ptr<Shape> makeShape(size_t i) {
+        double size = 1.0 + static_cast<double>(i % 11);
+        switch (i % 3) {
+            case 0: return std::make_unique<Circle>(size);
+            case 1: return std::make_unique<Rectangle>(size, 2.0);
+            default: return std::make_unique<Triangle>(size, size, size);
+        }
+    }
+
+    GeometryCalculator batched;
+    GeometryCalculator sequential;
+};
+
+TEST_F(CalculatorBatchTest, MatchesSequentialEdits) {
+    CalculatorBatch batch = batched.beginBatch();
+    std::vector<size_t> removed;
+    for (size_t i = 0; i < 500; ++i) {
+        size_t index = batch.addShape(makeShape(i + 7), Point{-1.0, static_cast<double>(i)});
+        EXPECT_EQ(index, 3000 + i);
+        sequential.addShape(makeShape(i + 7), Point{-1.0, static_cast<double>(i)});
+    }
+    for (size_t i = 0; i < 3500; i += 7) {
+        batch.replaceShape(i, std::make_unique<Circle>(0.5));
+        batch.replaceShape(i, std::make_unique<Circle>(2.5));  // Last one wins
+        sequential.replaceShape(i, std::make_unique<Circle>(2.5));
+        batch.setPosition(i, Point{1.0, 1.0});
+        sequential.setPosition(i, Point{1.0, 1.0});
+        batch.setAttribute(i, "price", 3.0);
+        sequential.setAttribute(i, "price", 3.0);
+    }
+    for (size_t i = 3499; i < 3500; i -= 5) {
+        batch.removeShape(i);
+        batch.removeShape(i);
+        removed.push_back(i);
+    }
+    for (size_t i : removed) {  // Descending, so earlier indices stay put
+        sequential.removeShape(i);
+    }
+
+    uint64_t version = batched.version();
+    batch.commit();
+    EXPECT_GT(batched.version(), version);
+    EXPECT_EQ(batch.editCount(), 0u);
+
+    ASSERT_EQ(batched.shapeCount(), sequential.shapeCount());
+    EXPECT_NEAR(batched.totalArea(), sequential.totalArea(), 1e-6);
+    EXPECT_NEAR(batched.views().value("large"), sequential.views().value("large"), 1e-6);
+    EXPECT_EQ(batched.statistics().recordedCount(), sequential.statistics().recordedCount());
+    for (size_t i = 0; i < batched.shapeCount(); ++i) {
+        PlacedShape a = batched.getPlacedShape(i);
+        PlacedShape b = sequential.getPlacedShape(i);
+        ASSERT_EQ(a.shape->name(), b.shape->name()) << i;
+        ASSERT_DOUBLE_EQ(a.shape->area(), b.shape->area()) << i;
+        ASSERT_DOUBLE_EQ(a.position.y, b.position.y) << i;
+        ASSERT_DOUBLE_EQ(batched.attributes().number(i, "price"),
+                         sequential.attributes().number(i, "price")) << i;
+    }
+    GroupedTotals cost = batched.weightedAggregate({AttributeWeight::of("price"), {}, {}, ""});
+    EXPECT_NEAR(cost.totals[0],
+                sequential.weightedAggregate({AttributeWeight::of("price"), {}, {}, ""}).totals[0], 1e-6);
+}
+
+TEST_F(CalculatorBatchTest, ValidatesWhenBuffering) {
+    CalculatorBatch batch = batched.beginBatch();
+    EXPECT_EQ(batch.addShape(nullptr), CalculatorBatch::npos);
+    EXPECT_THROW(batch.removeShape(3000), std::out_of_range);
+    EXPECT_THROW(batch.replaceShape(0, nullptr), std::invalid_argument);
+    EXPECT_THROW(batch.setAttribute(0, "missing", 1.0), std::invalid_argument);
+    EXPECT_THROW(batch.setAttribute(0, "price", "cheap"), std::invalid_argument);
+
+    size_t added = batch.addShape(std::make_unique<Circle>(1.0));
+    EXPECT_NO_THROW(batch.removeShape(added));
+    EXPECT_EQ(batch.editCount(), 2u);
+}
+
+TEST_F(CalculatorBatchTest, StaleBatchAppliesNothing) {
+    CalculatorBatch batch = batched.beginBatch();
+    batch.removeShape(0);
+    batch.addShape(std::make_unique<Circle>(1.0));
+    batched.addShape(std::make_unique<Circle>(1.0));
+
+    EXPECT_THROW(batch.commit(), std::logic_error);
+    EXPECT_EQ(batched.shapeCount(), 3001u);
+
+    batch.discard();
+    batch.removeShape(3000);
+    batch.commit();
+    EXPECT_EQ(batched.shapeCount(), 3000u);
+}
+
+TEST_F(CalculatorBatchTest, BatchDoesNotApplyToMovedInShapes) {
+    // Both fixture calculators went through the same mutations
+    CalculatorBatch batch = batched.beginBatch();
+    batch.removeShape(0);
+    batched = std::move(sequential);
+
+    EXPECT_THROW(batch.commit(), std::logic_error);
+    EXPECT_EQ(batched.shapeCount(), 3000u);
+}
+
+TEST_F(CalculatorBatchTest, DroppedColumnAppliesNothing) {
+    CalculatorBatch batch = batched.beginBatch();
+    batch.removeShape(0);
+    batch.setAttribute(1, "price", 2.0);
+    batched.dropAttribute("price");
+
+    uint64_t version = batched.version();
+    EXPECT_THROW(batch.commit(), std::invalid_argument);
+    EXPECT_EQ(batched.shapeCount(), 3000u);
+    EXPECT_EQ(batched.version(), version);
+}
+
+TEST_F(CalculatorBatchTest, FullDictionaryAppliesNothing) {
+    // 65536 codes: the default category and 65535 others
+    batched.addCategoricalAttribute("tag", "none");
+    for (size_t i = 1; i < 65536; ++i) {
+        batched.setAttribute(0, "tag", "tag " + std::to_string(i));
+    }
+    double area = batched.totalArea();
+
+    CalculatorBatch batch = batched.beginBatch();
+    batch.addShape(makeShape(0));
+    batch.replaceShape(1, makeShape(2));
+    batch.setAttribute(2, "tag", "tag 7");
+    batch.setAttribute(3, "tag", "one too many");
+
+    uint64_t version = batched.version();
+    EXPECT_THROW(batch.commit(), std::length_error);
+    EXPECT_EQ(batched.shapeCount(), 3000u);
+    EXPECT_EQ(batched.version(), version);
+    EXPECT_DOUBLE_EQ(batched.totalArea(), area);
+    EXPECT_EQ(batched.attributes().category(2, "tag"), "none");
+}
+
+TEST_F(CalculatorBatchTest, InvalidatesCachedResultsOnce) {
+    double before = batched.totalArea();
+    CalculatorBatch batch = batched.beginBatch();
+    for (size_t i = 0; i < 100; ++i) {
+        batch.addShape(std::make_unique<Rectangle>(1.0, 1.0));
+    }
+    EXPECT_DOUBLE_EQ(batched.totalArea(), before);  // Nothing visible before commit
+    batch.commit();
+    EXPECT_NEAR(batched.totalArea(), before + 100.0, 1e-6);
+
+    // The batch is reusable against the updated calculator
+    batch.removeShape(batched.shapeCount() - 1);
+    batch.commit();
+    EXPECT_EQ(batched.shapeCount(), 3099u);
+}
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include "content_tree.h"
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include <random>
+#include <vector>
+
+using namespace geometry;
+
+namespace {
+
+/**
+ * @brief Tree rebuilt from scratch over a calculator's shapes
+ */
+ContentTree recomputed(const GeometryCalculator& calc) {
+    ContentTree tree;
+    for (size_t i = 0; i < calc.shapeCount(); ++i) {
+        PlacedShape placed = calc.getPlacedShape(i);
+        tree.push(shapeContentHash(*placed.shape, placed.position));
+    }
+    return tree;
+}
+
+} // namespace
+
+class ContentTreeTest : public ::testing::Test {
+protected:
+    GeometryCalculator calc;
+
+    void SetUp() override {
+        // Setup code if needed
+        for (int i = 0; i < 1000; ++i) {
+            calc.addShape(std::make_unique<Circle>(1.0 + i), Point{static_cast<double>(i), 0.0});
+        }
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+TEST_F(ContentTreeTest, RootDependsOnlyOnLeaves) {
+    std::mt19937_64 rng(7);
+    ContentTree tree;
+    std::vector<uint64_t> values;
+    for (int step = 0; step < 3000; ++step) {
+        uint64_t value = rng();
+        switch (rng() % 4) {
+            case 0:
+            case 1:
+                tree.push(value);
+                values.push_back(value);
+                break;
+            case 2:
+                if (!values.empty()) {
+                    size_t index = rng() % values.size();
+                    tree.set(index, value);
+                    values[index] = value;
+                }
+                break;
+            case 3:
+                if (!values.empty()) {
+                    size_t index = rng() % values.size();
+                    tree.erase(index);
+                    values.erase(values.begin() + static_cast<ptrdiff_t>(index));
+                }
+                break;
+        }
+    }
+    tree.eraseSorted({0, 5, 6, 200});
+    for (size_t index : {200, 6, 5, 0}) {
+        values.erase(values.begin() + static_cast<ptrdiff_t>(index));
+    }
+
+    ContentTree fresh;
+    for (uint64_t value : values) {
+        fresh.push(value);
+    }
+    ASSERT_EQ(tree.size(), values.size());
+    EXPECT_EQ(tree, fresh);
+    EXPECT_TRUE(diffContent(tree, fresh).empty());
+
+    // A range hashes like a tree holding just that range, whatever its alignment
+    for (auto [begin, end] : {std::pair<size_t, size_t>{0, 0}, {3, 17}, {31, 97}, {64, 128}, {5, values.size()}}) {
+        ContentTree slice;
+        for (size_t i = begin; i < end; ++i) {
+            slice.push(values[i]);
+        }
+        EXPECT_EQ(tree.rangeHash(begin, end), slice.rootHash()) << begin << ", " << end;
+    }
+
+    ContentTree joined = fresh.select({0, 1, 2});
+    joined.append(fresh.select({3, 4}));
+    EXPECT_EQ(joined, fresh.select({0, 1, 2, 3, 4}));
+    EXPECT_NE(joined, fresh.select({0, 1, 2, 4, 3}));
+}
+
+TEST_F(ContentTreeTest, GrowthMatchesOnePassBuild) {
+    // Appends across leaf segments and new root levels hash like a tree built in one pass
+    std::mt19937_64 rng(11);
+    ContentTree grown;
+    std::vector<size_t> rows;
+    for (size_t i = 0; i < 5000; ++i) {
+        grown.push(rng());
+        rows.push_back(i);
+        if ((i & (i + 1)) == 0 || i % 997 == 0) {
+            ASSERT_EQ(grown, grown.select(rows)) << i;
+        }
+    }
+    std::vector<size_t> middle(rows.begin() + 1000, rows.begin() + 4100);
+    EXPECT_EQ(grown.rangeHash(1000, 4100), grown.select(middle).rootHash());
+
+    ContentTree changed = grown;
+    changed.set(4000, 1);
+    changed.set(17, 2);
+    ContentDiff diff = diffContent(grown, changed);
+    ASSERT_EQ(diff.modified.size(), 2u);
+    EXPECT_EQ(diff.modified[0], std::make_pair(size_t{17}, size_t{17}));
+    EXPECT_EQ(diff.modified[1], std::make_pair(size_t{4000}, size_t{4000}));
+
+    // Shrinking drops the levels it no longer needs
+    ContentTree prefix = grown.select(std::vector<size_t>(rows.begin(), rows.begin() + 40));
+    grown.eraseSorted(std::vector<size_t>(rows.begin() + 40, rows.end()));
+    EXPECT_EQ(grown, prefix);
+    grown.push(3);
+    prefix.push(3);
+    EXPECT_EQ(grown, prefix);
+    EXPECT_TRUE(diffContent(grown, prefix).empty());
+}
+
+TEST_F(ContentTreeTest, ShapeHashCoversContentAndPosition) {
+    Circle circle(2.0);
+    Rectangle square(2.0, 2.0);
+    EXPECT_EQ(shapeContentHash(circle, Point{1.0, 2.0}), shapeContentHash(Circle(2.0), Point{1.0, 2.0}));
+    EXPECT_NE(shapeContentHash(circle, Point{1.0, 2.0}), shapeContentHash(circle, Point{2.0, 1.0}));
+    EXPECT_NE(shapeContentHash(circle, Point{}), shapeContentHash(Circle(std::nextafter(2.0, 3.0)), Point{}));
+    EXPECT_NE(shapeContentHash(square, Point{}), shapeContentHash(Rectangle(2.0, 2.5), Point{}));
+
+    Path rounded = Path::roundedRectangle(2.0, 1.0, 0.25);
+    EXPECT_EQ(shapeContentHash(rounded, Point{}), shapeContentHash(Path::roundedRectangle(2.0, 1.0, 0.25), Point{}));
+    EXPECT_NE(shapeContentHash(rounded, Point{}), shapeContentHash(Path::roundedRectangle(2.0, 1.0, 0.3), Point{}));
+}
+
+TEST_F(ContentTreeTest, MutationsKeepTreeCurrent) {
+    GeometryCalculator copy;
+    for (int i = 0; i < 1000; ++i) {
+        copy.addShape(std::make_unique<Circle>(1.0 + i), Point{static_cast<double>(i), 0.0});
+    }
+    EXPECT_TRUE(calc.sameContent(copy));
+    copy.setPosition(3, Point{0.5, 0.5});
+    EXPECT_FALSE(calc.sameContent(copy));
+
+    calc.replaceShape(10, std::make_unique<Rectangle>(1.0, 2.0));
+    calc.setPosition(20, Point{-1.0, -1.0});
+    calc.removeShape(30);
+    EXPECT_EQ(calc.content(), recomputed(calc));
+
+    CalculatorBatch batch = calc.beginBatch();
+    batch.addShape(std::make_unique<Circle>(5.0), Point{1.0, 1.0});
+    batch.replaceShape(40, std::make_unique<Circle>(0.5));
+    batch.setPosition(40, Point{2.0, 2.0});
+    batch.setPosition(999, Point{3.0, 3.0});
+    batch.removeShape(50);
+    batch.removeShape(51);
+    batch.commit();
+    EXPECT_EQ(calc.content(), recomputed(calc));
+
+    calc.merge(copy);
+    EXPECT_EQ(calc.shapeCount(), 1998u);
+    EXPECT_EQ(calc.content(), recomputed(calc));
+    EXPECT_EQ(copy.content().size(), 0u);
+
+    auto parts = calc.partition(2, [](const Shape& shape) { return shape.area() > 1000.0 ? 1u : 0u; });
+    for (const auto& part : parts) {
+        EXPECT_EQ(part.content(), recomputed(part));
+    }
+    EXPECT_EQ(calc.content().size(), 0u);
+
+    GeometryCalculator moved = std::move(parts[1]);
+    EXPECT_EQ(moved.content(), recomputed(moved));
+    moved.clear();
+    EXPECT_TRUE(moved.sameContent(calc));
+}
+
+TEST_F(ContentTreeTest, DiffReportsChangedShapes) {
+    ContentTree snapshot = calc.content();
+
+    // Same count: replaced and moved shapes are modifications in place
+    calc.replaceShape(100, std::make_unique<Circle>(0.25));
+    calc.setPosition(700, Point{9.0, 9.0});
+    ContentDiff diff = diffContent(snapshot, calc.content());
+    EXPECT_TRUE(diff.removed.empty());
+    EXPECT_TRUE(diff.added.empty());
+    ASSERT_EQ(diff.modified.size(), 2u);
+    EXPECT_EQ(diff.modified[0], std::make_pair(size_t{100}, size_t{100}));
+    EXPECT_EQ(diff.modified[1], std::make_pair(size_t{700}, size_t{700}));
+
+    // Same count after a removal and an addition: only those are reported
+    snapshot = calc.content();
+    calc.removeShape(0);
+    calc.addShape(std::make_unique<Circle>(5.0), Point{3.0, 3.0});
+    diff = diffContent(snapshot, calc.content());
+    EXPECT_EQ(diff.removed, (std::vector<size_t>{0}));
+    EXPECT_EQ(diff.added, (std::vector<size_t>{999}));
+    EXPECT_TRUE(diff.modified.empty());
+
+    // Past the edit bound, equal sizes are compared by position
+    snapshot = calc.content();
+    for (size_t i = 0; i < 900; i += 3) {
+        calc.replaceShape(i, std::make_unique<Circle>(0.5));
+    }
+    diff = diffContent(snapshot, calc.content());
+    EXPECT_TRUE(diff.removed.empty());
+    EXPECT_TRUE(diff.added.empty());
+    ASSERT_EQ(diff.modified.size(), 300u);
+    EXPECT_EQ(diff.modified[299], std::make_pair(size_t{897}, size_t{897}));
+
+    // Removals shift later shapes, which the edit script recognizes as unchanged
+    snapshot = calc.content();
+    calc.removeShape(500);
+    calc.removeShape(10);
+    calc.addShape(std::make_unique<Circle>(3.0), Point{1.0, 2.0});
+    calc.replaceShape(0, std::make_unique<Circle>(7.0));
+    diff = diffContent(snapshot, calc.content());
+    EXPECT_EQ(diff.removed, (std::vector<size_t>{10, 500}));
+    EXPECT_EQ(diff.added, (std::vector<size_t>{998}));
+    ASSERT_EQ(diff.modified.size(), 1u);
+    EXPECT_EQ(diff.modified[0], std::make_pair(size_t{0}, size_t{0}));
+
+    // A replica brought up to date reports no differences
+    GeometryCalculator replica;
+    EXPECT_EQ(replica.diff(calc).added.size(), calc.shapeCount());
+    for (size_t i = 0; i < calc.shapeCount(); ++i) {
+        PlacedShape placed = calc.getPlacedShape(i);
+        replica.addShape(std::make_unique<Circle>(static_cast<const Circle&>(*placed.shape)), placed.position);
+    }
+    EXPECT_TRUE(replica.diff(calc).empty());
+    EXPECT_TRUE(replica.sameContent(calc));
+}
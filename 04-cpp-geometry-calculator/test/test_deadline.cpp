@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace geometry;
+
+class DeadlineTest : public ::testing::Test {
+protected:
+    GeometryCalculator calculator;
+
+    void SetUp() override {
+        // Sizes grow with the index, so a prefix in insertion order would
+        // badly underestimate the total
+        for (int i = 0; i < 10000; ++i) {
+            double size = 1.0 + i * 0.001;
+            calculator.addShape(std::make_unique<Rectangle>(size, 2.0), {i * 10.0, 0.0});
+        }
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+TEST_F(DeadlineTest, SpreadOrderVisitsEveryIndexOnce) {
+    for (size_t count : {1u, 2u, 3u, 10u, 97u, 1000u}) {
+        size_t stride = spreadStride(count);
+        std::vector<int> seen(count, 0);
+        for (size_t k = 0; k < count; ++k) {
+            ++seen[spreadIndex(k, stride, count)];
+        }
+        for (int hits : seen) {
+            EXPECT_EQ(hits, 1);
+        }
+    }
+}
+
+TEST_F(DeadlineTest, ExpiryAndCancellation) {
+    EXPECT_FALSE(Deadline().expired());
+    EXPECT_TRUE(Deadline::after(std::chrono::nanoseconds(0)).expired());
+    EXPECT_FALSE(Deadline::after(std::chrono::hours(1)).expired());
+
+    CancellationToken token;
+    Deadline deadline(token);
+    CancellationToken copy = token;
+    copy.cancel();
+    EXPECT_TRUE(token.cancelled());
+    EXPECT_TRUE(deadline.expired());
+}
+
+TEST_F(DeadlineTest, ExactWithoutDeadline) {
+    PartialResult area = calculator.totalArea(Deadline());
+    EXPECT_TRUE(area.exact());
+    EXPECT_DOUBLE_EQ(area.coverage(), 1.0);
+    EXPECT_NEAR(area.value, calculator.totalArea(), 1e-9);
+    EXPECT_EQ(area.estimate, area.value);
+
+    PartialResult perimeter = calculator.totalPerimeter(Deadline::after(std::chrono::hours(1)));
+    EXPECT_TRUE(perimeter.exact());
+    EXPECT_NEAR(perimeter.value, calculator.totalPerimeter(), 1e-9);
+}
+
+TEST_F(DeadlineTest, PartialResultExtrapolatesAndResumes) {
+    CancellationToken token;
+    token.cancel();
+    PartialResult partial = calculator.totalArea(Deadline(token));
+
+    ASSERT_FALSE(partial.exact());
+    EXPECT_GT(partial.processed, 0u);
+    EXPECT_LT(partial.coverage(), 0.1);
+    EXPECT_NEAR(partial.estimate, calculator.totalArea(), 0.01 * calculator.totalArea());
+
+    PartialResult resumed = calculator.totalArea(Deadline(), &partial);
+    EXPECT_TRUE(resumed.exact());
+    EXPECT_NEAR(resumed.value, calculator.totalArea(), 1e-9);
+
+    // A perimeter sum does not continue an area sum
+    PartialResult perimeter = calculator.totalPerimeter(Deadline(), &partial);
+    EXPECT_NEAR(perimeter.value, calculator.totalPerimeter(), 1e-9);
+
+    // A result from before a change is ignored, even if the count is unchanged
+    calculator.replaceShape(0, std::make_unique<Circle>(50.0));
+    PartialResult replaced = calculator.totalArea(Deadline(), &partial);
+    EXPECT_NEAR(replaced.value, calculator.totalArea(), 1e-9);
+    calculator.addShape(std::make_unique<Circle>(1.0));
+    PartialResult restarted = calculator.totalArea(Deadline(), &partial);
+    EXPECT_NEAR(restarted.value, calculator.totalArea(), 1e-9);
+}
+
+TEST_F(DeadlineTest, ResumeIgnoresMovedInShapes) {
+    // Same shape count and mutation count as the fixture's calculator
+    GeometryCalculator other;
+    for (int i = 0; i < 10000; ++i) {
+        other.addShape(std::make_unique<Circle>(2.0), {i * 10.0, 0.0});
+    }
+    CancellationToken token;
+    token.cancel();
+    PartialResult partial = calculator.totalArea(Deadline(token));
+    ASSERT_FALSE(partial.exact());
+
+    calculator = std::move(other);
+    PartialResult resumed = calculator.totalArea(Deadline(), &partial);
+    EXPECT_NEAR(resumed.value, 10000 * 4.0 * M_PI, 1e-6);
+}
+
+TEST_F(DeadlineTest, UnionPerimeterWithinDeadline) {
+    PartialResult exact = calculator.unionPerimeter(Deadline());
+    EXPECT_TRUE(exact.exact());
+    EXPECT_DOUBLE_EQ(exact.value, calculator.unionPerimeter());
+
+    CancellationToken token;
+    token.cancel();
+    PartialResult cancelled = calculator.unionPerimeter(Deadline(token));
+    EXPECT_FALSE(cancelled.exact());
+    EXPECT_EQ(cancelled.processed, 0u);
+    EXPECT_EQ(cancelled.total, calculator.shapeCount());
+}
@@ -116,3 +116,84 @@ TEST_F(GeometryCalculatorTest, GetShapesInfo) {
     EXPECT_NE(info.find("Rectangle"), std::string::npos);
     EXPECT_NE(info.find("Total shapes: 2"), std::string::npos);
 }
+
+TEST_F(GeometryCalculatorTest, ReportPagesMatchFullReport) {
+    for (int i = 1; i <= 2500; ++i) {
+        if (i % 2 == 0) {
+            calculator->addShape(std::make_unique<Circle>(i * 0.01));
+        } else {
+            calculator->addShape(std::make_unique<Rectangle>(i * 0.01, 2.0));
+        }
+    }
+    
+    std::string pages;
+    size_t cursor = 0;
+    size_t page_count = 0;
+    for (bool more = true; more; ++page_count) {
+        ReportPage page = calculator->reportPage(cursor, 50);
+        EXPECT_LE(page.count, 50u);
+        pages += page.text;
+        cursor = page.next;
+        more = page.has_more;
+    }
+    EXPECT_EQ(page_count, 50u);
+    
+    std::string info = calculator->getShapesInfo();
+    EXPECT_NE(info.find(pages + calculator->reportFooter()), std::string::npos);
+    
+    ReportPage last = calculator->reportPage(2499, 50);
+    EXPECT_EQ(last.count, 1u);
+    EXPECT_EQ(last.text.rfind("Shape 2500: Circle", 0), 0u);
+    EXPECT_FALSE(last.has_more);
+    EXPECT_EQ(calculator->reportPage(5000, 50).count, 0u);
+}
+
+TEST_F(GeometryCalculatorTest, FilteredReportPages) {
+    for (int i = 1; i <= 100; ++i) {
+        calculator->addShape(std::make_unique<Circle>(1.0));
+        calculator->addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0));
+    }
+    
+    ShapeQuery triangles;
+    triangles.kinds = kindMask(ShapeKind::Triangle);
+    ReportPage page = calculator->reportPage(0, 10, triangles);
+    EXPECT_EQ(page.count, 10u);
+    EXPECT_EQ(page.next, 20u);
+    EXPECT_EQ(page.text.find("Circle"), std::string::npos);
+    EXPECT_EQ(page.text.rfind("Shape 2: ", 0), 0u);
+    
+    ShapeQuery large;
+    large.min_area = 100.0;
+    page = calculator->reportPage(0, 10, large);
+    EXPECT_EQ(page.count, 0u);
+    EXPECT_FALSE(page.has_more);
+    
+    EXPECT_NE(calculator->reportFooter().find("Total Area: 914.16"), std::string::npos);
+}
+
+TEST_F(GeometryCalculatorTest, UsableAfterMove) {
+    ViewDefinition circles;
+    circles.kinds = kindMask(ShapeKind::Circle);
+    calculator->createView("circles", circles);
+    calculator->addShape(std::make_unique<Circle>(1.0));
+    calculator->addShape(std::make_unique<Rectangle>(2.0, 3.0));
+
+    GeometryCalculator moved(std::move(*calculator));
+    EXPECT_EQ(moved.shapeCount(), 2u);
+    EXPECT_DOUBLE_EQ(moved.views().value("circles"), 1.0);
+
+    // The moved-from calculator is empty and accepts new shapes
+    EXPECT_EQ(calculator->shapeCount(), 0u);
+    EXPECT_TRUE(calculator->views().empty());
+    EXPECT_EQ(calculator->statistics().distinctCount(), 0.0);
+    calculator->addShape(std::make_unique<Circle>(2.0));
+    calculator->addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0));
+    calculator->removeShape(0);
+    EXPECT_EQ(calculator->shapeCount(), 1u);
+    EXPECT_DOUBLE_EQ(calculator->totalArea(), 6.0);
+
+    *calculator = std::move(moved);
+    moved.addShape(std::make_unique<Circle>(1.0));
+    EXPECT_EQ(moved.shapeCount(), 1u);
+    EXPECT_EQ(calculator->shapeCount(), 2u);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+using namespace geometry;
+
+class MaterializedViewsTest : public ::testing::Test {
+protected:
+    GeometryCalculator calculator;
+
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    static ViewDefinition trianglesAreaWithPerimeterAbove10() {
+        ViewDefinition view;
+        view.aggregate = QueryAggregate::TotalArea;
+        view.kinds = kindMask(ShapeKind::Triangle);
+        view.where(ShapeFeature::Perimeter, std::nextafter(10.0, INFINITY), INFINITY);
+        return view;
+    }
+
+    static ViewDefinition circlesWithRadius1To2() {
+        ViewDefinition view;
+        view.kinds = kindMask(ShapeKind::Circle);
+        view.where(ShapeFeature::MinDimension, 1.0, 2.0);
+        return view;
+    }
+};
+
+TEST_F(MaterializedViewsTest, FeaturesOfEachKind) {
+    auto circle = shapeFeatures(Circle(2.0));
+    EXPECT_EQ(circle.kind, ShapeKind::Circle);
+    EXPECT_DOUBLE_EQ(circle.values[2], 2.0);
+    EXPECT_DOUBLE_EQ(circle.values[3], 2.0);
+
+    auto triangle = shapeFeatures(Triangle(3.0, 4.0, 5.0));
+    EXPECT_DOUBLE_EQ(triangle.values[0], 6.0);
+    EXPECT_DOUBLE_EQ(triangle.values[1], 12.0);
+    EXPECT_DOUBLE_EQ(triangle.values[2], 3.0);
+    EXPECT_DOUBLE_EQ(triangle.values[3], 5.0);
+
+    auto path = shapeFeatures(Path::roundedRectangle(4.0, 2.0, 0.5));
+    EXPECT_NEAR(path.values[2], 2.0, 1e-12);
+    EXPECT_NEAR(path.values[3], 4.0, 1e-12);
+}
+
+TEST_F(MaterializedViewsTest, ViewsFollowMutations) {
+    calculator.createView("big triangles", trianglesAreaWithPerimeterAbove10());
+    size_t circles = calculator.createView("mid circles", circlesWithRadius1To2());
+
+    calculator.addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0));   // perimeter 12
+    calculator.addShape(std::make_unique<Triangle>(2.0, 3.0, 4.0));   // perimeter 9
+    calculator.addShape(std::make_unique<Circle>(1.5));
+    calculator.addShape(std::make_unique<Circle>(3.0));
+    calculator.addShape(std::make_unique<Rectangle>(1.5, 1.5));
+
+    EXPECT_DOUBLE_EQ(calculator.views().value("big triangles"), 6.0);
+    EXPECT_DOUBLE_EQ(calculator.views().value(circles), 1.0);
+
+    calculator.replaceShape(3, std::make_unique<Circle>(2.0));
+    EXPECT_DOUBLE_EQ(calculator.views().value(circles), 2.0);
+
+    calculator.removeShape(0);
+    EXPECT_DOUBLE_EQ(calculator.views().value("big triangles"), 0.0);
+
+    calculator.clear();
+    EXPECT_DOUBLE_EQ(calculator.views().value(circles), 0.0);
+    EXPECT_EQ(calculator.views().size(), 2u);
+}
+
+TEST_F(MaterializedViewsTest, ViewCreatedAfterShapesIsPopulated) {
+    calculator.addShape(std::make_unique<Circle>(1.0));
+    calculator.addShape(std::make_unique<Circle>(5.0));
+    calculator.addShape(std::make_unique<Rectangle>(2.0, 3.0));
+
+    ViewDefinition all_perimeter;
+    all_perimeter.aggregate = QueryAggregate::TotalPerimeter;
+    calculator.createView("perimeter", all_perimeter);
+    calculator.createView("mid circles", circlesWithRadius1To2());
+
+    EXPECT_DOUBLE_EQ(calculator.views().value("perimeter"), calculator.totalPerimeter());
+    EXPECT_DOUBLE_EQ(calculator.views().value("mid circles"), 1.0);
+}
+
+TEST_F(MaterializedViewsTest, ManyViewsMatchQueries) {
+    // 100 views over area bands, checked against full recomputation
+    std::vector<ShapeQuery> queries;
+    for (int i = 0; i < 100; ++i) {
+        ViewDefinition view;
+        view.aggregate = i % 2 == 0 ? QueryAggregate::TotalArea : QueryAggregate::Count;
+        view.kinds = i % 3 == 0 ? kindMask(ShapeKind::Rectangle) : kAllShapeKinds;
+        view.where(ShapeFeature::Area, i * 0.5, i * 0.5 + 20.0);
+        calculator.createView("band " + std::to_string(i), view);
+
+        ShapeQuery query;
+        query.aggregate = view.aggregate;
+        query.kinds = view.kinds;
+        query.min_area = i * 0.5;
+        query.max_area = i * 0.5 + 20.0;
+        queries.push_back(query);
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> size(0.5, 8.0);
+    for (int step = 0; step < 2000; ++step) {
+        int action = static_cast<int>(rng() % 4);
+        if (action == 0 && calculator.shapeCount() > 0) {
+            calculator.removeShape(rng() % calculator.shapeCount());
+        } else if (action == 1 && calculator.shapeCount() > 0) {
+            calculator.replaceShape(rng() % calculator.shapeCount(),
+                                    std::make_unique<Circle>(size(rng) / 2.0));
+        } else {
+            calculator.addShape(std::make_unique<Rectangle>(size(rng), size(rng)));
+        }
+    }
+
+    for (size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_NEAR(calculator.views().value(i), calculator.query(queries[i]), 1e-9) << i;
+    }
+}
+
+TEST_F(MaterializedViewsTest, InvalidViews) {
+    calculator.createView("a", ViewDefinition{});
+    EXPECT_THROW(calculator.createView("a", ViewDefinition{}), std::invalid_argument);
+    EXPECT_THROW(calculator.createView("", ViewDefinition{}), std::invalid_argument);
+
+    ViewDefinition union_view;
+    union_view.aggregate = QueryAggregate::UnionPerimeter;
+    EXPECT_THROW(calculator.createView("union", union_view), std::invalid_argument);
+
+    ViewDefinition nan_view;
+    nan_view.where(ShapeFeature::Area, std::nan(""), 1.0);
+    EXPECT_THROW(calculator.createView("nan", nan_view), std::invalid_argument);
+
+    size_t id = calculator.views().id("a");
+    EXPECT_TRUE(calculator.dropView("a"));
+    EXPECT_FALSE(calculator.dropView("a"));
+    EXPECT_THROW(calculator.views().value(id), std::out_of_range);
+    EXPECT_THROW(calculator.views().value("a"), std::invalid_argument);
+    EXPECT_TRUE(calculator.views().empty());
+}
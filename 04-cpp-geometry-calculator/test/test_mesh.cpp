@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "mesh.h"
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+using namespace geometry;
+
+class MeshTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Unit cube: 8 vertices, 12 outward-facing triangles
+        for (int i = 0; i < 8; ++i) {
+            cube.addVertex(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+        }
+        const uint32_t faces[12][3] = {
+            {0, 2, 1}, {1, 2, 3}, {4, 5, 6}, {5, 7, 6}, {0, 1, 4}, {1, 5, 4},
+            {2, 6, 3}, {3, 6, 7}, {0, 4, 2}, {2, 4, 6}, {1, 3, 5}, {3, 7, 5},
+        };
+        for (const auto& f : faces) {
+            cube.addFace(f[0], f[1], f[2]);
+        }
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    static std::string toBinaryStl(const TriangleMesh& mesh) {
+        std::string data(80, '\0');
+        uint32_t count = static_cast<uint32_t>(mesh.faceCount());
+        data.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (size_t f = 0; f < mesh.faceCount(); ++f) {
+            float record[12] = {};
+            for (size_t k = 0; k < 3; ++k) {
+                uint32_t v = mesh.indices[3 * f + k];
+                record[3 + 3 * k] = static_cast<float>(mesh.x[v]);
+                record[4 + 3 * k] = static_cast<float>(mesh.y[v]);
+                record[5 + 3 * k] = static_cast<float>(mesh.z[v]);
+            }
+            data.append(reinterpret_cast<const char*>(record), sizeof(record));
+            data.append(2, '\0');
+        }
+        return data;
+    }
+
+    TriangleMesh cube;
+};
+
+TEST_F(MeshTest, EmptyMesh) {
+    TriangleMesh mesh;
+    EXPECT_DOUBLE_EQ(meshSurfaceArea(mesh), 0.0);
+
+    MeshStats stats = computeMeshStats(mesh);
+    EXPECT_DOUBLE_EQ(stats.total_area, 0.0);
+    EXPECT_DOUBLE_EQ(stats.total_perimeter, 0.0);
+}
+
+TEST_F(MeshTest, ClosedCube) {
+    EXPECT_NEAR(meshSurfaceArea(cube), 6.0, 1e-12);
+
+    MeshStats stats = computeMeshStats(cube);
+    EXPECT_NEAR(stats.total_area, 6.0, 1e-12);
+    EXPECT_DOUBLE_EQ(stats.total_perimeter, 0.0);
+}
+
+TEST_F(MeshTest, RegionAreaAndPerimeter) {
+    // Unit square made of two triangles in different regions
+    TriangleMesh square;
+    square.addVertex(0, 0, 0);
+    square.addVertex(1, 0, 0);
+    square.addVertex(1, 1, 0);
+    square.addVertex(0, 1, 0);
+    square.addFace(0, 1, 2);
+    square.addFace(0, 2, 3);
+    square.regions = {0, 1};
+
+    MeshStats stats = computeMeshStats(square);
+    EXPECT_NEAR(stats.total_area, 1.0, 1e-12);
+    EXPECT_NEAR(stats.total_perimeter, 4.0, 1e-12);
+    ASSERT_EQ(stats.region_area.size(), 2u);
+    EXPECT_NEAR(stats.region_area[0], 0.5, 1e-12);
+    EXPECT_NEAR(stats.region_perimeter[1], 2.0 + std::sqrt(2.0), 1e-12);
+}
+
+TEST_F(MeshTest, LargeMeshMatchesClosedForm) {
+    // n x n grid of unit squares, two triangles each
+    const uint32_t n = 200;
+    TriangleMesh grid;
+    for (uint32_t j = 0; j <= n; ++j) {
+        for (uint32_t i = 0; i <= n; ++i) {
+            grid.addVertex(i, j, 0.0);
+        }
+    }
+    for (uint32_t j = 0; j < n; ++j) {
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t v = j * (n + 1) + i;
+            grid.addFace(v, v + 1, v + n + 2);
+            grid.addFace(v, v + n + 2, v + n + 1);
+        }
+    }
+
+    MeshStats stats = computeMeshStats(grid);
+    EXPECT_NEAR(stats.total_area, n * n, 1e-9);
+    EXPECT_NEAR(stats.total_perimeter, 4.0 * n, 1e-9);
+}
+
+TEST_F(MeshTest, InvalidMesh) {
+    TriangleMesh mesh;
+    mesh.addVertex(0, 0, 0);
+    mesh.addFace(0, 1, 2);
+    EXPECT_THROW(meshSurfaceArea(mesh), std::invalid_argument);
+
+    cube.regions = {0};
+    EXPECT_THROW(computeMeshStats(cube), std::invalid_argument);
+}
+
+TEST_F(MeshTest, BinaryStlRoundTrip) {
+    std::string data = toBinaryStl(cube);
+
+    std::istringstream area_stream(data);
+    EXPECT_NEAR(binaryStlSurfaceArea(area_stream), 6.0, 1e-12);
+
+    std::istringstream mesh_stream(data);
+    TriangleMesh mesh = readBinaryStl(mesh_stream);
+    EXPECT_EQ(mesh.vertexCount(), 8u); // Vertices are welded
+    EXPECT_EQ(mesh.faceCount(), 12u);
+    EXPECT_DOUBLE_EQ(computeMeshStats(mesh).total_perimeter, 0.0);
+}
+
+TEST_F(MeshTest, TruncatedStl) {
+    std::string data = toBinaryStl(cube);
+    data.resize(data.size() - 10);
+
+    std::istringstream in(data);
+    EXPECT_THROW(binaryStlSurfaceArea(in), std::runtime_error);
+}
+
+TEST_F(MeshTest, ObjWithGroups) {
+    std::istringstream in(
+        "# unit square and a triangle\n"
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 1 1 0\n"
+        "v 0 1 0\n"
+        "g square\n"
+        "f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+        "g triangle\n"
+        "v 0 0 1\n"
+        "v 2 0 1\n"
+        "v 0 2 1\n"
+        "f -3 -2 -1\n");
+
+    TriangleMesh mesh = readObj(in);
+    ASSERT_EQ(mesh.faceCount(), 3u);
+    ASSERT_EQ(mesh.region_names.size(), 2u);
+    EXPECT_EQ(mesh.region_names[1], "triangle");
+
+    MeshStats stats = computeMeshStats(mesh);
+    EXPECT_NEAR(stats.region_area[0], 1.0, 1e-12);
+    EXPECT_NEAR(stats.region_area[1], 2.0, 1e-12);
+    EXPECT_NEAR(stats.region_perimeter[0], 4.0, 1e-12);
+    EXPECT_NEAR(stats.total_area, 3.0, 1e-12);
+}
+
+TEST_F(MeshTest, MalformedObj) {
+    std::istringstream in("v 0 0 0\nf 1 2\n");
+    EXPECT_THROW(readObj(in), std::runtime_error);
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "oriented_boxes.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cmath>
+#include <random>
+
+using namespace geometry;
+
+class OrientedBoxesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    static bool encloses(const OrientedBox& box, const Point& p, double eps = 1e-9) {
+        double dx = p.x - box.center.x;
+        double dy = p.y - box.center.y;
+        double u = dx * std::cos(box.angle) + dy * std::sin(box.angle);
+        double v = -dx * std::sin(box.angle) + dy * std::cos(box.angle);
+        return std::abs(u) <= box.width / 2.0 + eps && std::abs(v) <= box.height / 2.0 + eps;
+    }
+};
+
+TEST_F(OrientedBoxesTest, ConvexHullDropsInteriorAndCollinearPoints) {
+    std::vector<Point> hull = convexHull({{0, 0}, {1, 0}, {2, 0}, {2, 2}, {1, 1}, {0, 2}, {0, 1}});
+
+    ASSERT_EQ(hull.size(), 4u);
+    EXPECT_DOUBLE_EQ(hull[0].x, 0.0);
+    EXPECT_DOUBLE_EQ(hull[0].y, 0.0);
+    EXPECT_DOUBLE_EQ(hull[1].x, 2.0);
+    EXPECT_DOUBLE_EQ(hull[1].y, 0.0);
+}
+
+TEST_F(OrientedBoxesTest, RotatedSquareIsRecovered) {
+    double angle = M_PI / 6.0;
+    std::vector<Point> points;
+    for (int i = 0; i < 4; ++i) {
+        double a = angle + M_PI / 4.0 + i * M_PI / 2.0;
+        points.push_back({5.0 + std::sqrt(2.0) * std::cos(a), -3.0 + std::sqrt(2.0) * std::sin(a)});
+    }
+    OrientedBox box = minimumBoundingBox(points);
+
+    EXPECT_NEAR(box.area(), 4.0, 1e-9);
+    EXPECT_NEAR(box.angle, angle, 1e-9);
+    EXPECT_NEAR(box.center.x, 5.0, 1e-9);
+    EXPECT_NEAR(box.center.y, -3.0, 1e-9);
+}
+
+TEST_F(OrientedBoxesTest, DegeneratePointSets) {
+    OrientedBox point = minimumBoundingBox({{1.0, 2.0}, {1.0, 2.0}});
+    EXPECT_DOUBLE_EQ(point.area(), 0.0);
+    EXPECT_DOUBLE_EQ(point.center.x, 1.0);
+
+    OrientedBox segment = minimumBoundingBox({{0.0, 0.0}, {3.0, 4.0}, {1.5, 2.0}});
+    EXPECT_NEAR(segment.width + segment.height, 5.0, 1e-12);
+    EXPECT_NEAR(segment.area(), 0.0, 1e-12);
+
+    EXPECT_THROW(minimumBoundingBox(std::vector<Point>{}), std::invalid_argument);
+}
+
+TEST_F(OrientedBoxesTest, TriangleCriteriaDiffer) {
+    Triangle triangle(3.0, 4.0, 5.0);
+    PlacedShape placed{&triangle, {0.0, 0.0}};
+
+    OrientedBox by_area = minimumBoundingBox(placed, BoxCriterion::MinArea);
+    EXPECT_NEAR(by_area.area(), 12.0, 1e-9);
+
+    // Flush with the hypotenuse: 5 x 2.4 has perimeter 14.8, the legs give 14
+    OrientedBox by_perimeter = minimumBoundingBox(placed, BoxCriterion::MinPerimeter);
+    EXPECT_NEAR(by_perimeter.perimeter(), 14.0, 1e-9);
+
+    for (const Point& p : placedVertices(placed)) {
+        EXPECT_TRUE(encloses(by_area, p));
+        EXPECT_TRUE(encloses(by_perimeter, p));
+    }
+}
+
+TEST_F(OrientedBoxesTest, ClosedFormsForCircleAndRectangle) {
+    Circle circle(2.0);
+    OrientedBox disc = minimumBoundingBox({&circle, {1.0, 1.0}});
+    EXPECT_DOUBLE_EQ(disc.width, 4.0);
+    EXPECT_DOUBLE_EQ(disc.height, 4.0);
+    EXPECT_DOUBLE_EQ(disc.center.x, 1.0);
+
+    Rectangle rect(6.0, 2.0);
+    OrientedBox box = minimumBoundingBox({&rect, {1.0, 1.0}});
+    EXPECT_DOUBLE_EQ(box.area(), 12.0);
+    EXPECT_DOUBLE_EQ(box.center.x, 4.0);
+    EXPECT_DOUBLE_EQ(box.center.y, 2.0);
+    EXPECT_DOUBLE_EQ(box.angle, 0.0);
+}
+
+TEST_F(OrientedBoxesTest, MatchesAngleSweep) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-10.0, 10.0);
+    std::vector<Point> points;
+    for (int i = 0; i < 200; ++i) {
+        points.push_back({coord(rng), coord(rng) * 0.3});
+    }
+    OrientedBox box = minimumBoundingBox(points);
+    for (const Point& p : points) {
+        EXPECT_TRUE(encloses(box, p));
+    }
+
+    double best = std::numeric_limits<double>::infinity();
+    for (int step = 0; step < 20000; ++step) {
+        double a = step * (M_PI / 2.0) / 20000.0;
+        double c = std::cos(a);
+        double s = std::sin(a);
+        double min_u = 1e300, max_u = -1e300, min_v = 1e300, max_v = -1e300;
+        for (const Point& p : points) {
+            double u = p.x * c + p.y * s;
+            double v = -p.x * s + p.y * c;
+            min_u = std::min(min_u, u);
+            max_u = std::max(max_u, u);
+            min_v = std::min(min_v, v);
+            max_v = std::max(max_v, v);
+        }
+        best = std::min(best, (max_u - min_u) * (max_v - min_v));
+    }
+    EXPECT_LE(box.area(), best + 1e-9);
+    EXPECT_NEAR(box.area(), best, best * 1e-3);
+}
+
+TEST_F(OrientedBoxesTest, PathBoxEnclosesCurves) {
+    Path path = Path::roundedRectangle(4.0, 2.0, 0.5);
+    OrientedBox box = minimumBoundingBox({&path, {0.0, 0.0}}, BoxCriterion::MinArea, 1e-3);
+
+    EXPECT_GE(box.width * box.height, 8.0 - 1e-9);
+    EXPECT_NEAR(box.area(), 8.0, 0.02);
+}
+
+TEST_F(OrientedBoxesTest, ColumnsMatchPerShapeBoxes) {
+    Circle circle(1.0);
+    Rectangle rect(2.0, 3.0);
+    Triangle triangle(3.0, 4.0, 5.0);
+    std::vector<PlacedShape> shapes;
+    for (int i = 0; i < 300; ++i) {
+        const Shape* shape = i % 3 == 0 ? static_cast<const Shape*>(&circle)
+                           : i % 3 == 1 ? static_cast<const Shape*>(&rect)
+                                        : static_cast<const Shape*>(&triangle);
+        shapes.push_back({shape, {static_cast<double>(i), 0.0}});
+    }
+    OrientedBoxColumns columns = orientedBoxes(shapes, BoxCriterion::MinPerimeter);
+
+    ASSERT_EQ(columns.size(), shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        OrientedBox expected = minimumBoundingBox(shapes[i], BoxCriterion::MinPerimeter);
+        OrientedBox actual = columns.box(i);
+        EXPECT_DOUBLE_EQ(actual.center.x, expected.center.x);
+        EXPECT_DOUBLE_EQ(actual.width, expected.width);
+        EXPECT_DOUBLE_EQ(actual.height, expected.height);
+        EXPECT_DOUBLE_EQ(actual.angle, expected.angle);
+    }
+}
+
+TEST_F(OrientedBoxesTest, GroupBoxes) {
+    Circle circle(1.0);
+    Rectangle rect(1.0, 1.0);
+    std::vector<PlacedShape> shapes = {
+        {&circle, {0.0, 0.0}}, {&rect, {5.0, 5.0}}, {&circle, {10.0, 0.0}}};
+    OrientedBoxColumns columns = groupOrientedBoxes(shapes, {0, 1, 0}, 3, BoxCriterion::MinArea, 1e-4);
+
+    ASSERT_EQ(columns.size(), 3u);
+    OrientedBox pair = columns.box(0);
+    EXPECT_NEAR(std::max(pair.width, pair.height), 12.0, 1e-3);
+    EXPECT_NEAR(std::min(pair.width, pair.height), 2.0, 1e-3);
+    EXPECT_GE(pair.area(), 24.0 - 1e-9);
+    EXPECT_NEAR(pair.center.x, 5.0, 1e-3);
+
+    EXPECT_DOUBLE_EQ(columns.box(1).area(), 1.0);
+    EXPECT_DOUBLE_EQ(columns.box(2).area(), 0.0);
+
+    EXPECT_THROW(groupOrientedBoxes(shapes, {0, 1}, 3), std::invalid_argument);
+    EXPECT_THROW(groupOrientedBoxes(shapes, {0, 1, 3}, 3), std::out_of_range);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace geometry;
+
+class PathTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    // Brute-force polyline length of a cubic Bezier
+    static double polylineLength(const PathSegment& s, int steps) {
+        auto point = [&](double t) {
+            double u = 1.0 - t;
+            const auto& p = s.points;
+            return Point{u * u * u * p[0].x + 3 * t * u * u * p[1].x + 3 * t * t * u * p[2].x +
+                             t * t * t * p[3].x,
+                         u * u * u * p[0].y + 3 * t * u * u * p[1].y + 3 * t * t * u * p[2].y +
+                             t * t * t * p[3].y};
+        };
+        double length = 0.0;
+        Point prev = point(0.0);
+        for (int i = 1; i <= steps; ++i) {
+            Point next = point(static_cast<double>(i) / steps);
+            length += std::hypot(next.x - prev.x, next.y - prev.y);
+            prev = next;
+        }
+        return length;
+    }
+};
+
+TEST_F(PathTest, PolygonFromLines) {
+    Path path({
+        PathSegment::line({0.0, 0.0}, {3.0, 0.0}),
+        PathSegment::line({3.0, 0.0}, {3.0, 4.0}),
+        PathSegment::line({3.0, 4.0}, {0.0, 0.0}),
+    });
+
+    EXPECT_NEAR(path.area(), 6.0, 1e-12);
+    EXPECT_NEAR(path.perimeter(), 12.0, 1e-12);
+    EXPECT_EQ(path.name(), "Path");
+    EXPECT_EQ(path.kind(), ShapeKind::Path);
+    EXPECT_TRUE(path.isValid());
+}
+
+TEST_F(PathTest, FullCircleArc) {
+    Path path({PathSegment::arc({1.0, 2.0}, 3.0, 0.0, 2.0 * M_PI)});
+
+    EXPECT_NEAR(path.area(), M_PI * 9.0, 1e-12);
+    EXPECT_NEAR(path.perimeter(), 6.0 * M_PI, 1e-12);
+}
+
+TEST_F(PathTest, ClockwisePathHasPositiveArea) {
+    Path path({
+        PathSegment::line({0.0, 0.0}, {0.0, 2.0}),
+        PathSegment::line({0.0, 2.0}, {2.0, 2.0}),
+        PathSegment::line({2.0, 2.0}, {2.0, 0.0}),
+        PathSegment::line({2.0, 0.0}, {0.0, 0.0}),
+    });
+
+    EXPECT_NEAR(path.area(), 4.0, 1e-12);
+}
+
+TEST_F(PathTest, RoundedRectangle) {
+    Path path = Path::roundedRectangle(4.0, 3.0, 0.5);
+
+    EXPECT_NEAR(path.area(), 12.0 - (4.0 - M_PI) * 0.25, 1e-12);
+    EXPECT_NEAR(path.perimeter(), 2.0 * (4.0 + 3.0) - 8.0 * 0.5 + 2.0 * M_PI * 0.5, 1e-12);
+
+    BoundingBox box = path.bounds();
+    EXPECT_NEAR(box.min_x, 0.0, 1e-12);
+    EXPECT_NEAR(box.max_x, 4.0, 1e-12);
+    EXPECT_NEAR(box.max_y, 3.0, 1e-12);
+}
+
+TEST_F(PathTest, CubicAreaAndLength) {
+    // Closed lens: a Bezier arch over the segment [0, 4] on the x axis
+    PathSegment arch = PathSegment::cubic({4.0, 0.0}, {3.0, 3.0}, {1.0, 3.0}, {0.0, 0.0});
+    Path path({PathSegment::line({0.0, 0.0}, {4.0, 0.0}), arch});
+
+    // Reference area from the trapezoid rule on a fine polyline
+    double area = 0.0;
+    const int steps = 100000;
+    Point prev = {4.0, 0.0};
+    for (int i = 1; i <= steps; ++i) {
+        double t = static_cast<double>(i) / steps;
+        double u = 1.0 - t;
+        Point next{u * u * u * 4.0 + 3 * t * u * u * 3.0 + 3 * t * t * u * 1.0,
+                   3 * t * u * u * 3.0 + 3 * t * t * u * 3.0};
+        area += (prev.x - next.x) * (prev.y + next.y) / 2.0;
+        prev = next;
+    }
+
+    EXPECT_NEAR(path.area(), area, 1e-6);
+    EXPECT_NEAR(path.perimeter(), 4.0 + polylineLength(arch, 200000), 1e-6);
+}
+
+TEST_F(PathTest, CuspRequiresAdaptiveSubdivision) {
+    // Control points crossing over produce a cusp, where a single
+    // Gauss-Legendre rule is inaccurate
+    PathSegment cusp = PathSegment::cubic({0.0, 0.0}, {4.0, 3.0}, {0.0, 3.0}, {4.0, 0.0});
+    Path path({cusp, PathSegment::line({4.0, 0.0}, {0.0, 0.0})});
+
+    EXPECT_NEAR(path.perimeter(), 4.0 + polylineLength(cusp, 400000), 1e-6);
+}
+
+TEST_F(PathTest, InvalidPaths) {
+    EXPECT_THROW(Path({}), std::invalid_argument);
+    EXPECT_THROW(Path({PathSegment::line({0.0, 0.0}, {1.0, 0.0})}), std::invalid_argument);
+    EXPECT_THROW(Path({PathSegment::line({0.0, 0.0}, {1.0, 0.0}),
+                       PathSegment::line({1.0, 0.0}, {0.0, 0.0})}),
+                 std::invalid_argument); // Zero area
+    EXPECT_THROW(PathSegment::arc({0.0, 0.0}, 0.0, 0.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(Path::roundedRectangle(2.0, 2.0, 1.5), std::invalid_argument);
+}
+
+TEST_F(PathTest, FlattenIsCounterClockwiseWithinTolerance) {
+    Path path({PathSegment::arc({0.0, 0.0}, 1.0, 0.0, -2.0 * M_PI)});
+    std::vector<double> weights;
+    auto outline = path.flatten(1e-4, &weights);
+
+    ASSERT_EQ(outline.size(), weights.size());
+    double signed_area = 0.0;
+    double length = 0.0;
+    for (size_t i = 0; i < outline.size(); ++i) {
+        const Point& a = outline[i];
+        const Point& b = outline[(i + 1) % outline.size()];
+        signed_area += a.x * b.y - b.x * a.y;
+        length += std::hypot(b.x - a.x, b.y - a.y) * weights[i];
+    }
+    EXPECT_GT(signed_area, 0.0);
+    EXPECT_NEAR(length, 2.0 * M_PI, 1e-9);
+}
+
+TEST_F(PathTest, CalculatorAggregatesPaths) {
+    GeometryCalculator calculator;
+    calculator.addShape(std::make_unique<Path>(Path::roundedRectangle(2.0, 2.0, 1.0)));
+    calculator.addShape(std::make_unique<Rectangle>(2.0, 2.0));
+
+    EXPECT_NEAR(calculator.totalArea(), M_PI + 4.0, 1e-12);
+    EXPECT_EQ(calculator.statistics().recordedCount(), 2u);
+}
+
+TEST_F(PathTest, UnionPerimeterWithPaths) {
+    GeometryCalculator calculator;
+    // Rounded square sitting exactly on a rectangle's top edge
+    calculator.addShape(std::make_unique<Rectangle>(4.0, 1.0), {0.0, -1.0});
+    calculator.addShape(std::make_unique<Path>(Path::roundedRectangle(4.0, 2.0, 0.5)), {0.0, 0.0});
+
+    // The rounded corners leave two notches against the rectangle's edge
+    double path_perimeter = 2.0 * (4.0 + 2.0) - 4.0 + M_PI;
+    double shared = 3.0;
+    double expected = path_perimeter + (2.0 * (4.0 + 1.0)) - 2.0 * shared;
+    EXPECT_NEAR(calculator.unionPerimeter(1e-7), expected, 1e-5);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "placement.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cmath>
+
+using namespace geometry;
+
+class PlacementTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+TEST_F(PlacementTest, CircleBounds) {
+    Circle circle(2.0);
+    BoundingBox box = placedBounds({&circle, {1.0, -1.0}});
+
+    EXPECT_DOUBLE_EQ(box.min_x, -1.0);
+    EXPECT_DOUBLE_EQ(box.min_y, -3.0);
+    EXPECT_DOUBLE_EQ(box.max_x, 3.0);
+    EXPECT_DOUBLE_EQ(box.max_y, 1.0);
+}
+
+TEST_F(PlacementTest, RectangleVertices) {
+    Rectangle rect(4.0, 2.0);
+    auto vertices = placedVertices({&rect, {1.0, 1.0}});
+
+    ASSERT_EQ(vertices.size(), 4u);
+    EXPECT_DOUBLE_EQ(vertices[0].x, 1.0);
+    EXPECT_DOUBLE_EQ(vertices[2].x, 5.0);
+    EXPECT_DOUBLE_EQ(vertices[2].y, 3.0);
+}
+
+TEST_F(PlacementTest, TriangleVerticesMatchSides) {
+    Triangle triangle(3.0, 4.0, 5.0);
+    auto v = placedVertices({&triangle, {0.0, 0.0}});
+
+    ASSERT_EQ(v.size(), 3u);
+    EXPECT_NEAR(std::hypot(v[1].x - v[0].x, v[1].y - v[0].y), 3.0, 1e-12);
+    EXPECT_NEAR(std::hypot(v[2].x - v[1].x, v[2].y - v[1].y), 4.0, 1e-12);
+    EXPECT_NEAR(std::hypot(v[0].x - v[2].x, v[0].y - v[2].y), 5.0, 1e-12);
+    EXPECT_GT(v[2].y, 0.0); // Counter-clockwise winding
+}
+
+TEST_F(PlacementTest, CircleOutlineWithinTolerance) {
+    Circle circle(10.0);
+    const double tolerance = 1e-3;
+    auto outline = placedOutline({&circle, {0.0, 0.0}}, tolerance);
+
+    ASSERT_GE(outline.size(), 16u);
+    double chord_angle = 2.0 * M_PI / static_cast<double>(outline.size());
+    double sagitta = 10.0 * (1.0 - std::cos(chord_angle / 2.0));
+    EXPECT_LE(sagitta, tolerance);
+}
+
+TEST_F(PlacementTest, InvalidTolerance) {
+    EXPECT_THROW(circleSegmentCount(1.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(circleSegmentCount(1.0, -1.0), std::invalid_argument);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "predicates.h"
+#include "shapes/triangle.h"
+#include <cmath>
+
+using namespace geometry;
+
+class PredicatesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    /**
+     * Reference orientation for points on the 2^-53 grid, in 128-bit integers
+     */
+    static int gridOrientation(const Point& a, const Point& b, const Point& c) {
+        auto grid = [](double v) { return static_cast<__int128>(std::ldexp(v, 53)); };
+        __int128 det = (grid(a.x) - grid(c.x)) * (grid(b.y) - grid(c.y)) -
+                       (grid(a.y) - grid(c.y)) * (grid(b.x) - grid(c.x));
+        return det > 0 ? 1 : (det < 0 ? -1 : 0);
+    }
+};
+
+TEST_F(PredicatesTest, OrientationBasics) {
+    EXPECT_EQ(orientation({0.0, 0.0}, {1.0, 0.0}, {0.0, 1.0}), 1);
+    EXPECT_EQ(orientation({0.0, 0.0}, {0.0, 1.0}, {1.0, 0.0}), -1);
+    EXPECT_EQ(orientation({0.0, 0.0}, {1.0, 1.0}, {2.0, 2.0}), 0);
+    EXPECT_EQ(orientation({1.0, 1.0}, {1.0, 1.0}, {5.0, -3.0}), 0);
+}
+
+TEST_F(PredicatesTest, NearlyCollinearPointsAreExact) {
+    // Perturbations of a point on the line y = x by single units in the last place
+    const double ulp = 0x1p-53;
+    const Point b{12.0, 12.0};
+    const Point c{24.0, 24.0};
+    size_t naive_wrong = 0;
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            Point a{0.5 + i * ulp, 0.5 + j * ulp};
+            int expected = gridOrientation(a, b, c);
+            EXPECT_EQ(orientation(a, b, c), expected) << i << ", " << j;
+            EXPECT_EQ(orientation(b, a, c), -expected);
+            EXPECT_EQ(orientation(b, c, a), expected);
+
+            double naive = (a.x - c.x) * (b.y - c.y) - (a.y - c.y) * (b.x - c.x);
+            naive_wrong += (naive > 0 ? 1 : (naive < 0 ? -1 : 0)) != expected;
+        }
+    }
+    // Plain doubles get a large share of these wrong
+    EXPECT_GT(naive_wrong, 100u);
+}
+
+TEST_F(PredicatesTest, InCircle) {
+    Point a{1.0, 0.0};
+    Point b{0.0, 1.0};
+    Point c{-1.0, 0.0};
+
+    EXPECT_EQ(inCircle(a, b, c, {0.0, 0.0}), 1);
+    EXPECT_EQ(inCircle(a, b, c, {2.0, 0.0}), -1);
+    EXPECT_EQ(inCircle(a, b, c, {0.0, -1.0}), 0);
+    EXPECT_EQ(inCircle(a, c, b, {0.0, 0.0}), -1);
+
+    // One unit in the last place inside and outside the circle
+    EXPECT_EQ(inCircle(a, b, c, {0.0, -1.0 + 0x1p-53}), 1);
+    EXPECT_EQ(inCircle(a, b, c, {0.0, -1.0 - 0x1p-52}), -1);
+    EXPECT_EQ(inCircleExact(a, b, c, {0.0, -1.0 + 0x1p-53}), 1);
+
+    // Cocircular points far from the origin
+    Point center{1e6 + 0.5, -3e6};
+    EXPECT_EQ(inCircle({center.x + 3.0, center.y + 4.0}, {center.x - 4.0, center.y + 3.0},
+                       {center.x - 3.0, center.y - 4.0}, {center.x + 5.0, center.y}), 0);
+}
+
+TEST_F(PredicatesTest, TriangleInequalityIsExact) {
+    const double tiny = 0x1p-53;
+    EXPECT_FALSE(1.0 + tiny > 1.0);  // The rounded sum loses the sliver
+    EXPECT_TRUE(sumExceeds(1.0, tiny, 1.0));
+    EXPECT_TRUE(satisfiesTriangleInequality(1.0, tiny, 1.0));
+    EXPECT_FALSE(satisfiesTriangleInequality(1.0, tiny, 1.0 + 0x1p-52));
+    EXPECT_FALSE(satisfiesTriangleInequality(1.0, 1.0, 2.0));
+    EXPECT_FALSE(satisfiesTriangleInequality(1.0, NAN, 1.0));
+
+    EXPECT_NO_THROW(Triangle(1.0, tiny, 1.0));
+    EXPECT_THROW(Triangle(1.0, 1.0, 2.0), std::invalid_argument);
+    Triangle triangle(3.0, 4.0, 5.0);
+    EXPECT_NO_THROW(triangle.setSides(tiny, 1.0, 1.0));
+    EXPECT_TRUE(triangle.isValid());
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace geometry;
+
+class QueryCacheTest : public ::testing::Test {
+protected:
+    GeometryCalculator calculator;
+
+    void SetUp() override {
+        calculator.addShape(std::make_unique<Circle>(1.0));
+        calculator.addShape(std::make_unique<Rectangle>(2.0, 3.0), {5.0, 0.0});
+        calculator.addShape(std::make_unique<Rectangle>(1.0, 1.0), {10.0, 0.0});
+        calculator.addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0), {20.0, 0.0});
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+TEST_F(QueryCacheTest, FilteredAggregates) {
+    ShapeQuery rectangles;
+    rectangles.kinds = kindMask(ShapeKind::Rectangle);
+    EXPECT_DOUBLE_EQ(calculator.query(rectangles), 7.0);
+
+    rectangles.aggregate = QueryAggregate::Count;
+    EXPECT_DOUBLE_EQ(calculator.query(rectangles), 2.0);
+
+    ShapeQuery large;
+    large.aggregate = QueryAggregate::TotalPerimeter;
+    large.min_area = 3.0;
+    EXPECT_DOUBLE_EQ(calculator.query(large), M_PI * 2.0 + 10.0 + 12.0);
+
+    ShapeQuery all;
+    all.aggregate = QueryAggregate::UnionPerimeter;
+    EXPECT_NEAR(calculator.query(all), calculator.totalPerimeter(), 1e-9);
+}
+
+TEST_F(QueryCacheTest, NormalizationMergesEquivalentQueries) {
+    ShapeQuery a;
+    a.min_area = -5.0;
+    a.tolerance = 0.5;  // Ignored by area queries
+    ShapeQuery b;
+    EXPECT_EQ(normalizeQuery(a), normalizeQuery(b));
+    EXPECT_EQ(queryHash(normalizeQuery(a)), queryHash(normalizeQuery(b)));
+
+    ShapeQuery empty_kinds;
+    empty_kinds.kinds = 0;
+    ShapeQuery empty_range;
+    empty_range.min_area = 10.0;
+    empty_range.max_area = 1.0;
+    EXPECT_EQ(normalizeQuery(empty_kinds), normalizeQuery(empty_range));
+    EXPECT_DOUBLE_EQ(calculator.query(empty_range), 0.0);
+
+    ShapeQuery bad;
+    bad.min_area = std::nan("");
+    EXPECT_THROW(calculator.query(bad), std::invalid_argument);
+    bad = ShapeQuery{QueryAggregate::UnionPerimeter};
+    bad.tolerance = 0.0;
+    EXPECT_THROW(calculator.query(bad), std::invalid_argument);
+}
+
+TEST_F(QueryCacheTest, RepeatedQueriesHitTheCache) {
+    calculator.queryCache().clear();
+    double first = calculator.totalArea();
+    double second = calculator.totalArea();
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(calculator.queryCache().misses(), 1u);
+    EXPECT_EQ(calculator.queryCache().hits(), 1u);
+
+    ShapeQuery equivalent;
+    equivalent.min_area = -1.0;
+    calculator.query(equivalent);
+    EXPECT_EQ(calculator.queryCache().hits(), 2u);
+}
+
+TEST_F(QueryCacheTest, MutationsInvalidateResults) {
+    double area = calculator.totalArea();
+    uint64_t version = calculator.version();
+
+    calculator.addShape(std::make_unique<Rectangle>(1.0, 1.0));
+    EXPECT_GT(calculator.version(), version);
+    EXPECT_DOUBLE_EQ(calculator.totalArea(), area + 1.0);
+
+    calculator.replaceShape(4, std::make_unique<Rectangle>(2.0, 1.0));
+    EXPECT_DOUBLE_EQ(calculator.totalArea(), area + 2.0);
+
+    calculator.removeShape(4);
+    EXPECT_DOUBLE_EQ(calculator.totalArea(), area);
+    EXPECT_EQ(calculator.shapeCount(), 4u);
+
+    // Move the 1x1 rectangle inside the circle: its boundary disappears
+    double union_before = calculator.unionPerimeter();
+    calculator.setPosition(2, {-0.5, -0.5});
+    EXPECT_LT(calculator.unionPerimeter(), union_before);
+    EXPECT_EQ(calculator.getPlacedShape(2).position.x, -0.5);
+
+    calculator.clear();
+    EXPECT_DOUBLE_EQ(calculator.totalArea(), 0.0);
+}
+
+TEST_F(QueryCacheTest, InvalidMutations) {
+    uint64_t version = calculator.version();
+    EXPECT_THROW(calculator.replaceShape(10, std::make_unique<Circle>(1.0)), std::out_of_range);
+    EXPECT_THROW(calculator.replaceShape(0, nullptr), std::invalid_argument);
+    EXPECT_THROW(calculator.removeShape(4), std::out_of_range);
+    EXPECT_THROW(calculator.setPosition(4, {}), std::out_of_range);
+    EXPECT_EQ(calculator.version(), version);
+}
+
+TEST_F(QueryCacheTest, LeastRecentlyUsedEviction) {
+    QueryCache cache(2);
+    ShapeQuery a{QueryAggregate::Count};
+    ShapeQuery b{QueryAggregate::TotalArea};
+    ShapeQuery c{QueryAggregate::TotalPerimeter};
+
+    cache.insert(a, 1, 1.0);
+    cache.insert(b, 1, 2.0);
+    ASSERT_TRUE(cache.find(a, 1).has_value());  // a is now most recent
+    cache.insert(c, 1, 3.0);                    // evicts b
+
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_FALSE(cache.find(b, 1).has_value());
+    EXPECT_DOUBLE_EQ(*cache.find(a, 1), 1.0);
+    EXPECT_DOUBLE_EQ(*cache.find(c, 1), 3.0);
+
+    // Stale versions miss and free their entry
+    EXPECT_FALSE(cache.find(a, 2).has_value());
+    EXPECT_EQ(cache.size(), 1u);
+
+    cache.setCapacity(0);
+    cache.insert(a, 2, 1.0);
+    EXPECT_EQ(cache.size(), 0u);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "replication.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace geometry;
+
+class ReplicationTest : public ::testing::Test {
+protected:
+    int fds[2] = {-1, -1};
+    GeometryCalculator leader_calc;
+
+    void SetUp() override {
+        // Setup code if needed
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        for (int i = 0; i < 50; ++i) {
+            leader_calc.addShape(std::make_unique<Circle>(1.0 + i), Point{static_cast<double>(i), 1.0});
+        }
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+        for (int fd : fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+};
+
+TEST_F(ReplicationTest, FollowerTracksLeader) {
+    ReplicationLeader leader(leader_calc, fds[0], 512);
+    ReplicationFollower follower(fds[1]);
+    EXPECT_EQ(follower.poll(std::chrono::milliseconds(1000)), leader.sequence());
+    EXPECT_TRUE(follower.calculator().sameContent(leader_calc));
+
+    leader_calc.addShape(std::make_unique<Rectangle>(2.0, 3.0), Point{-1.0, 2.0});
+    leader_calc.addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0));
+    leader_calc.addShape(std::make_unique<Path>(Path::roundedRectangle(4.0, 2.0, 0.5)), Point{5.0, 5.0});
+    leader_calc.replaceShape(3, std::make_unique<Circle>(0.5));
+    leader_calc.setPosition(4, Point{7.0, 7.0});
+    leader_calc.removeShape(0);
+
+    CalculatorBatch batch = leader_calc.beginBatch();
+    batch.addShape(std::make_unique<Circle>(9.0));
+    batch.replaceShape(10, std::make_unique<Rectangle>(1.0, 1.0));
+    batch.setPosition(11, Point{-3.0, -3.0});
+    batch.removeShape(20);
+    batch.removeShape(21);
+    batch.commit();
+
+    GeometryCalculator other;
+    other.addShape(std::make_unique<Circle>(4.0), Point{8.0, 8.0});
+    leader_calc.merge(other);
+    leader.flush();
+
+    follower.poll(std::chrono::milliseconds(1000));
+    EXPECT_EQ(follower.sequence(), leader.sequence());
+    EXPECT_EQ(follower.calculator().shapeCount(), leader_calc.shapeCount());
+    EXPECT_TRUE(follower.calculator().diff(leader_calc).empty());
+    EXPECT_DOUBLE_EQ(follower.calculator().totalArea(), leader_calc.totalArea());
+
+    leader_calc.clear();
+    leader_calc.addShape(std::make_unique<Circle>(1.0));
+    leader.flush();
+    follower.poll(std::chrono::milliseconds(1000));
+    EXPECT_TRUE(follower.calculator().sameContent(leader_calc));
+    EXPECT_EQ(follower.calculator().shapeCount(), 1u);
+}
+
+TEST_F(ReplicationTest, FollowerTakesOverWhenLeaderCloses) {
+    {
+        ReplicationLeader leader(leader_calc, fds[0]);
+        leader_calc.removeShape(49);
+    }
+    close(fds[0]);
+    fds[0] = -1;
+
+    ReplicationFollower follower(fds[1]);
+    EXPECT_EQ(follower.poll(std::chrono::milliseconds(1000)), 2u);
+    EXPECT_TRUE(follower.closed());
+    GeometryCalculator promoted = follower.takeOver();
+    EXPECT_TRUE(promoted.sameContent(leader_calc));
+    EXPECT_EQ(follower.calculator().shapeCount(), 0u);
+
+    EXPECT_THROW(follower.poll(), std::logic_error);
+
+    // Detached leaders no longer observe the calculator
+    leader_calc.addShape(std::make_unique<Circle>(2.0));
+    promoted.addShape(std::make_unique<Circle>(2.0));
+    EXPECT_TRUE(promoted.sameContent(leader_calc));
+}
+
+TEST_F(ReplicationTest, FollowerRejectsBrokenStreams) {
+    ReplicationFollower follower(fds[1]);
+    {
+        ReplicationLeader first(leader_calc, fds[0]);
+    }
+    {
+        // A second leader on the same channel restarts the sequence
+        ReplicationLeader second(leader_calc, fds[0]);
+    }
+    EXPECT_THROW(follower.poll(std::chrono::milliseconds(1000)), std::runtime_error);
+
+    int garbage[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, garbage), 0);
+    const char bytes[40] = "not a replication frame";
+    ASSERT_EQ(write(garbage[0], bytes, sizeof(bytes)), static_cast<ssize_t>(sizeof(bytes)));
+    ReplicationFollower confused(garbage[1]);
+    EXPECT_THROW(confused.poll(std::chrono::milliseconds(1000)), std::runtime_error);
+    close(garbage[0]);
+    close(garbage[1]);
+}
+
+TEST_F(ReplicationTest, ChannelFailureLeavesLeaderIntact) {
+    ReplicationLeader leader(leader_calc, fds[0], 64);
+    close(fds[1]);
+    fds[1] = -1;
+
+    // Frames fill after a few adds and their writes fail mid-batch
+    double area = leader_calc.totalArea();
+    CalculatorBatch batch = leader_calc.beginBatch();
+    for (int i = 0; i < 20; ++i) {
+        batch.addShape(std::make_unique<Circle>(1.0));
+    }
+    batch.removeShape(0);
+    EXPECT_NO_THROW(batch.commit());
+    EXPECT_TRUE(leader.failed());
+    EXPECT_EQ(leader.pendingBytes(), 0u);
+    EXPECT_EQ(leader_calc.shapeCount(), 69u);
+    EXPECT_NEAR(leader_calc.totalArea(), area + 20.0 * M_PI - M_PI, 1e-9);
+
+    EXPECT_NO_THROW(leader_calc.addShape(std::make_unique<Circle>(1.0)));
+    EXPECT_THROW(leader.flush(), std::runtime_error);
+    EXPECT_EQ(leader_calc.shapeCount(), 70u);
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "segmented_vector.h"
+
+using namespace geometry;
+
+class SegmentedVectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+TEST_F(SegmentedVectorTest, AppendsKeepAddresses) {
+    SegmentedVector<double, 8> values;
+    values.push_back(1.0);
+    const double* first = &values[0];
+    for (int i = 1; i < 100; ++i) {
+        values.push_back(static_cast<double>(i) + 1.0);
+    }
+    EXPECT_EQ(&values[0], first);
+    EXPECT_EQ(values.size(), 100u);
+    EXPECT_EQ(values.segmentCount(), 13u);
+    EXPECT_EQ(values.segmentLength(12), 4u);
+    EXPECT_DOUBLE_EQ(values[99], 100.0);
+    EXPECT_DOUBLE_EQ(values.segment(1)[0], 9.0);
+}
+
+TEST_F(SegmentedVectorTest, EraseAndResize) {
+    SegmentedVector<int, 4> values;
+    for (int i = 0; i < 20; ++i) {
+        values.push_back(i);
+    }
+    values.erase(0);
+    EXPECT_EQ(values.size(), 19u);
+    EXPECT_EQ(values[0], 1);
+    EXPECT_EQ(values[18], 19);
+
+    values.eraseSorted({0, 3, 4, 5, 18});  // Values 1, 4, 5, 6, 19
+    ASSERT_EQ(values.size(), 14u);
+    EXPECT_EQ(values[0], 2);
+    EXPECT_EQ(values[2], 7);
+    EXPECT_EQ(values[13], 18);
+    EXPECT_EQ(values.segmentCount(), 4u);
+
+    values.resize(2);
+    EXPECT_EQ(values.segmentCount(), 1u);
+    values.resize(6, -1);
+    EXPECT_EQ(values[1], 3);
+    EXPECT_EQ(values[5], -1);
+
+    SegmentedVector<int, 4> copy = values;
+    copy[0] = 42;
+    EXPECT_EQ(values[0], 2);
+    EXPECT_EQ(copy.size(), 6u);
+
+    values.assign(3, 7);
+    EXPECT_EQ(values.size(), 3u);
+    EXPECT_EQ(values[2], 7);
+    values.clear();
+    EXPECT_TRUE(values.empty());
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "shape_distance.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cmath>
+#include <memory>
+#include <random>
+
+using namespace geometry;
+
+class ShapeDistanceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    static std::vector<Point> sampleBoundary(const PlacedShape& placed, double spacing) {
+        std::vector<Point> samples;
+        if (placed.shape->kind() == ShapeKind::Circle) {
+            double r = static_cast<const Circle*>(placed.shape)->radius();
+            size_t count = static_cast<size_t>(std::ceil(2.0 * M_PI * r / spacing));
+            for (size_t s = 0; s < count; ++s) {
+                double angle = 2.0 * M_PI * static_cast<double>(s) / static_cast<double>(count);
+                samples.push_back({placed.position.x + r * std::cos(angle),
+                                   placed.position.y + r * std::sin(angle)});
+            }
+            return samples;
+        }
+        std::vector<Point> vertices = placedVertices(placed);
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Point& a = vertices[i];
+            const Point& b = vertices[(i + 1) % vertices.size()];
+            size_t count = static_cast<size_t>(std::ceil(std::hypot(b.x - a.x, b.y - a.y) / spacing));
+            for (size_t s = 0; s < count; ++s) {
+                double t = static_cast<double>(s) / static_cast<double>(count);
+                samples.push_back({a.x + t * (b.x - a.x), a.y + t * (b.y - a.y)});
+            }
+        }
+        return samples;
+    }
+};
+
+TEST_F(ShapeDistanceTest, ClosedFormCases) {
+    Circle small(1.0);
+    Circle large(2.0);
+    Rectangle square(2.0, 2.0);
+    Triangle right(3.0, 4.0, 5.0);
+
+    EXPECT_NEAR(minimumDistance({&small, {0.0, 0.0}}, {&large, {5.0, 0.0}}), 2.0, 1e-12);
+    EXPECT_NEAR(minimumDistance({&square, {0.0, 0.0}}, {&small, {5.0, 1.0}}), 2.0, 1e-12);
+    EXPECT_NEAR(minimumDistance({&small, {5.0, 5.0}}, {&square, {0.0, 0.0}}),
+                std::sqrt(18.0) - 1.0, 1e-12);
+    EXPECT_NEAR(minimumDistance({&square, {0.0, 0.0}}, {&square, {3.0, 4.0}}), std::sqrt(5.0), 1e-12);
+    // Vertices (0, 0), (3, 0), (3, 4); the square's corner (0, 2) is 6/5 from the hypotenuse
+    EXPECT_NEAR(minimumDistance({&right, {0.0, 0.0}}, {&square, {-2.0, 2.0}}), 1.2, 1e-12);
+}
+
+TEST_F(ShapeDistanceTest, OverlapIsZero) {
+    Circle small(0.5);
+    Rectangle wide(4.0, 1.0);
+    Rectangle tall(1.0, 4.0);
+
+    // Circle inside a rectangle
+    EXPECT_DOUBLE_EQ(minimumDistance({&small, {2.0, 0.5}}, {&wide, {0.0, 0.0}}), 0.0);
+    // A cross: edges intersect but no vertex lies inside the other shape
+    EXPECT_DOUBLE_EQ(minimumDistance({&wide, {0.0, 0.0}}, {&tall, {1.5, -1.5}}), 0.0);
+    // Touching
+    EXPECT_DOUBLE_EQ(minimumDistance({&wide, {0.0, 0.0}}, {&tall, {4.0, 0.0}}), 0.0);
+}
+
+TEST_F(ShapeDistanceTest, MatchesSampledBoundaries) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(-6.0, 6.0);
+    std::uniform_real_distribution<double> size(0.5, 3.0);
+    std::vector<std::unique_ptr<Shape>> owned;
+    std::vector<PlacedShape> placed;
+    for (size_t i = 0; i < 30; ++i) {
+        switch (i % 3) {
+            case 0: owned.push_back(std::make_unique<Circle>(size(rng))); break;
+            case 1: owned.push_back(std::make_unique<Rectangle>(size(rng), size(rng))); break;
+            default: owned.push_back(std::make_unique<Triangle>(3.0, 4.0, 5.0)); break;
+        }
+        placed.push_back({owned.back().get(), {coord(rng), coord(rng)}});
+    }
+    std::vector<ShapePair> pairs;
+    for (size_t a = 0; a < placed.size(); ++a) {
+        for (size_t b = a + 1; b < placed.size(); ++b) {
+            pairs.push_back({a, b});
+        }
+    }
+
+    DistanceShapes shapes(placed);
+    std::vector<double> distances = shapes.distances(pairs);
+    ASSERT_EQ(distances.size(), pairs.size());
+    for (size_t p = 0; p < pairs.size(); p += 7) {
+        std::vector<Point> a = sampleBoundary(placed[pairs[p].first], 0.02);
+        std::vector<Point> b = sampleBoundary(placed[pairs[p].second], 0.02);
+        double sampled = std::numeric_limits<double>::infinity();
+        for (const Point& u : a) {
+            for (const Point& v : b) {
+                sampled = std::min(sampled, std::hypot(u.x - v.x, u.y - v.y));
+            }
+        }
+        if (distances[p] > 0.0) {
+            EXPECT_LE(distances[p], sampled + 1e-9);
+            EXPECT_NEAR(distances[p], sampled, 0.05);
+        }
+        EXPECT_DOUBLE_EQ(distances[p], minimumDistance(placed[pairs[p].first], placed[pairs[p].second]));
+    }
+
+    for (double threshold : {0.1, 1.0, 3.0}) {
+        std::vector<uint8_t> close = shapes.within(pairs, threshold);
+        for (size_t p = 0; p < pairs.size(); ++p) {
+            EXPECT_EQ(close[p] != 0, distances[p] < threshold) << "pair " << p;
+        }
+    }
+}
+
+TEST_F(ShapeDistanceTest, ThresholdAndErrors) {
+    Circle circle(1.0);
+    DistanceShapes shapes({{&circle, {0.0, 0.0}}, {&circle, {1.0, 0.0}}});
+
+    EXPECT_EQ(shapes.within({{0, 1}}, 0.0)[0], 0);
+    EXPECT_EQ(shapes.within({{0, 1}}, 0.5)[0], 1);
+    EXPECT_THROW(shapes.distances({{0, 2}}), std::out_of_range);
+    EXPECT_THROW(shapes.within({{2, 0}}, 1.0), std::out_of_range);
+
+    Path path = Path::roundedRectangle(2.0, 1.0, 0.25);
+    EXPECT_THROW(DistanceShapes({{&path, {0.0, 0.0}}}), std::invalid_argument);
+    EXPECT_THROW(DistanceShapes({{nullptr, {0.0, 0.0}}}), std::invalid_argument);
+}
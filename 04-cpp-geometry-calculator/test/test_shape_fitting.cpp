@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shape_fitting.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace geometry;
+
+class ShapeFittingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        rng.seed(42);
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    double noise() {
+        return std::uniform_real_distribution<double>(-0.002, 0.002)(rng);
+    }
+
+    void addOutliers(PointCloud& cloud, size_t count, double lo, double hi) {
+        std::uniform_real_distribution<double> coord(lo, hi);
+        for (size_t i = 0; i < count; ++i) {
+            cloud.add({coord(rng), coord(rng)});
+        }
+    }
+
+    PointCloud circleCloud(const Point& center, double radius, size_t count) {
+        PointCloud cloud;
+        for (size_t i = 0; i < count; ++i) {
+            double angle = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(count);
+            cloud.add({center.x + radius * std::cos(angle) + noise(),
+                       center.y + radius * std::sin(angle) + noise()});
+        }
+        return cloud;
+    }
+
+    PointCloud polygonCloud(const std::vector<Point>& vertices, size_t per_edge) {
+        PointCloud cloud;
+        for (size_t e = 0; e < vertices.size(); ++e) {
+            const Point& a = vertices[e];
+            const Point& b = vertices[(e + 1) % vertices.size()];
+            for (size_t i = 0; i < per_edge; ++i) {
+                double t = static_cast<double>(i) / static_cast<double>(per_edge);
+                cloud.add({a.x + t * (b.x - a.x) + noise(), a.y + t * (b.y - a.y) + noise()});
+            }
+        }
+        return cloud;
+    }
+
+    std::mt19937 rng;
+};
+
+TEST_F(ShapeFittingTest, FitCircleWithOutliers) {
+    PointCloud cloud = circleCloud({3.0, -2.0}, 5.0, 400);
+    addOutliers(cloud, 100, -10.0, 10.0);
+
+    FitResult result = fitShape(cloud, ShapeKind::Circle);
+
+    ASSERT_NE(result.shape, nullptr);
+    ASSERT_EQ(result.shape->kind(), ShapeKind::Circle);
+    EXPECT_NEAR(static_cast<const Circle&>(*result.shape).radius(), 5.0, 1e-3);
+    EXPECT_NEAR(result.position.x, 3.0, 1e-3);
+    EXPECT_NEAR(result.position.y, -2.0, 1e-3);
+    EXPECT_GE(result.inliers, 400u);
+    EXPECT_LT(result.rms_residual, 0.01);
+}
+
+TEST_F(ShapeFittingTest, FitRectangle) {
+    PointCloud cloud = polygonCloud({{1.0, 2.0}, {5.0, 2.0}, {5.0, 5.0}, {1.0, 5.0}}, 100);
+    addOutliers(cloud, 50, -5.0, 10.0);
+
+    FitResult result = fitShape(cloud, ShapeKind::Rectangle);
+
+    ASSERT_NE(result.shape, nullptr);
+    const auto& rect = static_cast<const Rectangle&>(*result.shape);
+    EXPECT_NEAR(rect.width(), 4.0, 1e-2);
+    EXPECT_NEAR(rect.height(), 3.0, 1e-2);
+    EXPECT_NEAR(result.position.x, 1.0, 1e-2);
+    EXPECT_NEAR(result.position.y, 2.0, 1e-2);
+}
+
+TEST_F(ShapeFittingTest, FitTriangle) {
+    PointCloud cloud = polygonCloud({{0.0, 0.0}, {3.0, 0.0}, {3.0, 4.0}}, 150);
+    addOutliers(cloud, 40, -2.0, 6.0);
+
+    FitResult result = fitShape(cloud, ShapeKind::Triangle);
+
+    ASSERT_NE(result.shape, nullptr);
+    EXPECT_NEAR(result.shape->perimeter(), 12.0, 1e-2);
+    EXPECT_NEAR(result.shape->area(), 6.0, 1e-2);
+}
+
+TEST_F(ShapeFittingTest, FitTrianglePlacesVertices) {
+    const std::vector<std::vector<Point>> triangles = {
+        {{0.0, 0.0}, {3.0, 0.0}, {3.0, 4.0}},
+        {{0.0, 0.0}, {0.0, 3.0}, {-4.0, 0.0}},
+        {{5.0, 1.0}, {-1.0, 1.0}, {2.0, 5.0}},
+    };
+    for (const auto& corners : triangles) {
+        FitResult result = fitShape(polygonCloud(corners, 150), ShapeKind::Triangle);
+
+        ASSERT_NE(result.shape, nullptr);
+        std::vector<Point> placed = placedVertices({result.shape.get(), result.position});
+        ASSERT_EQ(placed.size(), 3u);
+        for (const Point& corner : corners) {
+            double nearest = std::numeric_limits<double>::infinity();
+            for (const Point& p : placed) {
+                nearest = std::min(nearest, std::hypot(p.x - corner.x, p.y - corner.y));
+            }
+            EXPECT_LT(nearest, 1e-2) << corner.x << ", " << corner.y;
+        }
+    }
+}
+
+TEST_F(ShapeFittingTest, FitFailsOnPureNoise) {
+    PointCloud cloud;
+    addOutliers(cloud, 300, -10.0, 10.0);
+
+    FitResult result = fitShape(cloud, ShapeKind::Circle);
+
+    EXPECT_EQ(result.shape, nullptr);
+}
+
+TEST_F(ShapeFittingTest, FitIsDeterministic) {
+    PointCloud cloud = circleCloud({0.0, 0.0}, 2.0, 200);
+    addOutliers(cloud, 100, -4.0, 4.0);
+
+    FitResult first = fitShape(cloud, ShapeKind::Circle);
+    FitResult second = fitShape(cloud, ShapeKind::Circle);
+
+    ASSERT_NE(first.shape, nullptr);
+    ASSERT_NE(second.shape, nullptr);
+    EXPECT_DOUBLE_EQ(first.shape->area(), second.shape->area());
+    EXPECT_EQ(first.inliers, second.inliers);
+}
+
+TEST_F(ShapeFittingTest, InvalidInput) {
+    PointCloud cloud = circleCloud({0.0, 0.0}, 1.0, 10);
+    cloud.x.push_back(1.0);
+    EXPECT_THROW(fitShape(cloud, ShapeKind::Circle), std::invalid_argument);
+
+    FitOptions options;
+    options.inlier_threshold = 0.0;
+    EXPECT_THROW(fitShape(circleCloud({0.0, 0.0}, 1.0, 10), ShapeKind::Circle, options),
+                 std::invalid_argument);
+}
+
+TEST_F(ShapeFittingTest, BatchFitIntoCalculator) {
+    std::vector<PointCloud> clouds;
+    for (int i = 0; i < 20; ++i) {
+        clouds.push_back(circleCloud({10.0 * i, 0.0}, 1.0 + i, 200));
+    }
+    PointCloud noise_only;
+    addOutliers(noise_only, 100, -1.0, 1.0);
+    clouds.push_back(noise_only);
+
+    GeometryCalculator calculator;
+    size_t added = fitShapesInto(clouds, ShapeKind::Circle, calculator);
+
+    EXPECT_EQ(added, 20u);
+    ASSERT_EQ(calculator.shapeCount(), 20u);
+    for (size_t i = 0; i < 20; ++i) {
+        PlacedShape placed = calculator.getPlacedShape(i);
+        EXPECT_NEAR(static_cast<const Circle*>(placed.shape)->radius(), 1.0 + i, 1e-2);
+        EXPECT_NEAR(placed.position.x, 10.0 * i, 1e-2);
+    }
+}
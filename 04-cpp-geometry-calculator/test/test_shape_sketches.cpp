@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shape_sketches.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <cmath>
+
+using namespace geometry;
+
+class ShapeSketchesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    static ShapeSignature circleSignature(double radius) {
+        return canonicalSignature(Circle(radius));
+    }
+};
+
+TEST_F(ShapeSketchesTest, CanonicalSignatureIsOrderIndependent) {
+    EXPECT_EQ(canonicalSignature(Rectangle(4.0, 6.0)), canonicalSignature(Rectangle(6.0, 4.0)));
+    EXPECT_EQ(canonicalSignature(Triangle(3.0, 4.0, 5.0)),
+              canonicalSignature(Triangle(5.0, 3.0, 4.0)));
+    EXPECT_FALSE(canonicalSignature(Circle(1.0)) == canonicalSignature(Circle(2.0)));
+}
+
+TEST_F(ShapeSketchesTest, CanonicalSignatureQuantizes) {
+    EXPECT_EQ(canonicalSignature(Circle(1.0), 1e-3), canonicalSignature(Circle(1.0001), 1e-3));
+    EXPECT_EQ(signatureHash(canonicalSignature(Circle(1.0), 1e-3)),
+              signatureHash(canonicalSignature(Circle(1.0001), 1e-3)));
+    EXPECT_THROW(canonicalSignature(Circle(1.0), 0.0), std::invalid_argument);
+}
+
+TEST_F(ShapeSketchesTest, HeavyHittersExactBelowCapacity) {
+    HeavyHitterSketch sketch(8);
+    for (int i = 0; i < 5; ++i) {
+        for (int n = 0; n <= i; ++n) {
+            sketch.add(circleSignature(1.0 + i));
+        }
+    }
+
+    auto top = sketch.topK(3);
+    ASSERT_EQ(top.size(), 3u);
+    EXPECT_EQ(top[0].signature, circleSignature(5.0));
+    EXPECT_EQ(top[0].count, 5u);
+    EXPECT_EQ(top[0].error, 0u);
+    EXPECT_EQ(top[1].count, 4u);
+    EXPECT_EQ(top[2].count, 3u);
+    EXPECT_EQ(sketch.total(), 15u);
+}
+
+TEST_F(ShapeSketchesTest, HeavyHitterSurvivesNoise) {
+    HeavyHitterSketch sketch(16);
+    for (int i = 0; i < 10000; ++i) {
+        sketch.add(circleSignature(1000.0 + i));
+        if (i % 4 == 0) {
+            sketch.add(circleSignature(7.0));
+        }
+    }
+
+    auto top = sketch.topK(1);
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].signature, circleSignature(7.0));
+    EXPECT_GE(top[0].count, 2500u);
+    EXPECT_LE(top[0].count - top[0].error, 2500u);
+}
+
+TEST_F(ShapeSketchesTest, HeavyHitterMerge) {
+    HeavyHitterSketch a(4);
+    HeavyHitterSketch b(4);
+    for (int i = 0; i < 100; ++i) {
+        a.add(circleSignature(1.0));
+        b.add(circleSignature(1.0));
+        b.add(circleSignature(2.0));
+    }
+    a.merge(b);
+
+    auto top = a.topK(2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].signature, circleSignature(1.0));
+    EXPECT_EQ(top[0].count, 200u);
+    EXPECT_EQ(top[1].count, 100u);
+    EXPECT_EQ(a.total(), 300u);
+}
+
+TEST_F(ShapeSketchesTest, DistinctCountAccuracy) {
+    DistinctCounter counter(12);
+    const int distinct = 50000;
+    for (int repeat = 0; repeat < 2; ++repeat) {
+        for (int i = 0; i < distinct; ++i) {
+            counter.add(signatureHash(circleSignature(1.0 + i)));
+        }
+    }
+
+    // Standard error at precision 12 is about 1.6%
+    EXPECT_NEAR(counter.estimate(), distinct, distinct * 0.06);
+}
+
+TEST_F(ShapeSketchesTest, DistinctCountSmallCardinality) {
+    DistinctCounter counter;
+    for (int i = 0; i < 10; ++i) {
+        counter.add(signatureHash(circleSignature(1.0 + i)));
+    }
+
+    EXPECT_NEAR(counter.estimate(), 10.0, 0.5);
+}
+
+TEST_F(ShapeSketchesTest, DistinctCountMergeMatchesUnion) {
+    DistinctCounter a;
+    DistinctCounter b;
+    DistinctCounter both;
+    for (int i = 0; i < 3000; ++i) {
+        uint64_t h = signatureHash(circleSignature(1.0 + i));
+        (i % 2 == 0 ? a : b).add(h);
+        both.add(h);
+    }
+    a.merge(b);
+
+    EXPECT_DOUBLE_EQ(a.estimate(), both.estimate());
+    EXPECT_THROW(a.merge(DistinctCounter(10)), std::invalid_argument);
+}
+
+TEST_F(ShapeSketchesTest, CalculatorMaintainsStatistics) {
+    GeometryCalculator calculator;
+    calculator.addShape(std::make_unique<Rectangle>(4.0, 6.0));
+    calculator.addShape(std::make_unique<Rectangle>(6.0, 4.0));
+    calculator.addShape(std::make_unique<Circle>(1.0));
+
+    const ShapeStatistics& stats = calculator.statistics();
+    EXPECT_EQ(stats.recordedCount(), 3u);
+    EXPECT_NEAR(stats.distinctCount(), 2.0, 0.1);
+
+    auto top = stats.mostCommon(1);
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].signature.kind, ShapeKind::Rectangle);
+    EXPECT_EQ(top[0].count, 2u);
+
+    calculator.clear();
+    EXPECT_EQ(calculator.statistics().recordedCount(), 0u);
+}
+
+TEST_F(ShapeSketchesTest, MergeStatisticsAcrossCalculators) {
+    GeometryCalculator first;
+    GeometryCalculator second;
+    first.addShape(std::make_unique<Circle>(1.0));
+    second.addShape(std::make_unique<Circle>(1.0));
+    second.addShape(std::make_unique<Circle>(2.0));
+
+    ShapeStatistics combined = first.statistics();
+    combined.merge(second.statistics());
+
+    EXPECT_EQ(combined.recordedCount(), 3u);
+    EXPECT_NEAR(combined.distinctCount(), 2.0, 0.1);
+    EXPECT_EQ(combined.mostCommon(1)[0].count, 2u);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shape_store.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace geometry;
+
+class ShapeStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    static void fill(ShapeStore& store, size_t count, double first) {
+        for (size_t i = 0; i < count; ++i) {
+            double radius = first + static_cast<double>(i);
+            store.push(std::make_unique<Circle>(radius), Point{radius, 0.0});
+        }
+    }
+
+    static void fill(GeometryCalculator& calculator, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            double size = 1.0 + static_cast<double>(i % 10);
+            switch (i % 3) {
+                case 0:
+                    calculator.addShape(std::make_unique<Circle>(size), Point{size, 0.0});
+                    break;
+                case 1:
+                    calculator.addShape(std::make_unique<Rectangle>(size, 2.0));
+                    break;
+                default:
+                    calculator.addShape(std::make_unique<Triangle>(size, size, size));
+                    break;
+            }
+        }
+    }
+};
+
+TEST_F(ShapeStoreTest, SpliceKeepsOrderAndIndexing) {
+    ShapeStore store;
+    ShapeStore other;
+    fill(store, ShapeStore::kChunkCapacity + 10, 1.0);
+    fill(other, 2 * ShapeStore::kChunkCapacity + 5, 5000.0);
+    size_t other_chunks = other.chunkCount();
+
+    store.splice(other);
+    EXPECT_EQ(other.size(), 0u);
+    EXPECT_EQ(store.size(), 3 * ShapeStore::kChunkCapacity + 15);
+    EXPECT_EQ(store.chunkCount(), 2 + other_chunks);
+    for (size_t i = 0; i < store.size(); ++i) {
+        double expected = i < ShapeStore::kChunkCapacity + 10
+            ? 1.0 + static_cast<double>(i)
+            : 5000.0 + static_cast<double>(i - ShapeStore::kChunkCapacity - 10);
+        ASSERT_DOUBLE_EQ(store.position(i).x, expected) << i;
+        ASSERT_DOUBLE_EQ(static_cast<const Circle&>(std::as_const(store).shape(i)).radius(), expected);
+    }
+
+    store.erase(ShapeStore::kChunkCapacity + 3);
+    EXPECT_DOUBLE_EQ(store.position(ShapeStore::kChunkCapacity + 3).x,
+                     static_cast<double>(ShapeStore::kChunkCapacity) + 5.0);
+    EXPECT_DOUBLE_EQ(store.position(store.size() - 1).x,
+                     5000.0 + static_cast<double>(2 * ShapeStore::kChunkCapacity + 4));
+}
+
+TEST_F(ShapeStoreTest, SmallSplicesDoNotFragment) {
+    ShapeStore store;
+    for (int i = 0; i < 100; ++i) {
+        ShapeStore small;
+        fill(small, 3, 1.0);
+        store.splice(small);
+    }
+    EXPECT_EQ(store.size(), 300u);
+    EXPECT_EQ(store.chunkCount(), 1u);
+
+    for (size_t i = 0; i < 300; ++i) {
+        store.erase(0);
+    }
+    EXPECT_EQ(store.chunkCount(), 0u);
+}
+
+TEST_F(ShapeStoreTest, EraseSortedCompactsAcrossChunks) {
+    ShapeStore store;
+    fill(store, 2 * ShapeStore::kChunkCapacity + 10, 0.5);
+    std::vector<size_t> removed;
+    for (size_t i = 0; i < ShapeStore::kChunkCapacity; ++i) {
+        removed.push_back(i);  // The whole first chunk
+    }
+    for (size_t i = ShapeStore::kChunkCapacity; i < store.size(); i += 3) {
+        removed.push_back(i);
+    }
+
+    size_t before = store.size();
+    store.eraseSorted(removed);
+    EXPECT_EQ(store.size(), before - removed.size());
+    EXPECT_EQ(store.chunkCount(), 2u);
+
+    size_t next = 0;
+    for (size_t i = 0; i < before; ++i) {
+        if (std::binary_search(removed.begin(), removed.end(), i)) {
+            continue;
+        }
+        ASSERT_DOUBLE_EQ(store.position(next).x, 0.5 + static_cast<double>(i)) << next;
+        ++next;
+    }
+}
+
+TEST_F(ShapeStoreTest, MergeCalculators) {
+    GeometryCalculator a;
+    GeometryCalculator b;
+    fill(a, 1500);
+    fill(b, 2500);
+
+    ViewDefinition circle_area;
+    circle_area.aggregate = QueryAggregate::TotalArea;
+    circle_area.kinds = kindMask(ShapeKind::Circle);
+    a.createView("circle area", circle_area);
+    b.createView("circle area", circle_area);
+    a.createView("count", ViewDefinition{});  // Not in b: rebuilt from b's shapes
+
+    double area = a.totalArea() + b.totalArea();
+    double distinct = b.statistics().distinctCount();
+
+    a.merge(b);
+    EXPECT_EQ(a.shapeCount(), 4000u);
+    EXPECT_EQ(b.shapeCount(), 0u);
+    EXPECT_DOUBLE_EQ(b.totalArea(), 0.0);
+    EXPECT_NEAR(a.totalArea(), area, 1e-9 * area);
+    EXPECT_NEAR(a.views().value("circle area"),
+                a.query(ShapeQuery{QueryAggregate::TotalArea, kindMask(ShapeKind::Circle)}), 1e-6);
+    EXPECT_DOUBLE_EQ(a.views().value("count"), 4000.0);
+    EXPECT_EQ(a.statistics().recordedCount(), 4000u);
+    EXPECT_GE(a.statistics().distinctCount(), distinct * 0.9);
+    EXPECT_DOUBLE_EQ(a.getPlacedShape(1500).position.x, 1.0);
+}
+
+TEST_F(ShapeStoreTest, PartitionByKind) {
+    GeometryCalculator calculator;
+    fill(calculator, 5000);
+    double area = calculator.totalArea();
+
+    auto parts = calculator.partition(3, [](const Shape& shape) {
+        return static_cast<size_t>(shape.kind());
+    });
+    ASSERT_EQ(parts.size(), 3u);
+    EXPECT_EQ(calculator.shapeCount(), 0u);
+    EXPECT_EQ(parts[0].shapeCount() + parts[1].shapeCount() + parts[2].shapeCount(), 5000u);
+    EXPECT_NEAR(parts[0].totalArea() + parts[1].totalArea() + parts[2].totalArea(), area,
+                1e-9 * area);
+
+    for (size_t p = 0; p < 3; ++p) {
+        EXPECT_EQ(parts[p].statistics().recordedCount(), parts[p].shapeCount());
+        for (size_t i = 0; i < parts[p].shapeCount(); ++i) {
+            ASSERT_EQ(static_cast<size_t>(parts[p].getShape(i)->kind()), p);
+        }
+    }
+    // Relative order and positions are kept
+    EXPECT_DOUBLE_EQ(parts[0].getPlacedShape(1).position.x, 4.0);
+}
+
+TEST_F(ShapeStoreTest, PartitionRejectsBadIndex) {
+    GeometryCalculator calculator;
+    fill(calculator, 2000);
+    EXPECT_THROW(calculator.partition(2, [](const Shape& shape) {
+        return shape.area() > 50.0 ? size_t{2} : size_t{0};
+    }), std::out_of_range);
+    EXPECT_EQ(calculator.shapeCount(), 2000u);
+}
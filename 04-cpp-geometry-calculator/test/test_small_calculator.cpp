@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "small_calculator.h"
+#include "shapes/circle.h"
+#include "shapes/path.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <stdexcept>
+
+using namespace geometry;
+
+class SmallCalculatorTest : public ::testing::Test {
+protected:
+    SmallGeometryCalculator<4> calculator;
+
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+TEST_F(SmallCalculatorTest, ShapeValuesMatchShapeClasses) {
+    ShapeValue circle = ShapeValue::circle(1.5);
+    ShapeValue rectangle = ShapeValue::rectangle(2.0, 3.5);
+    ShapeValue triangle = ShapeValue::triangle(3.0, 4.0, 5.0);
+
+    EXPECT_EQ(circle.area(), Circle(1.5).area());
+    EXPECT_EQ(circle.perimeter(), Circle(1.5).perimeter());
+    EXPECT_EQ(rectangle.area(), Rectangle(2.0, 3.5).area());
+    EXPECT_EQ(rectangle.perimeter(), Rectangle(2.0, 3.5).perimeter());
+    EXPECT_EQ(triangle.area(), Triangle(3.0, 4.0, 5.0).area());
+    EXPECT_EQ(triangle.perimeter(), Triangle(3.0, 4.0, 5.0).perimeter());
+
+    EXPECT_EQ(ShapeValue::fromShape(*triangle.toShape()), triangle);
+    EXPECT_EQ(sizeof(ShapeValue), 32u);
+}
+
+TEST_F(SmallCalculatorTest, TotalsMatchGeometryCalculator) {
+    GeometryCalculator reference;
+    for (int i = 1; i <= 3; ++i) {
+        calculator.addShape(ShapeValue::circle(i * 0.7));
+        reference.addShape(std::make_unique<Circle>(i * 0.7));
+    }
+    auto triangle = std::unique_ptr<Shape>(std::make_unique<Triangle>(2.0, 3.0, 4.0));
+    calculator.addShape(triangle);
+    reference.addShape(std::make_unique<Triangle>(2.0, 3.0, 4.0));
+
+    EXPECT_TRUE(calculator.isInline());
+    EXPECT_EQ(calculator.shapeCount(), 4u);
+    EXPECT_EQ(calculator.totalArea(), reference.totalArea());
+    EXPECT_EQ(calculator.totalPerimeter(), reference.totalPerimeter());
+    EXPECT_EQ(calculator.getShape(3)->kind, ShapeKind::Triangle);
+    EXPECT_EQ(calculator.getShape(4), nullptr);
+}
+
+TEST_F(SmallCalculatorTest, OverflowMovesToHeap) {
+    for (int i = 1; i <= 11; ++i) {
+        calculator.addShape(ShapeValue::rectangle(i, 1.0));
+    }
+    EXPECT_FALSE(calculator.isInline());
+    EXPECT_EQ(calculator.shapeCount(), 11u);
+    EXPECT_DOUBLE_EQ(calculator.totalArea(), 66.0);
+    EXPECT_DOUBLE_EQ(calculator.getShape(10)->dimensions[0], 11.0);
+
+    SmallGeometryCalculator<4> copy = calculator;
+    SmallGeometryCalculator<4> moved = std::move(calculator);
+    EXPECT_DOUBLE_EQ(copy.totalArea(), 66.0);
+    EXPECT_DOUBLE_EQ(moved.totalArea(), 66.0);
+    EXPECT_EQ(calculator.shapeCount(), 0u);
+
+    moved.clear();
+    EXPECT_TRUE(moved.isInline());
+    EXPECT_DOUBLE_EQ(moved.totalArea(), 0.0);
+}
+
+TEST_F(SmallCalculatorTest, InvalidShapes) {
+    EXPECT_THROW(ShapeValue::circle(-1.0), std::invalid_argument);
+    EXPECT_THROW(ShapeValue::rectangle(1.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(ShapeValue::triangle(1.0, 2.0, 5.0), std::invalid_argument);
+    EXPECT_THROW(ShapeValue::fromShape(Path::roundedRectangle(2.0, 1.0, 0.25)),
+                 std::invalid_argument);
+
+    calculator.addShape(std::unique_ptr<Shape>());
+    EXPECT_EQ(calculator.shapeCount(), 0u);
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include "calculator_tasks.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+using namespace geometry;
+
+class TaskGraphTest : public ::testing::Test {
+protected:
+    TaskPool pool{4};
+
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+TEST_F(TaskGraphTest, DependenciesAreRespected) {
+    TaskGraph graph;
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& name) {
+        return [&, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+
+    auto a = graph.addTask("a", record("a"));
+    auto b = graph.addTask("b", record("b"));
+    auto c = graph.addTask("c", record("c"));
+    auto d = graph.addTask("d", record("d"));
+    graph.precede(a, b);
+    graph.precede(a, c);
+    graph.precede(b, d);
+    graph.precede(c, d);
+    graph.run(pool);
+
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_EQ(order.front(), "a");
+    EXPECT_EQ(order.back(), "d");
+    EXPECT_EQ(graph.nodeCount(), 4u);
+    EXPECT_EQ(graph.name(c), "c");
+}
+
+TEST_F(TaskGraphTest, StreamedChunksSeeTheirUpstreamChunk) {
+    const size_t chunks = 64;
+    std::vector<int> produced(chunks, 0);
+    std::vector<int> consumed(chunks, 0);
+    std::atomic<size_t> finished{0};
+
+    TaskGraph graph;
+    auto produce = graph.addChunkedTask("produce", chunks, [&](size_t i) {
+        produced[i] = static_cast<int>(i) + 1;
+    });
+    auto consume = graph.addChunkedTask("consume", chunks, [&](size_t i) {
+        consumed[i] = produced[i] * 2;
+    });
+    auto done = graph.addTask("done", [&]() { finished = chunks; });
+    graph.stream(produce, consume);
+    graph.precede(consume, done);
+
+    // The graph can be run repeatedly
+    graph.run(pool);
+    graph.run(pool);
+
+    for (size_t i = 0; i < chunks; ++i) {
+        EXPECT_EQ(consumed[i], 2 * (static_cast<int>(i) + 1));
+    }
+    EXPECT_EQ(finished.load(), chunks);
+    EXPECT_EQ(graph.chunkCount(produce), chunks);
+}
+
+TEST_F(TaskGraphTest, OrderedChunksRunInOrder) {
+    std::vector<size_t> order;
+    TaskGraph graph;
+    graph.addChunkedTask("ordered", 100, [&](size_t i) { order.push_back(i); }, true);
+    graph.run(pool);
+
+    ASSERT_EQ(order.size(), 100u);
+    for (size_t i = 0; i < order.size(); ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST_F(TaskGraphTest, FirstExceptionIsRethrown) {
+    std::atomic<bool> after_ran{false};
+    TaskGraph graph;
+    auto failing = graph.addTask("failing", []() { throw std::runtime_error("boom"); });
+    auto after = graph.addTask("after", [&]() { after_ran = true; });
+    graph.precede(failing, after);
+
+    EXPECT_THROW(graph.run(pool), std::runtime_error);
+    EXPECT_FALSE(after_ran.load());
+}
+
+TEST_F(TaskGraphTest, InvalidGraphs) {
+    TaskGraph graph;
+    auto a = graph.addTask("a", []() {});
+    auto b = graph.addChunkedTask("b", 3, [](size_t) {});
+    EXPECT_THROW(graph.stream(a, b), std::invalid_argument);
+    EXPECT_THROW(graph.precede(a, 7), std::invalid_argument);
+    EXPECT_THROW(graph.addChunkedTask("empty", 0, [](size_t) {}), std::invalid_argument);
+
+    graph.precede(a, b);
+    graph.precede(b, a);
+    EXPECT_THROW(graph.run(pool), std::invalid_argument);
+}
+
+TEST_F(TaskGraphTest, NestedRunOnWorkerThread) {
+    TaskPool single(1);
+    std::atomic<int> inner_runs{0};
+    TaskGraph inner;
+    inner.addChunkedTask("inner", 8, [&](size_t) { ++inner_runs; });
+
+    TaskGraph outer;
+    outer.addTask("outer", [&]() { inner.run(single); });
+    outer.run(single);
+
+    EXPECT_EQ(inner_runs.load(), 8);
+}
+
+TEST_F(TaskGraphTest, PipelineMatchesSequentialCalculator) {
+    const size_t chunks = 16;
+    const size_t per_chunk = 50;
+    auto loader = [](size_t chunk) {
+        ShapeBatch batch;
+        for (size_t i = 0; i < per_chunk; ++i) {
+            double size = 1.0 + static_cast<double>(chunk * per_chunk + i) * 0.01;
+            batch.shapes.push_back(std::make_unique<Rectangle>(size, 1.0));
+            batch.positions.push_back({static_cast<double>(i) * 10.0, static_cast<double>(chunk) * 10.0});
+        }
+        batch.shapes.push_back(nullptr);  // Dropped by validation
+        batch.positions.push_back({});
+        return batch;
+    };
+
+    GeometryCalculator sequential;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        ShapeBatch batch = loader(chunk);
+        for (size_t i = 0; i < batch.shapes.size(); ++i) {
+            sequential.addShape(std::move(batch.shapes[i]), batch.positions[i]);
+        }
+    }
+
+    GeometryCalculator calculator;
+    double area = 0.0;
+    double perimeter = 0.0;
+    double union_perimeter = 0.0;
+    TaskGraph graph;
+    IngestNodes ingest = addIngestNodes(graph, calculator, chunks, loader);
+    graph.precede(ingest.commit, addTotalAreaNode(graph, calculator, area));
+    graph.precede(ingest.commit, addTotalPerimeterNode(graph, calculator, perimeter));
+    graph.precede(ingest.commit, addUnionPerimeterNode(graph, calculator, union_perimeter));
+    graph.run(pool);
+
+    ASSERT_EQ(calculator.shapeCount(), sequential.shapeCount());
+    for (size_t i = 0; i < calculator.shapeCount(); ++i) {
+        EXPECT_DOUBLE_EQ(calculator.getShape(i)->area(), sequential.getShape(i)->area());
+        EXPECT_EQ(calculator.getPlacedShape(i).position.x, sequential.getPlacedShape(i).position.x);
+    }
+    EXPECT_DOUBLE_EQ(area, sequential.totalArea());
+    EXPECT_DOUBLE_EQ(perimeter, sequential.totalPerimeter());
+    EXPECT_DOUBLE_EQ(union_perimeter, sequential.unionPerimeter());
+}
+
+TEST_F(TaskGraphTest, IngestRejectsMismatchedPositions) {
+    GeometryCalculator calculator;
+    TaskGraph graph;
+    addIngestNodes(graph, calculator, 2, [](size_t) {
+        ShapeBatch batch;
+        batch.shapes.push_back(std::make_unique<Circle>(1.0));
+        batch.positions.resize(2);
+        return batch;
+    });
+
+    EXPECT_THROW(graph.run(pool), std::invalid_argument);
+    EXPECT_EQ(calculator.shapeCount(), 0u);
+}
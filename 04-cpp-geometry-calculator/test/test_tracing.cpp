@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "shapes/circle.h"
+#include "tracing.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace geometry;
+
+class TracingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setTracingEnabled(true);
+        setTraceBufferCapacity(1 << 16);
+    }
+
+    void TearDown() override {
+        setTracingEnabled(true);
+        clearTrace();
+    }
+};
+
+TEST_F(TracingTest, ScopesFromSeveralThreads) {
+    // Threads stay alive until all have recorded, so none reuses another's buffer
+    std::atomic<int> recorded{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([t, &recorded] {
+            for (int i = 0; i < 5; ++i) {
+                TraceScope scope("test", t == 0 ? "first \"quoted\"" : "other", i);
+            }
+            ++recorded;
+            while (recorded.load() < 3) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(traceEventCount(), 15u);
+    std::string json = traceJson();
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"first \\\"quoted\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"cat\":\"test\""), std::string::npos);
+    EXPECT_NE(json.find("\"dropped_events\":0"), std::string::npos);
+
+    // Three threads, each with its own tid and name metadata
+    size_t names = 0;
+    for (size_t pos = 0; (pos = json.find("\"thread_name\"", pos)) != std::string::npos; ++pos) {
+        ++names;
+    }
+    EXPECT_EQ(names, 3u);
+}
+
+TEST_F(TracingTest, RingBufferKeepsNewestEvents) {
+    setTraceBufferCapacity(4);
+    for (uint64_t i = 0; i < 10; ++i) {
+        recordTraceEvent("test", "event", traceClock(), 1500, i);
+    }
+    EXPECT_EQ(traceEventCount(), 4u);
+
+    std::string json = traceJson();
+    EXPECT_EQ(json.find("\"arg\":5}"), std::string::npos);
+    size_t six = json.find("\"arg\":6}");
+    size_t nine = json.find("\"arg\":9}");
+    ASSERT_NE(six, std::string::npos);
+    ASSERT_NE(nine, std::string::npos);
+    EXPECT_LT(six, nine);
+    EXPECT_NE(json.find("\"dur\":1.500"), std::string::npos);
+    EXPECT_NE(json.find("\"dropped_events\":6"), std::string::npos);
+}
+
+TEST_F(TracingTest, PausedTracingRecordsNothing) {
+    setTracingEnabled(false);
+    {
+        TraceScope scope("test", "ignored");
+    }
+    EXPECT_EQ(traceEventCount(), 0u);
+    EXPECT_NE(traceJson().find("\"traceEvents\":[\n]"), std::string::npos);
+}
+
+TEST_F(TracingTest, InternalWorkIsInstrumented) {
+    GeometryCalculator calculator;
+    for (int i = 0; i < 3000; ++i) {
+        calculator.addShape(std::make_unique<Circle>(1.0 + i % 5));
+    }
+    auto parts = calculator.partition(2, [](const Shape& shape) {
+        return shape.area() > 20.0 ? size_t{1} : size_t{0};
+    });
+    parts[0].reportPage(0, 10);
+
+    std::string json = traceJson();
+#if GEOMETRY_ENABLE_TRACING
+    EXPECT_NE(json.find("parallelFor block"), std::string::npos);
+    EXPECT_NE(json.find("reportPage"), std::string::npos);
+#else
+    EXPECT_EQ(traceEventCount(), 0u);
+#endif
+}
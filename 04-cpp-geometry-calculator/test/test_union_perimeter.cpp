@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "geometry_calculator.h"
+#include "union_perimeter.h"
+#include "shapes/circle.h"
+#include "shapes/rectangle.h"
+#include "shapes/triangle.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace geometry;
+
+class UnionPerimeterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        calculator = std::make_unique<GeometryCalculator>();
+    }
+
+    void TearDown() override {
+        calculator.reset();
+    }
+
+    std::unique_ptr<GeometryCalculator> calculator;
+};
+
+TEST_F(UnionPerimeterTest, EmptyCalculator) {
+    EXPECT_DOUBLE_EQ(calculator->unionPerimeter(), 0.0);
+}
+
+TEST_F(UnionPerimeterTest, DisjointShapesMatchTotalPerimeter) {
+    calculator->addShape(std::make_unique<Circle>(1.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Rectangle>(2.0, 3.0), {10.0, 0.0});
+    calculator->addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0), {20.0, 0.0});
+
+    EXPECT_NEAR(calculator->unionPerimeter(), calculator->totalPerimeter(), 1e-9);
+}
+
+TEST_F(UnionPerimeterTest, OverlappingRectangles) {
+    // Two 2x2 squares offset by (1, 1): union outline is a 3x3 staircase
+    calculator->addShape(std::make_unique<Rectangle>(2.0, 2.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Rectangle>(2.0, 2.0), {1.0, 1.0});
+
+    EXPECT_DOUBLE_EQ(calculator->unionPerimeter(), 12.0);
+    EXPECT_DOUBLE_EQ(calculator->totalPerimeter(), 16.0);
+}
+
+TEST_F(UnionPerimeterTest, AbuttingRectanglesHideSharedEdge) {
+    calculator->addShape(std::make_unique<Rectangle>(1.0, 1.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Rectangle>(1.0, 1.0), {1.0, 0.0});
+
+    EXPECT_DOUBLE_EQ(calculator->unionPerimeter(), 6.0);
+}
+
+TEST_F(UnionPerimeterTest, ContainedRectangle) {
+    calculator->addShape(std::make_unique<Rectangle>(10.0, 10.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Rectangle>(1.0, 1.0), {2.0, 2.0});
+
+    EXPECT_DOUBLE_EQ(calculator->unionPerimeter(), 40.0);
+}
+
+TEST_F(UnionPerimeterTest, RectangleFrameCountsInnerContour) {
+    // Four bars around a 2x2 hole inside a 4x4 square
+    calculator->addShape(std::make_unique<Rectangle>(4.0, 1.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Rectangle>(4.0, 1.0), {0.0, 3.0});
+    calculator->addShape(std::make_unique<Rectangle>(1.0, 4.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Rectangle>(1.0, 4.0), {3.0, 0.0});
+
+    EXPECT_DOUBLE_EQ(calculator->unionPerimeter(), 16.0 + 8.0);
+}
+
+TEST_F(UnionPerimeterTest, OverlappingCircles) {
+    // Unit circles one radius apart each lose a 120 degree arc
+    calculator->addShape(std::make_unique<Circle>(1.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Circle>(1.0), {1.0, 0.0});
+
+    EXPECT_NEAR(calculator->unionPerimeter(1e-8), 8.0 * M_PI / 3.0, 1e-6);
+}
+
+TEST_F(UnionPerimeterTest, ChainOfCircles) {
+    // Each circle loses a 120 degree arc to each neighbour one radius away;
+    // each of the 4 * count arc ends is placed within about the tolerance
+    const int count = 200;
+    const double tolerance = 1e-5;
+    for (int i = 0; i < count; ++i) {
+        calculator->addShape(std::make_unique<Circle>(1.0), {static_cast<double>(i), 0.0});
+    }
+
+    double expected = 2.0 * (4.0 * M_PI / 3.0) + (count - 2) * (2.0 * M_PI / 3.0);
+    EXPECT_NEAR(calculator->unionPerimeter(tolerance), expected, 4.0 * count * tolerance);
+}
+
+TEST_F(UnionPerimeterTest, CircleInsideRectangle) {
+    calculator->addShape(std::make_unique<Rectangle>(4.0, 4.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Circle>(1.0), {2.0, 2.0});
+
+    EXPECT_NEAR(calculator->unionPerimeter(), 16.0, 1e-9);
+}
+
+TEST_F(UnionPerimeterTest, CoincidentTrianglesCountedOnce) {
+    calculator->addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0), {0.0, 0.0});
+    calculator->addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0), {0.0, 0.0});
+
+    EXPECT_NEAR(calculator->unionPerimeter(), 12.0, 1e-9);
+}
+
+TEST_F(UnionPerimeterTest, TriangleOnRectangle) {
+    // Right triangle sitting on top of a 3x2 rectangle, sharing its base
+    calculator->addShape(std::make_unique<Rectangle>(3.0, 2.0), {0.0, -2.0});
+    calculator->addShape(std::make_unique<Triangle>(3.0, 4.0, 5.0), {0.0, 0.0});
+
+    EXPECT_NEAR(calculator->unionPerimeter(), 2.0 + 3.0 + 2.0 + 4.0 + 5.0, 1e-9);
+}
+
+TEST_F(UnionPerimeterTest, ManyClustersMatchSerialSum) {
+    double expected = 0.0;
+    for (int i = 0; i < 200; ++i) {
+        double x = 10.0 * i;
+        calculator->addShape(std::make_unique<Rectangle>(2.0, 2.0), {x, 0.0});
+        calculator->addShape(std::make_unique<Rectangle>(2.0, 2.0), {x + 1.0, 1.0});
+        expected += 12.0;
+    }
+
+    EXPECT_NEAR(calculator->unionPerimeter(), expected, 1e-9);
+}
+
+TEST_F(UnionPerimeterTest, OverlapClusters) {
+    std::vector<BoundingBox> boxes = {
+        {0.0, 0.0, 1.0, 1.0},
+        {5.0, 5.0, 6.0, 6.0},
+        {1.0, 1.0, 2.0, 2.0}, // Touches box 0
+    };
+    auto clusters = overlapClusters(boxes, overlappingPairs(boxes));
+
+    ASSERT_EQ(clusters.size(), 2u);
+    EXPECT_EQ(clusters[0], (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(clusters[1], (std::vector<size_t>{1}));
+}
+
+TEST_F(UnionPerimeterTest, OverlappingPairsMatchBruteForce) {
+    // Wide bars stacked without touching stay active together in the sweep
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coordinate(0.0, 100.0);
+    std::vector<BoundingBox> boxes;
+    for (int i = 0; i < 300; ++i) {
+        boxes.push_back({0.0, 2.0 * i, 100.0, 2.0 * i + 1.0});
+    }
+    for (int i = 0; i < 300; ++i) {
+        double x = coordinate(rng);
+        double y = coordinate(rng) * 6.0;
+        boxes.push_back({x, y, x + coordinate(rng) / 10.0, y + coordinate(rng) / 10.0});
+    }
+    boxes.push_back({50.0, 1.0, 60.0, 2.0});  // Touches bars 0 and 1
+
+    std::vector<std::pair<size_t, size_t>> expected;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        for (size_t j = i + 1; j < boxes.size(); ++j) {
+            if (boxes[i].min_x <= boxes[j].max_x && boxes[j].min_x <= boxes[i].max_x &&
+                boxes[i].min_y <= boxes[j].max_y && boxes[j].min_y <= boxes[i].max_y) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    auto pairs = overlappingPairs(boxes);
+    std::sort(pairs.begin(), pairs.end());
+    EXPECT_EQ(pairs, expected);
+}